@@ -0,0 +1,490 @@
+#include "bench_media.h"
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <glib/gstdio.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libavutil/opt.h>
+#include <errno.h>
+#include <string.h>
+
+const BenchImageSize bench_image_sizes[] = {
+    { "small", 640, 480 },
+    { "hd", 1920, 1080 },
+    { "4k", 3840, 2160 },
+};
+const gsize bench_image_size_count = G_N_ELEMENTS(bench_image_sizes);
+
+const char *const bench_image_formats[] = { "png", "jpg", "webp", "gif" };
+const gsize bench_image_format_count = G_N_ELEMENTS(bench_image_formats);
+
+static guint32 bench_media_next_random(guint32 *state) {
+    // xorshift32: small, fast and the same everywhere
+    guint32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Smooth gradients under a few soft discs plus mild grain, which
+// compresses and scales roughly like a photograph.
+static void bench_media_fill(guint8 *pixels, gint width, gint height, gint rowstride, guint32 seed) {
+    guint32 state = seed ? seed : 1;
+    gint discs[6][4];
+    for (gint i = 0; i < 6; i++) {
+        discs[i][0] = (gint)(bench_media_next_random(&state) % (guint32)width);
+        discs[i][1] = (gint)(bench_media_next_random(&state) % (guint32)height);
+        discs[i][2] = MAX(width, height) / 8 + (gint)(bench_media_next_random(&state) % (guint32)(width / 6 + 1));
+        discs[i][3] = (gint)(bench_media_next_random(&state) & 0xffffff);
+    }
+    for (gint y = 0; y < height; y++) {
+        guint8 *row = pixels + (gsize)y * (gsize)rowstride;
+        for (gint x = 0; x < width; x++) {
+            gint r = x * 255 / width;
+            gint g = y * 255 / height;
+            gint b = 255 - (r + g) / 2;
+            for (gint i = 0; i < 6; i++) {
+                gint64 dx = x - discs[i][0];
+                gint64 dy = y - discs[i][1];
+                gint64 radius = discs[i][2];
+                if (dx * dx + dy * dy < radius * radius) {
+                    gint color = discs[i][3];
+                    r = (r + ((color >> 16) & 0xff)) / 2;
+                    g = (g + ((color >> 8) & 0xff)) / 2;
+                    b = (b + (color & 0xff)) / 2;
+                }
+            }
+            gint grain = (gint)(bench_media_next_random(&state) & 15) - 8;
+            row[x * 3 + 0] = (guint8)CLAMP(r + grain, 0, 255);
+            row[x * 3 + 1] = (guint8)CLAMP(g + grain, 0, 255);
+            row[x * 3 + 2] = (guint8)CLAMP(b + grain, 0, 255);
+        }
+    }
+}
+
+static GdkPixbuf *bench_media_new_pixbuf(gint width, gint height, guint32 seed) {
+    GdkPixbuf *pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, width, height);
+    if (pixbuf) {
+        bench_media_fill(gdk_pixbuf_get_pixels(pixbuf), width, height, gdk_pixbuf_get_rowstride(pixbuf), seed);
+    }
+    return pixbuf;
+}
+
+static void bench_media_put_u16(GString *out, guint value) {
+    g_string_append_c(out, (gchar)(value & 0xff));
+    g_string_append_c(out, (gchar)((value >> 8) & 0xff));
+}
+
+typedef struct {
+    GString *out;
+    guint8 block[255];
+    guint block_len;
+    guint32 bits;
+    guint bit_count;
+} BenchGifWriter;
+
+static void bench_gif_put_byte(BenchGifWriter *writer, guint8 byte) {
+    writer->block[writer->block_len++] = byte;
+    if (writer->block_len == sizeof(writer->block)) {
+        g_string_append_c(writer->out, (gchar)writer->block_len);
+        g_string_append_len(writer->out, (const gchar *)writer->block, writer->block_len);
+        writer->block_len = 0;
+    }
+}
+
+static void bench_gif_put_code(BenchGifWriter *writer, guint code) {
+    writer->bits |= (guint32)code << writer->bit_count;
+    writer->bit_count += 9;
+    while (writer->bit_count >= 8) {
+        bench_gif_put_byte(writer, (guint8)(writer->bits & 0xff));
+        writer->bits >>= 8;
+        writer->bit_count -= 8;
+    }
+}
+
+// A GIF with a fixed 3-3-2 palette. The LZW stream only holds literals and
+// is reset before the code table would need 10-bit codes, which any decoder
+// reads and which is simple to write.
+static GString *bench_media_encode_gif(const GdkPixbuf *pixbuf) {
+    gint width = gdk_pixbuf_get_width(pixbuf);
+    gint height = gdk_pixbuf_get_height(pixbuf);
+    gint rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+    const guint8 *pixels = gdk_pixbuf_read_pixels(pixbuf);
+
+    GString *out = g_string_new("GIF89a");
+    bench_media_put_u16(out, (guint)width);
+    bench_media_put_u16(out, (guint)height);
+    g_string_append_c(out, (gchar)0xf7);
+    g_string_append_c(out, 0);
+    g_string_append_c(out, 0);
+    for (guint i = 0; i < 256; i++) {
+        g_string_append_c(out, (gchar)(((i >> 5) & 7) * 255 / 7));
+        g_string_append_c(out, (gchar)(((i >> 2) & 7) * 255 / 7));
+        g_string_append_c(out, (gchar)((i & 3) * 255 / 3));
+    }
+    g_string_append_c(out, ',');
+    bench_media_put_u16(out, 0);
+    bench_media_put_u16(out, 0);
+    bench_media_put_u16(out, (guint)width);
+    bench_media_put_u16(out, (guint)height);
+    g_string_append_c(out, 0);
+    g_string_append_c(out, 8);
+
+    const guint clear_code = 256;
+    const guint end_code = 257;
+    BenchGifWriter writer = { .out = out };
+    guint since_clear = 0;
+    bench_gif_put_code(&writer, clear_code);
+    for (gint y = 0; y < height; y++) {
+        const guint8 *row = pixels + (gsize)y * (gsize)rowstride;
+        for (gint x = 0; x < width; x++) {
+            const guint8 *p = row + x * 3;
+            if (since_clear == 254) {
+                bench_gif_put_code(&writer, clear_code);
+                since_clear = 0;
+            }
+            bench_gif_put_code(&writer, (guint)((p[0] & 0xe0) | ((p[1] >> 3) & 0x1c) | (p[2] >> 6)));
+            since_clear++;
+        }
+    }
+    bench_gif_put_code(&writer, end_code);
+    if (writer.bit_count > 0) {
+        bench_gif_put_byte(&writer, (guint8)(writer.bits & 0xff));
+    }
+    if (writer.block_len > 0) {
+        g_string_append_c(out, (gchar)writer.block_len);
+        g_string_append_len(out, (const gchar *)writer.block, writer.block_len);
+    }
+    g_string_append_c(out, 0);
+    g_string_append_c(out, ';');
+    return out;
+}
+
+static gboolean bench_media_can_write(const char *format) {
+    gboolean writable = FALSE;
+    GSList *formats = gdk_pixbuf_get_formats();
+    for (GSList *node = formats; node; node = node->next) {
+        GdkPixbufFormat *info = node->data;
+        gchar *name = gdk_pixbuf_format_get_name(info);
+        if (g_strcmp0(name, format) == 0 && gdk_pixbuf_format_is_writable(info)) {
+            writable = TRUE;
+        }
+        g_free(name);
+    }
+    g_slist_free(formats);
+    return writable;
+}
+
+static gboolean bench_media_save(GdkPixbuf *pixbuf, const char *path, const char *format, GError **error) {
+    if (g_strcmp0(format, "gif") == 0) {
+        GString *gif = bench_media_encode_gif(pixbuf);
+        gboolean ok = g_file_set_contents(path, gif->str, (gssize)gif->len, error);
+        g_string_free(gif, TRUE);
+        return ok;
+    }
+    if (g_strcmp0(format, "jpg") == 0) {
+        return gdk_pixbuf_save(pixbuf, path, "jpeg", error, "quality", "85", NULL);
+    }
+    if (g_strcmp0(format, "webp") == 0) {
+        return gdk_pixbuf_save(pixbuf, path, "webp", error, "quality", "85", NULL);
+    }
+    return gdk_pixbuf_save(pixbuf, path, "png", error, NULL);
+}
+
+gchar* bench_media_image_path(const char *directory, const BenchImageSize *size, const char *format) {
+    gchar *name = g_strdup_printf("%s-%dx%d.%s", size->name, size->width, size->height, format);
+    gchar *path = g_build_filename(directory, "images", name, NULL);
+    g_free(name);
+    return path;
+}
+
+static gboolean bench_media_write_images(const char *directory, GPtrArray *skipped, GError **error) {
+    gboolean can_webp = bench_media_can_write("webp");
+    if (!can_webp) {
+        g_ptr_array_add(skipped, g_strdup("webp"));
+    }
+    for (gsize s = 0; s < bench_image_size_count; s++) {
+        const BenchImageSize *size = &bench_image_sizes[s];
+        GdkPixbuf *pixbuf = bench_media_new_pixbuf(size->width, size->height, (guint32)(s + 1) * 2654435761u);
+        for (gsize f = 0; f < bench_image_format_count; f++) {
+            const char *format = bench_image_formats[f];
+            if (g_strcmp0(format, "webp") == 0 && !can_webp) {
+                continue;
+            }
+            gchar *path = bench_media_image_path(directory, size, format);
+            gboolean ok = bench_media_save(pixbuf, path, format, error);
+            g_free(path);
+            if (!ok) {
+                g_object_unref(pixbuf);
+                return FALSE;
+            }
+        }
+        g_object_unref(pixbuf);
+    }
+    return TRUE;
+}
+
+static gboolean bench_media_write_grid(const char *directory, GError **error) {
+    gchar *grid = g_build_filename(directory, "grid", NULL);
+    gboolean ok = g_mkdir_with_parents(grid, 0755) == 0;
+    for (gint i = 0; ok && i < BENCH_GRID_IMAGES; i++) {
+        const char *format = (i % 2) ? "jpg" : "png";
+        GdkPixbuf *pixbuf = bench_media_new_pixbuf(640, 480, 0x9e3779b9u ^ (guint32)(i * 7919 + 1));
+        gchar *name = g_strdup_printf("grid-%02d.%s", i, format);
+        gchar *path = g_build_filename(grid, name, NULL);
+        ok = bench_media_save(pixbuf, path, format, error);
+        g_free(path);
+        g_free(name);
+        g_object_unref(pixbuf);
+    }
+    if (!ok && error && !*error) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s", grid);
+    }
+    g_free(grid);
+    return ok;
+}
+
+static gboolean bench_media_write_scan(const char *directory, GError **error) {
+    gchar *scan = g_build_filename(directory, "scan", NULL);
+    if (g_mkdir_with_parents(scan, 0755) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s", scan);
+        g_free(scan);
+        return FALSE;
+    }
+    GdkPixbuf *pixbuf = bench_media_new_pixbuf(32, 32, 7u);
+    gchar *png = NULL;
+    gsize png_len = 0;
+    gboolean ok = gdk_pixbuf_save_to_buffer(pixbuf, &png, &png_len, "png", error, NULL);
+    g_object_unref(pixbuf);
+    for (gint i = 0; ok && i < BENCH_SCAN_FILES; i++) {
+        gchar *name = g_strdup_printf("scan-%04d.png", i);
+        gchar *path = g_build_filename(scan, name, NULL);
+        ok = g_file_set_contents(path, png, (gssize)png_len, error);
+        g_free(path);
+        g_free(name);
+    }
+    g_free(png);
+    g_free(scan);
+    return ok;
+}
+
+// Fills a YUV 4:2:0 frame with a drifting gradient and a moving box, so
+// every frame differs and motion search has real work.
+static void bench_media_fill_video_frame(AVFrame *frame, gint index) {
+    for (gint y = 0; y < frame->height; y++) {
+        guint8 *row = frame->data[0] + (gsize)y * (gsize)frame->linesize[0];
+        for (gint x = 0; x < frame->width; x++) {
+            row[x] = (guint8)((x + y + index * 3) & 0xff);
+        }
+    }
+    gint box = frame->height / 4;
+    gint box_x = (index * 7) % MAX(frame->width - box, 1);
+    gint box_y = (index * 3) % MAX(frame->height - box, 1);
+    for (gint y = box_y; y < box_y + box; y++) {
+        memset(frame->data[0] + (gsize)y * (gsize)frame->linesize[0] + box_x, 235, (gsize)box);
+    }
+    for (gint y = 0; y < frame->height / 2; y++) {
+        guint8 *u = frame->data[1] + (gsize)y * (gsize)frame->linesize[1];
+        guint8 *v = frame->data[2] + (gsize)y * (gsize)frame->linesize[2];
+        for (gint x = 0; x < frame->width / 2; x++) {
+            u[x] = (guint8)(128 + y / 2 + index);
+            v[x] = (guint8)(64 + x / 2 + index * 2);
+        }
+    }
+}
+
+static gboolean bench_media_write_packets(AVCodecContext *codec, AVFormatContext *format, AVStream *stream,
+                                          AVPacket *packet, const AVFrame *frame) {
+    if (avcodec_send_frame(codec, frame) < 0) {
+        return FALSE;
+    }
+    for (;;) {
+        int result = avcodec_receive_packet(codec, packet);
+        if (result == AVERROR(EAGAIN) || result == AVERROR_EOF) {
+            return TRUE;
+        }
+        if (result < 0) {
+            return FALSE;
+        }
+        av_packet_rescale_ts(packet, codec->time_base, stream->time_base);
+        packet->stream_index = stream->index;
+        if (av_interleaved_write_frame(format, packet) < 0) {
+            return FALSE;
+        }
+    }
+}
+
+static gboolean bench_media_write_video(const char *directory, GError **error) {
+    gchar *path = g_build_filename(directory, "video.avi", NULL);
+    const AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    AVFormatContext *format = NULL;
+    AVCodecContext *codec = NULL;
+    AVFrame *frame = NULL;
+    AVPacket *packet = NULL;
+    gboolean header_written = FALSE;
+    gboolean ok = FALSE;
+
+    if (!encoder || avformat_alloc_output_context2(&format, NULL, "avi", path) < 0 || !format) {
+        goto out;
+    }
+    AVStream *stream = avformat_new_stream(format, NULL);
+    codec = avcodec_alloc_context3(encoder);
+    frame = av_frame_alloc();
+    packet = av_packet_alloc();
+    if (!stream || !codec || !frame || !packet) {
+        goto out;
+    }
+    codec->width = BENCH_VIDEO_WIDTH;
+    codec->height = BENCH_VIDEO_HEIGHT;
+    codec->pix_fmt = AV_PIX_FMT_YUV420P;
+    codec->time_base = (AVRational){ 1, BENCH_VIDEO_FPS };
+    codec->framerate = (AVRational){ BENCH_VIDEO_FPS, 1 };
+    codec->gop_size = BENCH_VIDEO_FPS;
+    codec->bit_rate = 2000000;
+    codec->flags |= AV_CODEC_FLAG_BITEXACT;
+    if (format->oformat->flags & AVFMT_GLOBALHEADER) {
+        codec->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    format->flags |= AVFMT_FLAG_BITEXACT;
+    if (avcodec_open2(codec, encoder, NULL) < 0 ||
+        avcodec_parameters_from_context(stream->codecpar, codec) < 0) {
+        goto out;
+    }
+    stream->time_base = codec->time_base;
+    if (avio_open(&format->pb, path, AVIO_FLAG_WRITE) < 0) {
+        goto out;
+    }
+    if (avformat_write_header(format, NULL) < 0) {
+        goto out;
+    }
+    header_written = TRUE;
+
+    frame->format = codec->pix_fmt;
+    frame->width = codec->width;
+    frame->height = codec->height;
+    if (av_frame_get_buffer(frame, 0) < 0) {
+        goto out;
+    }
+    for (gint i = 0; i < BENCH_VIDEO_FRAMES; i++) {
+        if (av_frame_make_writable(frame) < 0) {
+            goto out;
+        }
+        bench_media_fill_video_frame(frame, i);
+        frame->pts = i;
+        if (!bench_media_write_packets(codec, format, stream, packet, frame)) {
+            goto out;
+        }
+    }
+    ok = bench_media_write_packets(codec, format, stream, packet, NULL);
+
+out:
+    if (header_written && av_write_trailer(format) < 0) {
+        ok = FALSE;
+    }
+    if (format && format->pb) {
+        avio_closep(&format->pb);
+    }
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&codec);
+    avformat_free_context(format);
+    if (!ok) {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_FAILED, "Cannot encode %s", path);
+    }
+    g_free(path);
+    return ok;
+}
+
+// A plain PDF 1.4 file: per page a few filled shapes and a column of text
+// in a standard font, so the rasterizer does both paths and glyphs.
+static gboolean bench_media_write_book(const char *directory, GError **error) {
+    const gint objects = 3 + BENCH_BOOK_PAGES * 2;
+    gsize *offsets = g_new0(gsize, (gsize)objects + 1);
+    GString *pdf = g_string_new("%PDF-1.4\n");
+
+    offsets[1] = pdf->len;
+    g_string_append(pdf, "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+    offsets[2] = pdf->len;
+    g_string_append(pdf, "2 0 obj\n<< /Type /Pages /Kids [");
+    for (gint page = 0; page < BENCH_BOOK_PAGES; page++) {
+        g_string_append_printf(pdf, " %d 0 R", 4 + page * 2);
+    }
+    g_string_append_printf(pdf, " ] /Count %d >>\nendobj\n", BENCH_BOOK_PAGES);
+    offsets[3] = pdf->len;
+    g_string_append(pdf, "3 0 obj\n<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica >>\nendobj\n");
+
+    for (gint page = 0; page < BENCH_BOOK_PAGES; page++) {
+        gint page_object = 4 + page * 2;
+        GString *content = g_string_new(NULL);
+        for (gint i = 0; i < 8; i++) {
+            g_string_append_printf(content, "%.2f %.2f %.2f rg %d %d %d %d re f\n",
+                                   (gdouble)((page + i) % 5) / 4.0,
+                                   (gdouble)(i % 3) / 2.0,
+                                   (gdouble)((page * 3 + i) % 7) / 6.0,
+                                   40 + i * 60, 420 + (i * 37 + page * 11) % 300, 50, 40 + i * 5);
+        }
+        g_string_append(content, "0 0 0 rg BT /F1 11 Tf 14 TL 48 380 Td\n");
+        for (gint line = 0; line < 24; line++) {
+            g_string_append_printf(content,
+                                   "(Page %d line %d: the quick brown fox jumps over the lazy dog) '\n",
+                                   page + 1, line + 1);
+        }
+        g_string_append(content, "ET\n");
+
+        offsets[page_object] = pdf->len;
+        g_string_append_printf(pdf,
+                               "%d 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 612 792]"
+                               " /Resources << /Font << /F1 3 0 R >> >> /Contents %d 0 R >>\nendobj\n",
+                               page_object, page_object + 1);
+        offsets[page_object + 1] = pdf->len;
+        g_string_append_printf(pdf, "%d 0 obj\n<< /Length %" G_GSIZE_FORMAT " >>\nstream\n",
+                               page_object + 1, content->len);
+        g_string_append_len(pdf, content->str, (gssize)content->len);
+        g_string_append(pdf, "endstream\nendobj\n");
+        g_string_free(content, TRUE);
+    }
+
+    gsize xref = pdf->len;
+    g_string_append_printf(pdf, "xref\n0 %d\n0000000000 65535 f \n", objects + 1);
+    for (gint i = 1; i <= objects; i++) {
+        g_string_append_printf(pdf, "%010" G_GSIZE_FORMAT " 00000 n \n", offsets[i]);
+    }
+    g_string_append_printf(pdf, "trailer\n<< /Size %d /Root 1 0 R >>\nstartxref\n%" G_GSIZE_FORMAT "\n%%%%EOF\n",
+                           objects + 1, xref);
+
+    gchar *path = g_build_filename(directory, "book.pdf", NULL);
+    gboolean ok = g_file_set_contents(path, pdf->str, (gssize)pdf->len, error);
+    g_free(path);
+    g_string_free(pdf, TRUE);
+    g_free(offsets);
+    return ok;
+}
+
+gboolean bench_media_generate(const char *directory, gchar ***out_skipped, GError **error) {
+    g_return_val_if_fail(directory != NULL, FALSE);
+
+    gchar *images = g_build_filename(directory, "images", NULL);
+    if (g_mkdir_with_parents(images, 0755) != 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno), "Cannot create %s", images);
+        g_free(images);
+        return FALSE;
+    }
+    g_free(images);
+
+    GPtrArray *skipped = g_ptr_array_new_with_free_func(g_free);
+    gboolean ok = bench_media_write_images(directory, skipped, error) &&
+                  bench_media_write_grid(directory, error) &&
+                  bench_media_write_scan(directory, error) &&
+                  bench_media_write_video(directory, error) &&
+                  bench_media_write_book(directory, error);
+    g_ptr_array_add(skipped, NULL);
+    gchar **list = (gchar **)g_ptr_array_free(skipped, FALSE);
+    if (out_skipped) {
+        *out_skipped = list;
+    } else {
+        g_strfreev(list);
+    }
+    return ok;
+}
@@ -0,0 +1,53 @@
+#ifndef BENCH_MEDIA_H
+#define BENCH_MEDIA_H
+
+#include <glib.h>
+
+/*
+ * Synthetic media for the benchmark suite. Everything is drawn from fixed
+ * seeds, so two runs of the generator produce the same pixels and the
+ * benchmarks compare like with like across releases. Nothing is fetched.
+ *
+ * Layout under the media directory:
+ *   images/   <name>-<w>x<h>.{png,jpg,webp,gif} at the sizes below
+ *   grid/     a page of small images for the preview grid and preloader
+ *   scan/     many tiny images for the directory scan
+ *   video.avi a short MPEG-4 clip
+ *   book.pdf  a few pages of vector shapes and text
+ */
+
+typedef struct {
+    const char *name;
+    gint width;
+    gint height;
+} BenchImageSize;
+
+extern const BenchImageSize bench_image_sizes[];
+extern const gsize bench_image_size_count;
+extern const char *const bench_image_formats[];
+extern const gsize bench_image_format_count;
+
+#define BENCH_GRID_IMAGES 36
+#define BENCH_SCAN_FILES 2000
+#define BENCH_VIDEO_WIDTH 640
+#define BENCH_VIDEO_HEIGHT 360
+#define BENCH_VIDEO_FRAMES 90
+#define BENCH_VIDEO_FPS 30
+#define BENCH_BOOK_PAGES 12
+
+/**
+ * @brief Writes the benchmark media into @p directory, creating it.
+ *
+ * Formats the local gdk-pixbuf cannot write (usually WebP) are left out
+ * and named in @p out_skipped, which the caller frees with g_strfreev.
+ *
+ * @return FALSE with @p error set if a file could not be written.
+ */
+gboolean bench_media_generate(const char *directory, gchar ***out_skipped, GError **error);
+
+/**
+ * @brief Returns the path of an image written by `bench_media_generate`.
+ */
+gchar* bench_media_image_path(const char *directory, const BenchImageSize *size, const char *format);
+
+#endif // BENCH_MEDIA_H
@@ -0,0 +1,611 @@
+/*
+ * Benchmark suite: renders, preloads, lays out grids, scans directories,
+ * plays video and rasterizes book pages from synthetic media, and writes
+ * the timings as JSON (see bench_report.h).
+ *
+ * Usage: pixelterm-bench --generate MEDIA_DIR
+ *        pixelterm-bench [--iterations N] [--filter PREFIX] [--output FILE] MEDIA_DIR
+ */
+
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswscale/swscale.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "app.h"
+#include "app_cli.h"
+#include "app_config_runtime.h"
+#include "bench_media.h"
+#include "bench_report.h"
+#include "book.h"
+#include "browser.h"
+#include "dir_scan.h"
+#include "preloader.h"
+#include "renderer.h"
+#include "sixel_encoder.h"
+#include "video_player_decode_internal.h"
+
+// The terminal the renders are sized for, in cells
+#define BENCH_TERM_COLUMNS 160
+#define BENCH_TERM_ROWS 48
+// Preloads are sized like the preview grid's cells
+#define BENCH_PRELOAD_COLUMNS 24
+#define BENCH_PRELOAD_ROWS 8
+#define BENCH_PRELOAD_TIMEOUT_US (60 * G_USEC_PER_SEC)
+
+typedef struct {
+    const char *name;
+    gboolean force_text;
+    gboolean force_sixel;
+    gboolean force_kitty;
+    gboolean force_iterm2;
+} BenchProtocol;
+
+static const BenchProtocol k_protocols[] = {
+    { "text", TRUE, FALSE, FALSE, FALSE },
+    { "sixel", FALSE, TRUE, FALSE, FALSE },
+    { "kitty", FALSE, FALSE, TRUE, FALSE },
+    { "iterm2", FALSE, FALSE, FALSE, TRUE },
+};
+
+typedef struct {
+    const char *media_dir;
+    const char *filter;
+    gint iterations;
+    BenchReport *report;
+} BenchContext;
+
+static gboolean bench_selected(const BenchContext *bench, const char *name) {
+    return !bench->filter || g_str_has_prefix(name, bench->filter);
+}
+
+static ImageRenderer *bench_new_renderer(const BenchProtocol *protocol, gint columns, gint rows) {
+    RendererConfig config = {
+        .max_width = columns,
+        .max_height = rows,
+        .preserve_aspect_ratio = TRUE,
+        .dither = FALSE,
+        .color_space = CHAFA_COLOR_SPACE_RGB,
+        .work_factor = 9,
+        .force_text = protocol->force_text,
+        .force_sixel = protocol->force_sixel,
+        .force_kitty = protocol->force_kitty,
+        .force_iterm2 = protocol->force_iterm2,
+        .text_symbol_mode = TEXT_SYMBOL_MODE_AUTO,
+        .gamma = 1.0,
+        .color_enhance = COLOR_ENHANCE_OFF,
+        .dither_mode = CHAFA_DITHER_MODE_NONE,
+        .color_extractor = CHAFA_COLOR_EXTRACTOR_AVERAGE,
+        .optimizations = CHAFA_OPTIMIZATION_REUSE_ATTRIBUTES
+    };
+    ImageRenderer *renderer = renderer_create();
+    if (renderer && renderer_initialize(renderer, &config) != ERROR_NONE) {
+        renderer_destroy(renderer);
+        renderer = NULL;
+    }
+    return renderer;
+}
+
+static void bench_decode(BenchContext *bench) {
+    for (gsize s = 0; s < bench_image_size_count; s++) {
+        const BenchImageSize *size = &bench_image_sizes[s];
+        for (gsize f = 0; f < bench_image_format_count; f++) {
+            gchar *name = g_strdup_printf("decode/%s/%s", bench_image_formats[f], size->name);
+            if (!bench_selected(bench, name)) {
+                g_free(name);
+                continue;
+            }
+            gchar *path = bench_media_image_path(bench->media_dir, size, bench_image_formats[f]);
+            if (!g_file_test(path, G_FILE_TEST_EXISTS)) {
+                bench_report_add_skipped(bench->report, name, "format not generated");
+            } else {
+                GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+                for (gint i = 0; i < bench->iterations; i++) {
+                    gint64 start = g_get_monotonic_time();
+                    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file(path, NULL);
+                    bench_samples_add_since(samples, start);
+                    g_clear_object(&pixbuf);
+                }
+                bench_report_add_samples(bench->report, name, samples);
+                g_array_free(samples, TRUE);
+            }
+            g_free(path);
+            g_free(name);
+        }
+    }
+}
+
+static void bench_render(BenchContext *bench) {
+    for (gsize s = 0; s < bench_image_size_count; s++) {
+        const BenchImageSize *size = &bench_image_sizes[s];
+        gchar *path = bench_media_image_path(bench->media_dir, size, "png");
+        GdkPixbuf *loaded = gdk_pixbuf_new_from_file(path, NULL);
+        g_free(path);
+        // Frames reach the renderer as RGBA
+        GdkPixbuf *pixbuf = loaded ? gdk_pixbuf_add_alpha(loaded, FALSE, 0, 0, 0) : NULL;
+        g_clear_object(&loaded);
+
+        for (gsize p = 0; p < G_N_ELEMENTS(k_protocols); p++) {
+            gchar *name = g_strdup_printf("render/%s/%s", k_protocols[p].name, size->name);
+            ImageRenderer *renderer = NULL;
+            if (!bench_selected(bench, name)) {
+                g_free(name);
+                continue;
+            }
+            if (!pixbuf) {
+                bench_report_add_skipped(bench->report, name, "cannot load image");
+            } else if (!(renderer = bench_new_renderer(&k_protocols[p], BENCH_TERM_COLUMNS, BENCH_TERM_ROWS))) {
+                bench_report_add_skipped(bench->report, name, "renderer setup failed");
+            } else {
+                GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+                for (gint i = 0; i < bench->iterations; i++) {
+                    gint64 start = g_get_monotonic_time();
+                    GString *rendered = renderer_render_image_data(renderer, gdk_pixbuf_read_pixels(pixbuf),
+                                                                   gdk_pixbuf_get_width(pixbuf),
+                                                                   gdk_pixbuf_get_height(pixbuf),
+                                                                   gdk_pixbuf_get_rowstride(pixbuf), 4);
+                    bench_samples_add_since(samples, start);
+                    if (rendered) {
+                        g_string_free(rendered, TRUE);
+                    }
+                }
+                bench_report_add_samples(bench->report, name, samples);
+                g_array_free(samples, TRUE);
+                renderer_destroy(renderer);
+            }
+            g_free(name);
+        }
+        g_clear_object(&pixbuf);
+    }
+}
+
+static GPtrArray *bench_list_grid(const BenchContext *bench) {
+    GPtrArray *paths = g_ptr_array_new_with_free_func(g_free);
+    for (gint i = 0; i < BENCH_GRID_IMAGES; i++) {
+        gchar *name = g_strdup_printf("grid-%02d.%s", i, (i % 2) ? "jpg" : "png");
+        g_ptr_array_add(paths, g_build_filename(bench->media_dir, "grid", name, NULL));
+        g_free(name);
+    }
+    return paths;
+}
+
+// Returns how long the preloader took to render every grid image, or a
+// negative value if it did not finish.
+static gdouble bench_preload_once(const BenchProtocol *protocol, const GPtrArray *paths) {
+    ImagePreloader *preloader = preloader_create();
+    if (!preloader) {
+        return -1.0;
+    }
+    preloader_initialize(preloader, FALSE, 9, protocol->force_text, protocol->force_sixel, protocol->force_kitty,
+                         protocol->force_iterm2, TEXT_SYMBOL_MODE_AUTO, 1.0, COLOR_ENHANCE_OFF);
+    preloader_update_terminal_size(preloader, BENCH_TERM_COLUMNS, BENCH_TERM_ROWS);
+
+    gint64 start = g_get_monotonic_time();
+    gint64 deadline = start + BENCH_PRELOAD_TIMEOUT_US;
+    preloader_start(preloader);
+    guint queued = 0;
+    guint done = 0;
+    while (done < paths->len && g_get_monotonic_time() < deadline) {
+        // The queue is short; keep it topped up as the worker drains it
+        while (queued < paths->len &&
+               preloader_add_task(preloader, g_ptr_array_index(paths, queued), 0,
+                                  BENCH_PRELOAD_COLUMNS, BENCH_PRELOAD_ROWS) == ERROR_NONE) {
+            queued++;
+        }
+        while (done < paths->len) {
+            GString *cached = preloader_get_cached_image(preloader, g_ptr_array_index(paths, done),
+                                                         BENCH_PRELOAD_COLUMNS, BENCH_PRELOAD_ROWS);
+            if (!cached) {
+                break;
+            }
+            g_string_free(cached, TRUE);
+            done++;
+        }
+        if (done < paths->len) {
+            g_usleep(500);
+        }
+    }
+    gdouble elapsed_ms = (gdouble)(g_get_monotonic_time() - start) / 1000.0;
+    preloader_stop(preloader);
+    preloader_destroy(preloader);
+    return done == paths->len ? elapsed_ms : -1.0;
+}
+
+static void bench_preload(BenchContext *bench) {
+    GPtrArray *paths = bench_list_grid(bench);
+    for (gsize p = 0; p < G_N_ELEMENTS(k_protocols); p++) {
+        gchar *name = g_strdup_printf("preload/%s/batch", k_protocols[p].name);
+        if (bench_selected(bench, name)) {
+            GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+            gdouble total_ms = 0.0;
+            for (gint i = 0; i < bench->iterations; i++) {
+                gdouble elapsed_ms = bench_preload_once(&k_protocols[p], paths);
+                if (elapsed_ms < 0.0) {
+                    break;
+                }
+                g_array_append_val(samples, elapsed_ms);
+                total_ms += elapsed_ms;
+            }
+            if (samples->len == (guint)bench->iterations && total_ms > 0.0) {
+                gchar *rate = g_strdup_printf("preload/%s/throughput", k_protocols[p].name);
+                bench_report_add_samples(bench->report, name, samples);
+                bench_report_add_value(bench->report, rate, "images/s",
+                                       (gdouble)paths->len * samples->len * 1000.0 / total_ms);
+                g_free(rate);
+            } else {
+                bench_report_add_skipped(bench->report, name, "preloader did not finish");
+            }
+            g_array_free(samples, TRUE);
+        }
+        g_free(name);
+    }
+    g_ptr_array_free(paths, TRUE);
+}
+
+typedef ErrorCode (*BenchAppFn)(PixelTermApp *app);
+
+// Runs @p fn with stdout on /dev/null, so drawing costs no terminal time.
+static ErrorCode bench_run_quietly(BenchAppFn fn, PixelTermApp *app) {
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (saved < 0 || null_fd < 0) {
+        if (saved >= 0) {
+            close(saved);
+        }
+        if (null_fd >= 0) {
+            close(null_fd);
+        }
+        return ERROR_FILE_NOT_FOUND;
+    }
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+    ErrorCode error = fn(app);
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return error;
+}
+
+static void bench_grid(BenchContext *bench) {
+    gchar *grid = g_build_filename(bench->media_dir, "grid", NULL);
+    for (gsize p = 0; p < G_N_ELEMENTS(k_protocols); p++) {
+        gchar *name = g_strdup_printf("grid/%s/page", k_protocols[p].name);
+        if (!bench_selected(bench, name)) {
+            g_free(name);
+            continue;
+        }
+        AppConfig config;
+        app_config_init(&config);
+        // Every page is drawn from the files, not from earlier renders
+        config.preload_enabled = FALSE;
+        config.force_text = k_protocols[p].force_text;
+        config.force_sixel = k_protocols[p].force_sixel;
+        config.force_kitty = k_protocols[p].force_kitty;
+        config.force_iterm2 = k_protocols[p].force_iterm2;
+
+        PixelTermApp *app = app_create();
+        ErrorCode error = app ? ERROR_NONE : ERROR_MEMORY_ALLOC;
+        if (error == ERROR_NONE) {
+            app_config_apply_runtime(app, &config);
+            error = app_initialize(app, app->dither_enabled);
+        }
+        if (error == ERROR_NONE) {
+            error = app_load_directory(app, grid);
+        }
+        if (error == ERROR_NONE) {
+            app->ui_text_hidden = TRUE;
+            error = bench_run_quietly(app_enter_preview, app);
+        }
+
+        GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+        for (gint i = 0; error == ERROR_NONE && i < bench->iterations; i++) {
+            gint64 start = g_get_monotonic_time();
+            error = bench_run_quietly(app_render_preview_grid, app);
+            bench_samples_add_since(samples, start);
+        }
+        if (error == ERROR_NONE) {
+            bench_report_add_samples(bench->report, name, samples);
+        } else {
+            bench_report_add_skipped(bench->report, name, "grid setup failed");
+        }
+        g_array_free(samples, TRUE);
+        if (app) {
+            app_destroy(app);
+        }
+        g_free(name);
+    }
+    g_free(grid);
+}
+
+static void bench_scan(BenchContext *bench) {
+    gchar *scan = g_build_filename(bench->media_dir, "scan", NULL);
+    gchar *read_name = g_strdup_printf("scan/read/%d", BENCH_SCAN_FILES);
+    gchar *browse_name = g_strdup_printf("scan/browser/%d", BENCH_SCAN_FILES);
+
+    if (bench_selected(bench, read_name)) {
+        GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+        for (gint i = 0; i < bench->iterations; i++) {
+            GArray *entries = NULL;
+            gint64 start = g_get_monotonic_time();
+            ErrorCode error = dir_scan_read(scan, &entries);
+            bench_samples_add_since(samples, start);
+            if (error == ERROR_NONE) {
+                dir_scan_entries_free(entries);
+            }
+        }
+        bench_report_add_samples(bench->report, read_name, samples);
+        g_array_free(samples, TRUE);
+    }
+
+    // What opening the directory costs: listing, filtering and sorting
+    if (bench_selected(bench, browse_name)) {
+        GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+        for (gint i = 0; i < bench->iterations; i++) {
+            FileBrowser *browser = browser_create();
+            if (!browser) {
+                break;
+            }
+            browser->defer_validation = TRUE;
+            gint64 start = g_get_monotonic_time();
+            (void)browser_scan_directory(browser, scan);
+            bench_samples_add_since(samples, start);
+            browser_destroy(browser);
+        }
+        bench_report_add_samples(bench->report, browse_name, samples);
+        g_array_free(samples, TRUE);
+    }
+
+    g_free(browse_name);
+    g_free(read_name);
+    g_free(scan);
+}
+
+// Decodes the whole clip and renders every frame the way the player's
+// render workers do, appending per-frame milliseconds to @p samples.
+static gboolean bench_video_once(const char *path, const BenchProtocol *protocol, GArray *samples) {
+    AVFormatContext *format = NULL;
+    AVCodecContext *codec = NULL;
+    AVFrame *decoded = NULL;
+    AVFrame *rgba = NULL;
+    AVPacket *packet = NULL;
+    struct SwsContext *sws = NULL;
+    guint8 *rgba_buffer = NULL;
+    ImageRenderer *renderer = NULL;
+    SixelPaletteCache *palettes = NULL;
+    gboolean ok = FALSE;
+    int stream_index = -1;
+
+    if (avformat_open_input(&format, path, NULL, NULL) != 0) {
+        return FALSE;
+    }
+    if (avformat_find_stream_info(format, NULL) < 0) {
+        goto out;
+    }
+    const AVCodec *decoder = NULL;
+    stream_index = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, &decoder, 0);
+    if (stream_index < 0 || !decoder) {
+        goto out;
+    }
+    codec = avcodec_alloc_context3(decoder);
+    if (!codec || avcodec_parameters_to_context(codec, format->streams[stream_index]->codecpar) < 0 ||
+        avcodec_open2(codec, decoder, NULL) < 0) {
+        goto out;
+    }
+    decoded = av_frame_alloc();
+    rgba = av_frame_alloc();
+    packet = av_packet_alloc();
+    renderer = bench_new_renderer(protocol, BENCH_TERM_COLUMNS, BENCH_TERM_ROWS);
+    palettes = sixel_palette_cache_new();
+    if (!decoded || !rgba || !packet || !renderer ||
+        video_player_alloc_rgba_buffer(rgba, codec->width, codec->height, &rgba_buffer) <= 0 ||
+        !(sws = video_player_create_sws_context(codec, codec->width, codec->height))) {
+        goto out;
+    }
+
+    gboolean eof = FALSE;
+    gint64 start = g_get_monotonic_time();
+    while (!eof) {
+        if (av_read_frame(format, packet) < 0) {
+            avcodec_send_packet(codec, NULL);
+            eof = TRUE;
+        } else {
+            if (packet->stream_index == stream_index) {
+                avcodec_send_packet(codec, packet);
+            }
+            av_packet_unref(packet);
+        }
+        while (avcodec_receive_frame(codec, decoded) == 0) {
+            sws_scale(sws, (const uint8_t * const *)decoded->data, decoded->linesize, 0, codec->height,
+                      rgba->data, rgba->linesize);
+            GString *rendered = renderer_render_sixel_data(renderer, palettes, rgba->data[0], codec->width,
+                                                           codec->height, rgba->linesize[0]);
+            if (!rendered) {
+                rendered = renderer_render_image_data(renderer, rgba->data[0], codec->width, codec->height,
+                                                      rgba->linesize[0], 4);
+            }
+            if (rendered) {
+                g_string_free(rendered, TRUE);
+            }
+            bench_samples_add_since(samples, start);
+            start = g_get_monotonic_time();
+        }
+    }
+    ok = TRUE;
+
+out:
+    sixel_palette_cache_free(palettes);
+    if (renderer) {
+        renderer_destroy(renderer);
+    }
+    if (sws) {
+        sws_freeContext(sws);
+    }
+    av_freep(&rgba_buffer);
+    av_packet_free(&packet);
+    av_frame_free(&rgba);
+    av_frame_free(&decoded);
+    avcodec_free_context(&codec);
+    avformat_close_input(&format);
+    return ok;
+}
+
+static void bench_video(BenchContext *bench) {
+    gchar *path = g_build_filename(bench->media_dir, "video.avi", NULL);
+    video_player_ffmpeg_init_once();
+    for (gsize p = 0; p < G_N_ELEMENTS(k_protocols); p++) {
+        gchar *name = g_strdup_printf("video/%s/frame", k_protocols[p].name);
+        if (bench_selected(bench, name)) {
+            GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+            gboolean ok = TRUE;
+            for (gint i = 0; ok && i < bench->iterations; i++) {
+                ok = bench_video_once(path, &k_protocols[p], samples);
+            }
+            gdouble total_ms = 0.0;
+            for (guint i = 0; i < samples->len; i++) {
+                total_ms += g_array_index(samples, gdouble, i);
+            }
+            if (ok && samples->len > 0 && total_ms > 0.0) {
+                gchar *rate = g_strdup_printf("video/%s/fps", k_protocols[p].name);
+                bench_report_add_samples(bench->report, name, samples);
+                bench_report_add_value(bench->report, rate, "fps", (gdouble)samples->len * 1000.0 / total_ms);
+                g_free(rate);
+            } else {
+                bench_report_add_skipped(bench->report, name, "cannot decode video");
+            }
+            g_array_free(samples, TRUE);
+        }
+        g_free(name);
+    }
+    g_free(path);
+}
+
+static void bench_book(BenchContext *bench) {
+    const char *name = "book/page";
+    if (!bench_selected(bench, name)) {
+        return;
+    }
+    gchar *path = g_build_filename(bench->media_dir, "book.pdf", NULL);
+    GArray *samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    gboolean ok = TRUE;
+    for (gint i = 0; ok && i < bench->iterations; i++) {
+        // A fresh document each time, so no page comes from the display list cache
+        ErrorCode error = ERROR_NONE;
+        BookDocument *doc = book_open(path, &error);
+        ok = doc != NULL;
+        for (gint page = 0; ok && page < book_get_page_count(doc); page++) {
+            BookPageImage image = {0};
+            gint64 start = g_get_monotonic_time();
+            ok = book_render_page(doc, page, BENCH_TERM_COLUMNS, BENCH_TERM_ROWS, &image) == ERROR_NONE;
+            bench_samples_add_since(samples, start);
+            book_page_image_free(&image);
+        }
+        if (doc) {
+            book_close(doc);
+        }
+    }
+    if (ok && samples->len > 0) {
+        bench_report_add_samples(bench->report, name, samples);
+    } else {
+        bench_report_add_skipped(bench->report, name, "cannot render book pages (built without MuPDF?)");
+    }
+    g_array_free(samples, TRUE);
+    g_free(path);
+}
+
+static void bench_print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s --generate MEDIA_DIR\n"
+            "       %s [--iterations N] [--filter PREFIX] [--output FILE] MEDIA_DIR\n",
+            program, program);
+}
+
+int main(int argc, char **argv) {
+    static struct option long_options[] = {
+        {"generate",   no_argument,       0, 'g'},
+        {"iterations", required_argument, 0, 'n'},
+        {"filter",     required_argument, 0, 'f'},
+        {"output",     required_argument, 0, 'o'},
+        {"help",       no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+    gboolean generate = FALSE;
+    gint iterations = 10;
+    const char *filter = NULL;
+    const char *output = NULL;
+    int c;
+    while ((c = getopt_long(argc, argv, "gn:f:o:h", long_options, NULL)) != -1) {
+        switch (c) {
+            case 'g':
+                generate = TRUE;
+                break;
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+            case 'f':
+                filter = optarg;
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                bench_print_usage(argv[0]);
+                return c == 'h' ? 0 : 1;
+        }
+    }
+    if (optind != argc - 1 || iterations <= 0) {
+        bench_print_usage(argv[0]);
+        return 1;
+    }
+    const char *media_dir = argv[optind];
+
+    if (generate) {
+        GError *error = NULL;
+        gchar **skipped = NULL;
+        gboolean ok = bench_media_generate(media_dir, &skipped, &error);
+        if (!ok) {
+            fprintf(stderr, "Cannot generate benchmark media: %s\n", error ? error->message : "unknown error");
+            g_clear_error(&error);
+        } else if (skipped && skipped[0]) {
+            gchar *list = g_strjoinv(", ", skipped);
+            fprintf(stderr, "Not generated (no encoder): %s\n", list);
+            g_free(list);
+        }
+        g_strfreev(skipped);
+        return ok ? 0 : 1;
+    }
+
+    FILE *out = stdout;
+    if (output && !(out = fopen(output, "w"))) {
+        fprintf(stderr, "Cannot write %s\n", output);
+        return 1;
+    }
+    BenchContext bench = {
+        .media_dir = media_dir,
+        .filter = filter,
+        .iterations = iterations,
+        .report = bench_report_new()
+    };
+    bench_decode(&bench);
+    bench_render(&bench);
+    bench_preload(&bench);
+    bench_grid(&bench);
+    bench_scan(&bench);
+    bench_video(&bench);
+    bench_book(&bench);
+    bench_report_write(bench.report, out, iterations);
+
+    bench_report_free(bench.report);
+    if (out != stdout) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "bench_report.h"
+
+#include <stdlib.h>
+
+#include "common.h"
+
+struct BenchReport {
+    GString *results;
+    guint count;
+};
+
+BenchReport* bench_report_new(void) {
+    BenchReport *report = g_new0(BenchReport, 1);
+    report->results = g_string_new(NULL);
+    return report;
+}
+
+void bench_report_free(BenchReport *report) {
+    if (!report) {
+        return;
+    }
+    g_string_free(report->results, TRUE);
+    g_free(report);
+}
+
+static void bench_report_append_string(GString *out, const char *value) {
+    g_string_append_c(out, '"');
+    for (const char *p = value; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            g_string_append_c(out, '\\');
+            g_string_append_c(out, *p);
+        } else if ((guchar)*p < 0x20) {
+            g_string_append_printf(out, "\\u%04x", (guint)(guchar)*p);
+        } else {
+            g_string_append_c(out, *p);
+        }
+    }
+    g_string_append_c(out, '"');
+}
+
+// Numbers are written with a C-locale decimal point whatever LC_NUMERIC says
+static void bench_report_append_number(GString *out, const char *key, gdouble value) {
+    gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+    g_string_append_printf(out, ", \"%s\": %s", key, g_ascii_formatd(buffer, sizeof(buffer), "%.4f", value));
+}
+
+static void bench_report_begin(BenchReport *report, const char *name) {
+    g_string_append(report->results, report->count ? ",\n    {\"name\": " : "\n    {\"name\": ");
+    bench_report_append_string(report->results, name);
+    report->count++;
+}
+
+static gint bench_compare_doubles(gconstpointer a, gconstpointer b) {
+    gdouble x = *(const gdouble *)a;
+    gdouble y = *(const gdouble *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_report_add_samples(BenchReport *report, const char *name, const GArray *samples) {
+    if (!report || !name || !samples || samples->len == 0) {
+        return;
+    }
+    gdouble *sorted = g_memdup2(samples->data, sizeof(gdouble) * samples->len);
+    qsort(sorted, samples->len, sizeof(gdouble), bench_compare_doubles);
+    gdouble sum = 0.0;
+    for (guint i = 0; i < samples->len; i++) {
+        sum += sorted[i];
+    }
+    guint n = samples->len;
+    gdouble median = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+    guint p95 = MIN(n - 1, (guint)((gdouble)n * 0.95));
+
+    bench_report_begin(report, name);
+    g_string_append(report->results, ", \"unit\": \"ms\"");
+    bench_report_append_number(report->results, "value", median);
+    g_string_append_printf(report->results, ", \"samples\": %u", n);
+    bench_report_append_number(report->results, "min", sorted[0]);
+    bench_report_append_number(report->results, "mean", sum / (gdouble)n);
+    bench_report_append_number(report->results, "p95", sorted[p95]);
+    bench_report_append_number(report->results, "max", sorted[n - 1]);
+    g_string_append_c(report->results, '}');
+    g_free(sorted);
+}
+
+void bench_report_add_value(BenchReport *report, const char *name, const char *unit, gdouble value) {
+    if (!report || !name || !unit) {
+        return;
+    }
+    bench_report_begin(report, name);
+    g_string_append(report->results, ", \"unit\": ");
+    bench_report_append_string(report->results, unit);
+    bench_report_append_number(report->results, "value", value);
+    g_string_append_c(report->results, '}');
+}
+
+void bench_report_add_skipped(BenchReport *report, const char *name, const char *reason) {
+    if (!report || !name) {
+        return;
+    }
+    bench_report_begin(report, name);
+    g_string_append(report->results, ", \"skipped\": ");
+    bench_report_append_string(report->results, reason ? reason : "");
+    g_string_append_c(report->results, '}');
+}
+
+void bench_report_write(const BenchReport *report, FILE *out, gint iterations) {
+    if (!report || !out) {
+        return;
+    }
+    GString *json = g_string_new("{\n  \"schema\": 1,\n  \"version\": ");
+    bench_report_append_string(json, APP_VERSION);
+    g_string_append_printf(json, ",\n  \"cpus\": %u,\n  \"iterations\": %d,\n  \"results\": [",
+                           g_get_num_processors(), iterations);
+    g_string_append_len(json, report->results->str, (gssize)report->results->len);
+    g_string_append(json, report->count ? "\n  ]\n}\n" : "]\n}\n");
+    fwrite(json->str, 1, json->len, out);
+    fflush(out);
+    g_string_free(json, TRUE);
+}
+
+void bench_samples_add_since(GArray *samples, gint64 start_us) {
+    gdouble elapsed_ms = (gdouble)(g_get_monotonic_time() - start_us) / 1000.0;
+    g_array_append_val(samples, elapsed_ms);
+}
@@ -0,0 +1,47 @@
+#ifndef BENCH_REPORT_H
+#define BENCH_REPORT_H
+
+#include <glib.h>
+#include <stdio.h>
+
+/*
+ * Benchmark results as JSON, one object per measurement:
+ *
+ *   {"name": "render/kitty/hd-png", "unit": "ms", "value": 12.5,
+ *    "samples": 20, "min": 11.9, "mean": 12.7, "p95": 14.1, "max": 15.0}
+ *
+ * Timed measurements report their median as "value"; rates such as frames
+ * per second carry only "value". Names are stable across releases so the
+ * files can be compared directly.
+ */
+
+typedef struct BenchReport BenchReport;
+
+BenchReport* bench_report_new(void);
+void bench_report_free(BenchReport *report);
+
+/**
+ * @brief Records a timed measurement from per-iteration @p samples in
+ *        milliseconds.
+ */
+void bench_report_add_samples(BenchReport *report, const char *name, const GArray *samples);
+/**
+ * @brief Records a single derived value, such as a rate.
+ */
+void bench_report_add_value(BenchReport *report, const char *name, const char *unit, gdouble value);
+/**
+ * @brief Records a measurement that could not run here and why.
+ */
+void bench_report_add_skipped(BenchReport *report, const char *name, const char *reason);
+
+/**
+ * @brief Writes the report with a header naming the version and host.
+ */
+void bench_report_write(const BenchReport *report, FILE *out, gint iterations);
+
+/**
+ * @brief Appends the milliseconds since @p start_us to @p samples.
+ */
+void bench_samples_add_since(GArray *samples, gint64 start_us);
+
+#endif // BENCH_REPORT_H
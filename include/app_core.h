@@ -8,6 +8,9 @@ void app_destroy(PixelTermApp *app);
 ErrorCode app_initialize(PixelTermApp *app, gboolean dither_enabled);
 ErrorCode app_load_directory(PixelTermApp *app, const char *directory);
 ErrorCode app_load_single_file(PixelTermApp *app, const char *filepath);
+ErrorCode app_load_directory_async(PixelTermApp *app, const char *directory, const char *focus_path);
+void app_process_directory_loader(PixelTermApp *app);
+void app_process_directory_changes(PixelTermApp *app);
 
 ErrorCode app_next_image(PixelTermApp *app);
 ErrorCode app_previous_image(PixelTermApp *app);
@@ -21,5 +24,12 @@ gint app_get_current_index(const PixelTermApp *app);
 gint app_get_total_images(const PixelTermApp *app);
 const gchar* app_get_current_filepath(const PixelTermApp *app);
 gboolean app_has_images(const PixelTermApp *app);
+/**
+ * @brief Returns kind, size, animation and duration for @p filepath from
+ *        the directory's metadata cache, probing and recording it on a miss.
+ *
+ * @return FALSE if the file is not supported media.
+ */
+gboolean app_get_media_meta(const PixelTermApp *app, const gchar *filepath, MediaMeta *out);
 
 #endif // APP_CORE_H
@@ -14,6 +14,7 @@ ErrorCode app_file_manager_jump_to_letter(PixelTermApp *app, char letter);
 ErrorCode app_file_manager_refresh(PixelTermApp *app);
 ErrorCode app_file_manager_select_path(PixelTermApp *app, const char *path);
 ErrorCode app_file_manager_toggle_hidden(PixelTermApp *app);
+gboolean app_file_manager_apply_change(PixelTermApp *app, const DirWatchEvent *event);
 gboolean app_file_manager_selection_is_image(PixelTermApp *app);
 gint app_file_manager_get_selected_image_index(PixelTermApp *app);
 gboolean app_file_manager_has_images(PixelTermApp *app);
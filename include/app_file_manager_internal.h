@@ -5,12 +5,7 @@
 #include <glib.h>
 
 gint app_file_manager_compare_names(gconstpointer a, gconstpointer b);
-void app_file_manager_invalidate_selection_cache(PixelTermApp *app);
-GList* app_file_manager_find_link_with_hint(const PixelTermApp *app,
-                                            gint target_index,
-                                            GList *hint_link,
-                                            gint hint_index);
-GList* app_file_manager_get_selected_node(PixelTermApp *app);
+const gchar* app_file_manager_get_selected_path(const PixelTermApp *app);
 gchar* app_file_manager_display_name(const PixelTermApp *app, const gchar *entry, gboolean *is_directory);
 void app_file_manager_layout(const PixelTermApp *app,
                              gint total_entries,
@@ -9,8 +9,7 @@ const gchar *app_preview_get_selected_filepath(PixelTermApp *app);
 
 void app_preview_render_cells(const GridRenderContext *context,
                               PixelTermApp *app,
-                              ImageRenderer *renderer,
-                              GList *cursor);
+                              ImageRenderer *renderer);
 void app_preview_render_selected_filename(PixelTermApp *app);
 void app_preview_draw_cell_border(const PixelTermApp *app,
                                   const PreviewLayout *layout,
@@ -9,6 +9,14 @@ ErrorCode app_display_help(PixelTermApp *app);
 ErrorCode app_refresh_display(PixelTermApp *app);
 ErrorCode app_render_by_mode(PixelTermApp *app);
 void app_process_async_render(PixelTermApp *app);
+// Redraws just the "index/total" row of the single view, e.g. while a scan grows the list
+void app_render_single_index_line(PixelTermApp *app);
 void app_get_image_target_dimensions(const PixelTermApp *app, gint *max_width, gint *max_height);
+// Draws the performance HUD when shown and due: after a repaint, or when its
+// values changed and PERF_HUD_REFRESH_US has passed. @p force draws it now.
+void app_render_perf_hud(PixelTermApp *app, gboolean force);
+void app_clear_perf_hud(PixelTermApp *app);
+// Milliseconds until the HUD is due for a refresh; -1 while it is hidden
+gint app_perf_hud_timeout_ms(const PixelTermApp *app);
 
 #endif // APP_RENDER_H
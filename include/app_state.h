@@ -2,11 +2,19 @@
 #define APP_STATE_H
 
 #include "common.h"
+#include "dir_loader.h"
+#include "dir_watch.h"
+#include "media_index.h"
+#include "media_meta.h"
 #include "kitty_transfer.h"
+#include "kitty_registry.h"
 #include "preloader.h"
 #include "gif_player.h"
 #include "video_player.h"
 #include "book.h"
+#include "book_page_cache.h"
+#include "image_zoom.h"
+#include "perf_hud.h"
 
 typedef enum {
     RETURN_MODE_NONE = -1,
@@ -47,32 +55,36 @@ typedef struct {
     TextSymbolMode text_symbol_mode;
     ColorEnhanceMode color_enhance;
     KittyTransferMode kitty_transfer;
+    KittyCompressionMode kitty_compression;
+    gint video_dirty_threshold;
+    gboolean natural_sort;
+    gint recursive_depth;
+    gchar *trace_path;      // Owned; NULL unless --trace was given
 } AppConfig;
 
 typedef struct {
     gint selected;
     gint scroll;
     gint zoom;
-    GList *selected_link;
-    gint selected_link_index;
 } PreviewState;
 
 typedef struct {
     gchar *directory;
-    GList *entries;
+    GPtrArray *entries;     // Owned paths: "..", directories, then files
     gint entries_count;
+    gint directory_count;   // Leading entries that are directories, ".." included
     gint selected_entry;
-    GList *selected_link;
-    gint selected_link_index;
     gint scroll_offset;
     gint previous_selected_entry;
 } FileManagerState;
 
 typedef struct {
     BookDocument *doc;
+    BookPageCache *page_cache;
     gchar *path;
     gint page;
     gint page_count;
+    gint prefetch_page;  // Page the last prefetch was anchored at; gives reading direction
     gint preview_selected;
     gint preview_scroll;
     gint preview_zoom;
@@ -117,13 +129,18 @@ typedef struct {
     ChafaTermInfo *term_info;
 
     // File management
-    GList *image_files;
+    MediaIndex *image_files;
     gchar *current_directory;
     gint current_index;
     gint total_images;
+    DirLoader *dir_loader;  // Background scan still adding to image_files
+    DirWatch *dir_watch;    // Change notifications for the directory on screen
+    GArray *dir_watch_pending; // Events held back until dir_loader is done
+    MediaMetaStore *media_meta; // Cached kind/size/duration for current_directory
 
     // Preloading
     ImagePreloader *preloader;
+    KittyRegistry *kitty_images; // Images resident in a kitty terminal; NULL otherwise
 
     // Animation support
     GifPlayer *gif_player;
@@ -134,7 +151,8 @@ typedef struct {
     gboolean info_visible;  // Track if info is currently displayed
     gboolean help_visible;  // Track if help overlay is currently displayed
     gboolean ui_text_hidden; // Hide all UI text overlays (single/preview)
-    gboolean show_fps; // Toggle FPS overlay in video view
+    gboolean show_fps; // Performance HUD (F); video also shows protocol and FPS
+    PerfHud perf_hud;  // What the HUD last sampled and drew
     gdouble video_scale; // Scale factor for video render size
     gboolean video_was_playing_before_resize;
     gboolean clear_workaround_enabled; // Enable double-clear workaround on full refresh
@@ -149,9 +167,13 @@ typedef struct {
     TextSymbolMode text_symbol_mode;
     ColorEnhanceMode color_enhance;
     KittyTransferMode kitty_transfer;
+    KittyCompressionMode kitty_compression;
+    gint video_dirty_threshold;     // Changed percent above which video frames are sent whole
     gboolean needs_redraw;
     AppMode mode;  // Current UI mode (single/preview/file manager/book)
     gboolean show_hidden_files;  // Toggle visibility of dotfiles in file manager
+    gboolean natural_sort;       // Order digit runs in names by numeric value
+    gint recursive_depth;        // Subdirectory levels collected into the image list, 0 for none
     ReturnMode return_to_mode;   // Return mode after file manager
     gboolean suppress_full_clear; // Skip full clear on next single-image refresh
     gboolean delete_pending;     // Awaiting delete confirmation
@@ -166,6 +188,7 @@ typedef struct {
     gint image_view_height;      // Single image render height in cells
     gint image_viewport_px_w;    // Single image viewport width in pixels
     gint image_viewport_px_h;    // Single image viewport height in pixels
+    ImageZoomSource *zoom_source; // Decoded current image for zoom/pan
 
     // Terminal info
     gint term_width;
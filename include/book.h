@@ -30,6 +30,18 @@ void book_close(BookDocument *doc);
 
 const char* book_get_path(const BookDocument *doc);
 gint book_get_page_count(const BookDocument *doc);
+/**
+ * @brief Keeps at least @p count interpreted pages cached.
+ *
+ * Callers pass the number of pages on screen, so all of them can be drawn
+ * again at a new size without parsing the document. The cache is still
+ * bounded in bytes.
+ */
+void book_set_visible_pages(BookDocument *doc, gint count);
+/**
+ * @brief Number of times a page has been loaded and interpreted, not counting cache hits.
+ */
+guint book_page_loads_for_test(BookDocument *doc);
 
 ErrorCode book_render_page(BookDocument *doc,
                            gint page_index,
@@ -38,6 +50,53 @@ ErrorCode book_render_page(BookDocument *doc,
                            BookPageImage *out_image);
 void book_page_image_free(BookPageImage *image);
 
+// Thumbnails are packed RGB, no alpha.
+#define BOOK_THUMBNAIL_CHANNELS 3
+
+/**
+ * @brief Pixel box a thumbnail occupies for a cell area of the current terminal.
+ */
+void book_get_thumbnail_size(gint target_cols, gint target_rows, gint *out_width, gint *out_height);
+/**
+ * @brief Rasterizes a page thumbnail straight into a caller-provided RGB buffer.
+ *
+ * The page is fitted inside @p max_width x @p max_height pixels with reduced
+ * anti-aliasing and written from the top-left of @p pixels, which must hold
+ * @p max_height rows of @p stride bytes. Results are cached process-wide by
+ * document path, file mtime, page and box size.
+ *
+ * @param out_width Receives the thumbnail width in pixels.
+ * @param out_height Receives the thumbnail height in pixels.
+ * @return `ERROR_NONE` on success.
+ */
+ErrorCode book_render_thumbnail(BookDocument *doc,
+                                gint page_index,
+                                gint max_width,
+                                gint max_height,
+                                guint8 *pixels,
+                                gint stride,
+                                gint *out_width,
+                                gint *out_height);
+/**
+ * @brief Parallel `book_render_thumbnail` over several pages.
+ *
+ * Slot `i` is written at `pixels + i * stride * max_height`.
+ */
+ErrorCode book_render_thumbnails(BookDocument *doc,
+                                 const gint *page_indices,
+                                 gint count,
+                                 gint max_width,
+                                 gint max_height,
+                                 guint8 *pixels,
+                                 gint stride,
+                                 gint *out_widths,
+                                 gint *out_heights,
+                                 ErrorCode *out_errors);
+/**
+ * @brief Frees every cached thumbnail.
+ */
+void book_thumbnail_cache_clear(void);
+
 BookToc* book_load_toc(BookDocument *doc);
 void book_toc_free(BookToc *toc);
 
@@ -0,0 +1,109 @@
+#ifndef BOOK_PAGE_CACHE_H
+#define BOOK_PAGE_CACHE_H
+
+#include "common.h"
+#include "book.h"
+#include "renderer.h"
+
+/*
+ * Bounded LRU of rasterized book pages and their terminal renders, keyed by
+ * page index and target cell size. A worker thread prefetches neighbouring
+ * pages so page turns can be served without touching MuPDF.
+ */
+#define BOOK_PAGE_CACHE_MAX_ENTRIES 12
+#define BOOK_PAGE_CACHE_MAX_BYTES ((gsize)192 * 1024 * 1024)
+
+typedef struct BookPageCache BookPageCache;
+
+/**
+ * @brief Creates a page cache for an open book and starts its prefetch worker.
+ *
+ * The cache borrows @p doc; it must be destroyed before the document is closed.
+ *
+ * @param doc The open book document.
+ * @return A new cache, or NULL if @p doc is NULL or the worker cannot start.
+ */
+BookPageCache* book_page_cache_create(BookDocument *doc);
+/**
+ * @brief Stops the prefetch worker and frees every cached page.
+ *
+ * @param cache The cache to destroy. NULL is ignored.
+ */
+void book_page_cache_destroy(BookPageCache *cache);
+
+/**
+ * @brief Returns a rasterized page, serving it from the cache when possible.
+ *
+ * Behaves like `book_render_page`. On a miss the page is rasterized and kept
+ * for later calls. If the prefetch worker is rasterizing the same page, the
+ * call waits for that result instead of rendering it twice.
+ *
+ * @param cache The page cache.
+ * @param page_index Zero-based page index.
+ * @param target_cols Target width in terminal cells.
+ * @param target_rows Target height in terminal cells.
+ * @param out_image Receives a caller-owned copy; free with `book_page_image_free`.
+ * @return `ERROR_NONE` on success, or the `book_render_page` error.
+ */
+ErrorCode book_page_cache_render_page(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      BookPageImage *out_image);
+/**
+ * @brief Looks up a terminal render of a page made with a matching renderer config.
+ *
+ * @param cache The page cache.
+ * @param page_index Zero-based page index.
+ * @param target_cols Target width in terminal cells.
+ * @param target_rows Target height in terminal cells.
+ * @param config Renderer configuration the render must have been made with.
+ * @param out_width Receives the rendered width in cells. May be NULL.
+ * @param out_height Receives the rendered height in cells. May be NULL.
+ * @param out_graphics_mode Receives whether the render uses a graphics protocol. May be NULL.
+ * @return A caller-owned copy of the render on hit, or NULL on miss.
+ */
+GString* book_page_cache_get_rendered(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      const RendererConfig *config,
+                                      gint *out_width,
+                                      gint *out_height,
+                                      gboolean *out_graphics_mode);
+/**
+ * @brief Stores a terminal render of a page. The cache keeps its own copy.
+ */
+void book_page_cache_store_rendered(BookPageCache *cache,
+                                    gint page_index,
+                                    gint target_cols,
+                                    gint target_rows,
+                                    const RendererConfig *config,
+                                    const GString *rendered,
+                                    gint rendered_width,
+                                    gint rendered_height,
+                                    gboolean graphics_mode);
+/**
+ * @brief Replaces pending prefetch work with pages around @p page_index.
+ *
+ * Pages are queued in reading order. Going forward, that is the next two
+ * pages after the @p span visible ones, then the page before. Going backward,
+ * it is the two previous pages, then the page after the visible span.
+ *
+ * @param cache The page cache.
+ * @param page_index First visible page.
+ * @param span Number of visible pages (1 for single, 2 for spreads).
+ * @param direction Reading direction; negative means backward.
+ * @param target_cols Per-page target width in terminal cells.
+ * @param target_rows Per-page target height in terminal cells.
+ * @param config Renderer configuration used for the prefetched terminal renders.
+ */
+void book_page_cache_prefetch(BookPageCache *cache,
+                              gint page_index,
+                              gint span,
+                              gint direction,
+                              gint target_cols,
+                              gint target_rows,
+                              const RendererConfig *config);
+
+#endif // BOOK_PAGE_CACHE_H
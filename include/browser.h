@@ -2,14 +2,16 @@
 #define BROWSER_H
 
 #include "common.h"
+#include "media_index.h"
 
 // File browser structure
 typedef struct {
     gchar *directory_path;
-    GList *image_files;
-    GList *current;
+    MediaIndex *image_files;
     gint current_index;
     gint total_files;
+    // List files with a media extension without opening them; callers validate on display
+    gboolean defer_validation;
 } FileBrowser;
 
 // Browser lifecycle functions
@@ -39,7 +41,12 @@ void browser_destroy(FileBrowser *browser);
  *
  * Clears any previously loaded files, sets the new directory path, and then
  * iterates through the directory, adding all supported image files to an
- * internal list. The list is sorted alphabetically.
+ * internal index. The index is sorted with `path_sort_compare`.
+ *
+ * Entry types come from the directory stream, so regular files are found
+ * without a per-entry stat. Files are then sniffed for media content in a
+ * parallel batch, except that with `defer_validation` set, files with a
+ * supported media extension are listed without being opened at all.
  *
  * @param browser A pointer to the `FileBrowser` instance.
  * @param directory The path to the directory to scan.
@@ -140,14 +147,13 @@ gboolean browser_has_files(const FileBrowser *browser);
  */
 ErrorCode browser_delete_current_file(FileBrowser *browser);
 /**
- * @brief Retrieves a list of all file paths currently managed by the browser.
+ * @brief Retrieves the index of all file paths currently managed by the browser.
  *
  * @param browser A pointer to the constant `FileBrowser` instance.
- * @return A `GList` containing `gchar*` file paths. The returned list and
- *         its string elements are internal copies and should not be modified
- *         or freed by the caller.
+ * @return The browser's `MediaIndex`, or NULL. It is internal data and should
+ *         not be modified or freed by the caller.
  */
-GList* browser_get_all_files(const FileBrowser *browser);
+const MediaIndex* browser_get_all_files(const FileBrowser *browser);
 
 // Utility functions
 /**
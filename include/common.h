@@ -92,6 +92,16 @@ gboolean is_video_file(const char *filename);
  */
 gboolean is_media_file(const char *filename);
 
+/**
+ * @brief Checks for a supported image or video extension without any file I/O.
+ *
+ * Unlike `is_image_file`, a name without an extension is never sniffed.
+ *
+ * @param filename The file name or path.
+ * @return `TRUE` if the extension is a supported image or video extension.
+ */
+gboolean has_media_extension(const char *filename);
+
 /**
  * @brief Checks if a file is a valid video file (exists, non-zero size).
  *
@@ -181,6 +191,26 @@ gint64 get_file_size(const char *path);
  *         or -1 if the file does not exist or its modification time cannot be determined.
  */
 gint64 get_file_mtime(const char *path);
+/**
+ * @brief Returns the modification time in @p st as nanoseconds since the epoch.
+ *
+ * Hides the platform spelling of the field (`st_mtim` or `st_mtimespec`).
+ */
+gint64 stat_mtime_ns(const struct stat *st);
+
+/**
+ * @brief Work for one index of `parallel_for`.
+ */
+typedef void (*ParallelForFunc)(guint index, gpointer user_data);
+/**
+ * @brief Calls @p func once for every index below @p count and returns when
+ *        all calls are done.
+ *
+ * The calls are spread over a short-lived pool of at most @p max_threads
+ * threads, so @p func must be safe to run concurrently. With fewer than two
+ * threads, or if no pool can be created, they run in order on the caller.
+ */
+void parallel_for(guint count, guint max_threads, ParallelForFunc func, gpointer user_data);
 /**
  * @brief Frees a dynamically allocated string and sets its pointer to NULL.
  * 
@@ -0,0 +1,77 @@
+#ifndef DIR_LOADER_H
+#define DIR_LOADER_H
+
+#include "common.h"
+#include "media_meta.h"
+
+/*
+ * Background directory scan for the image list. A worker thread walks the
+ * directory with `dir_scan_next`, keeps files with a supported media
+ * extension (sniffing only files without one), and publishes sorted batches
+ * that the main loop merges into the list as they arrive. Batches start
+ * small so the first results show up quickly and double up to a cap so the
+ * number of merges grows only logarithmically with directory size.
+ *
+ * With a nonzero depth the scan also descends into subdirectories. Found
+ * directories go on a shared queue served by a small pool of workers, each
+ * directory is visited once by device and inode so symlink loops end, and
+ * hidden directories are skipped. Batches are then ordered by the path below
+ * the scanned directory (`path_sort_list_relative`).
+ *
+ * Sniffing reads every extensionless file, so the scan first asks a copy of
+ * the directory's `MediaMetaStore`: an unchanged file with a record is kept
+ * or dropped by its recorded kind without being opened. Files the sniff
+ * rejects are handed back through `dir_loader_take_rejected` so the caller
+ * can record them; accepted ones get a full record when first probed.
+ */
+#define DIR_LOADER_FIRST_BATCH 256
+#define DIR_LOADER_MAX_BATCH 16384
+#define DIR_LOADER_MAX_DEPTH 64
+#define DIR_LOADER_MAX_WORKERS 8
+
+typedef struct DirLoader DirLoader;
+
+/**
+ * @brief Starts scanning @p directory on worker threads.
+ *
+ * @param directory The directory to scan. Paths are built from it as given.
+ * @param skip_name A file name in @p directory itself to leave out of the
+ *        results, typically the file already shown, or NULL.
+ * @param natural_sort Whether batches are sorted with natural ordering.
+ * @param max_depth How many directory levels below @p directory to descend;
+ *        0 scans only @p directory. Clamped to `DIR_LOADER_MAX_DEPTH`.
+ * @param known Media facts recorded for the directory, or NULL. The loader
+ *        keeps its own copy, so the store may change while the scan runs.
+ * @return A new loader, or NULL if no worker thread can be started.
+ */
+DirLoader* dir_loader_start(const char *directory, const char *skip_name, gboolean natural_sort, gint max_depth,
+                            const MediaMetaStore *known);
+/**
+ * @brief Cancels the scan, waits for the worker and frees pending results.
+ *
+ * @param loader The loader to free. NULL is ignored.
+ */
+void dir_loader_free(DirLoader *loader);
+
+/**
+ * @brief Takes every batch published since the last call.
+ *
+ * Does not block. The returned batches are merged into one list in
+ * `path_sort_list_relative` order for the scanned directory, ready for
+ * `media_index_merge`. Without recursion that is plain basename order.
+ *
+ * @param loader The loader.
+ * @param out_done Set to `TRUE` once the scan has finished and every batch
+ *        has been taken.
+ * @return A sorted list of newly found paths (caller-owned strings), or NULL.
+ */
+GList* dir_loader_take(DirLoader *loader, gboolean *out_done);
+/**
+ * @brief Takes the files without a media extension that were sniffed since
+ *        the last call and turned out not to be media.
+ *
+ * @return Unordered list of paths (caller-owned strings), or NULL.
+ */
+GList* dir_loader_take_rejected(DirLoader *loader);
+
+#endif // DIR_LOADER_H
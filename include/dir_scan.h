@@ -0,0 +1,78 @@
+#ifndef DIR_SCAN_H
+#define DIR_SCAN_H
+
+#include "common.h"
+
+/*
+ * Directory listing built on readdir's d_type. Entry types come from the
+ * directory stream itself, so a listing costs no per-entry stat except for
+ * symlinks and filesystems that report DT_UNKNOWN. Content sniffing is kept
+ * separate and batched so callers only pay for it where it is needed.
+ */
+#define DIR_SCAN_SNIFF_MAX_THREADS 8
+
+typedef enum {
+    DIR_SCAN_ENTRY_REGULAR = 0,
+    DIR_SCAN_ENTRY_DIRECTORY
+} DirScanEntryType;
+
+typedef struct {
+    gchar *name;
+    DirScanEntryType type;
+} DirScanEntry;
+
+typedef struct DirScanIter DirScanIter;
+
+/**
+ * @brief Opens @p directory for incremental listing.
+ *
+ * @return A new iterator, or NULL if the directory cannot be opened.
+ */
+DirScanIter* dir_scan_open(const char *directory);
+/**
+ * @brief Returns the next regular file or directory, applying the same
+ * filtering as `dir_scan_read`.
+ *
+ * @param iter The iterator.
+ * @param out_name Receives the entry name, valid until the next call.
+ * @param out_type Receives the entry type.
+ * @return `TRUE` if an entry was returned, `FALSE` at the end of the directory.
+ */
+gboolean dir_scan_next(DirScanIter *iter, const gchar **out_name, DirScanEntryType *out_type);
+/**
+ * @brief Closes an iterator. NULL is ignored.
+ */
+void dir_scan_close(DirScanIter *iter);
+
+/**
+ * @brief Lists the regular files and directories in @p directory.
+ *
+ * "." and ".." are skipped, as are entries that are neither regular files nor
+ * directories after following symlinks (sockets, devices, dangling links).
+ * Entries are returned in directory order.
+ *
+ * @param directory The directory to list.
+ * @param out_entries Receives a `GArray` of `DirScanEntry`; free with
+ *        `dir_scan_entries_free`.
+ * @return `ERROR_NONE` on success, or `ERROR_FILE_NOT_FOUND` if the directory
+ *         cannot be opened.
+ */
+ErrorCode dir_scan_read(const char *directory, GArray **out_entries);
+/**
+ * @brief Frees an entry array returned by `dir_scan_read`. NULL is ignored.
+ */
+void dir_scan_entries_free(GArray *entries);
+
+/**
+ * @brief Runs `is_valid_media_file` over a batch of paths.
+ *
+ * Each check opens the file, so on network filesystems the batch is spread
+ * over a small thread pool to overlap the round trips.
+ *
+ * @param paths Paths to check.
+ * @param count Number of paths.
+ * @param out_valid Receives one result per path.
+ */
+void dir_scan_sniff_media(const gchar *const *paths, guint count, gboolean *out_valid);
+
+#endif // DIR_SCAN_H
@@ -0,0 +1,86 @@
+#ifndef DIR_WATCH_H
+#define DIR_WATCH_H
+
+#include "common.h"
+
+/*
+ * Change notifications for a single directory. On Linux the watcher uses
+ * inotify, so changes cost nothing until they happen and are reported as
+ * they arrive. Where inotify is unavailable (other platforms, exhausted
+ * watch limits) it falls back to diffing periodic listings of the directory.
+ * Either way callers receive the same add/remove/modify events and can
+ * update their lists in place instead of rescanning.
+ */
+#define DIR_WATCH_POLL_INTERVAL_US 1000000
+
+typedef enum {
+    DIR_WATCH_BACKEND_AUTO = 0,   // inotify, falling back to polling
+    DIR_WATCH_BACKEND_POLL
+} DirWatchBackend;
+
+typedef enum {
+    DIR_WATCH_EVENT_ADDED = 0,    // Created or renamed into the directory
+    DIR_WATCH_EVENT_REMOVED,      // Deleted or renamed out of the directory
+    DIR_WATCH_EVENT_MODIFIED,     // Contents rewritten
+    DIR_WATCH_EVENT_RESCAN        // Events were lost; the directory must be re-read
+} DirWatchEventType;
+
+typedef struct {
+    DirWatchEventType type;
+    gchar *name;                  // Entry name, NULL for DIR_WATCH_EVENT_RESCAN
+    gboolean is_directory;
+} DirWatchEvent;
+
+typedef struct DirWatch DirWatch;
+
+/**
+ * @brief Starts watching @p directory.
+ *
+ * @param directory The directory to watch.
+ * @param backend `DIR_WATCH_BACKEND_AUTO` to prefer inotify, or
+ *        `DIR_WATCH_BACKEND_POLL` to always poll.
+ * @return A new watcher, or NULL if the directory cannot be opened.
+ */
+DirWatch* dir_watch_new(const char *directory, DirWatchBackend backend);
+/**
+ * @brief Stops watching and frees the watcher. NULL is ignored.
+ */
+void dir_watch_free(DirWatch *watch);
+
+/**
+ * @brief Returns the directory passed to `dir_watch_new`.
+ */
+const gchar* dir_watch_get_directory(const DirWatch *watch);
+/**
+ * @brief Returns `TRUE` if the watcher diffs listings instead of using inotify.
+ */
+gboolean dir_watch_is_polling(const DirWatch *watch);
+/**
+ * @brief Returns the inotify descriptor to wait on, or -1 when polling.
+ */
+gint dir_watch_get_fd(const DirWatch *watch);
+/**
+ * @brief Sets how often the polling backend re-lists the directory.
+ *
+ * @param watch The watcher.
+ * @param interval_us Minimum time between listings in microseconds.
+ */
+void dir_watch_set_poll_interval(DirWatch *watch, gint64 interval_us);
+
+/**
+ * @brief Collects the changes seen since the last call.
+ *
+ * Does not block. The polling backend only re-lists the directory once the
+ * poll interval has passed and returns NULL in between.
+ *
+ * @param watch The watcher.
+ * @return A `GArray` of `DirWatchEvent` in the order they happened, or NULL
+ *         if nothing changed. Free with `dir_watch_events_free`.
+ */
+GArray* dir_watch_take_events(DirWatch *watch);
+/**
+ * @brief Frees an event array returned by `dir_watch_take_events`. NULL is ignored.
+ */
+void dir_watch_events_free(GArray *events);
+
+#endif // DIR_WATCH_H
@@ -0,0 +1,68 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <glib.h>
+
+/*
+ * Blocking wait for the main loop. One poll covers terminal input, a
+ * self-pipe fed by signal handlers, an optional directory watch descriptor
+ * and every source of the default GMainContext, so GIF and video timers are
+ * dispatched from the same wait. Worker threads wake the loop with
+ * `event_loop_wake`, which signals the context's wakeup descriptor. The
+ * process sleeps until one of these has something, instead of spinning on a
+ * fixed interval.
+ */
+
+typedef enum {
+    EVENT_LOOP_READY_NONE = 0,
+    EVENT_LOOP_READY_INPUT = 1 << 0,      // Input descriptor readable or hung up
+    EVENT_LOOP_READY_RESIZE = 1 << 1,     // SIGWINCH arrived
+    EVENT_LOOP_READY_SIGNAL = 1 << 2,     // Another notified signal arrived
+    EVENT_LOOP_READY_WATCH = 1 << 3       // Watch descriptor readable
+} EventLoopReady;
+
+typedef struct EventLoop EventLoop;
+
+/**
+ * @brief Creates the loop and its signal pipe.
+ *
+ * Only one loop may exist at a time, since signal handlers reach it through
+ * process-wide state.
+ *
+ * @param input_fd Descriptor to wait on for input, e.g. STDIN_FILENO.
+ * @return A new loop, or NULL if the signal pipe cannot be created.
+ */
+EventLoop* event_loop_new(gint input_fd);
+/**
+ * @brief Frees the loop. Signals notified afterwards are dropped. NULL is ignored.
+ */
+void event_loop_free(EventLoop *loop);
+/**
+ * @brief Sets an extra descriptor to wait on, or -1 for none.
+ */
+void event_loop_set_watch_fd(EventLoop *loop, gint fd);
+
+/**
+ * @brief Waits until something is ready or @p timeout_ms passes.
+ *
+ * Due GMainContext sources are dispatched before returning, and the wait is
+ * shortened to the context's own next timeout.
+ *
+ * @param loop The loop.
+ * @param timeout_ms Longest wait in milliseconds, -1 for no limit.
+ * @return A mask of `EventLoopReady` flags; NONE after a timeout, a
+ *         dispatched source or `event_loop_wake`.
+ */
+guint event_loop_wait(EventLoop *loop, gint timeout_ms);
+
+/**
+ * @brief Reports @p signum to the loop. Async-signal-safe; call it from
+ *        signal handlers.
+ */
+void event_loop_notify_signal(int signum);
+/**
+ * @brief Wakes a waiting loop from any thread.
+ */
+void event_loop_wake(void);
+
+#endif // EVENT_LOOP_H
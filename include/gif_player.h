@@ -3,6 +3,7 @@
 
 #include "common.h"
 #include "renderer.h"
+#include "kitty_animation.h"
 #include <gdk-pixbuf/gdk-pixbuf.h>
 
 // GIF animation player structure
@@ -39,6 +40,15 @@ typedef struct {
     gint fixed_frame_top_row;
     gboolean fixed_frame_valid;
     GPtrArray *last_frame_lines;
+
+    // Kitty: frames uploaded once during the first loop, then looped by
+    // the terminal
+    KittyAnimation *kitty_animation;
+    GdkPixbufAnimationIter *kitty_iter;     // Next frame to upload
+    gint64 kitty_iter_time_ms;              // Playback time of kitty_iter
+    gint kitty_loop_frames;                 // Frames in one loop; 0 until measured
+    gint kitty_loop_count;                  // Times the loop plays; 0 for endless
+    gboolean kitty_unsupported;             // Loop not found or not RGBA
 } GifPlayer;
 
 // GIF Player functions
@@ -109,6 +119,11 @@ ErrorCode gif_player_load(GifPlayer *player, const gchar *filepath);
  * 
  * If a GIF is loaded and is animated, this function initiates the timer
  * to sequentially display frames, creating an animation effect.
+ *
+ * With the kitty protocol the frames are instead uploaded once, one per
+ * frame delay during the first loop, and the terminal loops them; the
+ * timer stops once the last frame is in. Calling this again while playing
+ * places the animation again after the screen was cleared.
  * 
  * @param player A pointer to the `GifPlayer` instance.
  * @return `ERROR_NONE` on success, or `ERROR_INVALID_IMAGE` if no animated
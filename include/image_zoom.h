@@ -0,0 +1,63 @@
+#ifndef IMAGE_ZOOM_H
+#define IMAGE_ZOOM_H
+
+#include "common.h"
+
+/*
+ * Decoded source image for the single-view zoom mode, kept resident while the
+ * same file stays on screen. Downscaled mip levels are built lazily by
+ * halving, and each frame scales only the visible viewport from the nearest
+ * level at or above the requested resolution.
+ */
+#define IMAGE_ZOOM_MAX_LEVELS 16
+
+typedef struct ImageZoomSource ImageZoomSource;
+
+/**
+ * @brief Decodes @p filepath and wraps it as a zoom source.
+ *
+ * @param filepath Image file to load.
+ * @param error Return location for a load error, or NULL.
+ * @return A new zoom source, or NULL if the image cannot be decoded.
+ */
+ImageZoomSource* image_zoom_source_new(const gchar *filepath, GError **error);
+/**
+ * @brief Wraps an already decoded pixbuf. The source takes its own reference.
+ */
+ImageZoomSource* image_zoom_source_new_from_pixbuf(const gchar *filepath, GdkPixbuf *pixbuf);
+void image_zoom_source_free(ImageZoomSource *source);
+
+const gchar* image_zoom_source_get_path(const ImageZoomSource *source);
+void image_zoom_source_get_size(const ImageZoomSource *source, gint *out_width, gint *out_height);
+
+/**
+ * @brief Picks the mip level a viewport at @p scale should be sampled from.
+ *
+ * Level 0 is the source; level n is the source halved n times. The chosen
+ * level is the smallest one that still has at least @p scale times the
+ * source resolution, so sampling never upscales a downscaled level.
+ */
+gint image_zoom_level_for_scale(gdouble scale);
+
+/**
+ * @brief Renders one viewport of the image scaled by @p scale.
+ *
+ * Coordinates are in pixels of the virtual scaled image, which is never
+ * materialized; only the @p view_width x @p view_height region is produced.
+ *
+ * @param source The zoom source.
+ * @param scale Scale from source pixels to virtual image pixels.
+ * @param view_x Left edge of the viewport in the virtual image.
+ * @param view_y Top edge of the viewport in the virtual image.
+ * @param view_width Viewport width in pixels.
+ * @param view_height Viewport height in pixels.
+ * @return A new pixbuf of the viewport, or NULL on failure.
+ */
+GdkPixbuf* image_zoom_source_render_viewport(ImageZoomSource *source,
+                                             gdouble scale,
+                                             gint view_x,
+                                             gint view_y,
+                                             gint view_width,
+                                             gint view_height);
+
+#endif // IMAGE_ZOOM_H
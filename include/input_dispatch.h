@@ -8,6 +8,8 @@ void input_dispatch_handle_event(PixelTermApp *app,
                                  InputHandler *input_handler,
                                  const InputEvent *event);
 void input_dispatch_process_pending(PixelTermApp *app);
+// Milliseconds until `input_dispatch_process_pending` has work, -1 if never.
+gint input_dispatch_next_timeout_ms(const PixelTermApp *app);
 void input_dispatch_process_animations(PixelTermApp *app);
 void input_dispatch_pause_video_for_resize(PixelTermApp *app);
 
@@ -8,6 +8,7 @@ void input_dispatch_core_handle_event(PixelTermApp *app,
                                       InputHandler *input_handler,
                                       const InputEvent *event);
 void input_dispatch_core_process_pending(PixelTermApp *app);
+gint input_dispatch_core_next_timeout_ms(const PixelTermApp *app);
 void input_dispatch_core_process_animations(PixelTermApp *app);
 void input_dispatch_core_pause_video_for_resize(PixelTermApp *app);
 
@@ -4,5 +4,7 @@
 #include "app.h"
 
 void input_dispatch_process_pending_clicks(PixelTermApp *app);
+// Milliseconds until a pending click resolves as a single click, -1 if none.
+gint input_dispatch_pending_clicks_timeout_ms(const PixelTermApp *app);
 
 #endif
@@ -0,0 +1,127 @@
+#ifndef KITTY_ANIMATION_H
+#define KITTY_ANIMATION_H
+
+#include <glib.h>
+
+/*
+ * Animations handed to a kitty terminal. Frames are uploaded once into one
+ * image (`a=T` for the first frame, `a=f` for the rest) and the terminal
+ * loops them itself (`a=a`), so a playing GIF costs nothing once its first
+ * loop is in. Each frame after the first is built from a copy of the
+ * previous one plus the rectangle of pixels that changed; a frame equal to
+ * the previous one only lengthens that frame's gap.
+ *
+ * Frames are RGBA and are scaled to the animation's pixel size. Commands
+ * are appended to a caller's buffer, which is written out with the frame
+ * being drawn. An animation is not thread-safe; it is used from the main
+ * loop.
+ */
+
+// Frames and terminal memory above which a GIF keeps per-frame transmits.
+// Together with KITTY_REGISTRY_DEFAULT_BUDGET this stays within kitty's
+// default 320 MB storage quota.
+#define KITTY_ANIMATION_MAX_FRAMES 512
+#define KITTY_ANIMATION_MAX_BYTES ((gsize)96 * 1024 * 1024)
+
+typedef enum {
+    KITTY_ANIMATION_STOPPED = 1,
+    KITTY_ANIMATION_LOADING = 2,    // Plays, waiting at the last frame for more
+    KITTY_ANIMATION_RUNNING = 3
+} KittyAnimationState;
+
+typedef struct KittyAnimation KittyAnimation;
+
+/**
+ * @brief Creates an animation of @p width x @p height pixels shown over
+ *        @p columns x @p rows cells. Nothing is sent until the first frame.
+ *
+ * @return NULL if a size is not positive.
+ */
+KittyAnimation* kitty_animation_new(gint width, gint height, gint columns, gint rows);
+/**
+ * @brief Frees the animation. The terminal's copy is left alone; append
+ *        `kitty_animation_append_delete` first to free it. NULL is ignored.
+ */
+void kitty_animation_free(KittyAnimation *animation);
+
+/**
+ * @brief Returns TRUE if @p animation has the given pixel and cell size.
+ */
+gboolean kitty_animation_matches(const KittyAnimation *animation,
+                                 gint width,
+                                 gint height,
+                                 gint columns,
+                                 gint rows);
+/**
+ * @brief Returns the number of frames appended so far.
+ */
+guint kitty_animation_frame_count(const KittyAnimation *animation);
+guint32 kitty_animation_get_id(const KittyAnimation *animation);
+
+/**
+ * @brief Appends the commands adding @p pixels as the next frame, shown for
+ *        @p gap_ms milliseconds.
+ *
+ * The first frame transmits the image and places it at the cursor without
+ * moving the cursor.
+ *
+ * @param pixels    RGBA source of any size; scaled to the animation's size.
+ * @param rowstride Bytes per source row.
+ * @return FALSE if @p pixels is unusable; @p out is unchanged.
+ */
+gboolean kitty_animation_append_frame(KittyAnimation *animation,
+                                      const guint8 *pixels,
+                                      gint width,
+                                      gint height,
+                                      gint rowstride,
+                                      gint gap_ms,
+                                      GString *out);
+
+/**
+ * @brief Appends a placement of the uploaded image at the cursor, for
+ *        redrawing it after the screen was cleared.
+ */
+void kitty_animation_append_place(const KittyAnimation *animation, GString *out);
+/**
+ * @brief Appends a command setting the terminal's playback state.
+ *
+ * @param loops Times to play the frames; 0 loops endlessly. Ignored for
+ *              `KITTY_ANIMATION_STOPPED`.
+ */
+void kitty_animation_append_state(const KittyAnimation *animation,
+                                  KittyAnimationState state,
+                                  gint loops,
+                                  GString *out);
+/**
+ * @brief Appends a delete freeing the image and all of its frames.
+ */
+void kitty_animation_append_delete(const KittyAnimation *animation, GString *out);
+
+/**
+ * @brief Hashes one frame's pixels and display time, for finding where an
+ *        animation starts over.
+ */
+guint64 kitty_animation_hash_frame(const guint8 *pixels,
+                                   gint width,
+                                   gint height,
+                                   gint rowstride,
+                                   gint n_channels,
+                                   gint delay_ms);
+/**
+ * @brief Finds the loop in the first @p count frame hashes of a playback.
+ *
+ * If @p ended, the playback stopped after @p count frames and the frames
+ * are split into whole loops. Otherwise a loop counts as found once it has
+ * repeated in full; the playback is taken to be endless.
+ *
+ * @param out_frames Receives the frames in one loop.
+ * @param out_loops  Receives the times the loop plays; 0 for endless.
+ * @return FALSE if no loop is known yet.
+ */
+gboolean kitty_animation_find_loop(const guint64 *hashes,
+                                   gsize count,
+                                   gboolean ended,
+                                   gint *out_frames,
+                                   gint *out_loops);
+
+#endif // KITTY_ANIMATION_H
@@ -0,0 +1,65 @@
+#ifndef KITTY_COMMAND_INTERNAL_H
+#define KITTY_COMMAND_INTERNAL_H
+
+#include <glib.h>
+
+/*
+ * Scanning of kitty graphics commands in rendered output, shared by the
+ * image registry and the transfer compressor, and writing of chunked ones. A command is
+ * ESC _ G <control> [; <payload>] ESC '\', where control is a comma
+ * separated list of one-letter keys and values.
+ */
+
+// Byte offsets of one command within the scanned string.
+typedef struct {
+    gsize start;
+    gsize control;
+    gsize control_end;
+    gsize payload;
+    gsize payload_len;
+    gsize end;              // Just past the terminator
+} KittyCommand;
+
+/**
+ * @brief Finds the first complete command at or after @p from.
+ */
+gboolean kitty_command_next(const GString *s, gsize from, KittyCommand *cmd);
+/**
+ * @brief Finds the value of the one-letter @p key in a command's control data.
+ */
+gboolean kitty_command_get(const GString *s,
+                           const KittyCommand *cmd,
+                           char key,
+                           const char **out_value,
+                           gsize *out_len);
+/**
+ * @brief Returns the integer value of @p key, or @p fallback if it is
+ *        missing or not a number.
+ */
+gint64 kitty_command_get_int(const GString *s, const KittyCommand *cmd, char key, gint64 fallback);
+/**
+ * @brief Returns TRUE if @p key is present with exactly the value @p value.
+ */
+gboolean kitty_command_has(const GString *s, const KittyCommand *cmd, char key, const char *value);
+
+/**
+ * @brief Finds the first command of @p s if it is a transmit-and-display
+ *        (a=T) without an image id or number, so one can be given to it.
+ */
+gboolean kitty_command_first_untagged_transmit(const GString *s, KittyCommand *out_first);
+/**
+ * @brief Appends the control keys that give @p cmd the image id @p id, to be
+ *        placed at the start of its control data.
+ */
+void kitty_command_append_id_tag(GString *out, const GString *s, const KittyCommand *cmd, guint32 id);
+
+// Most base64 kitty accepts in one chunk
+#define KITTY_COMMAND_CHUNK 4096
+
+/**
+ * @brief Appends one command with @p control and @p data as its payload,
+ *        base64 encoded and split into chunks as kitty requires.
+ */
+void kitty_command_append_payload(GString *out, const char *control, const guint8 *data, gsize len);
+
+#endif // KITTY_COMMAND_INTERNAL_H
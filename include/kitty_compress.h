@@ -0,0 +1,70 @@
+#ifndef KITTY_COMPRESS_H
+#define KITTY_COMPRESS_H
+
+#include <glib.h>
+
+#include "kitty_transfer.h"
+
+/*
+ * Deflate for inline kitty images. Chafa sends kitty images as raw RGBA in
+ * base64, which is all there is over ssh. `kitty_compress_rendered`
+ * rewrites such a transmit to carry zlib data (`o=z`); the renderer calls it
+ * right after printing, so the work lands on whichever thread rendered the
+ * image, normally a preload or playback worker.
+ *
+ * Whether to compress and at which level is picked per image by comparing
+ * the expected time to deflate and send the result with the time to send
+ * the raw data, using the link throughput measured by term_output and the
+ * deflate speed and ratio seen on earlier images. Until the link has been
+ * measured, auto mode compresses only in ssh sessions.
+ *
+ * The functions are thread-safe.
+ */
+
+/**
+ * @brief Sets the process-wide policy; the default is auto.
+ */
+void kitty_compress_set_mode(KittyCompressionMode mode);
+KittyCompressionMode kitty_compress_get_mode(void);
+
+/**
+ * @brief Compresses the kitty transmit in @p rendered in place when the
+ *        current policy says it pays off.
+ *
+ * Output without a raw, uncompressed kitty transmit is left alone.
+ *
+ * @return TRUE if @p rendered was rewritten.
+ */
+gboolean kitty_compress_rendered(GString *rendered);
+
+/**
+ * @brief Returns a copy of @p rendered with its kitty transmit deflated at
+ *        @p level (1-9).
+ *
+ * Text around the transmit is kept.
+ *
+ * @param out_raw_bytes Optional; receives the uncompressed pixel data size.
+ * @return NULL if @p rendered holds no raw kitty transmit or the data does
+ *         not shrink.
+ */
+GString* kitty_compress_transmit(const GString *rendered, gint level, gsize *out_raw_bytes);
+
+/**
+ * @brief Picks the zlib level for @p raw_bytes of pixel data under @p mode.
+ *
+ * @param link_bytes_per_sec Measured throughput, or 0 if unknown.
+ * @param remote             TRUE in an ssh session.
+ * @return 0 to send the data uncompressed.
+ */
+gint kitty_compress_pick_level(KittyCompressionMode mode,
+                               gsize raw_bytes,
+                               gdouble link_bytes_per_sec,
+                               gboolean remote);
+
+/**
+ * @brief Forgets the deflate speed and ratio learned so far and restores
+ *        auto mode.
+ */
+void kitty_compress_reset(void);
+
+#endif // KITTY_COMPRESS_H
@@ -4,9 +4,13 @@
 #include "common.h"
 #include "kitty_transfer.h"
 
+typedef struct KittyShmRing KittyShmRing;
+typedef struct KittyShmSlot KittyShmSlot;
+
 typedef struct {
     GString *command;
     gchar *shm_name;
+    KittyShmSlot *slot;         // Set instead of shm_name for ring frames
     gint display_width_cells;
     gint display_height_cells;
 } KittyGraphicsFrame;
@@ -25,6 +29,18 @@ void kitty_graphics_frame_free(KittyGraphicsFrame *frame);
 
 void kitty_graphics_shm_unlink(const gchar *shm_name);
 
+/**
+ * @brief Works out the pixel size to send for a @p src_width x @p src_height
+ *        image shown over the given cells: the cells' pixel size, but never
+ *        more than the source, so the terminal does any upscaling.
+ */
+void kitty_graphics_get_transfer_size(gint src_width,
+                                      gint src_height,
+                                      gint display_width_cells,
+                                      gint display_height_cells,
+                                      gint *width_out,
+                                      gint *height_out);
+
 GString *kitty_graphics_build_shm_command(const gchar *shm_name,
                                           gint width,
                                           gint height,
@@ -32,4 +48,51 @@ GString *kitty_graphics_build_shm_command(const gchar *shm_name,
                                           gint display_height_cells,
                                           gsize payload_size);
 
+/*
+ * Persistent frame buffers for kitty video: files in a tmpfs directory that
+ * are written in place and sent with t=f, instead of a new shm object per
+ * frame. A frame's slot is released when the frame is dropped unshown, or
+ * marked submitted once its command reached the terminal; the ring reuses
+ * submitted slots after a short settle time. Thread-safe.
+ */
+
+/**
+ * @brief Creates a ring in @p directory (NULL: /dev/shm).
+ *
+ * Files left in @p directory by pixelterm processes that have exited are
+ * removed first.
+ *
+ * @return NULL if the directory is missing or not writable.
+ */
+KittyShmRing *kitty_shm_ring_new(const gchar *directory);
+/**
+ * @brief Deletes the ring's files. Slots still held by frames are deleted
+ *        when released.
+ */
+void kitty_shm_ring_free(KittyShmRing *ring);
+guint kitty_shm_ring_slot_count(KittyShmRing *ring);
+
+/**
+ * @brief Like `kitty_graphics_frame_new_shm_rgba`, writing into a ring slot.
+ *
+ * @return NULL if the frame is invalid or every slot is still in use.
+ */
+KittyGraphicsFrame *kitty_graphics_frame_new_ring_rgba(KittyShmRing *ring,
+                                                        const guint8 *pixels,
+                                                        gint width,
+                                                        gint height,
+                                                        gint rowstride,
+                                                        gint display_width_cells,
+                                                        gint display_height_cells);
+
+const gchar *kitty_shm_slot_get_path(const KittyShmSlot *slot);
+/**
+ * @brief Marks the slot's frame as written to the terminal.
+ */
+void kitty_shm_slot_submitted(KittyShmSlot *slot);
+/**
+ * @brief Returns an unsubmitted slot to the ring.
+ */
+void kitty_shm_slot_release(KittyShmSlot *slot);
+
 #endif // KITTY_GRAPHICS_H
@@ -0,0 +1,67 @@
+#ifndef KITTY_GRAPHICS_SCALE_INTERNAL_H
+#define KITTY_GRAPHICS_SCALE_INTERNAL_H
+
+#include <glib.h>
+
+/*
+ * RGBA scaling for kitty shared-memory frames. The area-average scaler
+ * weights every source pixel by how much of it a destination pixel covers,
+ * using 8-bit fixed-point weights precomputed once per call for rows and
+ * columns. Rows are accumulated with SSE2, AVX2 or NEON where available;
+ * every variant produces the same bytes as the scalar one.
+ *
+ * Destination rows are tightly packed (dest_width * 4 bytes).
+ */
+
+typedef enum {
+    KITTY_SCALE_IMPL_AUTO = 0,      // Best variant for this CPU
+    KITTY_SCALE_IMPL_SCALAR,
+    KITTY_SCALE_IMPL_SSE2,
+    KITTY_SCALE_IMPL_AVX2,
+    KITTY_SCALE_IMPL_NEON
+} KittyScaleImpl;
+
+/**
+ * @brief Area-average scale of @p src into @p dest.
+ */
+void kitty_graphics_scale_rgba_area(guint8 *dest,
+                                    gint dest_width,
+                                    gint dest_height,
+                                    const guint8 *src,
+                                    gint src_width,
+                                    gint src_height,
+                                    gint src_rowstride);
+
+/**
+ * @brief Like `kitty_graphics_scale_rgba_area` with a fixed variant.
+ *
+ * @return FALSE if @p impl is not available on this CPU; @p dest is untouched.
+ */
+gboolean kitty_graphics_scale_rgba_area_with(KittyScaleImpl impl,
+                                             guint8 *dest,
+                                             gint dest_width,
+                                             gint dest_height,
+                                             const guint8 *src,
+                                             gint src_width,
+                                             gint src_height,
+                                             gint src_rowstride);
+
+/**
+ * @brief Nearest-neighbour scale; the previous implementation, kept as the
+ *        baseline for tests and benchmarks.
+ */
+void kitty_graphics_scale_rgba_nearest(guint8 *dest,
+                                       gint dest_width,
+                                       gint dest_height,
+                                       const guint8 *src,
+                                       gint src_width,
+                                       gint src_height,
+                                       gint src_rowstride);
+
+const char *kitty_graphics_scale_impl_name(KittyScaleImpl impl);
+/**
+ * @brief Returns the variant `KITTY_SCALE_IMPL_AUTO` resolves to.
+ */
+KittyScaleImpl kitty_graphics_scale_best_impl(void);
+
+#endif // KITTY_GRAPHICS_SCALE_INTERNAL_H
@@ -0,0 +1,94 @@
+#ifndef KITTY_REGISTRY_H
+#define KITTY_REGISTRY_H
+
+#include <glib.h>
+
+/*
+ * Images kept resident in a kitty terminal. The first time a rendered kitty
+ * image is shown, its transmit command (`a=T`) is tagged with an image ID
+ * from this registry, so the terminal keeps the pixel data after the
+ * placement is deleted. Showing the same file at the same cell geometry
+ * again only sends a placement command (`a=p`) for that ID: tens of bytes
+ * instead of the encoded image.
+ *
+ * Entries are keyed by path and target size in cells, like the preloader's
+ * cache, and are evicted least recently used first once the estimated
+ * terminal memory exceeds the budget. Evicting, forgetting or clearing an
+ * entry appends a delete command (`a=d,d=I`) that frees the terminal's copy;
+ * the caller writes those commands out with the frame it is drawing.
+ *
+ * A registry is not thread-safe; it is used from the main loop.
+ */
+
+// Stays below kitty's default storage quota of 320 MB
+#define KITTY_REGISTRY_DEFAULT_BUDGET ((gsize)192 * 1024 * 1024)
+
+typedef struct KittyRegistry KittyRegistry;
+
+/**
+ * @brief Creates an empty registry keeping at most @p budget_bytes of image
+ *        data resident in the terminal.
+ */
+KittyRegistry* kitty_registry_new(gsize budget_bytes);
+/**
+ * @brief Frees the registry. Terminal copies are left alone; call
+ *        `kitty_registry_clear` first to delete them. NULL is ignored.
+ */
+void kitty_registry_free(KittyRegistry *registry);
+
+/**
+ * @brief Appends a placement of the resident image for @p path at the given
+ *        target size to @p out.
+ *
+ * The placement draws at the cursor with the cell size and cursor movement
+ * of the original transmit.
+ *
+ * @param out_width  Optional; receives the image width in cells.
+ * @param out_height Optional; receives the image height in cells.
+ * @return FALSE if the image is not resident; @p out is unchanged.
+ */
+gboolean kitty_registry_place(KittyRegistry *registry,
+                              const char *path,
+                              gint target_width,
+                              gint target_height,
+                              GString *out,
+                              gint *out_width,
+                              gint *out_height);
+
+/**
+ * @brief Registers a freshly rendered image and appends its tagged transmit
+ *        to @p out, preceded by deletes for any images it evicts.
+ *
+ * @param width    Rendered width in cells, reported by later placements.
+ * @param height   Rendered height in cells.
+ * @param rendered Renderer output holding one kitty `a=T` transmit.
+ * @return FALSE if @p rendered is not an untagged kitty transmit or is larger
+ *         than the whole budget; @p out is unchanged and @p rendered should
+ *         be written as it is.
+ */
+gboolean kitty_registry_transmit(KittyRegistry *registry,
+                                 const char *path,
+                                 gint target_width,
+                                 gint target_height,
+                                 gint width,
+                                 gint height,
+                                 const GString *rendered,
+                                 GString *out);
+
+/**
+ * @brief Drops every image of @p path (the file changed or went away) and
+ *        appends their deletes to @p out.
+ */
+void kitty_registry_forget(KittyRegistry *registry, const char *path, GString *out);
+/**
+ * @brief Drops all images and appends their deletes to @p out.
+ */
+void kitty_registry_clear(KittyRegistry *registry, GString *out);
+
+guint kitty_registry_count(const KittyRegistry *registry);
+/**
+ * @brief Returns the estimated terminal memory held by resident images.
+ */
+gsize kitty_registry_resident_bytes(const KittyRegistry *registry);
+
+#endif // KITTY_REGISTRY_H
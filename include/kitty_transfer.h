@@ -7,4 +7,11 @@ typedef enum {
     KITTY_TRANSFER_SHM
 } KittyTransferMode;
 
+// Deflate (o=z) for inline kitty image data
+typedef enum {
+    KITTY_COMPRESSION_AUTO = 0,     // When the link is slow enough to pay off
+    KITTY_COMPRESSION_ALWAYS,
+    KITTY_COMPRESSION_NEVER
+} KittyCompressionMode;
+
 #endif // KITTY_TRANSFER_H
@@ -0,0 +1,112 @@
+#ifndef MEDIA_INDEX_H
+#define MEDIA_INDEX_H
+
+#include <glib.h>
+
+/*
+ * Array-backed list of media paths in `path_sort_compare` order. Positions
+ * map straight to array slots, so navigation and grid lookups are O(1) and
+ * lookups by name are a binary search. Path strings live in one string chunk
+ * owned by the index rather than in one allocation each. Space left by
+ * removed entries is reclaimed once it makes up half of the chunk, by
+ * copying the remaining paths into a new one.
+ *
+ * Entries are ordered by basename. An index created with a root instead
+ * orders them by the path below that root (`path_sort_compare_relative`),
+ * so one index can hold a whole directory tree with repeated file names.
+ *
+ * Positions are `gint` to match the current/total counters they index.
+ */
+
+typedef struct {
+    const gchar *path;      // Owned by the index; stable until remove/clear/free
+    const gchar *name;      // Sort name (basename or path below the root), points into path
+} MediaIndexEntry;
+
+typedef struct MediaIndex MediaIndex;
+
+/**
+ * @brief Creates an empty index.
+ *
+ * @param natural_sort Whether digit runs in names compare by numeric value.
+ */
+MediaIndex* media_index_new(gboolean natural_sort);
+/**
+ * @brief Creates an empty index ordered by the path below @p root.
+ *
+ * @param root Directory the collection is rooted at, or NULL to order by
+ *        basename like `media_index_new`.
+ * @param natural_sort Whether digit runs in names compare by numeric value.
+ */
+MediaIndex* media_index_new_relative(const gchar *root, gboolean natural_sort);
+/**
+ * @brief Frees the index and every path in it. NULL is ignored.
+ */
+void media_index_free(MediaIndex *index);
+/**
+ * @brief Removes every entry and releases the string storage.
+ */
+void media_index_clear(MediaIndex *index);
+
+/**
+ * @brief Returns the root passed to `media_index_new_relative`, or NULL.
+ */
+const gchar* media_index_get_root(const MediaIndex *index);
+/**
+ * @brief Returns the number of entries, 0 for NULL.
+ */
+gint media_index_length(const MediaIndex *index);
+/**
+ * @brief Returns the path at @p position, or NULL if it is out of range.
+ */
+const gchar* media_index_get(const MediaIndex *index, gint position);
+/**
+ * @brief Returns the sort name at @p position, or NULL if it is out of range.
+ */
+const gchar* media_index_get_name(const MediaIndex *index, gint position);
+
+/**
+ * @brief Finds an entry by sort name with a binary search.
+ *
+ * @param name A basename, or for a rooted index the path below the root.
+ * @return The entry's position, or -1 if no entry has that name.
+ */
+gint media_index_find_name(const MediaIndex *index, const gchar *name);
+/**
+ * @brief Finds an entry whose path equals @p path.
+ *
+ * @return The entry's position, or -1 if there is none.
+ */
+gint media_index_find_path(const MediaIndex *index, const gchar *path);
+
+/**
+ * @brief Adds @p path at its sorted position.
+ *
+ * @return The position of the new entry, or of the existing entry with the
+ *         same sort name, in which case nothing is added.
+ */
+gint media_index_insert(MediaIndex *index, const gchar *path);
+/**
+ * @brief Appends @p path without searching.
+ *
+ * The caller keeps the index sorted, e.g. when copying from another index.
+ */
+void media_index_append(MediaIndex *index, const gchar *path);
+/**
+ * @brief Merges a sorted batch into the index in one linear pass.
+ *
+ * @param index The index.
+ * @param sorted_paths Paths in the index's order (`path_sort_list`, or
+ *        `path_sort_list_relative` for a rooted index). Consumed, strings included.
+ * @return The number of entries added.
+ */
+gint media_index_merge(MediaIndex *index, GList *sorted_paths);
+/**
+ * @brief Removes the entry at @p position. Out-of-range positions are ignored.
+ *
+ * May move the remaining path strings, so pointers returned earlier must be
+ * looked up again afterwards.
+ */
+void media_index_remove(MediaIndex *index, gint position);
+
+#endif // MEDIA_INDEX_H
@@ -0,0 +1,99 @@
+#ifndef MEDIA_META_H
+#define MEDIA_META_H
+
+#include <glib.h>
+
+#include "media_utils.h"
+
+/*
+ * Persistent per-directory cache of media facts that otherwise take a
+ * decode or a container probe: kind, pixel size, whether an image animates
+ * and a video's duration. Records are keyed by the path below the directory
+ * and carry the file's inode, size and modification time; a lookup stats the
+ * file and drops the record if any of them changed, so the cache is checked
+ * lazily and never needs an explicit refresh.
+ *
+ * Each directory gets one small binary file under
+ * $XDG_CACHE_HOME/pixelterm/media-meta/ (fallback: $HOME/.cache), named by a
+ * hash of the directory path. The file is native-endian and versioned; a
+ * file that does not parse is ignored and rewritten on the next save.
+ *
+ * A store is not thread-safe; it is used from the main loop. Background
+ * scans read a copy of it instead.
+ */
+
+typedef struct {
+    MediaKind kind;
+    gint width;             // Pixels; 0 when unknown
+    gint height;
+    gboolean animated;      // More than one frame
+    gint64 duration_ms;     // Videos only; -1 when unknown
+} MediaMeta;
+
+typedef struct MediaMetaStore MediaMetaStore;
+
+/**
+ * @brief Returns the cache file used for @p directory, or NULL if no cache
+ *        directory can be determined. Caller frees.
+ */
+gchar* media_meta_cache_path(const gchar *directory);
+
+/**
+ * @brief Opens the store for @p directory and loads its cache file if any.
+ *
+ * @return A store, or NULL for a NULL directory. A missing or unreadable
+ *         cache file yields an empty store.
+ */
+MediaMetaStore* media_meta_store_open(const gchar *directory);
+/**
+ * @brief Like `media_meta_store_open`, with an explicit cache file.
+ */
+MediaMetaStore* media_meta_store_open_file(const gchar *directory, const gchar *cache_file);
+/**
+ * @brief Saves pending changes and frees the store. NULL is ignored.
+ */
+void media_meta_store_free(MediaMetaStore *store);
+/**
+ * @brief Writes the store to its cache file if anything changed since the
+ *        last load or save.
+ *
+ * @return FALSE if the file could not be written.
+ */
+gboolean media_meta_store_save(MediaMetaStore *store);
+
+/**
+ * @brief Looks up @p path, checking its record against the file on disk.
+ *
+ * @param out Filled when a current record exists.
+ * @return TRUE on a hit; a stale record is dropped and FALSE returned.
+ */
+gboolean media_meta_store_lookup(MediaMetaStore *store, const gchar *path, MediaMeta *out);
+/**
+ * @brief Like `media_meta_store_lookup`, but leaves a stale record in place.
+ *
+ * Nothing is modified, so several threads may call this on a store that no
+ * thread writes to, such as one made by `media_meta_store_copy`.
+ */
+gboolean media_meta_store_match(const MediaMetaStore *store, const gchar *path, MediaMeta *out);
+/**
+ * @brief Copies the records of @p store into a new store that is never saved.
+ *
+ * @return The copy, or NULL for a NULL store. Free with `media_meta_store_free`.
+ */
+MediaMetaStore* media_meta_store_copy(const MediaMetaStore *store);
+/**
+ * @brief Records @p meta for @p path as it is on disk now.
+ *
+ * Nothing is stored if the file cannot be stat'ed.
+ */
+void media_meta_store_put(MediaMetaStore *store, const gchar *path, const MediaMeta *meta);
+/**
+ * @brief Drops the record for @p path, e.g. after the file was removed.
+ */
+void media_meta_store_forget(MediaMetaStore *store, const gchar *path);
+/**
+ * @brief Returns the number of records held, 0 for NULL.
+ */
+guint media_meta_store_size(const MediaMetaStore *store);
+
+#endif // MEDIA_META_H
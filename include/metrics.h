@@ -0,0 +1,45 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <glib.h>
+
+/*
+ * Process-wide counters behind the performance HUD. The hot paths publish
+ * what they just measured (the last decode, render and write, the preload
+ * queue and cache) and the HUD reads a snapshot of all of them at once.
+ *
+ * Durations are microseconds. Values marked cumulative only grow; readers
+ * turn them into rates by comparing two snapshots. Any thread may publish.
+ */
+
+typedef enum {
+    METRIC_DECODE_US,       // Last image, animation, page or video frame decode
+    METRIC_RENDER_US,       // Last Chafa or sixel conversion of decoded pixels
+    METRIC_WRITE_US,        // Last frame write to the terminal
+    METRIC_FRAME_BYTES,     // Bytes in that frame
+    METRIC_PRELOAD_QUEUE,   // Preload tasks waiting
+    METRIC_PRELOAD_HITS,    // Renders served from the preload cache (cumulative)
+    METRIC_PRELOAD_MISSES,  // Lookups the preload cache could not serve (cumulative)
+    METRIC_CACHE_BYTES,     // Rendered output held by the preload cache
+    METRIC_WORKER_BUSY_US,  // Time background workers spent on tasks (cumulative)
+    METRIC_COUNT
+} MetricId;
+
+void metrics_set(MetricId id, gint64 value);
+void metrics_add(MetricId id, gint64 delta);
+
+/**
+ * @brief Publishes the time since @p start_us (from g_get_monotonic_time).
+ *
+ * @return The elapsed microseconds, for callers that also accumulate them.
+ */
+gint64 metrics_set_elapsed(MetricId id, gint64 start_us);
+
+/**
+ * @brief Copies every metric into @p out, consistently with each other.
+ */
+void metrics_snapshot(gint64 out[METRIC_COUNT]);
+
+void metrics_reset_for_test(void);
+
+#endif
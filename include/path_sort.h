@@ -0,0 +1,68 @@
+#ifndef PATH_SORT_H
+#define PATH_SORT_H
+
+#include <glib.h>
+
+/*
+ * Basename ordering used by the image list and the file manager. Letters sort
+ * AaBb… (uppercase before lowercase of the same letter) ahead of every other
+ * byte. Natural mode additionally compares digit runs by numeric value, so
+ * IMG_2 sorts before IMG_10.
+ *
+ * The `_relative` variants compare everything below a common root instead of
+ * the basename, for collections spanning a directory tree. Separators sort
+ * first, so each directory's files stay together and directories come in
+ * the same order as names.
+ */
+
+/**
+ * @brief Compares the basenames of two paths without allocating.
+ *
+ * @param natural Whether digit runs compare by numeric value.
+ * @return Negative, zero or positive, like strcmp. NULL sorts first.
+ */
+gint path_sort_compare(const gchar *path_a, const gchar *path_b, gboolean natural);
+/**
+ * @brief Compares two paths by the part below their first @p root_len bytes.
+ *
+ * @param root_len Length of the shared root; separators after it are skipped.
+ *        0 compares whole paths.
+ */
+gint path_sort_compare_relative(const gchar *path_a, const gchar *path_b, gsize root_len, gboolean natural);
+
+/**
+ * @brief Sorts a list of path strings by basename.
+ *
+ * Each basename is converted once into a weighted collation key held in one
+ * contiguous buffer, then the keys are merge sorted. The sort is stable and
+ * reuses the list's own nodes, so only the key buffers are allocated.
+ *
+ * @param paths List whose data members are path strings.
+ * @param natural Whether digit runs compare by numeric value.
+ * @return The sorted list (the same nodes, relinked data).
+ */
+GList* path_sort_list(GList *paths, gboolean natural);
+/**
+ * @brief `path_sort_list` ordering by the part of each path below @p root_len.
+ */
+GList* path_sort_list_relative(GList *paths, gsize root_len, gboolean natural);
+
+/**
+ * @brief Merges a sorted batch into a sorted list in one linear pass.
+ *
+ * Both lists must already be in `path_sort_list` order. Nodes are relinked,
+ * not copied, so links into @p sorted stay valid. On ties, entries already
+ * in @p sorted come first.
+ *
+ * @param sorted The existing sorted list. Consumed.
+ * @param batch The sorted batch to add. Consumed.
+ * @param natural Whether digit runs compare by numeric value.
+ * @return The merged list.
+ */
+GList* path_sort_merge(GList *sorted, GList *batch, gboolean natural);
+/**
+ * @brief `path_sort_merge` for lists in `path_sort_list_relative` order.
+ */
+GList* path_sort_merge_relative(GList *sorted, GList *batch, gsize root_len, gboolean natural);
+
+#endif // PATH_SORT_H
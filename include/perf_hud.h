@@ -0,0 +1,42 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <glib.h>
+
+#include "metrics.h"
+
+/*
+ * One-line performance readout drawn on the blank row under the title while
+ * `F` is on: the last decode, Chafa and write times, the size of the last
+ * frame, the preload queue and hit rate, cached bytes and worker
+ * utilization, all read from the metrics registry.
+ */
+
+#define PERF_HUD_ROW 2
+#define PERF_HUD_REFRESH_US 250000  // Resample and redraw at most this often
+#define PERF_HUD_LINE_MAX 160
+
+typedef struct {
+    gint64 sample_us;           // When worker time was last sampled; 0 before the first sample
+    gint64 busy_us;             // METRIC_WORKER_BUSY_US at that sample
+    gdouble worker_percent;     // Worker time over wall time between the last two samples
+    gboolean worker_measured;   // FALSE until two samples have been taken
+    gint64 drawn_us;            // When the line was last drawn
+    guint64 drawn_frames;       // Terminal frames written when it was drawn
+    gchar drawn_line[PERF_HUD_LINE_MAX];
+} PerfHud;
+
+/**
+ * @brief Updates worker utilization from @p metrics taken at @p now_us.
+ *
+ * Utilization is busy time per wall time in percent of one core, so several
+ * busy workers read above 100, as in top.
+ */
+void perf_hud_sample(PerfHud *hud, const gint64 metrics[METRIC_COUNT], gint64 now_us);
+
+/**
+ * @brief Writes the HUD text for @p metrics into @p out (plain text, no escapes).
+ */
+void perf_hud_format(const PerfHud *hud, const gint64 metrics[METRIC_COUNT], gchar *out, gsize out_size);
+
+#endif
@@ -7,6 +7,8 @@ void app_preloader_reset(PixelTermApp *app);
 ErrorCode app_preloader_enable(PixelTermApp *app, gboolean queue_tasks);
 void app_preloader_disable(PixelTermApp *app);
 void app_preloader_clear_queue(PixelTermApp *app);
+void app_preloader_cancel_pending(PixelTermApp *app);
+void app_preloader_invalidate(PixelTermApp *app, const char *filepath);
 void app_preloader_queue_directory(PixelTermApp *app);
 void app_preloader_update_terminal(PixelTermApp *app);
 
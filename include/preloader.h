@@ -2,6 +2,7 @@
 #define PRELOADER_H
 
 #include "common.h"
+#include "media_index.h"
 
 // Preload task structure
 typedef struct {
@@ -36,11 +37,13 @@ typedef struct {
     GQueue *task_queue;
     GHashTable *preload_cache;
     GQueue *lru_queue;
+    gsize cache_bytes;      // Rendered bytes held by preload_cache
     PreloaderStatus status;
     gboolean enabled;
     gint max_queue_size;
     gint max_cache_size;
     gint active_tasks;
+    guint generation;       // Bumped by preloader_cancel_pending; stale results are dropped
     
     // Terminal dimensions for rendering
     gint term_width;
@@ -152,13 +155,13 @@ ErrorCode preloader_add_task(ImagePreloader *preloader, const char *filepath, gi
  * prioritizes files around the `current_index` to optimize for user experience.
  * 
  * @param preloader A pointer to the `ImagePreloader` instance.
- * @param files A `GList` of `gchar*` filepaths to add as tasks.
+ * @param files The media index whose neighbours of `current_index` are queued.
  * @param current_index The index of the currently displayed file, used for prioritizing tasks.
  * @param target_width The target width (in characters) for rendering the images.
  * @param target_height The target height (in characters) for rendering the images.
  * @return `ERROR_NONE` on success, or an appropriate `ErrorCode` if task creation fails.
  */
-ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, GList *files, gint current_index, gint target_width, gint target_height);
+ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, const MediaIndex *files, gint current_index, gint target_width, gint target_height);
 /**
  * @brief Clears all pending preload tasks from the queue.
  * 
@@ -169,6 +172,17 @@ ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, GList *fi
  * @return `ERROR_NONE` on success.
  */
 ErrorCode preloader_clear_queue(ImagePreloader *preloader);
+/**
+ * @brief Clears the queue and discards the results of tasks already rendering.
+ *
+ * Used when the queued geometry became obsolete, e.g. while the terminal is
+ * being resized. A task in progress still runs to completion, but its result
+ * is not cached. Cached entries are kept; they are keyed by geometry and are
+ * reused if the same size comes back.
+ *
+ * @param preloader A pointer to the `ImagePreloader` instance.
+ */
+void preloader_cancel_pending(ImagePreloader *preloader);
 // Cache management
 /**
  * @brief Retrieves a rendered image from the cache.
@@ -2,6 +2,8 @@
 #define RENDERER_H
 
 #include "common.h"
+#include "media_meta.h"
+#include "sixel_encoder.h"
 
 // Renderer configuration
 typedef struct {
@@ -105,6 +107,24 @@ GString* renderer_render_image_data(ImageRenderer *renderer,
                                    gint height, 
                                    gint rowstride,
                                    gint n_channels);
+/**
+ * @brief Renders RGBA video frame data as sixels, reusing the palette kept
+ *        in @p palettes from earlier frames.
+ *
+ * Chafa quantizes every image from scratch and takes no palette from the
+ * caller, so sixel video frames are encoded by `sixel_encode_rgba` instead.
+ * Gamma and color enhancement are applied as in `renderer_render_image_data`.
+ *
+ * @return The sixel image, or NULL if the canvas is not in sixel mode, a
+ *         dither mode was asked for, or the data is unusable; render the
+ *         frame with `renderer_render_image_data` then.
+ */
+GString* renderer_render_sixel_data(ImageRenderer *renderer,
+                                    SixelPaletteCache *palettes,
+                                    const guint8 *pixel_data,
+                                    gint width,
+                                    gint height,
+                                    gint rowstride);
 /**
  * @brief Sets up or updates the Chafa canvas for rendering.
  * 
@@ -182,6 +202,18 @@ gboolean renderer_is_image_supported(const char *filepath);
  */
 ErrorCode renderer_get_image_dimensions(const char *filepath, gint *width, gint *height);
 ErrorCode renderer_get_media_dimensions(const char *filepath, gint *width, gint *height);
+/**
+ * @brief Probes the facts kept in a `MediaMetaStore`: kind, pixel size,
+ *        animation and, for videos, duration.
+ *
+ * Decodes images (an animated one through its animation loader) and probes
+ * video containers, so callers should cache the result.
+ *
+ * @param filepath The path to the media file.
+ * @param out Filled on success; size fields stay 0 if only the kind is known.
+ * @return `ERROR_NONE` if the file is supported media, `ERROR_INVALID_IMAGE` otherwise.
+ */
+ErrorCode renderer_probe_media(const char *filepath, MediaMeta *out);
 /**
  * @brief Retrieves the actual dimensions (in characters) that the last image was rendered to.
  * 
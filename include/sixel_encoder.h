@@ -0,0 +1,70 @@
+#ifndef SIXEL_ENCODER_H
+#define SIXEL_ENCODER_H
+
+#include <glib.h>
+
+/*
+ * Sixel encoding for video frames. Chafa builds a new palette for every
+ * image, which dominates the cost of sixel video and makes colors shimmer
+ * between frames. This encoder keeps one 256-color palette per video in a
+ * `SixelPaletteCache` and reuses it, together with a lookup table from
+ * 15-bit color to palette index, until a frame no longer fits it: when a
+ * frame's sampled quantization error grows well past the error of the frame
+ * the palette was built from, the scene is taken to have changed and a new
+ * palette is built by median cut.
+ *
+ * Pixels are mapped with a fixed 4x4 ordered dither, so still areas stay
+ * still from frame to frame.
+ */
+
+typedef struct SixelPaletteCache SixelPaletteCache;
+
+/**
+ * @brief Creates an empty cache; the first frame encoded builds a palette.
+ *        The cache is thread-safe and may be shared by render workers.
+ */
+SixelPaletteCache* sixel_palette_cache_new(void);
+void sixel_palette_cache_free(SixelPaletteCache *cache);
+/**
+ * @brief Drops the palette, so the next frame builds a new one.
+ */
+void sixel_palette_cache_reset(SixelPaletteCache *cache);
+/**
+ * @brief Returns how many palettes have been built.
+ */
+guint sixel_palette_cache_get_builds(SixelPaletteCache *cache);
+
+/**
+ * @brief Works out the pixel size of a sixel image covering @p columns x
+ *        @p rows cells, with the height rounded down to whole sixel bands.
+ *
+ * @return FALSE if the size comes out empty.
+ */
+gboolean sixel_get_image_size(gint columns, gint rows, gint *out_width, gint *out_height);
+
+/**
+ * @brief Scales RGBA @p pixels to @p width x @p height and encodes them as a
+ *        sixel image using the cache's palette.
+ *
+ * @return The DCS sequence, or NULL if an argument is unusable.
+ */
+GString* sixel_encode_rgba(SixelPaletteCache *cache,
+                           const guint8 *pixels,
+                           gint src_width,
+                           gint src_height,
+                           gint src_rowstride,
+                           gint width,
+                           gint height);
+/**
+ * @brief Encodes RGBA @p pixels at their own size with the cache's current
+ *        palette, without checking for a scene change, for patching part of
+ *        an image encoded with the same cache. A palette is built only if
+ *        the cache has none.
+ */
+GString* sixel_encode_rgba_patch(SixelPaletteCache *cache,
+                                 const guint8 *pixels,
+                                 gint width,
+                                 gint height,
+                                 gint rowstride);
+
+#endif // SIXEL_ENCODER_H
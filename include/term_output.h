@@ -0,0 +1,72 @@
+#ifndef TERM_OUTPUT_H
+#define TERM_OUTPUT_H
+
+#include <glib.h>
+
+/*
+ * Frame composition for terminal output. `term_output_install` points
+ * stdout at a stream that appends to an in-memory frame buffer while a frame
+ * is open, so the existing printf/fwrite render paths compose a screen
+ * update without touching the terminal. Closing the outermost frame hands
+ * the whole buffer to a single write(); more calls are only made when the
+ * kernel accepts a partial write. Outside a frame the stream is an ordinary
+ * fully buffered stdout that writes on fflush.
+ *
+ * Writing a large frame blocks until the terminal, or the ssh connection in
+ * front of it, has taken most of it, so the time those writes take gives
+ * the link's throughput (`write_bytes_per_sec`).
+ *
+ * Frames nest; an empty frame writes nothing. `ui_begin_sync_update` and
+ * `ui_end_sync_update` open and close a frame around the synchronized-output
+ * sequences. Without `term_output_install` (tests, or if the stream cannot
+ * be created) ending the outermost frame just flushes stdout.
+ *
+ * Frames belong to the main thread.
+ */
+
+typedef struct {
+    guint64 frames;                 // Frames written since install
+    guint64 bytes;                  // Bytes written to the descriptor, frames or not
+    guint64 syscalls;               // write() calls made for those bytes
+    gsize last_frame_bytes;
+    guint last_frame_syscalls;
+    gdouble write_bytes_per_sec;    // Smoothed rate of large frame writes; 0 until measured
+} TermOutputStats;
+
+/**
+ * @brief Replaces stdout with the composing stream writing to @p fd.
+ *
+ * @return TRUE on success; FALSE leaves stdout untouched.
+ */
+gboolean term_output_install(gint fd);
+/**
+ * @brief Closes any open frame, flushes and restores the original stdout.
+ */
+void term_output_uninstall(void);
+
+/**
+ * @brief Opens a frame; output is held until the outermost frame ends.
+ */
+void term_output_begin_frame(void);
+/**
+ * @brief Ends a frame. The outermost end writes the composed frame out.
+ *
+ * An end without a matching begin only flushes stdout.
+ *
+ * @return FALSE if writing failed.
+ */
+gboolean term_output_end_frame(void);
+/**
+ * @brief Closes a frame left open by mistake and flushes stdout.
+ *
+ * The main loop calls this before it sleeps so no output is held across
+ * the wait.
+ */
+void term_output_flush(void);
+
+/**
+ * @brief Copies the write counters into @p out.
+ */
+void term_output_get_stats(TermOutputStats *out);
+
+#endif // TERM_OUTPUT_H
@@ -0,0 +1,94 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <glib.h>
+
+/*
+ * Span tracing of the hot paths, written as Chrome trace-event JSON that
+ * chrome://tracing and ui.perfetto.dev open directly.
+ *
+ * Each thread records finished spans into its own ring buffer, so recording
+ * takes no lock; a thread keeps only its last TRACE_RING_CAPACITY spans.
+ * Rings of exited threads stay on their own track; past
+ * TRACE_RETIRED_RINGS_MAX of them the oldest is reused and its spans dropped.
+ * While tracing is off a span costs one flag check.
+ *
+ *   TraceSpan span = trace_span_begin(TRACE_CATEGORY_RENDER, "image");
+ *   ...
+ *   trace_span_end(&span);
+ *
+ * Categories and names must outlive the process (string literals).
+ */
+
+#define TRACE_ENV "PIXELTERM_TRACE"
+#define TRACE_DEFAULT_FILE "pixelterm-trace.json"
+#define TRACE_RING_CAPACITY 8192
+#define TRACE_RETIRED_RINGS_MAX 8   // Rings of exited threads kept for the file
+
+#define TRACE_CATEGORY_DECODE "decode"
+#define TRACE_CATEGORY_RENDER "render"
+#define TRACE_CATEGORY_PRESENT "present"
+#define TRACE_CATEGORY_PRELOAD "preload"
+#define TRACE_CATEGORY_SCAN "scan"
+#define TRACE_CATEGORY_BOOK "book"
+#define TRACE_CATEGORY_WRITE "write"
+
+typedef struct {
+    const char *category;
+    const char *name;
+    gint64 start_us;        // 0 while tracing is off
+} TraceSpan;
+
+// Read through trace_enabled(); set by trace_init and trace_finish.
+extern gint trace_active;
+
+static inline gboolean trace_enabled(void) {
+    return g_atomic_int_get(&trace_active) != 0;
+}
+
+static inline TraceSpan trace_span_begin(const char *category, const char *name) {
+    TraceSpan span = {category, name, 0};
+    if (trace_enabled()) {
+        span.start_us = g_get_monotonic_time();
+    }
+    return span;
+}
+
+/**
+ * @brief Records @p span as finished now, with one integer argument shown
+ *        alongside it (for example the byte count of a write).
+ *
+ * @param arg_name NULL records the span without an argument.
+ */
+void trace_span_end_arg(const TraceSpan *span, const char *arg_name, gint64 arg_value);
+
+static inline void trace_span_end(const TraceSpan *span) {
+    if (span->start_us != 0) {
+        trace_span_end_arg(span, NULL, 0);
+    }
+}
+
+/**
+ * @brief Starts tracing when @p path is set or TRACE_ENV asks for it.
+ *
+ * TRACE_ENV set to "1" writes TRACE_DEFAULT_FILE in the temporary
+ * directory; any other value except "0" is the output path. The trace is
+ * written by trace_finish, which runs at exit.
+ */
+void trace_init(const char *path);
+
+/**
+ * @brief Names the calling thread's track in the trace.
+ */
+void trace_set_thread_name(const char *name);
+
+/**
+ * @brief Stops recording and writes the trace; later calls do nothing.
+ *
+ * @return FALSE if the file could not be written.
+ */
+gboolean trace_finish(void);
+
+void trace_reset_for_test(void);
+
+#endif
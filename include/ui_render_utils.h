@@ -33,6 +33,7 @@ void ui_begin_sync_update(void);
 void ui_end_sync_update(void);
 void ui_clear_screen_for_refresh(const PixelTermApp *app);
 void ui_clear_kitty_images(const PixelTermApp *app);
+void ui_release_kitty_images(PixelTermApp *app);
 void ui_clear_single_view_lines(const PixelTermApp *app);
 void ui_clear_area(const PixelTermApp *app, gint top_row, gint height);
 void ui_render_panel(gint term_width, gint term_height, const UIPanel *panel);
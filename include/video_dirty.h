@@ -0,0 +1,116 @@
+#ifndef VIDEO_DIRTY_H
+#define VIDEO_DIRTY_H
+
+#include <glib.h>
+#include <chafa.h>
+
+#include "sixel_encoder.h"
+
+/*
+ * Dirty-rectangle updates for video shown with a graphics protocol. The
+ * frame on screen is kept as RGBA at the pixel size the terminal was sent,
+ * and the next frame is compared with it cell by cell. Changed cells are
+ * merged into rectangles, and only those are sent: kitty edits the shown
+ * image in place (`a=f` on its root frame), sixel and iTerm2 draw a small
+ * image at the rectangle's cell. When more than a threshold share of the
+ * cells changed, the player sends the whole frame as before.
+ */
+
+// Share of the image's cells, in percent, above which whole frames are sent
+#define VIDEO_DIRTY_DEFAULT_THRESHOLD 40
+// Unchanged cells between two changed runs of a row that are sent anyway,
+// rather than starting another rectangle
+#define VIDEO_DIRTY_JOIN_GAP 2
+
+typedef struct {
+    gint column;        // First cell, relative to the image
+    gint row;
+    gint columns;
+    gint rows;
+} VideoDirtyRect;
+
+typedef struct {
+    guint8 *pixels;     // Tightly packed RGBA
+    gint width;
+    gint height;
+    gint columns;       // Cells the image covers
+    gint rows;
+    gint cell_height;   // Pixel rows per cell row; 0 spreads the height over the rows
+} VideoDirtyFrame;
+
+typedef struct {
+    ChafaPixelMode pixel_mode;
+    guint32 kitty_image_id;             // Image holding the shown kitty frame
+    SixelPaletteCache *sixel_palettes;  // Palette the shown sixel frame used
+    gint top_row;                       // Screen cell of the image's top left, 1-based
+    gint left_column;
+} VideoDirtyTarget;
+
+/**
+ * @brief Scales RGBA @p pixels to @p width x @p height for comparing with
+ *        the next frame.
+ *
+ * @return NULL if a size is not positive.
+ */
+VideoDirtyFrame* video_dirty_frame_new(const guint8 *pixels,
+                                       gint src_width,
+                                       gint src_height,
+                                       gint src_rowstride,
+                                       gint width,
+                                       gint height,
+                                       gint columns,
+                                       gint rows,
+                                       gint cell_height);
+void video_dirty_frame_free(VideoDirtyFrame *frame);
+
+/**
+ * @brief Finds the rectangles of cells that differ between @p previous and
+ *        @p current.
+ *
+ * Changed cells of a row are joined across gaps of up to
+ * `VIDEO_DIRTY_JOIN_GAP` cells, and equal runs on consecutive rows become
+ * one rectangle.
+ *
+ * @param rects      Receives `VideoDirtyRect`s; cleared first.
+ * @param out_changed Receives the share of cells the rectangles cover, 0-1.
+ * @return FALSE if the frames differ in size, so no update is possible.
+ */
+gboolean video_dirty_find_rects(const VideoDirtyFrame *previous,
+                                const VideoDirtyFrame *current,
+                                GArray *rects,
+                                gdouble *out_changed);
+/**
+ * @brief Returns the pixels of @p frame under the cells of @p rect.
+ */
+void video_dirty_get_pixel_rect(const VideoDirtyFrame *frame,
+                                const VideoDirtyRect *rect,
+                                gint *out_x,
+                                gint *out_y,
+                                gint *out_width,
+                                gint *out_height);
+
+/**
+ * @brief Appends the commands redrawing @p rects of @p frame over the image
+ *        shown at @p target.
+ */
+void video_dirty_append_updates(GString *out,
+                                const VideoDirtyTarget *target,
+                                const VideoDirtyFrame *frame,
+                                const GArray *rects);
+
+/**
+ * @brief Returns a kitty image ID for a player's frames, above the IDs of
+ *        the image registry and of animations.
+ */
+guint32 video_dirty_new_kitty_id(void);
+/**
+ * @brief Gives the first kitty transmit in @p rendered the ID @p image_id,
+ *        so it replaces the previous frame and can be edited later.
+ *
+ * @param out_width  Receives the transmitted pixel width.
+ * @param out_height Receives the transmitted pixel height.
+ * @return FALSE if @p rendered holds no untagged `a=T` of known size.
+ */
+gboolean video_dirty_tag_kitty(GString *rendered, guint32 image_id, gint *out_width, gint *out_height);
+
+#endif // VIDEO_DIRTY_H
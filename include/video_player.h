@@ -2,8 +2,10 @@
 #define VIDEO_PLAYER_H
 
 #include "common.h"
+#include "kitty_graphics.h"
 #include "kitty_transfer.h"
 #include "renderer.h"
+#include "video_dirty.h"
 
 struct AVCodecContext;
 struct AVFormatContext;
@@ -23,6 +25,8 @@ typedef struct {
 typedef struct {
     GString *rendered;
     gchar *kitty_shm_name;
+    KittyShmSlot *kitty_shm_slot;   // Ring slot holding the kitty frame
+    VideoDirtyFrame *dirty;         // Pixels as sent, for sending only what the next frame changes
     gint rendered_width;
     gint rendered_height;
     gint64 pts_ms;
@@ -89,6 +93,14 @@ typedef struct {
     ColorEnhanceMode color_enhance;
     KittyTransferMode kitty_transfer;
     gboolean kitty_shm_enabled;
+    KittyShmRing *kitty_shm_ring;   // Reused frame buffers; NULL falls back to one shm object per frame
+    SixelPaletteCache *sixel_palettes;  // Palette kept across sixel frames until the scene changes
+    gint dirty_threshold;           // Changed percent above which whole frames are sent; 0 always sends them
+    guint32 kitty_image_id;         // ID of the kitty image showing the current frame
+    VideoDirtyFrame *dirty_shown;   // Frame on screen, for dirty-rectangle updates
+    ChafaPixelMode dirty_shown_mode;
+    gint dirty_shown_row;
+    gint dirty_shown_column;
 
     // FFmpeg state
     struct AVFormatContext *format_context;
@@ -142,6 +154,9 @@ gboolean video_player_is_playing(const VideoPlayer *player);
 gboolean video_player_has_video(const VideoPlayer *player);
 ErrorCode video_player_update_terminal_size(VideoPlayer *player);
 ErrorCode video_player_get_dimensions(const gchar *filepath, gint *width, gint *height);
+/* Reads the first video stream's size and the container duration (-1 when
+ * unknown) with one stream probe. @p duration_ms may be NULL. */
+ErrorCode video_player_probe(const gchar *filepath, gint *width, gint *height, gint64 *duration_ms);
 ErrorCode video_player_get_first_frame(const gchar *filepath,
                                        guint8 **pixels,
                                        gint *width,
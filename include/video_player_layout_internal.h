@@ -17,11 +17,11 @@ enum {
  *
  * All functions accept a VideoPlayer* and access only the layout fields:
  * render_area_*, render_term_*, last_frame_*, fixed_frame_*, last_frame_lines,
- * io_avg_ms/valid, last_present_us, last_presented_pts_ms, present_fps/valid,
- * show_stats, color_enhance, render_layout_generation.
+ * dirty_shown, io_avg_ms/valid, last_present_us, last_presented_pts_ms,
+ * present_fps/valid, show_stats, color_enhance, render_layout_generation.
  */
 
-/* Line cache */
+/* Line cache; also forgets the graphics frame kept for dirty rectangles */
 void video_player_clear_line_cache(VideoPlayer *player);
 
 /* I/O timing */
@@ -3,6 +3,7 @@
 #include "app.h"
 #include "preload_control.h"
 #include "ui_render_utils.h"
+#include "kitty_compress.h"
 
 static const gdouble k_book_spread_ratio = 1.0;
 static const gint k_book_spread_min_cols = 120;
@@ -18,15 +19,12 @@ static void app_init_preview_state(PixelTermApp *app) {
     app->preview.selected = 0;
     app->preview.scroll = 0;
     app->preview.zoom = 0; // 0 indicates uninitialized target cell width
-    app->preview.selected_link = NULL;
-    app->preview.selected_link_index = -1;
 }
 
 static void app_init_file_manager_state(PixelTermApp *app) {
     app->file_manager.entries_count = 0;
+    app->file_manager.directory_count = 0;
     app->file_manager.selected_entry = 0;
-    app->file_manager.selected_link = NULL;
-    app->file_manager.selected_link_index = -1;
     app->file_manager.scroll_offset = 0;
     app->file_manager.previous_selected_entry = 0;
 }
@@ -34,6 +32,7 @@ static void app_init_file_manager_state(PixelTermApp *app) {
 static void app_init_book_state(PixelTermApp *app) {
     app->book.page = 0;
     app->book.page_count = 0;
+    app->book.prefetch_page = 0;
     app->book.preview_selected = 0;
     app->book.preview_scroll = 0;
     app->book.preview_zoom = 0;
@@ -80,6 +79,8 @@ static void app_init_runtime_defaults(PixelTermApp *app) {
     app->gamma = 1.0;
     app->text_symbol_mode = TEXT_SYMBOL_MODE_AUTO;
     app->kitty_transfer = KITTY_TRANSFER_AUTO;
+    app->kitty_compression = KITTY_COMPRESSION_AUTO;
+    app->video_dirty_threshold = VIDEO_DIRTY_DEFAULT_THRESHOLD;
     app->needs_redraw = TRUE;
     app->mode = APP_MODE_SINGLE;
     app->return_to_mode = RETURN_MODE_NONE;
@@ -175,8 +176,11 @@ void app_destroy(PixelTermApp *app) {
         app->video_player = NULL;
     }
 
-    app_close_book(app);
+    g_clear_pointer(&app->kitty_images, kitty_registry_free);
 
+    app_close_book(app);
+    book_thumbnail_cache_clear();
+    g_clear_pointer(&app->zoom_source, image_zoom_source_free);
 
     // Cleanup Chafa resources
     if (app->canvas) {
@@ -192,16 +196,18 @@ void app_destroy(PixelTermApp *app) {
     }
 
     // Cleanup file list
-    if (app->image_files) {
-        g_list_free_full(app->image_files, (GDestroyNotify)g_free);
-    }
+    g_clear_pointer(&app->dir_loader, dir_loader_free);
+    g_clear_pointer(&app->dir_watch, dir_watch_free);
+    g_clear_pointer(&app->dir_watch_pending, dir_watch_events_free);
+    g_clear_pointer(&app->media_meta, media_meta_store_free);
+    media_index_free(app->image_files);
 
     // Cleanup directory path
     g_free(app->current_directory);
 
     // Cleanup file manager entries
     if (app->file_manager.entries) {
-        g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
+        g_ptr_array_unref(app->file_manager.entries);
     }
     g_free(app->file_manager.directory);
     g_free(app->async.image_path);
@@ -276,6 +282,13 @@ ErrorCode app_initialize(PixelTermApp *app, gboolean dither_enabled) {
         app->video_player->renderer->config.color_enhance = app->color_enhance;
     }
     app->video_player->color_enhance = app->color_enhance;
+    app->video_player->dirty_threshold = app->video_dirty_threshold;
+
+    // Kitty keeps transmitted images by ID, so repaints can reuse them
+    if (app->force_kitty) {
+        app->kitty_images = kitty_registry_new(KITTY_REGISTRY_DEFAULT_BUDGET);
+    }
+    kitty_compress_set_mode(app->kitty_compression);
 
     return ERROR_NONE;
 }
@@ -1,5 +1,6 @@
 #include "app.h"
 #include "app_config_runtime.h"
+#include "book_page_cache.h"
 #include "text_utils.h"
 #include "ui_render_utils.h"
 
@@ -132,6 +133,103 @@ static void app_book_render_help_line(const PixelTermApp *app) {
                                 G_N_ELEMENTS(k_book_page_help_segments));
 }
 
+static GString* app_book_render_page_string(PixelTermApp *app,
+                                            ImageRenderer **renderer,
+                                            const RendererConfig *config,
+                                            gint page_index,
+                                            gint page_cols,
+                                            gint page_rows,
+                                            gint *out_width,
+                                            gint *out_height,
+                                            ErrorCode *out_error) {
+    *out_width = 0;
+    *out_height = 0;
+    *out_error = ERROR_NONE;
+
+    BookPageCache *cache = app->book.page_cache;
+    GString *rendered = book_page_cache_get_rendered(cache,
+                                                     page_index,
+                                                     page_cols,
+                                                     page_rows,
+                                                     config,
+                                                     out_width,
+                                                     out_height,
+                                                     NULL);
+    if (rendered) {
+        return rendered;
+    }
+
+    BookPageImage page_image = {0};
+    ErrorCode page_err = cache
+        ? book_page_cache_render_page(cache, page_index, page_cols, page_rows, &page_image)
+        : book_render_page(app->book.doc, page_index, page_cols, page_rows, &page_image);
+    if (page_err != ERROR_NONE) {
+        *out_error = page_err;
+        return NULL;
+    }
+
+    // Cache hits skip renderer setup entirely, so create it on first miss.
+    if (!*renderer) {
+        ImageRenderer *created = renderer_create();
+        if (!created) {
+            book_page_image_free(&page_image);
+            *out_error = ERROR_MEMORY_ALLOC;
+            return NULL;
+        }
+        ErrorCode init_err = renderer_initialize(created, config);
+        if (init_err != ERROR_NONE) {
+            renderer_destroy(created);
+            book_page_image_free(&page_image);
+            *out_error = init_err;
+            return NULL;
+        }
+        *renderer = created;
+    }
+
+    rendered = renderer_render_image_data(*renderer,
+                                          page_image.pixels,
+                                          page_image.width,
+                                          page_image.height,
+                                          page_image.stride,
+                                          page_image.channels);
+    book_page_image_free(&page_image);
+    if (!rendered) {
+        *out_error = ERROR_INVALID_IMAGE;
+        return NULL;
+    }
+
+    renderer_get_rendered_dimensions(*renderer, out_width, out_height);
+    book_page_cache_store_rendered(cache,
+                                   page_index,
+                                   page_cols,
+                                   page_rows,
+                                   config,
+                                   rendered,
+                                   *out_width,
+                                   *out_height,
+                                   renderer_is_graphics_mode(*renderer));
+    return rendered;
+}
+
+static void app_book_prefetch_pages(PixelTermApp *app,
+                                    gint span,
+                                    gint page_cols,
+                                    gint page_rows,
+                                    const RendererConfig *config) {
+    if (!app->book.page_cache || !app->preload_enabled) {
+        return;
+    }
+    gint direction = app->book.page < app->book.prefetch_page ? -1 : 1;
+    app->book.prefetch_page = app->book.page;
+    book_page_cache_prefetch(app->book.page_cache,
+                             app->book.page,
+                             span,
+                             direction,
+                             page_cols,
+                             page_rows,
+                             config);
+}
+
 ErrorCode app_render_book_page(PixelTermApp *app) {
     if (!app) {
         return ERROR_MEMORY_ALLOC;
@@ -150,8 +248,6 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
     gint target_height = 0;
     app_get_image_target_dimensions(app, &target_width, &target_height);
 
-    BookPageImage base_image = {0};
-
     gboolean double_page = app_book_use_double_page(app);
     if (double_page) {
         gint gutter_cols = k_book_spread_gutter_cols;
@@ -162,54 +258,25 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
             gint per_page_rows = target_height;
             if (per_page_rows < 1) per_page_rows = 1;
 
-            BookPageImage left_image = {0};
-            ErrorCode left_err = book_render_page(app->book.doc, app->book.page, per_page_cols, per_page_rows, &left_image);
-            if (left_err != ERROR_NONE) {
-                return left_err;
-            }
-
-            BookPageImage right_image = {0};
-            gboolean has_right = (app->book.page + 1 < app->book.page_count);
-            if (has_right) {
-                ErrorCode right_err = book_render_page(app->book.doc, app->book.page + 1, per_page_cols, per_page_rows, &right_image);
-                if (right_err != ERROR_NONE) {
-                    has_right = FALSE;
-                }
-            }
-
-            ImageRenderer *renderer = renderer_create();
-            if (!renderer) {
-                book_page_image_free(&left_image);
-                book_page_image_free(&right_image);
-                return ERROR_MEMORY_ALLOC;
-            }
-
             RendererConfig config = app_book_make_renderer_config(app, per_page_cols, target_height);
+            ImageRenderer *renderer = NULL;
 
-            ErrorCode error = renderer_initialize(renderer, &config);
-            if (error != ERROR_NONE) {
-                renderer_destroy(renderer);
-                book_page_image_free(&left_image);
-                book_page_image_free(&right_image);
-                return error;
-            }
-
-            GString *left_rendered = renderer_render_image_data(renderer,
-                                                                left_image.pixels,
-                                                                left_image.width,
-                                                                left_image.height,
-                                                                left_image.stride,
-                                                                left_image.channels);
+            gint left_width = 0;
+            gint left_height = 0;
+            ErrorCode left_err = ERROR_NONE;
+            GString *left_rendered = app_book_render_page_string(app,
+                                                                 &renderer,
+                                                                 &config,
+                                                                 app->book.page,
+                                                                 per_page_cols,
+                                                                 per_page_rows,
+                                                                 &left_width,
+                                                                 &left_height,
+                                                                 &left_err);
             if (!left_rendered) {
                 renderer_destroy(renderer);
-                book_page_image_free(&left_image);
-                book_page_image_free(&right_image);
-                return ERROR_INVALID_IMAGE;
+                return left_err;
             }
-
-            gint left_width = 0;
-            gint left_height = 0;
-            renderer_get_rendered_dimensions(renderer, &left_width, &left_height);
             if (left_height <= 0) {
                 left_height = app_count_rendered_lines(left_rendered);
             }
@@ -223,15 +290,18 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
             GString *right_rendered = NULL;
             gint right_width = 0;
             gint right_height = 0;
-            if (has_right && right_image.pixels) {
-                right_rendered = renderer_render_image_data(renderer,
-                                                            right_image.pixels,
-                                                            right_image.width,
-                                                            right_image.height,
-                                                            right_image.stride,
-                                                            right_image.channels);
+            if (app->book.page + 1 < app->book.page_count) {
+                ErrorCode right_err = ERROR_NONE;
+                right_rendered = app_book_render_page_string(app,
+                                                             &renderer,
+                                                             &config,
+                                                             app->book.page + 1,
+                                                             per_page_cols,
+                                                             per_page_rows,
+                                                             &right_width,
+                                                             &right_height,
+                                                             &right_err);
                 if (right_rendered) {
-                    renderer_get_rendered_dimensions(renderer, &right_width, &right_height);
                     if (right_height <= 0) {
                         right_height = app_count_rendered_lines(right_rendered);
                     }
@@ -241,14 +311,9 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
                     if (right_width <= 0) {
                         right_width = per_page_cols;
                     }
-                } else {
-                    has_right = FALSE;
                 }
             }
 
-            book_page_image_free(&left_image);
-            book_page_image_free(&right_image);
-
             gint image_area_top_row = app_book_begin_frame(app, target_height);
 
             gint spread_cols = per_page_cols * 2 + gutter_cols;
@@ -353,52 +418,34 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
                 g_string_free(right_rendered, TRUE);
             }
             renderer_destroy(renderer);
+            app_book_prefetch_pages(app, 2, per_page_cols, per_page_rows, &config);
             return ERROR_NONE;
         }
     }
 
-    if (!double_page) {
-        gint page_cols = target_width > 0 ? target_width : 1;
-        gint page_rows = target_height > 0 ? target_height : 1;
-        ErrorCode page_err = book_render_page(app->book.doc, app->book.page, page_cols, page_rows, &base_image);
-        if (page_err != ERROR_NONE) {
-            return page_err;
-        }
-    }
-
-    ImageRenderer *renderer = renderer_create();
-    if (!renderer) {
-        book_page_image_free(&base_image);
-        return ERROR_MEMORY_ALLOC;
-    }
-
+    gint page_cols = target_width > 0 ? target_width : 1;
+    gint page_rows = target_height > 0 ? target_height : 1;
     RendererConfig config = app_book_make_renderer_config(app, target_width, target_height);
-
-    ErrorCode error = renderer_initialize(renderer, &config);
-    if (error != ERROR_NONE) {
-        renderer_destroy(renderer);
-        book_page_image_free(&base_image);
-        return error;
-    }
-
-    GString *rendered = renderer_render_image_data(renderer,
-                                                   base_image.pixels,
-                                                   base_image.width,
-                                                   base_image.height,
-                                                   base_image.stride,
-                                                   base_image.channels);
-    book_page_image_free(&base_image);
-
+    ImageRenderer *renderer = NULL;
+    gint image_width = 0;
+    gint image_height = 0;
+    ErrorCode page_err = ERROR_NONE;
+    GString *rendered = app_book_render_page_string(app,
+                                                    &renderer,
+                                                    &config,
+                                                    app->book.page,
+                                                    page_cols,
+                                                    page_rows,
+                                                    &image_width,
+                                                    &image_height,
+                                                    &page_err);
     if (!rendered) {
         renderer_destroy(renderer);
-        return ERROR_INVALID_IMAGE;
+        return page_err;
     }
 
     gint image_area_top_row = app_book_begin_frame(app, target_height);
 
-    gint image_width = 0;
-    gint image_height = 0;
-    renderer_get_rendered_dimensions(renderer, &image_width, &image_height);
     if (image_height <= 0) {
         image_height = 1;
         for (gsize i = 0; i < rendered->len; i++) {
@@ -483,5 +530,6 @@ ErrorCode app_render_book_page(PixelTermApp *app) {
     fflush(stdout);
     g_string_free(rendered, TRUE);
     renderer_destroy(renderer);
+    app_book_prefetch_pages(app, 1, page_cols, page_rows, &config);
     return ERROR_NONE;
 }
@@ -1,6 +1,8 @@
 #define _GNU_SOURCE
 
 #include "app_cli.h"
+#include "dir_loader.h"
+#include "video_dirty.h"
 #include "text_utils.h"
 #include "input.h"
 #include "process_env.h"
@@ -32,12 +34,21 @@ static void print_usage(const char *program_name) {
     printf("  %-29s %s\n", "--work-factor N", "Quality/speed tradeoff (1-9, default: 9)");
     printf("  %-29s %s\n", "--protocol MODE", "Output protocol: auto, text, sixel, kitty, iterm2");
     printf("  %-29s %s\n", "--kitty-transfer MODE", "Kitty video transfer: auto, direct, shm");
+    printf("  %-29s %s\n", "--kitty-compression MODE", "Deflate inline kitty images: auto, always, never");
+    printf("  %-29s %s\n", "--video-dirty-threshold N",
+           "Send only changed cells of graphics video frames while at most N% change (0-100, 0 sends whole frames, default: 40)");
     printf("  %-29s %s\n", "--text-symbols MODE", "Text symbol set: auto, half, quarter");
     printf("  %-29s %s\n", "--color-enhance MODE", "Color enhancement: off, vivid");
+    printf("  %-29s %s\n", "--natural-sort BOOL",
+           "Sort numbers in file names by value, e.g. IMG_2 before IMG_10 (default: false)");
+    printf("  %-29s %s\n", "--recursive DEPTH",
+           "Also collect media from subdirectories up to DEPTH levels down (0-64, default: 0)");
     printf("  %-29s %s\n", "--config PATH",
            "Load configuration file (default: $XDG_CONFIG_HOME/pixelterm/config.ini, fallback: $HOME/.config/pixelterm/config.ini)");
     printf("  %-29s %s\n", "--gamma G",
            "Gamma correction for image rendering (default: 1.0)");
+    printf("  %-29s %s\n", "--trace PATH",
+           "Record where time goes and write a Chrome trace to PATH on exit (also: PIXELTERM_TRACE=PATH)");
     printf("\n");
     printf("Notes:\n");
     printf("  Use -- before PATH when the path starts with '-' (example: pixelterm -- --config=gallery.txt)\n");
@@ -120,6 +131,25 @@ static gboolean parse_color_enhance_mode(const char *value, ColorEnhanceMode *ou
     return FALSE;
 }
 
+static gboolean parse_kitty_compression_mode(const char *value, KittyCompressionMode *out_mode) {
+    if (!value || !out_mode) {
+        return FALSE;
+    }
+    if (g_ascii_strcasecmp(value, "auto") == 0) {
+        *out_mode = KITTY_COMPRESSION_AUTO;
+        return TRUE;
+    }
+    if (g_ascii_strcasecmp(value, "always") == 0) {
+        *out_mode = KITTY_COMPRESSION_ALWAYS;
+        return TRUE;
+    }
+    if (g_ascii_strcasecmp(value, "never") == 0) {
+        *out_mode = KITTY_COMPRESSION_NEVER;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 static gboolean parse_kitty_transfer_mode(const char *value, KittyTransferMode *out_mode) {
     if (!value || !out_mode) {
         return FALSE;
@@ -317,7 +347,12 @@ static gboolean app_config_apply_group(GKeyFile *key_file,
         !app_config_read_boolean(key_file, group, "alt_screen", path, &config->alt_screen_enabled) ||
         !app_config_read_boolean(key_file, group, "clear_workaround", path,
                                  &config->clear_workaround_enabled) ||
-        !app_config_read_integer(key_file, group, "work_factor", path, 1, 9, &config->work_factor)) {
+        !app_config_read_boolean(key_file, group, "natural_sort", path, &config->natural_sort) ||
+        !app_config_read_integer(key_file, group, "work_factor", path, 1, 9, &config->work_factor) ||
+        !app_config_read_integer(key_file, group, "video_dirty_threshold", path, 0, 100,
+                                 &config->video_dirty_threshold) ||
+        !app_config_read_integer(key_file, group, "recursive", path, 0, DIR_LOADER_MAX_DEPTH,
+                                 &config->recursive_depth)) {
         g_free(safe_path);
         g_free(safe_group);
         return FALSE;
@@ -419,6 +454,30 @@ static gboolean app_config_apply_group(GKeyFile *key_file,
         g_free(value);
     }
 
+    if (g_key_file_has_key(key_file, group, "kitty_compression", NULL)) {
+        GError *error = NULL;
+        gchar *value = g_key_file_get_string(key_file, group, "kitty_compression", &error);
+        if (error) {
+            app_print_config_error("kitty_compression", path, error);
+            g_error_free(error);
+            g_free(value);
+            g_free(safe_path);
+            g_free(safe_group);
+            return FALSE;
+        }
+        KittyCompressionMode mode = KITTY_COMPRESSION_AUTO;
+        if (!parse_kitty_compression_mode(value, &mode)) {
+            app_print_config_enum_error("kitty_compression", safe_path, safe_group, value,
+                                        "auto, always, or never");
+            g_free(value);
+            g_free(safe_path);
+            g_free(safe_group);
+            return FALSE;
+        }
+        config->kitty_compression = mode;
+        g_free(value);
+    }
+
     if (g_key_file_has_key(key_file, group, "gamma", NULL)) {
         gdouble gamma = config->gamma;
         if (!app_config_read_double(key_file, group, "gamma", path, 0.0, 5.0, &gamma)) {
@@ -765,6 +824,11 @@ void app_config_init(AppConfig *config) {
     config->text_symbol_mode = TEXT_SYMBOL_MODE_AUTO;
     config->color_enhance = COLOR_ENHANCE_OFF;
     config->kitty_transfer = KITTY_TRANSFER_AUTO;
+    config->kitty_compression = KITTY_COMPRESSION_AUTO;
+    config->video_dirty_threshold = VIDEO_DIRTY_DEFAULT_THRESHOLD;
+    config->natural_sort = FALSE;
+    config->recursive_depth = 0;
+    config->trace_path = NULL;
 }
 
 ErrorCode app_parse_arguments(int argc, char *argv[], char **path, AppConfig *config) {
@@ -783,6 +847,11 @@ ErrorCode app_parse_arguments(int argc, char *argv[], char **path, AppConfig *co
         {"text-symbols", required_argument, 0, 1008},
         {"color-enhance", required_argument, 0, 1009},
         {"kitty-transfer", required_argument, 0, 1010},
+        {"natural-sort", required_argument, 0, 1011},
+        {"recursive", required_argument, 0, 1012},
+        {"kitty-compression", required_argument, 0, 1013},
+        {"video-dirty-threshold", required_argument, 0, 1014},
+        {"trace", required_argument, 0, 1015},
         {0, 0, 0, 0}
     };
 
@@ -930,6 +999,72 @@ ErrorCode app_parse_arguments(int argc, char *argv[], char **path, AppConfig *co
                 config->kitty_transfer = mode;
                 break;
             }
+            case 1011: { // --natural-sort
+                gboolean value = FALSE;
+                if (!app_parse_boolean(optarg, &value)) {
+                    gchar *safe_value = sanitize_for_terminal(optarg);
+                    fprintf(stderr, "Invalid --natural-sort value: %s (expected true/false, yes/no, on/off, or 1/0)\n",
+                            safe_value);
+                    g_free(safe_value);
+                    return ERROR_INVALID_ARGS;
+                }
+                config->natural_sort = value;
+                break;
+            }
+            case 1012: { // --recursive
+                char *end = NULL;
+                long value = strtol(optarg, &end, 10);
+                if (!optarg || optarg[0] == '\0' || (end && *end != '\0')) {
+                    gchar *safe_value = sanitize_for_terminal(optarg);
+                    fprintf(stderr, "Invalid --recursive value: %s (expected 0-%d)\n",
+                            safe_value, DIR_LOADER_MAX_DEPTH);
+                    g_free(safe_value);
+                    return ERROR_INVALID_ARGS;
+                }
+                if (value < 0 || value > DIR_LOADER_MAX_DEPTH) {
+                    fprintf(stderr, "Invalid --recursive value: %ld (expected 0-%d)\n", value, DIR_LOADER_MAX_DEPTH);
+                    return ERROR_INVALID_ARGS;
+                }
+                config->recursive_depth = (gint)value;
+                break;
+            }
+            case 1013: { // --kitty-compression
+                KittyCompressionMode mode = KITTY_COMPRESSION_AUTO;
+                if (!parse_kitty_compression_mode(optarg, &mode)) {
+                    gchar *safe_value = sanitize_for_terminal(optarg);
+                    fprintf(stderr, "Invalid --kitty-compression value: %s (expected auto, always, or never)\n",
+                            safe_value);
+                    g_free(safe_value);
+                    return ERROR_INVALID_ARGS;
+                }
+                config->kitty_compression = mode;
+                break;
+            }
+            case 1014: { // --video-dirty-threshold
+                char *end = NULL;
+                long value = strtol(optarg, &end, 10);
+                if (!optarg || optarg[0] == '\0' || (end && *end != '\0')) {
+                    gchar *safe_value = sanitize_for_terminal(optarg);
+                    fprintf(stderr, "Invalid --video-dirty-threshold value: %s (expected 0-100)\n",
+                            safe_value);
+                    g_free(safe_value);
+                    return ERROR_INVALID_ARGS;
+                }
+                if (value < 0 || value > 100) {
+                    fprintf(stderr, "Invalid --video-dirty-threshold value: %ld (expected 0-100)\n", value);
+                    return ERROR_INVALID_ARGS;
+                }
+                config->video_dirty_threshold = (gint)value;
+                break;
+            }
+            case 1015: // --trace
+                if (!optarg || optarg[0] == '\0') {
+                    fprintf(stderr, "Invalid --trace value: (expected path)\n");
+                    return ERROR_INVALID_ARGS;
+                }
+                g_free(config->trace_path);
+                config->trace_path = g_strdup(optarg);
+                break;
             case '?':
                 // Check if it's a long option (starts with --)
                 if (optind > 0 && argv[optind - 1] && strncmp(argv[optind - 1], "--", 2) == 0) {
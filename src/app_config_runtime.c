@@ -43,4 +43,8 @@ void app_config_apply_runtime(PixelTermApp *app, const AppConfig *config) {
     app->text_symbol_mode = config->text_symbol_mode;
     app->color_enhance = config->color_enhance;
     app->kitty_transfer = config->kitty_transfer;
+    app->kitty_compression = config->kitty_compression;
+    app->video_dirty_threshold = config->video_dirty_threshold;
+    app->natural_sort = config->natural_sort;
+    app->recursive_depth = config->recursive_depth;
 }
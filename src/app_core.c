@@ -2,48 +2,49 @@
 
 #include "app.h"
 
-#include "app_file_manager_internal.h"
 #include "book.h"
+#include "book_page_cache.h"
 #include "browser.h"
+#include "dir_loader.h"
+#include "path_sort.h"
 #include "preload_control.h"
 
 #include <sys/stat.h>
 #include <unistd.h>
 
-static GList* app_get_current_image_link(const PixelTermApp *app) {
-    if (!app || !app->image_files || app->current_index < 0) {
-        return NULL;
-    }
-    if (app->total_images > 0 && app->current_index >= app->total_images) {
-        return NULL;
-    }
+static void app_reset_image_list(PixelTermApp *app, const char *directory, gboolean recursive) {
+    // A running background scan would merge into the list being replaced
+    g_clear_pointer(&app->dir_loader, dir_loader_free);
 
-    GList *cursor = app->preview.selected_link;
-    gint idx = app->preview.selected_link_index;
-    if (!cursor || idx < 0) {
-        cursor = app->image_files;
-        idx = 0;
-    }
+    // Start from an empty index; a new one picks up the current sort mode.
+    // A recursive collection is ordered by the path below the directory.
+    media_index_free(app->image_files);
+    app->image_files = recursive ? media_index_new_relative(directory, app->natural_sort)
+                                 : media_index_new(app->natural_sort);
+    app->total_images = 0;
+    app->current_index = 0;
+    // Reset preloader state to avoid leaking threads or stale cache
+    app_preloader_reset(app);
 
-    while (cursor && idx < app->current_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    while (cursor && idx > app->current_index) {
-        cursor = cursor->prev;
-        idx--;
-    }
-    if (cursor && idx == app->current_index) {
-        return cursor;
-    }
+    g_free(app->current_directory);
+    // Normalize path to remove trailing slashes and resolve relative components
+    gchar *normalized_dir = g_canonicalize_filename(directory, NULL);
+    app->current_directory = normalized_dir ? normalized_dir : g_strdup(directory);
 
-    cursor = app->image_files;
-    idx = 0;
-    while (cursor && idx < app->current_index) {
-        cursor = cursor->next;
-        idx++;
+    // Writes back what the previous directory learned, then loads this one's
+    media_meta_store_free(app->media_meta);
+    app->media_meta = media_meta_store_open(app->current_directory);
+}
+
+static void app_watch_directory(PixelTermApp *app, const gchar *target) {
+    if (app->dir_watch && g_strcmp0(dir_watch_get_directory(app->dir_watch), target) == 0) {
+        return;
+    }
+    g_clear_pointer(&app->dir_watch, dir_watch_free);
+    g_clear_pointer(&app->dir_watch_pending, dir_watch_events_free);
+    if (target) {
+        app->dir_watch = dir_watch_new(target, DIR_WATCH_BACKEND_AUTO);
     }
-    return (cursor && idx == app->current_index) ? cursor : NULL;
 }
 
 ErrorCode app_load_directory(PixelTermApp *app, const char *directory) {
@@ -51,20 +52,7 @@ ErrorCode app_load_directory(PixelTermApp *app, const char *directory) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    // Cleanup existing file list
-    if (app->image_files) {
-        g_list_free_full(app->image_files, (GDestroyNotify)g_free);
-        app->image_files = NULL;
-    }
-    app->preview.selected_link = NULL;
-    app->preview.selected_link_index = -1;
-    // Reset preloader state to avoid leaking threads or stale cache
-    app_preloader_reset(app);
-
-    g_free(app->current_directory);
-    // Normalize path to remove trailing slashes and resolve relative components
-    gchar *normalized_dir = g_canonicalize_filename(directory, NULL);
-    app->current_directory = normalized_dir ? normalized_dir : g_strdup(directory);
+    app_reset_image_list(app, directory, FALSE);
 
     // Scan directory for image files
     FileBrowser *browser = browser_create();
@@ -72,36 +60,32 @@ ErrorCode app_load_directory(PixelTermApp *app, const char *directory) {
         return ERROR_MEMORY_ALLOC;
     }
 
+    // Extension matches are listed unopened; files are validated when shown
+    browser->defer_validation = TRUE;
     ErrorCode error = browser_scan_directory(browser, directory);
     if (error != ERROR_NONE) {
         browser_destroy(browser);
         return error;
     }
 
-    GList *file_list_from_browser = browser_get_all_files(browser);
-    gint browser_total = browser_get_total_files(browser);
+    const MediaIndex *browser_files = browser_get_all_files(browser);
+    gint browser_total = media_index_length(browser_files);
 
-    // Clear existing app->image_files and prepare for new entries
-    if (app->image_files) {
-        g_list_free_full(app->image_files, (GDestroyNotify)g_free);
-        app->image_files = NULL;
-    }
-    app->preview.selected_link = NULL;
-    app->preview.selected_link_index = -1;
-    app->total_images = 0; // Reset count
-
-    // Copy and duplicate file paths from browser's list to app's list
-    for (GList *current_node = file_list_from_browser; current_node; current_node = g_list_next(current_node)) {
-        gchar *filepath = (gchar*)current_node->data;
-        app->image_files = g_list_prepend(app->image_files, g_strdup(filepath));
+    if (!app->natural_sort) {
+        // The browser already uses the same order; copy straight across
+        for (gint i = 0; i < browser_total; i++) {
+            media_index_append(app->image_files, media_index_get(browser_files, i));
+        }
+    } else {
+        // Re-sort with natural ordering using precomputed collation keys
+        GList *paths = NULL;
+        for (gint i = browser_total - 1; i >= 0; i--) {
+            paths = g_list_prepend(paths, g_strdup(media_index_get(browser_files, i)));
+        }
+        media_index_merge(app->image_files, path_sort_list(paths, TRUE));
     }
-
-    // Now sort app->image_files using the custom comparison function
-    app->image_files = g_list_sort(app->image_files, (GCompareFunc)app_file_manager_compare_names);
     app->total_images = browser_total;
     app->current_index = 0;
-    app->preview.selected_link = app->image_files;
-    app->preview.selected_link_index = app->image_files ? 0 : -1;
 
     browser_destroy(browser);
 
@@ -116,6 +100,294 @@ ErrorCode app_load_directory(PixelTermApp *app, const char *directory) {
     return ERROR_NONE;
 }
 
+ErrorCode app_load_directory_async(PixelTermApp *app, const char *directory, const char *focus_path) {
+    if (!app || !directory) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    if (!g_file_test(directory, G_FILE_TEST_IS_DIR)) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+
+    app_reset_image_list(app, directory, app->recursive_depth > 0);
+
+    // The focused file is listed up front so it can be shown before the scan ends
+    gchar *focus_name = focus_path ? g_path_get_basename(focus_path) : NULL;
+    if (focus_name) {
+        gchar *focus_file = g_build_filename(directory, focus_name, NULL);
+        media_index_append(app->image_files, focus_file);
+        g_free(focus_file);
+        app->total_images = 1;
+    }
+
+    // Watch from before the scan starts so changes made while it runs are not missed
+    app_watch_directory(app, app->current_directory);
+    app->dir_loader = dir_loader_start(directory, focus_name, app->natural_sort, app->recursive_depth,
+                                       app->media_meta);
+    g_free(focus_name);
+    if (!app->dir_loader) {
+        // Fall back to a blocking scan of the top level, then restore the focused file
+        gchar *focus_copy = g_strdup(focus_path);
+        ErrorCode error = app_load_directory(app, directory);
+        if (error == ERROR_NONE && focus_copy) {
+            gchar *target_basename = g_path_get_basename(focus_copy);
+            gint idx = media_index_find_name(app->image_files, target_basename);
+            if (idx >= 0) {
+                app->current_index = idx;
+            }
+            g_free(target_basename);
+        }
+        g_free(focus_copy);
+        return error;
+    }
+
+    if (app->preload_enabled) {
+        (void)app_preloader_enable(app, TRUE);
+    }
+    return ERROR_NONE;
+}
+
+void app_process_directory_loader(PixelTermApp *app) {
+    if (!app || !app->dir_loader) {
+        return;
+    }
+
+    // Record what the sniff rejected so the next scan does not open it again
+    GList *rejected = dir_loader_take_rejected(app->dir_loader);
+    static const MediaMeta not_media = {MEDIA_KIND_UNKNOWN, 0, 0, FALSE, -1};
+    for (GList *l = rejected; l; l = l->next) {
+        media_meta_store_put(app->media_meta, l->data, &not_media);
+    }
+    g_list_free_full(rejected, g_free);
+
+    gboolean done = FALSE;
+    GList *batch = dir_loader_take(app->dir_loader, &done);
+    if (batch) {
+        // Path strings do not move when the index grows, so the shown and the
+        // highlighted files can be found again by path after the merge
+        const gchar *current_path = app_get_current_filepath(app);
+        const gchar *preview_path = NULL;
+        if (app_is_preview_mode(app) && app->preview.selected >= 0) {
+            preview_path = media_index_get(app->image_files, app->preview.selected);
+        }
+
+        app->total_images += media_index_merge(app->image_files, batch);
+
+        if (current_path) {
+            app->current_index = media_index_find_path(app->image_files, current_path);
+        }
+        if (preview_path) {
+            app->preview.selected = media_index_find_path(app->image_files, preview_path);
+        }
+
+        if (app_is_single_mode(app)) {
+            app_preloader_queue_directory(app);
+            app_render_single_index_line(app);
+        }
+    }
+
+    if (done) {
+        g_clear_pointer(&app->dir_loader, dir_loader_free);
+        if (app_is_preview_mode(app)) {
+            app->needs_screen_clear = TRUE;
+            app_render_preview_grid(app);
+        }
+    }
+}
+
+// Applies watcher events to the image list in place. Returns TRUE if the list
+// changed; @p out_current_changed is set when the shown file was removed or
+// rewritten and needs to be drawn again.
+static gboolean app_apply_image_changes(PixelTermApp *app, GArray *events, gboolean *out_current_changed) {
+    gint current = app->current_index;
+    gint preview = app_is_preview_mode(app) ? app->preview.selected : -1;
+
+    // New files are collected, sorted and merged once at the end. Only the
+    // top level is watched, where names below the root are plain basenames.
+    const gchar *root = media_index_get_root(app->image_files);
+    const gchar *first = media_index_get(app->image_files, 0);
+    gchar *list_dir = root ? g_strdup(root)
+                    : first ? g_path_get_dirname(first) : g_strdup(app->current_directory);
+    GHashTable *pending = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    gboolean changed = FALSE;
+
+    for (guint i = 0; i < events->len; i++) {
+        const DirWatchEvent *event = &g_array_index(events, DirWatchEvent, i);
+        if (!event->name || event->is_directory) {
+            continue;
+        }
+
+        gint position = media_index_find_name(app->image_files, event->name);
+        if (event->type == DIR_WATCH_EVENT_REMOVED) {
+            g_hash_table_remove(pending, event->name);
+            if (position < 0) {
+                continue;
+            }
+            // The next file slides into a removed slot, so only earlier
+            // removals shift the shown and highlighted positions
+            if (position == current) {
+                *out_current_changed = TRUE;
+            } else if (position < current) {
+                current--;
+            }
+            if (position < preview) {
+                preview--;
+            }
+            media_meta_store_forget(app->media_meta, media_index_get(app->image_files, position));
+            app_preloader_invalidate(app, media_index_get(app->image_files, position));
+            media_index_remove(app->image_files, position);
+            app->total_images--;
+            changed = TRUE;
+            continue;
+        }
+
+        if (position >= 0) {
+            // Rewritten in place or replaced by a rename: drop renders made
+            // from the old contents
+            app_preloader_invalidate(app, media_index_get(app->image_files, position));
+            if (position == current) {
+                *out_current_changed = TRUE;
+            }
+            continue;
+        }
+        if (g_hash_table_contains(pending, event->name)) {
+            continue;
+        }
+
+        // Files without a known extension are sniffed once they have been
+        // written; an empty file seen at creation is picked up on close.
+        gchar *path = g_build_filename(list_dir, event->name, NULL);
+        if (has_media_extension(event->name) ||
+            (event->type == DIR_WATCH_EVENT_MODIFIED && is_valid_media_file(path))) {
+            g_hash_table_insert(pending, g_strdup(event->name), path);
+        } else {
+            g_free(path);
+        }
+    }
+    g_free(list_dir);
+
+    current = CLAMP(current, 0, MAX(app->total_images - 1, 0));
+    preview = CLAMP(preview, 0, MAX(app->total_images - 1, 0));
+    if (g_hash_table_size(pending) > 0) {
+        const gchar *current_path = media_index_get(app->image_files, current);
+        const gchar *preview_path = media_index_get(app->image_files, preview);
+
+        GList *added = NULL;
+        GHashTableIter iter;
+        gpointer key = NULL;
+        gpointer value = NULL;
+        g_hash_table_iter_init(&iter, pending);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            // Stealing skips both destroy functions; the path moves to the list
+            added = g_list_prepend(added, value);
+            g_hash_table_iter_steal(&iter);
+            g_free(key);
+        }
+        app->total_images += media_index_merge(app->image_files, path_sort_list(added, app->natural_sort));
+        current = current_path ? media_index_find_path(app->image_files, current_path) : 0;
+        preview = preview_path ? media_index_find_path(app->image_files, preview_path) : 0;
+        changed = TRUE;
+    }
+    g_hash_table_unref(pending);
+    if (!changed) {
+        return FALSE;
+    }
+
+    app->current_index = current;
+    if (app_is_preview_mode(app)) {
+        app->preview.selected = preview;
+    }
+    return TRUE;
+}
+
+static void app_update_directory_watch(PixelTermApp *app) {
+    app_watch_directory(app, app_is_file_manager_mode(app) ? app->file_manager.directory : app->current_directory);
+}
+
+// Moves @p events to the end of @p queue; the names change owner with them.
+static void app_queue_directory_events(GArray **queue, GArray *events) {
+    if (!events) {
+        return;
+    }
+    if (!*queue) {
+        *queue = events;
+        return;
+    }
+    g_array_append_vals(*queue, events->data, events->len);
+    g_array_set_clear_func(events, NULL);
+    dir_watch_events_free(events);
+}
+
+void app_process_directory_changes(PixelTermApp *app) {
+    if (!app) {
+        return;
+    }
+    if (app->dir_loader) {
+        // The watch started before the scan. Its events wait here until the
+        // scan has merged everything, so each one is checked against the full
+        // list; a file both scanned and reported is found and not added twice.
+        app_queue_directory_events(&app->dir_watch_pending, dir_watch_take_events(app->dir_watch));
+        return;
+    }
+
+    app_update_directory_watch(app);
+    GArray *events = g_steal_pointer(&app->dir_watch_pending);
+    app_queue_directory_events(&events, dir_watch_take_events(app->dir_watch));
+    if (!events) {
+        return;
+    }
+
+    const gchar *watched = dir_watch_get_directory(app->dir_watch);
+    gboolean rescan = FALSE;
+    for (guint i = 0; i < events->len; i++) {
+        if (g_array_index(events, DirWatchEvent, i).type == DIR_WATCH_EVENT_RESCAN) {
+            rescan = TRUE;
+            break;
+        }
+    }
+
+    gboolean file_manager_changed = FALSE;
+    if (app_is_file_manager_mode(app) && g_strcmp0(app->file_manager.directory, watched) == 0) {
+        if (rescan) {
+            file_manager_changed = app_file_manager_refresh(app) == ERROR_NONE;
+        } else {
+            for (guint i = 0; i < events->len; i++) {
+                const DirWatchEvent *event = &g_array_index(events, DirWatchEvent, i);
+                file_manager_changed |= app_file_manager_apply_change(app, event);
+            }
+        }
+    }
+
+    gboolean images_changed = FALSE;
+    gboolean current_changed = FALSE;
+    if (g_strcmp0(app->current_directory, watched) == 0) {
+        if (rescan) {
+            // Events were dropped; re-list in the background around the shown file
+            gchar *focus = g_strdup(app_get_current_filepath(app));
+            gchar *directory = g_strdup(app->current_directory);
+            (void)app_load_directory_async(app, directory, focus);
+            g_free(directory);
+            g_free(focus);
+        } else {
+            images_changed = app_apply_image_changes(app, events, &current_changed);
+        }
+    }
+    dir_watch_events_free(events);
+
+    if (file_manager_changed) {
+        app_render_file_manager(app);
+    } else if (images_changed && app_is_single_mode(app)) {
+        app_preloader_queue_directory(app);
+        if (current_changed && app_has_images(app)) {
+            app_render_current_image(app);
+        } else {
+            app_render_single_index_line(app);
+        }
+    } else if (images_changed && app_is_preview_mode(app)) {
+        app->needs_screen_clear = TRUE;
+        app_render_preview_grid(app);
+    }
+}
+
 ErrorCode app_load_single_file(PixelTermApp *app, const char *filepath) {
     if (!app || !filepath) {
         return ERROR_FILE_NOT_FOUND;
@@ -136,67 +408,24 @@ ErrorCode app_load_single_file(PixelTermApp *app, const char *filepath) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    // Load the directory
-    ErrorCode error = app_load_directory(app, directory);
-    g_free(directory); // Free early to avoid memory leak
+    // Show the file right away; the rest of the directory streams in behind it
+    ErrorCode error = app_load_directory_async(app, directory, filepath);
+    g_free(directory);
 
     if (error != ERROR_NONE) {
         return error;
     }
-
-    // Find the specific file in the list by full canonical path first.
-    gchar *target_canonical = g_canonicalize_filename(filepath, NULL);
-    gchar *target_basename = g_path_get_basename(filepath);
-    gboolean found = FALSE;
-    gint idx = 0;
-    for (GList *cur = app->image_files; cur; cur = cur->next, idx++) {
-        gchar *current_path = (gchar*)cur->data;
-        gboolean full_path_match = g_strcmp0(current_path, target_canonical) == 0;
-
-        if (!full_path_match) {
-            gchar *current_basename = g_path_get_basename(current_path);
-            if (g_strcmp0(current_basename, target_basename) == 0) {
-                gchar *current_canonical = g_canonicalize_filename(current_path, NULL);
-                full_path_match = g_strcmp0(current_canonical, target_canonical) == 0;
-                g_free(current_canonical);
-            }
-            g_free(current_basename);
-        }
-
-        if (full_path_match) {
-            app->current_index = idx;
-            found = TRUE;
-            break;
-        }
-    }
-
-    if (!found) {
-        idx = 0;
-        for (GList *cur = app->image_files; cur; cur = cur->next, idx++) {
-            gchar *current_basename = g_path_get_basename((gchar*)cur->data);
-            if (g_strcmp0(current_basename, target_basename) == 0) {
-                app->current_index = idx;
-                found = TRUE;
-                g_free(current_basename);
-                break;
-            }
-            g_free(current_basename);
-        }
-    }
-    g_free(target_canonical);
-    g_free(target_basename);
-
-    // If file was found and loaded successfully, mark for redraw
-    if (found) {
-        app->needs_redraw = TRUE;
-        app->info_visible = FALSE;
-        app->return_to_mode = RETURN_MODE_SINGLE;
-        app->image_zoom = 1.0;
-        app->image_pan_x = 0.0;
-        app->image_pan_y = 0.0;
+    if (!app_get_current_filepath(app)) {
+        return ERROR_FILE_NOT_FOUND;
     }
 
-    return found ? ERROR_NONE : ERROR_FILE_NOT_FOUND;
+    app->needs_redraw = TRUE;
+    app->info_visible = FALSE;
+    app->return_to_mode = RETURN_MODE_SINGLE;
+    app->image_zoom = 1.0;
+    app->image_pan_x = 0.0;
+    app->image_pan_y = 0.0;
+    return ERROR_NONE;
 }
 
 ErrorCode app_open_book(PixelTermApp *app, const char *filepath) {
@@ -216,9 +445,11 @@ ErrorCode app_open_book(PixelTermApp *app, const char *filepath) {
     }
 
     app->book.doc = doc;
+    app->book.page_cache = book_page_cache_create(doc);
     app->book.path = g_strdup(filepath);
     app->book.page_count = book_get_page_count(doc);
     app->book.page = 0;
+    app->book.prefetch_page = 0;
     app->book.preview_selected = 0;
     app->book.preview_scroll = 0;
     app->book.preview_zoom = 0;
@@ -238,6 +469,8 @@ void app_close_book(PixelTermApp *app) {
     if (!app) {
         return;
     }
+    // The cache worker borrows the document, so stop it first.
+    g_clear_pointer(&app->book.page_cache, book_page_cache_destroy);
     if (app->book.doc) {
         book_close(app->book.doc);
         app->book.doc = NULL;
@@ -245,6 +478,7 @@ void app_close_book(PixelTermApp *app) {
     g_clear_pointer(&app->book.path, g_free);
     app->book.page = 0;
     app->book.page_count = 0;
+    app->book.prefetch_page = 0;
     app->book.preview_selected = 0;
     app->book.preview_scroll = 0;
     app->book.preview_zoom = 0;
@@ -355,8 +589,7 @@ ErrorCode app_delete_current_image(PixelTermApp *app) {
         return ERROR_INVALID_IMAGE;
     }
 
-    GList *current_link = app_get_current_image_link(app);
-    const gchar *filepath = current_link ? (const gchar*)current_link->data : NULL;
+    const gchar *filepath = app_get_current_filepath(app);
     if (!filepath) {
         return ERROR_FILE_NOT_FOUND;
     }
@@ -393,28 +626,23 @@ ErrorCode app_delete_current_image(PixelTermApp *app) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    // Remove from file list
-    if (current_link) {
-        // Remove from preload cache
-        if (app->preloader && app->preload_enabled) {
-            preloader_cache_remove(app->preloader, (const char*)current_link->data);
-        }
-
-        g_free(current_link->data);
-        app->image_files = g_list_delete_link(app->image_files, current_link);
-        app->total_images--;
-        app->preview.selected_link = NULL;
-        app->preview.selected_link_index = -1;
+    // Remove from preload cache
+    if (app->preloader && app->preload_enabled) {
+        preloader_cache_remove(app->preloader, filepath);
+    }
 
-        // Adjust index if necessary
-        if (app->current_index >= app->total_images && app->current_index > 0) {
-            app->current_index--;
-        }
+    // Remove from file list
+    media_index_remove(app->image_files, app->current_index);
+    app->total_images--;
 
-        // Update preload tasks after deletion
-        app_preloader_queue_directory(app);
+    // Adjust index if necessary
+    if (app->current_index >= app->total_images && app->current_index > 0) {
+        app->current_index--;
     }
 
+    // Update preload tasks after deletion
+    app_preloader_queue_directory(app);
+
     app->needs_redraw = TRUE;
     return ERROR_NONE;
 }
@@ -428,10 +656,26 @@ gint app_get_total_images(const PixelTermApp *app) {
 }
 
 const gchar* app_get_current_filepath(const PixelTermApp *app) {
-    GList *current_link = app_get_current_image_link(app);
-    return current_link ? (const gchar*)current_link->data : NULL;
+    if (!app || app->current_index < 0 || app->current_index >= app->total_images) {
+        return NULL;
+    }
+    return media_index_get(app->image_files, app->current_index);
 }
 
 gboolean app_has_images(const PixelTermApp *app) {
-    return app && app->image_files && app->total_images > 0;
+    return app && media_index_length(app->image_files) > 0 && app->total_images > 0;
+}
+
+gboolean app_get_media_meta(const PixelTermApp *app, const gchar *filepath, MediaMeta *out) {
+    if (!filepath || !out) {
+        return FALSE;
+    }
+    MediaMetaStore *store = app ? app->media_meta : NULL;
+    if (media_meta_store_lookup(store, filepath, out)) {
+        return out->kind != MEDIA_KIND_UNKNOWN;
+    }
+    // Unsupported files are recorded too, so they are not probed again
+    gboolean supported = renderer_probe_media(filepath, out) == ERROR_NONE;
+    media_meta_store_put(store, filepath, out);
+    return supported;
 }
@@ -1,57 +1,13 @@
 #include "app.h"
 #include "app_file_manager_internal.h"
+#include "dir_scan.h"
+#include "path_sort.h"
 
 gint app_file_manager_compare_names(gconstpointer a, gconstpointer b) {
-    const gchar *path_a = (const gchar*)a;
-    const gchar *path_b = (const gchar*)b;
-    if (!path_a || !path_b) {
-        return path_a ? 1 : (path_b ? -1 : 0);
-    }
-
     // Compare basenames using an AaBb… ordering: uppercase letters first,
     // then lowercase letters of the same alphabet, while still sorting by
     // alphabetical order within each case group.
-    gchar *base_a = g_path_get_basename(path_a);
-    gchar *base_b = g_path_get_basename(path_b);
-
-    const gchar *pa = base_a;
-    const gchar *pb = base_b;
-    while (*pa && *pb) {
-        gboolean a_is_alpha = g_ascii_isalpha(*pa);
-        gboolean b_is_alpha = g_ascii_isalpha(*pb);
-
-        gint weight_a;
-        gint weight_b;
-
-        if (a_is_alpha) {
-            weight_a = (g_ascii_tolower(*pa) - 'a') * 2 + (g_ascii_isupper(*pa) ? 0 : 1);
-        } else {
-            weight_a = 1000 + (guchar)(*pa); // Non-letters sort after letters
-        }
-
-        if (b_is_alpha) {
-            weight_b = (g_ascii_tolower(*pb) - 'a') * 2 + (g_ascii_isupper(*pb) ? 0 : 1);
-        } else {
-            weight_b = 1000 + (guchar)(*pb);
-        }
-
-        if (weight_a != weight_b) {
-            gint diff = weight_a - weight_b;
-            g_free(base_a);
-            g_free(base_b);
-            return diff;
-        }
-
-        pa++;
-        pb++;
-    }
-
-    // All compared characters matched; shorter string wins
-    gint result = (gint)(*pa) - (gint)(*pb);
-
-    g_free(base_a);
-    g_free(base_b);
-    return result;
+    return path_sort_compare((const gchar*)a, (const gchar*)b, FALSE);
 }
 
 // Hide system-like entries that start with special prefixes (e.g., $RECYCLE.BIN)
@@ -62,74 +18,25 @@ static gboolean app_file_manager_is_special_entry(const gchar *name) {
     return name[0] == '$';
 }
 
-void app_file_manager_invalidate_selection_cache(PixelTermApp *app) {
-    if (!app) {
-        return;
-    }
-    app->file_manager.selected_link = NULL;
-    app->file_manager.selected_link_index = -1;
-}
-
-GList* app_file_manager_find_link_with_hint(const PixelTermApp *app,
-                                            gint target_index,
-                                            GList *hint_link,
-                                            gint hint_index) {
-    if (!app || !app->file_manager.entries || target_index < 0) {
-        return NULL;
-    }
-    if (app->file_manager.entries_count > 0 && target_index >= app->file_manager.entries_count) {
+const gchar* app_file_manager_get_selected_path(const PixelTermApp *app) {
+    if (!app || !app->file_manager.entries || app->file_manager.selected_entry < 0 ||
+        (guint)app->file_manager.selected_entry >= app->file_manager.entries->len) {
         return NULL;
     }
-
-    GList *cursor = hint_link;
-    gint idx = hint_index;
-    if (!cursor || idx < 0) {
-        cursor = app->file_manager.entries;
-        idx = 0;
-    }
-
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    while (cursor && idx > target_index) {
-        cursor = cursor->prev;
-        idx--;
-    }
-    if (cursor && idx == target_index) {
-        return cursor;
-    }
-
-    cursor = app->file_manager.entries;
-    idx = 0;
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    return (cursor && idx == target_index) ? cursor : NULL;
+    return g_ptr_array_index(app->file_manager.entries, app->file_manager.selected_entry);
 }
 
-GList* app_file_manager_get_selected_node(PixelTermApp *app) {
-    if (!app || !app->file_manager.entries || app->file_manager.selected_entry < 0) {
-        return NULL;
-    }
-    if (app->file_manager.entries_count > 0 &&
-        app->file_manager.selected_entry >= app->file_manager.entries_count) {
-        return NULL;
+// Index of the entry whose path is @p path, or -1.
+static gint app_file_manager_index_of(const PixelTermApp *app, const gchar *path) {
+    if (!app->file_manager.entries || !path) {
+        return -1;
     }
-
-    GList *cursor = app_file_manager_find_link_with_hint(app,
-                                                         app->file_manager.selected_entry,
-                                                         app->file_manager.selected_link,
-                                                         app->file_manager.selected_link_index);
-    if (!cursor) {
-        app_file_manager_invalidate_selection_cache(app);
-        return NULL;
+    for (guint i = 0; i < app->file_manager.entries->len; i++) {
+        if (g_strcmp0(g_ptr_array_index(app->file_manager.entries, i), path) == 0) {
+            return (gint)i;
+        }
     }
-
-    app->file_manager.selected_link = cursor;
-    app->file_manager.selected_link_index = app->file_manager.selected_entry;
-    return cursor;
+    return -1;
 }
 
 gchar* app_file_manager_display_name(const PixelTermApp *app, const gchar *entry, gboolean *is_directory) {
@@ -153,8 +60,8 @@ gchar* app_file_manager_display_name(const PixelTermApp *app, const gchar *entry
 
 static gint app_file_manager_max_display_len(const PixelTermApp *app) {
     gint max_len = 0;
-    for (GList *cur = app->file_manager.entries; cur; cur = cur->next) {
-        gchar *entry = (gchar*)cur->data;
+    for (guint i = 0; app->file_manager.entries && i < app->file_manager.entries->len; i++) {
+        const gchar *entry = g_ptr_array_index(app->file_manager.entries, i);
         gboolean is_dir = FALSE;
         gchar *name = app_file_manager_display_name(app, entry, &is_dir);
         if (name) {
@@ -261,15 +168,9 @@ static void app_file_manager_select_current_image(PixelTermApp *app) {
         return;
     }
 
-    gint idx = 0;
-    for (GList *cur = app->file_manager.entries; cur; cur = cur->next, idx++) {
-        gchar *path = (gchar*)cur->data;
-        if (g_strcmp0(path, current_norm) == 0) {
-            app->file_manager.selected_entry = idx;
-            app->file_manager.selected_link = cur;
-            app->file_manager.selected_link_index = idx;
-            break;
-        }
+    gint idx = app_file_manager_index_of(app, current_norm);
+    if (idx >= 0) {
+        app->file_manager.selected_entry = idx;
     }
 
     g_free(current_norm);
@@ -296,29 +197,17 @@ ErrorCode app_file_manager_jump_to_letter(PixelTermApp *app, char letter) {
 
     gchar target = g_ascii_tolower(letter);
     gint start = (app->file_manager.selected_entry + 1) % total_entries;
-    GList *cursor = app_file_manager_find_link_with_hint(app,
-                                                          start,
-                                                          app->file_manager.selected_link,
-                                                          app->file_manager.selected_link_index);
-    if (!cursor) {
-        cursor = app->file_manager.entries;
-    }
-
     gint idx = start;
     for (gint visited = 0; visited < total_entries; visited++) {
-        if (!cursor) {
-            cursor = app->file_manager.entries;
-            idx = 0;
-        }
-        gchar *entry = cursor ? (gchar*)cursor->data : NULL;
+        const gchar *entry = (guint)idx < app->file_manager.entries->len
+                             ? g_ptr_array_index(app->file_manager.entries, idx)
+                             : NULL;
         if (entry) {
             gchar *base = g_path_get_basename(entry);
             if (base && base[0]) {
                 gchar first = g_ascii_tolower(base[0]);
                 if (first == target) {
                     app->file_manager.selected_entry = idx;
-                    app->file_manager.selected_link = cursor;
-                    app->file_manager.selected_link_index = idx;
                     g_free(base);
                     gint col_width = 0, cols = 0, visible_rows = 0, total_rows = 0;
                     app_file_manager_layout(app, total_entries, &col_width, &cols, &visible_rows, &total_rows);
@@ -337,7 +226,6 @@ ErrorCode app_file_manager_jump_to_letter(PixelTermApp *app, char letter) {
             }
             g_free(base);
         }
-        cursor = cursor ? cursor->next : NULL;
         idx++;
         if (idx >= total_entries) {
             idx = 0;
@@ -356,7 +244,6 @@ ErrorCode app_enter_file_manager(PixelTermApp *app) {
 
     (void)app_transition_mode(app, APP_MODE_FILE_MANAGER);
     app->file_manager.selected_entry = 0;
-    app_file_manager_invalidate_selection_cache(app);
     app->file_manager.scroll_offset = 0;
 
     if (app->file_manager.directory) {
@@ -390,12 +277,9 @@ ErrorCode app_exit_file_manager(PixelTermApp *app) {
     app->input.file_manager_click.pending = FALSE;
 
     // Cleanup directory entries
-    if (app->file_manager.entries) {
-        g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
-        app->file_manager.entries = NULL;
-    }
+    g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
     app->file_manager.entries_count = 0;
-    app_file_manager_invalidate_selection_cache(app);
+    app->file_manager.directory_count = 0;
     g_clear_pointer(&app->file_manager.directory, g_free);
 
     // Reset info visibility to ensure proper display
@@ -500,19 +384,13 @@ ErrorCode app_file_manager_left(PixelTermApp *app) {
 
         // Highlight the directory we just came from in the parent listing
         if (err == ERROR_NONE && child_dir) {
-            gint idx = 0;
-            for (GList *cur = app->file_manager.entries; cur; cur = cur->next, idx++) {
-                gchar *path = (gchar*)cur->data;
-                if (g_strcmp0(path, child_dir) == 0) {
-                    app->file_manager.selected_entry = idx;
-                    app->file_manager.selected_link = cur;
-                    app->file_manager.selected_link_index = idx;
-                    // Recalculate scroll to keep selection visible
-                    gint col_width = 0, cols = 0, visible_rows = 0, total_rows = 0;
-                    app_file_manager_layout(app, -1, &col_width, &cols, &visible_rows, &total_rows);
-                    app_file_manager_adjust_scroll(app, -1, cols, visible_rows);
-                    break;
-                }
+            gint idx = app_file_manager_index_of(app, child_dir);
+            if (idx >= 0) {
+                app->file_manager.selected_entry = idx;
+                // Recalculate scroll to keep selection visible
+                gint col_width = 0, cols = 0, visible_rows = 0, total_rows = 0;
+                app_file_manager_layout(app, -1, &col_width, &cols, &visible_rows, &total_rows);
+                app_file_manager_adjust_scroll(app, -1, cols, visible_rows);
             }
         }
 
@@ -552,14 +430,9 @@ ErrorCode app_file_manager_enter(PixelTermApp *app) {
     if (app->file_manager.selected_entry < 0) {
         return ERROR_INVALID_IMAGE;
     }
-    GList *selected_node = app_file_manager_get_selected_node(app);
-    if (!selected_node) {
-        return ERROR_INVALID_IMAGE;
-    }
-
-    gchar *selected_path = (gchar*)selected_node->data;
+    const gchar *selected_path = app_file_manager_get_selected_path(app);
     if (!selected_path) {
-        return ERROR_FILE_NOT_FOUND;
+        return ERROR_INVALID_IMAGE;
     }
 
     // Check if it's a directory
@@ -581,7 +454,6 @@ ErrorCode app_file_manager_enter(PixelTermApp *app) {
         app->file_manager.directory = new_directory;
         // Reset selection to first entry when changing directory
         app->file_manager.selected_entry = 0;
-        app_file_manager_invalidate_selection_cache(app);
         app->file_manager.scroll_offset = 0;
         // Refresh file manager with new directory
         ErrorCode err = app_file_manager_refresh(app);
@@ -601,12 +473,9 @@ ErrorCode app_file_manager_enter(PixelTermApp *app) {
             fflush(stdout);
 
             (void)app_transition_mode(app, APP_MODE_SINGLE);
-            if (app->file_manager.entries) {
-                g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
-                app->file_manager.entries = NULL;
-            }
+            g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
             app->file_manager.entries_count = 0;
-            app_file_manager_invalidate_selection_cache(app);
+            app->file_manager.directory_count = 0;
             g_clear_pointer(&app->file_manager.directory, g_free);
             app->info_visible = FALSE;
             app->needs_redraw = TRUE;
@@ -634,12 +503,9 @@ ErrorCode app_file_manager_enter(PixelTermApp *app) {
             // Exit file manager mode
             (void)app_transition_mode(app, APP_MODE_SINGLE);
             // Cleanup directory entries
-            if (app->file_manager.entries) {
-                g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
-                app->file_manager.entries = NULL;
-            }
+            g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
             app->file_manager.entries_count = 0;
-            app_file_manager_invalidate_selection_cache(app);
+            app->file_manager.directory_count = 0;
             g_clear_pointer(&app->file_manager.directory, g_free);
             // Reset info visibility to ensure proper display
             app->info_visible = FALSE;
@@ -663,8 +529,8 @@ ErrorCode app_file_manager_refresh(PixelTermApp *app) {
 
     gboolean had_entries = app->file_manager.entries != NULL;
     gchar *previous_directory = NULL;
-    if (had_entries && app->file_manager.entries && app->file_manager.entries->data) {
-        gchar *entry_dir = g_path_get_dirname((const gchar *)app->file_manager.entries->data);
+    if (had_entries && app->file_manager.entries->len > 0) {
+        gchar *entry_dir = g_path_get_dirname(g_ptr_array_index(app->file_manager.entries, 0));
         previous_directory = g_canonicalize_filename(entry_dir, NULL);
         g_free(entry_dir);
     } else if (app->file_manager.directory) {
@@ -675,11 +541,7 @@ ErrorCode app_file_manager_refresh(PixelTermApp *app) {
     if (app->return_to_mode == RETURN_MODE_NONE &&
         app->file_manager.entries &&
         app->file_manager.selected_entry >= 0) {
-        GList *selected_node = app_file_manager_get_selected_node(app);
-        gchar *selected_path = selected_node ? (gchar*)selected_node->data : NULL;
-        if (selected_path) {
-            previous_selection = g_strdup(selected_path);
-        }
+        previous_selection = g_strdup(app_file_manager_get_selected_path(app));
     }
 
     // Resolve directory to display: prefer file manager dir, then viewer dir, then cwd
@@ -706,9 +568,9 @@ ErrorCode app_file_manager_refresh(PixelTermApp *app) {
                                   app->return_to_mode == RETURN_MODE_NONE &&
                                   had_entries;
 
-    // Open directory
-    GDir *dir = g_dir_open(current_dir, 0, NULL);
-    if (!dir) {
+    // Read the directory; entry types come from d_type without per-entry stat
+    GArray *dir_entries = NULL;
+    if (dir_scan_read(current_dir, &dir_entries) != ERROR_NONE) {
         if (previous_directory) {
             g_free(app->file_manager.directory);
             app->file_manager.directory = previous_directory;
@@ -722,134 +584,93 @@ ErrorCode app_file_manager_refresh(PixelTermApp *app) {
     g_free(previous_directory);
 
     // Clear existing entries only after the replacement directory is readable.
-    if (app->file_manager.entries) {
-        g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
-        app->file_manager.entries = NULL;
-    }
+    g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
     app->file_manager.entries_count = 0;
-    app_file_manager_invalidate_selection_cache(app);
+    app->file_manager.directory_count = 0;
 
     // Persist canonical directory for consistent rendering/navigation
     g_free(app->file_manager.directory);
     app->file_manager.directory = current_dir;
 
-    // Collect all entries
-    GList *entries = NULL;
-    gint entries_count = 0;
+    // Collect directories and files separately
+    GList *dirs = NULL;
+    GList *files = NULL;
     gchar *parent_entry = NULL;
     gchar *parent_dir = g_path_get_dirname(current_dir);
     if (parent_dir) {
         if (g_strcmp0(parent_dir, current_dir) != 0) {
             parent_entry = g_build_filename(current_dir, "..", NULL);
-            entries = g_list_prepend(entries, parent_entry);
-            entries_count++;
         }
         g_free(parent_dir);
     }
-    const gchar *name;
-
-    // Add directories and files (skip current directory entry if encountered)
-    while ((name = g_dir_read_name(dir)) != NULL) {
-        gchar *full_path = g_build_filename(current_dir, name, NULL);
 
-        if (g_strcmp0(full_path, current_dir) == 0) {
-            g_free(full_path);
-            continue;
-        }
+    for (guint i = 0; i < dir_entries->len; i++) {
+        const DirScanEntry *entry = &g_array_index(dir_entries, DirScanEntry, i);
+        const gchar *name = entry->name;
 
         // Respect hidden-file visibility toggle
         if (!app->show_hidden_files && name[0] == '.') {
-            g_free(full_path);
             continue;
         }
 
         // Skip system-like entries that start with special symbols (e.g., $RECYCLE.BIN)
         if (app_file_manager_is_special_entry(name)) {
-            g_free(full_path);
             continue;
         }
 
-        if (g_file_test(full_path, G_FILE_TEST_IS_DIR) || g_file_test(full_path, G_FILE_TEST_IS_REGULAR)) {
-            entries = g_list_prepend(entries, full_path);  // Order is normalized after sort
-            entries_count++;
+        gchar *full_path = g_build_filename(current_dir, name, NULL);
+        if (entry->type == DIR_SCAN_ENTRY_DIRECTORY) {
+            dirs = g_list_prepend(dirs, full_path);  // Order is normalized after sort
         } else {
-            g_free(full_path);
+            files = g_list_prepend(files, full_path);
         }
     }
 
-    g_dir_close(dir);
+    guint scanned_count = dir_entries->len;
+    dir_scan_entries_free(dir_entries);
 
     // Sort entries: directories first, then files; each group alphabetical
-    GList *dirs = NULL;
-    GList *files = NULL;
-    for (GList *cur = entries; cur != NULL; cur = cur->next) {
-        gchar *path = (gchar*)cur->data;
-        if (g_file_test(path, G_FILE_TEST_IS_DIR)) {
-            dirs = g_list_prepend(dirs, path);
-        } else {
-            files = g_list_prepend(files, path);
-        }
-    }
-    dirs = g_list_sort(dirs, (GCompareFunc)app_file_manager_compare_names);
+    dirs = path_sort_list(dirs, app->natural_sort);
+    files = path_sort_list(files, app->natural_sort);
+    GPtrArray *entries = g_ptr_array_new_full(scanned_count + 1, g_free);
     if (parent_entry) {
-        dirs = g_list_remove(dirs, parent_entry);
-        dirs = g_list_prepend(dirs, parent_entry);
+        g_ptr_array_add(entries, parent_entry);
+    }
+    // The array takes over the strings; only the list cells are freed
+    for (GList *cur = dirs; cur; cur = cur->next) {
+        g_ptr_array_add(entries, cur->data);
     }
-    files = g_list_sort(files, (GCompareFunc)app_file_manager_compare_names);
-    app->file_manager.entries = g_list_concat(dirs, files);
-    g_list_free(entries); // pointers moved into dirs/files concatenated list
-    app->file_manager.entries_count = entries_count;
+    app->file_manager.directory_count = (gint)entries->len;
+    for (GList *cur = files; cur; cur = cur->next) {
+        g_ptr_array_add(entries, cur->data);
+    }
+    g_list_free(dirs);
+    g_list_free(files);
+    app->file_manager.entries = entries;
+    app->file_manager.entries_count = (gint)entries->len;
     app->file_manager.selected_entry = 0;
-    app->file_manager.selected_link = app->file_manager.entries;
-    app->file_manager.selected_link_index = app->file_manager.selected_link ? 0 : -1;
     app->file_manager.scroll_offset = 0;
     app_file_manager_select_current_image(app);
 
     if (preserve_selection && app->file_manager.entries) {
-        gboolean restored = FALSE;
-        if (previous_selection) {
-            gint idx = 0;
-            for (GList *cur = app->file_manager.entries; cur; cur = cur->next, idx++) {
-                gchar *path = (gchar*)cur->data;
-                if (g_strcmp0(path, previous_selection) == 0) {
-                    app->file_manager.selected_entry = idx;
-                    app->file_manager.selected_link = cur;
-                    app->file_manager.selected_link_index = idx;
-                    restored = TRUE;
-                    break;
-                }
-            }
-        }
-
-        if (!restored) {
-            gint target_index = CLAMP(previous_selected_entry, 0, app->file_manager.entries_count - 1);
-            GList *target_node = app_file_manager_find_link_with_hint(app,
-                                                                      target_index,
-                                                                      app->file_manager.selected_link,
-                                                                      app->file_manager.selected_link_index);
-            if (target_node) {
-                app->file_manager.selected_entry = target_index;
-                app->file_manager.selected_link = target_node;
-                app->file_manager.selected_link_index = target_index;
-            }
+        gint idx = app_file_manager_index_of(app, previous_selection);
+        if (idx >= 0) {
+            app->file_manager.selected_entry = idx;
+        } else if (app->file_manager.entries_count > 0) {
+            app->file_manager.selected_entry = CLAMP(previous_selected_entry, 0, app->file_manager.entries_count - 1);
         }
     }
 
     g_free(previous_selection);
 
     // Default: avoid selecting ".." when entering a directory; pick the first real entry.
-    if (!preserve_selection && app->file_manager.entries && app->file_manager.selected_entry == 0) {
-        const gchar *first = (const gchar*)app->file_manager.entries->data;
-        if (first && app->file_manager.entries->next) {
-            gchar *base = g_path_get_basename(first);
-            gboolean is_parent = (base && g_strcmp0(base, "..") == 0);
-            g_free(base);
-            if (is_parent) {
-                app->file_manager.selected_entry = 1;
-                app->file_manager.selected_link = app->file_manager.entries->next;
-                app->file_manager.selected_link_index = app->file_manager.selected_link ? 1 : -1;
-            }
+    if (!preserve_selection && app->file_manager.selected_entry == 0 &&
+        app->file_manager.entries_count > 1) {
+        gchar *base = g_path_get_basename(g_ptr_array_index(app->file_manager.entries, 0));
+        if (base && g_strcmp0(base, "..") == 0) {
+            app->file_manager.selected_entry = 1;
         }
+        g_free(base);
     }
 
     if (preserve_selection && app->file_manager.entries) {
@@ -864,6 +685,114 @@ ErrorCode app_file_manager_refresh(PixelTermApp *app) {
     return ERROR_NONE;
 }
 
+// First position in [start, end) whose path does not sort before @p path.
+static gint app_file_manager_lower_bound(const PixelTermApp *app, gint start, gint end, const gchar *path) {
+    while (start < end) {
+        gint mid = start + (end - start) / 2;
+        if (path_sort_compare(g_ptr_array_index(app->file_manager.entries, mid), path, app->natural_sort) < 0) {
+            start = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return start;
+}
+
+// First entry after "..", which always sorts first.
+static gint app_file_manager_first_named(const PixelTermApp *app) {
+    const GPtrArray *entries = app->file_manager.entries;
+    return entries && entries->len > 0 &&
+           g_str_has_suffix(g_ptr_array_index(entries, 0), G_DIR_SEPARATOR_S "..") ? 1 : 0;
+}
+
+// Finds @p path with a binary search in the directory or file section.
+static gint app_file_manager_find_entry(const PixelTermApp *app, const gchar *path, gboolean is_directory) {
+    const FileManagerState *fm = &app->file_manager;
+    if (!fm->entries) {
+        return -1;
+    }
+    gint start = is_directory ? app_file_manager_first_named(app) : fm->directory_count;
+    gint end = is_directory ? fm->directory_count : (gint)fm->entries->len;
+    gint idx = app_file_manager_lower_bound(app, start, end, path);
+    if (idx < end && strcmp(g_ptr_array_index(fm->entries, idx), path) == 0) {
+        return idx;
+    }
+    return -1;
+}
+
+gboolean app_file_manager_apply_change(PixelTermApp *app, const DirWatchEvent *event) {
+    if (!app || !event || !event->name || !app_is_file_manager_mode(app) || !app->file_manager.directory) {
+        return FALSE;
+    }
+    // Same filters as a full refresh
+    if ((!app->show_hidden_files && event->name[0] == '.') ||
+        app_file_manager_is_special_entry(event->name)) {
+        return FALSE;
+    }
+
+    FileManagerState *fm = &app->file_manager;
+    gchar *full_path = g_build_filename(fm->directory, event->name, NULL);
+    gint idx = app_file_manager_find_entry(app, full_path, event->is_directory);
+
+    if (event->type == DIR_WATCH_EVENT_MODIFIED ||
+        (event->type == DIR_WATCH_EVENT_ADDED && idx >= 0)) {
+        // Rewritten or replaced by a rename; sizes are shown next to names,
+        // so the list still needs a repaint
+        g_free(full_path);
+        return idx >= 0;
+    }
+
+    if (event->type == DIR_WATCH_EVENT_REMOVED) {
+        g_free(full_path);
+        if (idx < 0) {
+            return FALSE;
+        }
+        g_ptr_array_remove_index(fm->entries, (guint)idx);
+        fm->entries_count--;
+        if (idx < fm->directory_count) {
+            fm->directory_count--;
+        }
+        // Keep the selection on the same entry; if it was the one removed,
+        // the entry that moved into its slot takes over.
+        if (idx < fm->selected_entry) {
+            fm->selected_entry--;
+        }
+        fm->selected_entry = CLAMP(fm->selected_entry, 0, MAX(fm->entries_count - 1, 0));
+    } else if (event->type == DIR_WATCH_EVENT_ADDED) {
+        if (!fm->entries) {
+            fm->entries = g_ptr_array_new_with_free_func(g_free);
+        }
+        // Directories sort after "..", files after every directory
+        gint start = event->is_directory ? app_file_manager_first_named(app) : fm->directory_count;
+        gint end = event->is_directory ? fm->directory_count : fm->entries_count;
+        gint pos = app_file_manager_lower_bound(app, start, end, full_path);
+        g_ptr_array_insert(fm->entries, pos, full_path);
+        fm->entries_count++;
+        if (event->is_directory) {
+            fm->directory_count++;
+        }
+        if (pos <= fm->selected_entry && fm->entries_count > 1) {
+            fm->selected_entry++;
+        }
+    } else {
+        g_free(full_path);
+        return FALSE;
+    }
+
+    if (fm->entries_count > 0) {
+        gint col_width = 0;
+        gint cols = 0;
+        gint visible_rows = 0;
+        gint total_rows = 0;
+        app_file_manager_layout(app, -1, &col_width, &cols, &visible_rows, &total_rows);
+        app_file_manager_adjust_scroll(app, -1, cols, visible_rows);
+    } else {
+        fm->selected_entry = 0;
+        fm->scroll_offset = 0;
+    }
+    return TRUE;
+}
+
 ErrorCode app_file_manager_select_path(PixelTermApp *app, const char *path) {
     if (!app) {
         return ERROR_MEMORY_ALLOC;
@@ -880,23 +809,13 @@ ErrorCode app_file_manager_select_path(PixelTermApp *app, const char *path) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    gboolean found = FALSE;
-    gint idx = 0;
-    for (GList *cur = app->file_manager.entries; cur; cur = cur->next, idx++) {
-        gchar *entry = (gchar*)cur->data;
-        if (g_strcmp0(entry, target) == 0) {
-            app->file_manager.selected_entry = idx;
-            app->file_manager.selected_link = cur;
-            app->file_manager.selected_link_index = idx;
-            found = TRUE;
-            break;
-        }
-    }
+    gint idx = app_file_manager_index_of(app, target);
     g_free(target);
 
-    if (!found) {
+    if (idx < 0) {
         return ERROR_FILE_NOT_FOUND;
     }
+    app->file_manager.selected_entry = idx;
 
     gint col_width = 0, cols = 0, visible_rows = 0, total_rows = 0;
     app_file_manager_layout(app, -1, &col_width, &cols, &visible_rows, &total_rows);
@@ -911,8 +830,8 @@ gboolean app_file_manager_has_images(PixelTermApp *app) {
     }
 
     // Check if any entry in the current directory listing is an image file
-    for (GList *cur = app->file_manager.entries; cur; cur = cur->next) {
-        gchar *path = (gchar*)cur->data;
+    for (guint i = (guint)app->file_manager.directory_count; i < app->file_manager.entries->len; i++) {
+        const gchar *path = g_ptr_array_index(app->file_manager.entries, i);
         if (g_file_test(path, G_FILE_TEST_IS_REGULAR) && is_valid_media_file(path)) {
             return TRUE;
         }
@@ -931,8 +850,7 @@ gboolean app_file_manager_selection_is_image(PixelTermApp *app) {
         return FALSE;
     }
 
-    GList *node = app_file_manager_get_selected_node(app);
-    gchar *path = node ? (gchar*)node->data : NULL;
+    const gchar *path = app_file_manager_get_selected_path(app);
     if (!path) {
         return FALSE;
     }
@@ -950,22 +868,13 @@ gint app_file_manager_get_selected_image_index(PixelTermApp *app) {
         return -1;
     }
 
-    GList *selected_node = app_file_manager_get_selected_node(app);
-    gchar *selected_path = selected_node ? (gchar*)selected_node->data : NULL;
+    const gchar *selected_path = app_file_manager_get_selected_path(app);
     if (!selected_path) {
         return -1;
     }
 
     // Find the index of this file in the image list
-    gint image_index = 0;
-    for (GList *cur = app->image_files; cur; cur = cur->next, image_index++) {
-        const gchar *image_path = (const gchar*)cur->data;
-        if (g_strcmp0(selected_path, image_path) == 0) {
-            return image_index;
-        }
-    }
-
-    return -1; // Not found
+    return media_index_find_path(app->image_files, selected_path);
 }
 
 // Toggle hidden files visibility while preserving selection when possible
@@ -981,11 +890,7 @@ ErrorCode app_file_manager_toggle_hidden(PixelTermApp *app) {
     gchar *prev_selected = NULL;
     gint prev_selected_entry = app->file_manager.selected_entry;
     if (app->file_manager.selected_entry >= 0 && app->file_manager.entries) {
-        GList *node = app_file_manager_get_selected_node(app);
-        gchar *path = node ? (gchar*)node->data : NULL;
-        if (path) {
-            prev_selected = g_strdup(path);
-        }
+        prev_selected = g_strdup(app_file_manager_get_selected_path(app));
     }
 
     app->show_hidden_files = !app->show_hidden_files;
@@ -996,33 +901,12 @@ ErrorCode app_file_manager_toggle_hidden(PixelTermApp *app) {
     }
 
     // Restore selection to the same path if still visible
-    gboolean restored = FALSE;
-    if (prev_selected) {
-        gint idx = 0;
-        for (GList *cur = app->file_manager.entries; cur; cur = cur->next, idx++) {
-            gchar *path = (gchar*)cur->data;
-            if (g_strcmp0(path, prev_selected) == 0) {
-                app->file_manager.selected_entry = idx;
-                app->file_manager.selected_link = cur;
-                app->file_manager.selected_link_index = idx;
-                restored = TRUE;
-                break;
-            }
-        }
-        g_free(prev_selected);
-    }
-
-    if (!restored && app->file_manager.entries_count > 0) {
-        gint target_index = CLAMP(prev_selected_entry, 0, app->file_manager.entries_count - 1);
-        GList *target_node = app_file_manager_find_link_with_hint(app,
-                                                                  target_index,
-                                                                  app->file_manager.selected_link,
-                                                                  app->file_manager.selected_link_index);
-        if (target_node) {
-            app->file_manager.selected_entry = target_index;
-            app->file_manager.selected_link = target_node;
-            app->file_manager.selected_link_index = target_index;
-        }
+    gint idx = app_file_manager_index_of(app, prev_selected);
+    g_free(prev_selected);
+    if (idx >= 0) {
+        app->file_manager.selected_entry = idx;
+    } else if (app->file_manager.entries_count > 0) {
+        app->file_manager.selected_entry = CLAMP(prev_selected_entry, 0, app->file_manager.entries_count - 1);
     }
 
     // Ensure scroll offset keeps selection visible
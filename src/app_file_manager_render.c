@@ -287,7 +287,6 @@ ErrorCode app_handle_mouse_file_manager(PixelTermApp *app, gint mouse_x, gint mo
     }
 
     app->file_manager.selected_entry = hit_index;
-    app_file_manager_invalidate_selection_cache(app);
 
     gint col_width = 0, cols = 0, visible_rows = 0, total_rows = 0;
     app_file_manager_layout(app, -1, &col_width, &cols, &visible_rows, &total_rows);
@@ -312,12 +311,10 @@ ErrorCode app_file_manager_enter_at_position(PixelTermApp *app, gint mouse_x, gi
     gint prev_selected = app->file_manager.selected_entry;
     gint prev_scroll = app->file_manager.scroll_offset;
     app->file_manager.selected_entry = hit_index;
-    app_file_manager_invalidate_selection_cache(app);
     ErrorCode err = app_file_manager_enter(app);
 
     if (err != ERROR_NONE && app_is_file_manager_mode(app)) {
         app->file_manager.selected_entry = prev_selected;
-        app_file_manager_invalidate_selection_cache(app);
         app->file_manager.scroll_offset = prev_scroll;
     }
 
@@ -337,6 +334,7 @@ ErrorCode app_render_file_manager(PixelTermApp *app) {
 
     // Don't do a full-screen clear on every navigation step; we explicitly clear/redraw
     // the rows we touch to keep movement smooth and avoid extra terminal workarounds.
+    ui_begin_sync_update();
     printf("\033[H\033[0m");
 
     // Get current directory
@@ -435,13 +433,6 @@ ErrorCode app_render_file_manager(PixelTermApp *app) {
         list_bottom_row = list_top_row;
     }
     gint list_visible_rows = list_bottom_row - list_top_row + 1;
-    GList *render_cursor = NULL;
-    if (total_entries > 0 && start_row >= 0) {
-        render_cursor = app_file_manager_find_link_with_hint(app,
-                                                             start_row,
-                                                             app->file_manager.selected_link,
-                                                             app->file_manager.selected_link_index);
-    }
 
     for (gint i = 0; i < list_visible_rows; i++) {
         gint y = list_top_row + i;
@@ -470,10 +461,9 @@ ErrorCode app_render_file_manager(PixelTermApp *app) {
             continue;
         }
 
-        gchar *entry = render_cursor ? (gchar*)render_cursor->data : NULL;
-        if (render_cursor) {
-            render_cursor = render_cursor->next;
-        }
+        const gchar *entry = app->file_manager.entries && (guint)idx < app->file_manager.entries->len
+                             ? g_ptr_array_index(app->file_manager.entries, idx)
+                             : NULL;
         if (!entry) {
             continue;
         }
@@ -575,7 +565,7 @@ ErrorCode app_render_file_manager(PixelTermApp *app) {
     };
     ui_print_centered_help_line(app->term_height, app->term_width, segments, G_N_ELEMENTS(segments));
 
-    fflush(stdout);
+    ui_end_sync_update();
 
     g_free(safe_current_dir);
     if (free_dir) {
@@ -0,0 +1,73 @@
+#include "app.h"
+#include "metrics.h"
+#include "perf_hud.h"
+#include "term_output.h"
+#include "ui_render_utils.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// The HUD sits on the blank row under the title, which every mode but the
+// file manager keeps free; Zen mode gives that row to content.
+static gboolean app_perf_hud_row_available(const PixelTermApp *app) {
+    return app && !app->ui_text_hidden && !app_is_file_manager_mode(app) &&
+           app->term_height >= PERF_HUD_ROW + 1 && app->term_width > 0;
+}
+
+static gboolean app_perf_hud_visible(const PixelTermApp *app) {
+    return app && app->show_fps && app_perf_hud_row_available(app);
+}
+
+void app_render_perf_hud(PixelTermApp *app, gboolean force) {
+    if (!app_perf_hud_visible(app)) {
+        return;
+    }
+    PerfHud *hud = &app->perf_hud;
+    gint64 now_us = g_get_monotonic_time();
+    TermOutputStats stats;
+    term_output_get_stats(&stats);
+    // A repaint clears the row, except video frames, which start below it
+    gboolean repainted = stats.frames != hud->drawn_frames &&
+                         !(app->video_player && video_player_is_playing(app->video_player));
+    gboolean due = now_us - hud->drawn_us >= PERF_HUD_REFRESH_US;
+    if (!force && !repainted && !due) {
+        return;
+    }
+
+    gint64 metrics[METRIC_COUNT];
+    metrics_snapshot(metrics);
+    if (force || due || hud->sample_us == 0) {
+        perf_hud_sample(hud, metrics, now_us);
+    }
+    gchar line[PERF_HUD_LINE_MAX];
+    perf_hud_format(hud, metrics, line, sizeof(line));
+    hud->drawn_us = now_us;
+    hud->drawn_frames = stats.frames;
+    if (!force && !repainted && strcmp(line, hud->drawn_line) == 0) {
+        return;
+    }
+    g_strlcpy(hud->drawn_line, line, sizeof(hud->drawn_line));
+
+    // Written outside any frame so the HUD never counts as the frame it reports
+    printf("\0337");
+    ui_render_centered_row(PERF_HUD_ROW, app->term_width, line, "\033[2m");
+    printf("\0338");
+    fflush(stdout);
+}
+
+void app_clear_perf_hud(PixelTermApp *app) {
+    if (!app_perf_hud_row_available(app)) {
+        return;
+    }
+    app->perf_hud.drawn_line[0] = '\0';
+    printf("\0337\033[%d;1H\033[2K\0338", PERF_HUD_ROW);
+    fflush(stdout);
+}
+
+gint app_perf_hud_timeout_ms(const PixelTermApp *app) {
+    if (!app_perf_hud_visible(app)) {
+        return -1;
+    }
+    gint64 remaining = app->perf_hud.drawn_us + PERF_HUD_REFRESH_US - g_get_monotonic_time();
+    return remaining > 0 ? (gint)((remaining + 999) / 1000) : 0;
+}
@@ -12,8 +12,91 @@ static const gint k_book_spread_gutter_cols = 2;
 typedef struct {
     PixelTermApp *app;
     ImageRenderer *renderer;
+    // Thumbnails rasterized up front in parallel, one slot per page from first_index.
+    gint first_index;
+    gint page_count;
+    gint thumb_width;
+    gint thumb_height;
+    gint thumb_stride;
+    guint8 *thumb_pixels;
+    gint *thumb_widths;
+    gint *thumb_heights;
+    ErrorCode *thumb_errors;
 } BookPreviewRenderContext;
 
+static void app_book_preview_rasterize_visible(BookPreviewRenderContext *render_ctx,
+                                               const GridRenderContext *context) {
+    gint cols = context->layout->cols;
+    gint first = context->start_row * cols;
+    gint last = MIN(context->end_row * cols, context->total_items);
+    if (first < 0 || last <= first) {
+        return;
+    }
+
+    gint count = last - first;
+    // Zooming redraws these same pages, so their display lists must all stay cached
+    book_set_visible_pages(render_ctx->app->book.doc, count);
+    book_get_thumbnail_size(context->content_width,
+                            context->content_height,
+                            &render_ctx->thumb_width,
+                            &render_ctx->thumb_height);
+    render_ctx->thumb_stride = render_ctx->thumb_width * BOOK_THUMBNAIL_CHANNELS;
+    gsize slot_bytes = (gsize)render_ctx->thumb_stride * (gsize)render_ctx->thumb_height;
+    render_ctx->thumb_pixels = g_try_malloc(slot_bytes * (gsize)count);
+    if (!render_ctx->thumb_pixels) {
+        return;
+    }
+
+    gint *indices = g_new(gint, count);
+    for (gint i = 0; i < count; i++) {
+        indices[i] = first + i;
+    }
+    render_ctx->thumb_widths = g_new0(gint, count);
+    render_ctx->thumb_heights = g_new0(gint, count);
+    render_ctx->thumb_errors = g_new0(ErrorCode, count);
+    render_ctx->first_index = first;
+    render_ctx->page_count = count;
+    book_render_thumbnails(render_ctx->app->book.doc,
+                           indices,
+                           count,
+                           render_ctx->thumb_width,
+                           render_ctx->thumb_height,
+                           render_ctx->thumb_pixels,
+                           render_ctx->thumb_stride,
+                           render_ctx->thumb_widths,
+                           render_ctx->thumb_heights,
+                           render_ctx->thumb_errors);
+    g_free(indices);
+}
+
+static void app_book_preview_release_visible(BookPreviewRenderContext *render_ctx) {
+    g_clear_pointer(&render_ctx->thumb_pixels, g_free);
+    g_clear_pointer(&render_ctx->thumb_widths, g_free);
+    g_clear_pointer(&render_ctx->thumb_heights, g_free);
+    g_clear_pointer(&render_ctx->thumb_errors, g_free);
+    render_ctx->page_count = 0;
+}
+
+// Points out_image at the page's slot; the pixels stay owned by render_ctx.
+static ErrorCode app_book_preview_get_thumbnail(const BookPreviewRenderContext *render_ctx,
+                                                gint page_index,
+                                                BookPageImage *out_image) {
+    gint slot = page_index - render_ctx->first_index;
+    if (!render_ctx->thumb_pixels || slot < 0 || slot >= render_ctx->page_count) {
+        return ERROR_INVALID_IMAGE;
+    }
+    if (render_ctx->thumb_errors[slot] != ERROR_NONE) {
+        return render_ctx->thumb_errors[slot];
+    }
+    gsize slot_bytes = (gsize)render_ctx->thumb_stride * (gsize)render_ctx->thumb_height;
+    out_image->pixels = render_ctx->thumb_pixels + (gsize)slot * slot_bytes;
+    out_image->width = render_ctx->thumb_widths[slot];
+    out_image->height = render_ctx->thumb_heights[slot];
+    out_image->stride = render_ctx->thumb_stride;
+    out_image->channels = BOOK_THUMBNAIL_CHANNELS;
+    return ERROR_NONE;
+}
+
 static GridRenderResult app_book_preview_render_cell(const GridRenderContext *context,
                                                      const GridRenderCell *cell,
                                                      void *userdata) {
@@ -22,8 +105,6 @@ static GridRenderResult app_book_preview_render_cell(const GridRenderContext *co
         return GRID_RENDER_STOP_ALL;
     }
 
-    PixelTermApp *app = render_ctx->app;
-
     app_draw_grid_cell_background(context->layout,
                                   cell->cell_x,
                                   cell->cell_y,
@@ -31,11 +112,7 @@ static GridRenderResult app_book_preview_render_cell(const GridRenderContext *co
                                   "\033[34;1m");
 
     BookPageImage page_image;
-    ErrorCode page_err = book_render_page(app->book.doc,
-                                          cell->index,
-                                          context->content_width,
-                                          context->content_height,
-                                          &page_image);
+    ErrorCode page_err = app_book_preview_get_thumbnail(render_ctx, cell->index, &page_image);
     if (page_err != ERROR_NONE) {
         const char *label = "PAGE";
         gint label_len = (gint)strlen(label);
@@ -53,7 +130,6 @@ static GridRenderResult app_book_preview_render_cell(const GridRenderContext *co
                                                    page_image.height,
                                                    page_image.stride,
                                                    page_image.channels);
-    book_page_image_free(&page_image);
 
     if (!rendered) {
         const char *label = "PAGE";
@@ -790,6 +866,7 @@ ErrorCode app_render_book_preview(PixelTermApp *app) {
     PreviewLayout layout = app_book_preview_calculate_layout(app);
     app_book_preview_adjust_scroll(app, &layout);
 
+    ui_begin_sync_update();
     if (app->suppress_full_clear) {
         app->suppress_full_clear = FALSE;
         printf("\033[H\033[0m");
@@ -823,6 +900,7 @@ ErrorCode app_render_book_preview(PixelTermApp *app) {
     ErrorCode renderer_error = ERROR_NONE;
     ImageRenderer *renderer = app_create_grid_renderer(app, content_width, content_height, &renderer_error);
     if (!renderer) {
+        ui_end_sync_update();
         return renderer_error != ERROR_NONE ? renderer_error : ERROR_MEMORY_ALLOC;
     }
 
@@ -843,7 +921,9 @@ ErrorCode app_render_book_preview(PixelTermApp *app) {
         .app = app,
         .renderer = renderer
     };
+    app_book_preview_rasterize_visible(&render_ctx, &grid_context);
     grid_render_cells(&grid_context, app_book_preview_render_cell, &render_ctx);
+    app_book_preview_release_visible(&render_ctx);
 
     app_book_preview_render_selected_info(app);
     if (app->book.jump_active) {
@@ -866,7 +946,7 @@ ErrorCode app_render_book_preview(PixelTermApp *app) {
         ui_print_centered_help_line(app->term_height, app->term_width, segments, G_N_ELEMENTS(segments));
     }
 
-    fflush(stdout);
+    ui_end_sync_update();
     renderer_destroy(renderer);
     return ERROR_NONE;
 }
@@ -899,6 +979,7 @@ ErrorCode app_render_book_preview_selection_change(PixelTermApp *app, gint old_i
     gint end_row = MIN(layout.rows, start_row + layout.visible_rows);
     gint vertical_offset = app_preview_compute_vertical_offset(app, &layout, start_row, end_row);
 
+    ui_begin_sync_update();
     if (old_index != app->book.preview_selected) {
         app_book_preview_clear_cell_border(app, &layout, old_index, start_row, vertical_offset);
     }
@@ -909,6 +990,6 @@ ErrorCode app_render_book_preview_selection_change(PixelTermApp *app, gint old_i
         app_book_jump_render_prompt(app);
     }
 
-    fflush(stdout);
+    ui_end_sync_update();
     return ERROR_NONE;
 }
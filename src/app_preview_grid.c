@@ -139,70 +139,12 @@ static void app_preview_adjust_scroll(PixelTermApp *app, const PreviewLayout *la
     app->preview.scroll = app_preview_page_scroll_for_row(layout, row);
 }
 
-static GList* app_preview_find_link_with_hint(const PixelTermApp *app,
-                                              gint target_index,
-                                              GList *hint_link,
-                                              gint hint_index) {
-    if (!app || !app->image_files || target_index < 0) {
-        return NULL;
-    }
-    if (app->total_images > 0 && target_index >= app->total_images) {
-        return NULL;
-    }
-
-    GList *cursor = hint_link;
-    gint idx = hint_index;
-    if (!cursor || idx < 0) {
-        cursor = app->image_files;
-        idx = 0;
-    }
-
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    while (cursor && idx > target_index) {
-        cursor = cursor->prev;
-        idx--;
-    }
-    if (cursor && idx == target_index) {
-        return cursor;
-    }
-
-    cursor = app->image_files;
-    idx = 0;
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    return (cursor && idx == target_index) ? cursor : NULL;
-}
-
 static void app_preview_set_selected_index(PixelTermApp *app, gint index) {
     if (!app) {
         return;
     }
 
     app->preview.selected = index;
-
-    if (!app->image_files || index < 0 || (app->total_images > 0 && index >= app->total_images)) {
-        app->preview.selected_link = NULL;
-        app->preview.selected_link_index = -1;
-        return;
-    }
-
-    GList *cursor = app_preview_find_link_with_hint(app,
-                                                    index,
-                                                    app->preview.selected_link,
-                                                    app->preview.selected_link_index);
-    if (!cursor) {
-        app->preview.selected_link = NULL;
-        app->preview.selected_link_index = -1;
-        return;
-    }
-
-    app->preview.selected_link = cursor;
-    app->preview.selected_link_index = index;
 }
 
 static void app_preview_normalize_state(PixelTermApp *app, const PreviewLayout *layout) {
@@ -218,8 +160,7 @@ static void app_preview_normalize_state(PixelTermApp *app, const PreviewLayout *
         normalized_index = app->total_images - 1;
     }
 
-    if (normalized_index != app->preview.selected ||
-        app->preview.selected_link_index != normalized_index) {
+    if (normalized_index != app->preview.selected) {
         app_preview_set_selected_index(app, normalized_index);
     }
 
@@ -239,51 +180,27 @@ static void app_preview_queue_preloads(PixelTermApp *app, const PreviewLayout *l
     gint start_row = MAX(0, app->preview.scroll - 1);
     gint end_row = MIN(layout->rows, app->preview.scroll + layout->visible_rows + 1);
     gint start_index = start_row * layout->cols;
-    GList *cursor = app_preview_find_link_with_hint(app,
-                                                    start_index,
-                                                    app->preview.selected_link,
-                                                    app->preview.selected_link_index);
-
-    for (gint row = start_row; row < end_row && cursor; row++) {
-        for (gint col = 0; col < layout->cols && cursor; col++) {
-            gint idx = row * layout->cols + col;
-            if (idx >= app->total_images) {
-                cursor = NULL;
-                break;
-            }
-            const gchar *filepath = (const gchar*)cursor->data;
-            gint distance = ABS(idx - app->preview.selected);
-            gint priority = (distance == 0) ? 0 : (distance <= layout->cols ? 1 : 5 + distance);
-            preloader_add_task(app->preloader, filepath, priority, content_width, content_height);
-            cursor = cursor->next;
+    gint end_index = MIN(app->total_images, end_row * layout->cols);
+
+    for (gint idx = start_index; idx < end_index; idx++) {
+        const gchar *filepath = media_index_get(app->image_files, idx);
+        if (!filepath) {
+            break;
         }
+        gint distance = ABS(idx - app->preview.selected);
+        gint priority = (distance == 0) ? 0 : (distance <= layout->cols ? 1 : 5 + distance);
+        preloader_add_task(app->preloader, filepath, priority, content_width, content_height);
     }
 }
 
-static GList* app_preview_get_selected_link(PixelTermApp *app) {
-    if (!app || !app->image_files || app->preview.selected < 0) {
+const gchar *app_preview_get_selected_filepath(PixelTermApp *app) {
+    if (!app || app->preview.selected < 0) {
         return NULL;
     }
     if (app->total_images > 0 && app->preview.selected >= app->total_images) {
         return NULL;
     }
-    GList *cursor = app_preview_find_link_with_hint(app,
-                                                    app->preview.selected,
-                                                    app->preview.selected_link,
-                                                    app->preview.selected_link_index);
-    if (!cursor) {
-        app->preview.selected_link = NULL;
-        app->preview.selected_link_index = -1;
-        return NULL;
-    }
-    app->preview.selected_link = cursor;
-    app->preview.selected_link_index = app->preview.selected;
-    return cursor;
-}
-
-const gchar *app_preview_get_selected_filepath(PixelTermApp *app) {
-    GList *selected_link = app_preview_get_selected_link(app);
-    return selected_link ? (const gchar *)selected_link->data : NULL;
+    return media_index_get(app->image_files, app->preview.selected);
 }
 
 // Move selection inside preview grid
@@ -543,36 +460,27 @@ ErrorCode app_enter_preview(PixelTermApp *app) {
         return ERROR_INVALID_IMAGE;
     }
 
-    // Filter out invalid images before entering preview mode
-    GList *valid_images = NULL;
+    // Filter out invalid images before entering preview mode; appending in
+    // order keeps the copy sorted
+    MediaIndex *valid_images = media_index_new_relative(media_index_get_root(app->image_files), app->natural_sort);
     gint valid_count = 0;
-    gint new_current_index = app->current_index;
     gint valid_current_index = -1;
 
-    GList *current = app->image_files;
-    gint original_index = 0;
-    while (current) {
-        const gchar *filepath = (const gchar*)current->data;
-        if (is_valid_media_file(filepath)) {
-            valid_images = g_list_append(valid_images, g_strdup(filepath));
+    for (gint original_index = 0; original_index < app->total_images; original_index++) {
+        const gchar *filepath = media_index_get(app->image_files, original_index);
+        MediaMeta meta;
+        if (filepath && app_get_media_meta(app, filepath, &meta)) {
+            media_index_append(valid_images, filepath);
             if (original_index == app->current_index) {
                 valid_current_index = valid_count;
             }
             valid_count++;
         }
-        current = g_list_next(current);
-        original_index++;
     }
 
     // If we found valid images, replace the image list
-    if (valid_images && valid_count > 0) {
-        // Free the old image list
-        if (app->image_files) {
-            g_list_free_full(app->image_files, (GDestroyNotify)g_free);
-            app->preview.selected_link = NULL;
-            app->preview.selected_link_index = -1;
-        }
-
+    if (valid_count > 0) {
+        media_index_free(app->image_files);
         app->image_files = valid_images;
         app->total_images = valid_count;
 
@@ -584,7 +492,7 @@ ErrorCode app_enter_preview(PixelTermApp *app) {
         }
     } else {
         // If no valid images remain, return an error
-        g_list_free_full(valid_images, (GDestroyNotify)g_free);
+        media_index_free(valid_images);
         return ERROR_INVALID_IMAGE;
     }
 
@@ -657,6 +565,10 @@ ErrorCode app_render_preview_grid(PixelTermApp *app) {
     app_preview_normalize_state(app, &layout);
     app_preview_queue_preloads(app, &layout);
 
+    ui_begin_sync_update();
+    // Cells place their images again; drop the old placements first so
+    // they do not stack up
+    ui_clear_kitty_images(app);
     if (app->needs_screen_clear) {
         // Inside preview mode, prefer a normal clear to avoid extra terminal work.
         printf("\033[2J\033[H\033[0m"); // Clear screen and move cursor to top-left
@@ -673,6 +585,7 @@ ErrorCode app_render_preview_grid(PixelTermApp *app) {
     ErrorCode renderer_error = ERROR_NONE;
     ImageRenderer *renderer = app_create_grid_renderer(app, content_width, content_height, &renderer_error);
     if (!renderer) {
+        ui_end_sync_update();
         return renderer_error != ERROR_NONE ? renderer_error : ERROR_MEMORY_ALLOC;
     }
 
@@ -694,11 +607,6 @@ ErrorCode app_render_preview_grid(PixelTermApp *app) {
     gint start_row = app->preview.scroll;
     gint end_row = MIN(layout.rows, start_row + layout.visible_rows);
     gint vertical_offset = app_preview_compute_vertical_offset(app, &layout, start_row, end_row);
-    gint start_index = start_row * layout.cols;
-    GList *cursor = app_preview_find_link_with_hint(app,
-                                                    start_index,
-                                                    app->preview.selected_link,
-                                                    app->preview.selected_link_index);
     GridRenderContext grid_context = {
         .layout = &layout,
         .start_row = start_row,
@@ -709,7 +617,7 @@ ErrorCode app_render_preview_grid(PixelTermApp *app) {
         .total_items = app->total_images,
         .selected_index = app->preview.selected
     };
-    app_preview_render_cells(&grid_context, app, renderer, cursor);
+    app_preview_render_cells(&grid_context, app, renderer);
 
     app_preview_render_selected_filename(app);
 
@@ -729,7 +637,7 @@ ErrorCode app_render_preview_grid(PixelTermApp *app) {
         ui_print_centered_help_line(app->term_height, app->term_width, segments, G_N_ELEMENTS(segments));
     }
 
-    fflush(stdout);
+    ui_end_sync_update();
     renderer_destroy(renderer);
     return ERROR_NONE;
 }
@@ -764,6 +672,7 @@ ErrorCode app_render_preview_selection_change(PixelTermApp *app, gint old_index)
     gint end_row = MIN(layout.rows, start_row + layout.visible_rows);
     gint vertical_offset = app_preview_compute_vertical_offset(app, &layout, start_row, end_row);
 
+    ui_begin_sync_update();
     if (old_index != app->preview.selected) {
         app_preview_clear_cell_border(app, &layout, old_index, start_row, vertical_offset);
     }
@@ -771,6 +680,5 @@ ErrorCode app_render_preview_selection_change(PixelTermApp *app, gint old_index)
     app_preview_render_selected_filename(app);
 
     ui_end_sync_update();
-    fflush(stdout);
     return ERROR_NONE;
 }
@@ -1,6 +1,7 @@
 #include "app_preview_render_internal.h"
 
 #include "app_preview_shared_internal.h"
+#include "kitty_registry.h"
 #include "media_utils.h"
 #include "preloader.h"
 #include "text_utils.h"
@@ -12,7 +13,6 @@
 typedef struct {
     PixelTermApp *app;
     ImageRenderer *renderer;
-    GList *cursor;
 } PreviewGridRenderContext;
 
 static GridRenderResult app_preview_render_cell(const GridRenderContext *context,
@@ -23,19 +23,15 @@ static GridRenderResult app_preview_render_cell(const GridRenderContext *context
         return GRID_RENDER_STOP_ALL;
     }
 
-    if (!render_ctx->cursor) {
-        return GRID_RENDER_STOP_ALL;
-    }
-
     PixelTermApp *app = render_ctx->app;
-    const gchar *filepath = (const gchar*)render_ctx->cursor->data;
-    render_ctx->cursor = render_ctx->cursor->next;
+    const gchar *filepath = media_index_get(app->image_files, cell->index);
     if (!filepath) {
-        return GRID_RENDER_STOP_ROW;
+        return GRID_RENDER_STOP_ALL;
     }
 
-    MediaKind media_kind = media_classify(filepath);
-    gboolean is_video = media_is_video(media_kind);
+    // The cell's kind comes from the metadata cache instead of re-sniffing
+    MediaMeta meta;
+    gboolean is_video = app_get_media_meta(app, filepath, &meta) && media_is_video(meta.kind);
 
     const char *border_style =
         (app->return_to_mode == RETURN_MODE_PREVIEW_VIRTUAL) ? "\033[33;1m" : "\033[34;1m";
@@ -45,6 +41,32 @@ static GridRenderResult app_preview_render_cell(const GridRenderContext *context
                                   cell->use_border,
                                   border_style);
 
+    // An image already resident in the terminal is only placed again
+    gboolean use_kitty_images = app->kitty_images && !app->help_visible;
+    if (use_kitty_images) {
+        GString *placement = g_string_new(NULL);
+        gint placed_w = 0;
+        gint placed_h = 0;
+        if (kitty_registry_place(app->kitty_images,
+                                 filepath,
+                                 context->content_width,
+                                 context->content_height,
+                                 placement,
+                                 &placed_w,
+                                 &placed_h)) {
+            app_draw_rendered_graphics(cell->content_x,
+                                       cell->content_y,
+                                       context->content_width,
+                                       context->content_height,
+                                       placed_w,
+                                       placed_h,
+                                       placement);
+            g_string_free(placement, TRUE);
+            return GRID_RENDER_CONTINUE;
+        }
+        g_string_free(placement, TRUE);
+    }
+
     gboolean rendered_from_preload = FALSE;
     gboolean rendered_owned = FALSE;
     GString *rendered = NULL;
@@ -125,6 +147,22 @@ static GridRenderResult app_preview_render_cell(const GridRenderContext *context
                             context->content_height);
     }
 
+    GString *tagged = NULL;
+    if (use_kitty_images && graphics_mode) {
+        tagged = g_string_new(NULL);
+        if (!kitty_registry_transmit(app->kitty_images,
+                                     filepath,
+                                     context->content_width,
+                                     context->content_height,
+                                     rendered_w,
+                                     rendered_h,
+                                     rendered,
+                                     tagged)) {
+            g_string_free(tagged, TRUE);
+            tagged = NULL;
+        }
+    }
+
     app_draw_preview_content(cell->content_x,
                              cell->content_y,
                              context->content_width,
@@ -132,7 +170,10 @@ static GridRenderResult app_preview_render_cell(const GridRenderContext *context
                              rendered_w,
                              rendered_h,
                              graphics_mode,
-                             rendered);
+                             tagged ? tagged : rendered);
+    if (tagged) {
+        g_string_free(tagged, TRUE);
+    }
     if (rendered_owned) {
         g_string_free(rendered, TRUE);
     }
@@ -142,16 +183,14 @@ static GridRenderResult app_preview_render_cell(const GridRenderContext *context
 
 void app_preview_render_cells(const GridRenderContext *context,
                               PixelTermApp *app,
-                              ImageRenderer *renderer,
-                              GList *cursor) {
+                              ImageRenderer *renderer) {
     if (!context || !app || !renderer) {
         return;
     }
 
     PreviewGridRenderContext render_ctx = {
         .app = app,
-        .renderer = renderer,
-        .cursor = cursor
+        .renderer = renderer
     };
     grid_render_cells(context, app_preview_render_cell, &render_ctx);
 }
@@ -250,9 +289,10 @@ ErrorCode app_preview_print_info(PixelTermApp *app) {
     gchar *dirname = g_path_get_dirname(filepath);
     gchar *safe_basename = sanitize_for_terminal(basename);
     gchar *safe_dirname = sanitize_for_terminal(dirname);
-    gint width = 0;
-    gint height = 0;
-    renderer_get_media_dimensions(filepath, &width, &height);
+    MediaMeta meta;
+    gboolean have_meta = app_get_media_meta(app, filepath, &meta);
+    gint width = have_meta ? meta.width : 0;
+    gint height = have_meta ? meta.height : 0;
     gint64 file_size = get_file_size(filepath);
     gdouble file_size_mb = file_size > 0 ? file_size / (1024.0 * 1024.0) : 0.0;
     const char *ext = get_file_extension(filepath);
@@ -6,7 +6,8 @@
 #include "text_utils.h"
 #include "preload_control.h"
 #include "grid_render.h"
-#include "pixbuf_utils.h"
+#include "image_zoom.h"
+#include "kitty_registry.h"
 #include "app_single_render_internal.h"
 #include "app_single_render_test_internal.h"
 #include "ui_render_utils.h"
@@ -45,6 +46,31 @@ static void app_queue_async_render(PixelTermApp *app, const gchar *filepath,
     }
 }
 
+static void app_render_single_index_row(PixelTermApp *app) {
+    gint current = app_get_current_index(app) + 1;
+    gint total = app_get_total_images(app);
+    if (current < 1) current = 1;
+    if (total < 1) total = 1;
+    char idx_text[32];
+    g_snprintf(idx_text, sizeof(idx_text), "%d/%d", current, total);
+    ui_render_centered_row(3, app->term_width, idx_text, NULL);
+}
+
+void app_render_single_index_line(PixelTermApp *app) {
+    if (!app || !app_is_single_mode(app) || app->ui_text_hidden || app->help_visible ||
+        app->term_height < 3) {
+        return;
+    }
+
+    // Only the counter row changes while a directory scan is still running.
+    ui_begin_sync_update();
+    printf("\0337");
+    app_render_single_index_row(app);
+    printf("\0338");
+    ui_end_sync_update();
+    fflush(stdout);
+}
+
 static void app_render_single_placeholder(PixelTermApp *app, const gchar *filepath) {
     if (!app || !filepath || app->ui_text_hidden) {
         return;
@@ -57,13 +83,7 @@ static void app_render_single_placeholder(PixelTermApp *app, const gchar *filepa
     ui_render_centered_row(1, app->term_width, "Image View", NULL);
     ui_render_centered_row(2, app->term_width, "", NULL);
 
-    gint current = app_get_current_index(app) + 1;
-    gint total = app_get_total_images(app);
-    if (current < 1) current = 1;
-    if (total < 1) total = 1;
-    char idx_text[32];
-    g_snprintf(idx_text, sizeof(idx_text), "%d/%d", current, total);
-    ui_render_centered_row(3, app->term_width, idx_text, NULL);
+    app_render_single_index_row(app);
 
     gchar *basename = g_path_get_basename(filepath);
     gchar *safe_basename = sanitize_for_terminal(basename);
@@ -111,9 +131,12 @@ static void app_render_info_overlay(PixelTermApp *app,
         return;
     }
 
-    gint width = 0;
-    gint height = 0;
-    gboolean have_dimensions = renderer_get_media_dimensions(filepath, &width, &height) == ERROR_NONE;
+    // Answered from the directory's metadata cache; only a miss decodes the file
+    MediaMeta meta;
+    gboolean have_meta = app_get_media_meta(app, filepath, &meta);
+    gint width = have_meta ? meta.width : 0;
+    gint height = have_meta ? meta.height : 0;
+    gboolean have_dimensions = width > 0 && height > 0;
     gdouble aspect_ratio = (have_dimensions && height > 0) ? (gdouble)width / height : 0.0;
 
     gchar *basename = g_path_get_basename(filepath);
@@ -133,7 +156,12 @@ static void app_render_info_overlay(PixelTermApp *app,
     gchar *line_dimensions = have_dimensions
                                  ? g_strdup_printf("Dimensions: %d x %d px", width, height)
                                  : g_strdup("Dimensions: unknown");
-    gchar *line_format = g_strdup_printf("Format: %s", ext ? ext + 1 : "unknown");
+    gchar *line_format = (have_meta && meta.duration_ms >= 0)
+                             ? g_strdup_printf("Format: %s, %" G_GINT64_FORMAT ":%02" G_GINT64_FORMAT,
+                                               ext ? ext + 1 : "unknown",
+                                               meta.duration_ms / 60000,
+                                               (meta.duration_ms / 1000) % 60)
+                             : g_strdup_printf("Format: %s", ext ? ext + 1 : "unknown");
     gchar *line_aspect = have_dimensions
                              ? g_strdup_printf("Aspect: %.2f", aspect_ratio)
                              : g_strdup("Aspect: unknown");
@@ -196,6 +224,7 @@ static const UIPanelRow *app_help_rows_for_mode(const PixelTermApp *app, gsize *
         {"i", "File info"},
         {"r", "Delete"},
         {"~", "Zen mode"},
+        {"F", "Performance HUD"},
         {"?", "Close help"}
     };
     static const UIPanelRow preview_rows[] = {
@@ -206,6 +235,7 @@ static const UIPanelRow *app_help_rows_for_mode(const PixelTermApp *app, gsize *
         {"Tab", "File manager"},
         {"+/-", "Zoom grid"},
         {"r", "Delete"},
+        {"F", "Performance HUD"},
         {"?", "Close help"}
     };
     static const UIPanelRow file_manager_rows[] = {
@@ -227,6 +257,7 @@ static const UIPanelRow *app_help_rows_for_mode(const PixelTermApp *app, gsize *
         {"P", "Jump to page"},
         {"T", "Table of contents"},
         {"Enter", "Page preview"},
+        {"F", "Performance HUD"},
         {"?", "Close help"}
     };
     static const UIPanelRow book_preview_rows[] = {
@@ -237,6 +268,7 @@ static const UIPanelRow *app_help_rows_for_mode(const PixelTermApp *app, gsize *
         {"T", "Table of contents"},
         {"Enter / Tab", "Open page"},
         {"+/-", "Zoom grid"},
+        {"F", "Performance HUD"},
         {"?", "Close help"}
     };
 
@@ -489,13 +521,7 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         ui_render_centered_row(1, app->term_width, title, NULL);
         ui_render_centered_row(2, app->term_width, "", NULL);
 
-        gint current = app_get_current_index(app) + 1;
-        gint total = app_get_total_images(app);
-        if (current < 1) current = 1;
-        if (total < 1) total = 1;
-        char idx_text[32];
-        g_snprintf(idx_text, sizeof(idx_text), "%d/%d", current, total);
-        ui_render_centered_row(3, app->term_width, idx_text, NULL);
+        app_render_single_index_row(app);
     }
 
     if (is_video) {
@@ -540,7 +566,7 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
             const HelpSegment segments[] = {
                 {"←/→", "Prev/Next"},
                 {"Space", "Pause/Play"},
-                {"F", "FPS"},
+                {"F", "Perf"},
                 {"P", "Protocol"},
                 {"+/-", "Scale"},
                 {"Enter", "Preview"},
@@ -575,19 +601,27 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
     gint image_width = 0;
     gint image_height = 0;
 
+    // The decoded zoom source only stays resident while its image is on screen.
+    if (app->zoom_source && g_strcmp0(image_zoom_source_get_path(app->zoom_source), filepath) != 0) {
+        g_clear_pointer(&app->zoom_source, image_zoom_source_free);
+    }
+
     if (use_zoom) {
-        GError *load_error = NULL;
-        GdkPixbuf *pixbuf = pixbuf_utils_load_from_stream(filepath, &load_error);
-        if (!pixbuf) {
-            if (load_error) {
-                g_error_free(load_error);
+        if (!app->zoom_source) {
+            GError *load_error = NULL;
+            app->zoom_source = image_zoom_source_new(filepath, &load_error);
+            if (!app->zoom_source) {
+                if (load_error) {
+                    g_error_free(load_error);
+                }
+                ui_end_sync_update();
+                return ERROR_INVALID_IMAGE;
             }
-            ui_end_sync_update();
-            return ERROR_INVALID_IMAGE;
         }
 
-        gint orig_w = gdk_pixbuf_get_width(pixbuf);
-        gint orig_h = gdk_pixbuf_get_height(pixbuf);
+        gint orig_w = 0;
+        gint orig_h = 0;
+        image_zoom_source_get_size(app->zoom_source, &orig_w, &orig_h);
         if (orig_w < 1) orig_w = 1;
         if (orig_h < 1) orig_h = 1;
 
@@ -600,7 +634,8 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         gdouble desired_scale = base_scale * image_zoom;
         gdouble scaled_w = (gdouble)orig_w * desired_scale;
         gdouble scaled_h = (gdouble)orig_h * desired_scale;
-        const gdouble max_dim = 4096.0;
+        // The zoomed image is virtual, so this only keeps pan coordinates in gint range.
+        const gdouble max_dim = 1048576.0;
         if (scaled_w > max_dim || scaled_h > max_dim) {
             gdouble descale = scaled_w / max_dim;
             gdouble descale_h = scaled_h / max_dim;
@@ -619,13 +654,6 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         if (scaled_px_w < 1) scaled_px_w = 1;
         if (scaled_px_h < 1) scaled_px_h = 1;
 
-        GdkPixbuf *scaled = gdk_pixbuf_scale_simple(pixbuf, scaled_px_w, scaled_px_h, GDK_INTERP_BILINEAR);
-        g_object_unref(pixbuf);
-        if (!scaled) {
-            ui_end_sync_update();
-            return ERROR_MEMORY_ALLOC;
-        }
-
         gint crop_w = app->image_viewport_px_w;
         gint crop_h = app->image_viewport_px_h;
         if (crop_w < 1) crop_w = 1;
@@ -647,22 +675,20 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         if (crop_x > max_pan_x) crop_x = max_pan_x;
         if (crop_y > max_pan_y) crop_y = max_pan_y;
 
-        GdkPixbuf *render_pixbuf = scaled;
-        if (crop_w < scaled_px_w || crop_h < scaled_px_h) {
-            render_pixbuf = gdk_pixbuf_new_subpixbuf(scaled, crop_x, crop_y, crop_w, crop_h);
-            if (!render_pixbuf) {
-                g_object_unref(scaled);
-                ui_end_sync_update();
-                return ERROR_MEMORY_ALLOC;
-            }
-        } else {
-            g_object_ref(render_pixbuf);
+        GdkPixbuf *render_pixbuf = image_zoom_source_render_viewport(app->zoom_source,
+                                                                     desired_scale,
+                                                                     crop_x,
+                                                                     crop_y,
+                                                                     crop_w,
+                                                                     crop_h);
+        if (!render_pixbuf) {
+            ui_end_sync_update();
+            return ERROR_MEMORY_ALLOC;
         }
 
         ImageRenderer *renderer = APP_SINGLE_RENDER_CALL(renderer_create, renderer_create);
         if (!renderer) {
             g_object_unref(render_pixbuf);
-            g_object_unref(scaled);
             APP_SINGLE_RENDER_CALL(ui_end_sync_update, ui_end_sync_update);
             return ERROR_MEMORY_ALLOC;
         }
@@ -698,7 +724,6 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         if (error != ERROR_NONE) {
             APP_SINGLE_RENDER_CALL(renderer_destroy, renderer_destroy, renderer);
             g_object_unref(render_pixbuf);
-            g_object_unref(scaled);
             APP_SINGLE_RENDER_CALL(ui_end_sync_update, ui_end_sync_update);
             return error;
         }
@@ -717,7 +742,6 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
 
         APP_SINGLE_RENDER_CALL(renderer_destroy, renderer_destroy, renderer);
         g_object_unref(render_pixbuf);
-        g_object_unref(scaled);
 
         if (!rendered) {
             APP_SINGLE_RENDER_CALL(ui_end_sync_update, ui_end_sync_update);
@@ -853,7 +877,22 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         memset(pad_buffer, ' ', left_pad);
     }
 
-    const gchar *line_ptr = rendered->str;
+    // Kitty: an image shown before at this size is still in the terminal
+    // and only needs placing; a new one is transmitted under an ID
+    GString *kitty_output = NULL;
+    if (app->kitty_images && !use_zoom && !is_video && !gif_is_animated &&
+        !app->info_visible && !app->help_visible) {
+        kitty_output = g_string_new(NULL);
+        if (!kitty_registry_place(app->kitty_images, filepath, target_width, target_height,
+                                  kitty_output, NULL, NULL) &&
+            !kitty_registry_transmit(app->kitty_images, filepath, target_width, target_height,
+                                     image_width, image_height, rendered, kitty_output)) {
+            g_string_free(kitty_output, TRUE);
+            kitty_output = NULL;
+        }
+    }
+
+    const gchar *line_ptr = kitty_output ? kitty_output->str : rendered->str;
     gint row = image_top_row;
     while (line_ptr && *line_ptr) {
         const gchar *newline = strchr(line_ptr, '\n');
@@ -872,6 +911,9 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
         row++;
     }
     g_free(pad_buffer);
+    if (kitty_output) {
+        g_string_free(kitty_output, TRUE);
+    }
 
     app_render_info_overlay(app, filepath, image_area_top_row, target_height);
     app_render_help_overlay(app);
@@ -1,4 +1,6 @@
 #include "book.h"
+#include "metrics.h"
+#include "trace.h"
 
 /*
  * Bound untrusted document outlines so malformed PDFs/EPUBs cannot consume
@@ -24,6 +26,163 @@ gint book_toc_max_depth_for_test(void) {
 #endif
 #endif
 
+static gint book_clamped_target_pixels(gint cells, gint cell_px) {
+    const gint max_dim = 4096;
+    gint64 pixels = (gint64)cells * (gint64)cell_px;
+    if (pixels < 1) {
+        return 1;
+    }
+    if (pixels > max_dim) {
+        return max_dim;
+    }
+    return (gint)pixels;
+}
+
+void book_get_thumbnail_size(gint target_cols, gint target_rows, gint *out_width, gint *out_height) {
+    gint cell_w = 0, cell_h = 0;
+    get_terminal_cell_geometry(&cell_w, &cell_h);
+    if (cell_w <= 0) cell_w = 10;
+    if (cell_h <= 0) cell_h = 20;
+    if (out_width) {
+        *out_width = book_clamped_target_pixels(MAX(target_cols, 1), cell_w);
+    }
+    if (out_height) {
+        *out_height = book_clamped_target_pixels(MAX(target_rows, 1), cell_h);
+    }
+}
+
+#if defined(HAVE_MUPDF) || defined(PIXELTERM_BOOK_TESTING)
+/*
+ * Process-wide cache of rendered thumbnails. Keys include the file's mtime in
+ * nanoseconds and its size, so a book that changes on disk misses, even when
+ * rewritten within the same second, and its stale entries age out of the LRU.
+ * Pixels are stored tightly packed and copied into the caller's buffer.
+ */
+#define BOOK_THUMBNAIL_CACHE_MAX_BYTES ((gsize)32 * 1024 * 1024)
+
+typedef struct {
+    gchar *key;
+    guint8 *pixels;
+    gint width;
+    gint height;
+    gsize bytes;
+} BookThumbnailEntry;
+
+static GMutex book_thumbnail_lock;
+static GHashTable *book_thumbnail_entries = NULL;
+static GQueue book_thumbnail_lru = G_QUEUE_INIT;
+static gsize book_thumbnail_bytes = 0;
+
+static gchar* book_thumbnail_key(const char *path,
+                                 gint64 mtime_ns,
+                                 gint64 size,
+                                 gint page_index,
+                                 gint max_width,
+                                 gint max_height) {
+    return g_strdup_printf("%s\n%" G_GINT64_FORMAT "\n%" G_GINT64_FORMAT "\n%d\n%dx%d",
+                           path ? path : "", mtime_ns, size, page_index, max_width, max_height);
+}
+
+static void book_thumbnail_entry_free(BookThumbnailEntry *entry) {
+    if (!entry) {
+        return;
+    }
+    g_free(entry->key);
+    g_free(entry->pixels);
+    g_free(entry);
+}
+
+static gboolean book_thumbnail_cache_lookup(const char *path,
+                                            gint64 mtime_ns,
+                                            gint64 size,
+                                            gint page_index,
+                                            gint max_width,
+                                            gint max_height,
+                                            guint8 *pixels,
+                                            gint stride,
+                                            gint *out_width,
+                                            gint *out_height) {
+    gboolean hit = FALSE;
+    gchar *key = book_thumbnail_key(path, mtime_ns, size, page_index, max_width, max_height);
+    g_mutex_lock(&book_thumbnail_lock);
+    BookThumbnailEntry *entry = book_thumbnail_entries ? g_hash_table_lookup(book_thumbnail_entries, key) : NULL;
+    if (entry) {
+        gsize row_bytes = (gsize)entry->width * BOOK_THUMBNAIL_CHANNELS;
+        for (gint y = 0; y < entry->height; y++) {
+            memcpy(pixels + (gsize)y * (gsize)stride, entry->pixels + (gsize)y * row_bytes, row_bytes);
+        }
+        *out_width = entry->width;
+        *out_height = entry->height;
+        g_queue_remove(&book_thumbnail_lru, entry);
+        g_queue_push_head(&book_thumbnail_lru, entry);
+        hit = TRUE;
+    }
+    g_mutex_unlock(&book_thumbnail_lock);
+    g_free(key);
+    return hit;
+}
+
+static void book_thumbnail_cache_store(const char *path,
+                                       gint64 mtime_ns,
+                                       gint64 size,
+                                       gint page_index,
+                                       gint max_width,
+                                       gint max_height,
+                                       const guint8 *pixels,
+                                       gint stride,
+                                       gint width,
+                                       gint height) {
+    gsize row_bytes = (gsize)width * BOOK_THUMBNAIL_CHANNELS;
+    gsize bytes = row_bytes * (gsize)height;
+    if (width <= 0 || height <= 0 || bytes > BOOK_THUMBNAIL_CACHE_MAX_BYTES) {
+        return;
+    }
+
+    BookThumbnailEntry *entry = g_new0(BookThumbnailEntry, 1);
+    entry->key = book_thumbnail_key(path, mtime_ns, size, page_index, max_width, max_height);
+    entry->pixels = g_malloc(bytes);
+    entry->width = width;
+    entry->height = height;
+    entry->bytes = bytes;
+    for (gint y = 0; y < height; y++) {
+        memcpy(entry->pixels + (gsize)y * row_bytes, pixels + (gsize)y * (gsize)stride, row_bytes);
+    }
+
+    g_mutex_lock(&book_thumbnail_lock);
+    if (!book_thumbnail_entries) {
+        book_thumbnail_entries = g_hash_table_new(g_str_hash, g_str_equal);
+    }
+    BookThumbnailEntry *existing = g_hash_table_lookup(book_thumbnail_entries, entry->key);
+    if (existing) {
+        // A concurrent render of the same thumbnail got here first.
+        g_mutex_unlock(&book_thumbnail_lock);
+        book_thumbnail_entry_free(entry);
+        return;
+    }
+    g_hash_table_insert(book_thumbnail_entries, entry->key, entry);
+    g_queue_push_head(&book_thumbnail_lru, entry);
+    book_thumbnail_bytes += entry->bytes;
+    while (book_thumbnail_bytes > BOOK_THUMBNAIL_CACHE_MAX_BYTES && book_thumbnail_lru.length > 1) {
+        BookThumbnailEntry *evicted = g_queue_pop_tail(&book_thumbnail_lru);
+        g_hash_table_remove(book_thumbnail_entries, evicted->key);
+        book_thumbnail_bytes -= evicted->bytes;
+        book_thumbnail_entry_free(evicted);
+    }
+    g_mutex_unlock(&book_thumbnail_lock);
+}
+
+void book_thumbnail_cache_clear(void) {
+    g_mutex_lock(&book_thumbnail_lock);
+    BookThumbnailEntry *entry = NULL;
+    while ((entry = g_queue_pop_head(&book_thumbnail_lru)) != NULL) {
+        book_thumbnail_entry_free(entry);
+    }
+    g_clear_pointer(&book_thumbnail_entries, g_hash_table_destroy);
+    book_thumbnail_bytes = 0;
+    g_mutex_unlock(&book_thumbnail_lock);
+}
+#endif
+
 #ifdef HAVE_MUPDF
 
 typedef struct {
@@ -36,12 +195,53 @@ typedef struct {
 #include <math.h>
 #include <mupdf/fitz.h>
 
+// Thumbnails are a few dozen pixels per cell, so 4 anti-aliasing levels are plenty.
+#define BOOK_THUMBNAIL_AA_LEVEL 2
+
+/*
+ * A fz_document may only be used by one thread at a time, but display lists
+ * can be replayed concurrently from cloned contexts. Rendering therefore loads
+ * the page and records it into a display list under `lock`, then rasterizes
+ * the list outside the lock using a per-thread clone of `ctx`.
+ */
+#define BOOK_RENDER_MAX_THREADS 8
+/*
+ * Recently interpreted pages kept as display lists so rescaled renders skip
+ * parsing. The cache holds at least the pages on screen (see
+ * book_set_visible_pages) and drops the oldest lists past a byte budget.
+ */
+#define BOOK_DISPLAY_LIST_CACHE_MIN_PAGES 8
+#define BOOK_DISPLAY_LIST_CACHE_MAX_BYTES ((gsize)64 * 1024 * 1024)
+
+typedef struct {
+    gint page_index;
+    fz_display_list *list;
+    gsize bytes;
+} BookDisplayListEntry;
+
 struct BookDocument {
     fz_context *ctx;
     fz_document *doc;
     gint page_count;
     gchar *path;
+    // File mtime and size when opened; part of every thumbnail key.
+    gint64 mtime_ns;
+    gint64 size;
     gboolean suppress_stderr;
+    // Serializes access to `doc`, the base context and `display_lists`.
+    GMutex lock;
+    // Most recently used first.
+    GQueue display_lists;
+    gsize display_list_bytes;
+    gint display_list_pages;
+    // Pages interpreted so far; cache hits do not count.
+    guint page_loads;
+    // Backing mutexes for MuPDF's own locking callbacks.
+    GMutex mupdf_locks[FZ_LOCK_MAX];
+    fz_locks_context locks;
+    // Idle cloned contexts, reused across render calls and threads.
+    GMutex context_pool_lock;
+    GSList *idle_contexts;
 };
 
 typedef struct {
@@ -65,39 +265,35 @@ static gboolean book_should_suppress_warnings(const char *filepath) {
     return ext && g_ascii_strcasecmp(ext, ".epub") == 0;
 }
 
-static void book_stderr_silencer_begin(StderrSilencer *silencer) {
-    if (!silencer) {
-        return;
-    }
-    silencer->active = FALSE;
-    silencer->saved_fd = -1;
-    silencer->null_fd = -1;
+// stderr is process-wide, so concurrent renders share a single redirection.
+static GMutex book_stderr_lock;
+static gint book_stderr_depth = 0;
+static StderrSilencer book_stderr_shared = {-1, -1, FALSE};
 
+static gboolean book_stderr_redirect(StderrSilencer *silencer) {
     fflush(stderr);
     int saved = dup(STDERR_FILENO);
     if (saved < 0) {
-        return;
+        return FALSE;
     }
     int null_fd = open("/dev/null", O_WRONLY);
     if (null_fd < 0) {
         close(saved);
-        return;
+        return FALSE;
     }
     if (dup2(null_fd, STDERR_FILENO) < 0) {
         close(saved);
         close(null_fd);
-        return;
+        return FALSE;
     }
 
     silencer->saved_fd = saved;
     silencer->null_fd = null_fd;
     silencer->active = TRUE;
+    return TRUE;
 }
 
-static void book_stderr_silencer_end(StderrSilencer *silencer) {
-    if (!silencer || !silencer->active) {
-        return;
-    }
+static void book_stderr_restore(StderrSilencer *silencer) {
     fflush(stderr);
     dup2(silencer->saved_fd, STDERR_FILENO);
     close(silencer->saved_fd);
@@ -107,6 +303,213 @@ static void book_stderr_silencer_end(StderrSilencer *silencer) {
     silencer->active = FALSE;
 }
 
+static void book_stderr_silencer_begin(StderrSilencer *silencer) {
+    if (!silencer) {
+        return;
+    }
+    silencer->active = FALSE;
+    silencer->saved_fd = -1;
+    silencer->null_fd = -1;
+
+    g_mutex_lock(&book_stderr_lock);
+    if (book_stderr_depth > 0 || book_stderr_redirect(&book_stderr_shared)) {
+        book_stderr_depth++;
+        silencer->active = TRUE;
+    }
+    g_mutex_unlock(&book_stderr_lock);
+}
+
+static void book_stderr_silencer_end(StderrSilencer *silencer) {
+    if (!silencer || !silencer->active) {
+        return;
+    }
+    g_mutex_lock(&book_stderr_lock);
+    if (book_stderr_depth > 0 && --book_stderr_depth == 0) {
+        book_stderr_restore(&book_stderr_shared);
+    }
+    g_mutex_unlock(&book_stderr_lock);
+    silencer->active = FALSE;
+}
+
+/*
+ * MuPDF cannot say how much memory a display list holds, so the bytes a page
+ * leaves allocated while it is interpreted are counted instead. Blocks carry
+ * their size in front, and only the thread that set `book_alloc_probe` counts.
+ */
+#define BOOK_ALLOC_HEADER 16
+
+static GPrivate book_alloc_probe;
+
+static void book_alloc_count(gssize delta) {
+    gssize *probe = g_private_get(&book_alloc_probe);
+    if (probe) {
+        *probe += delta;
+    }
+}
+
+static void* book_alloc_malloc(void *user, size_t size) {
+    (void)user;
+    guint8 *block = malloc(size + BOOK_ALLOC_HEADER);
+    if (!block) {
+        return NULL;
+    }
+    *(size_t *)block = size;
+    book_alloc_count((gssize)size);
+    return block + BOOK_ALLOC_HEADER;
+}
+
+static void book_alloc_free(void *user, void *ptr) {
+    (void)user;
+    if (!ptr) {
+        return;
+    }
+    guint8 *block = (guint8 *)ptr - BOOK_ALLOC_HEADER;
+    book_alloc_count(-(gssize)*(size_t *)block);
+    free(block);
+}
+
+static void* book_alloc_realloc(void *user, void *ptr, size_t size) {
+    if (!ptr) {
+        return book_alloc_malloc(user, size);
+    }
+    if (size == 0) {
+        book_alloc_free(user, ptr);
+        return NULL;
+    }
+    guint8 *block = (guint8 *)ptr - BOOK_ALLOC_HEADER;
+    size_t old_size = *(size_t *)block;
+    block = realloc(block, size + BOOK_ALLOC_HEADER);
+    if (!block) {
+        return NULL;
+    }
+    *(size_t *)block = size;
+    book_alloc_count((gssize)size - (gssize)old_size);
+    return block + BOOK_ALLOC_HEADER;
+}
+
+static const fz_alloc_context book_alloc = {
+    NULL,
+    book_alloc_malloc,
+    book_alloc_realloc,
+    book_alloc_free
+};
+
+static void book_mupdf_lock(void *user, int lock) {
+    GMutex *locks = (GMutex *)user;
+    g_mutex_lock(&locks[lock]);
+}
+
+static void book_mupdf_unlock(void *user, int lock) {
+    GMutex *locks = (GMutex *)user;
+    g_mutex_unlock(&locks[lock]);
+}
+
+static void book_init_locks(BookDocument *book) {
+    g_mutex_init(&book->lock);
+    g_mutex_init(&book->context_pool_lock);
+    for (gint i = 0; i < FZ_LOCK_MAX; i++) {
+        g_mutex_init(&book->mupdf_locks[i]);
+    }
+    book->locks.user = book->mupdf_locks;
+    book->locks.lock = book_mupdf_lock;
+    book->locks.unlock = book_mupdf_unlock;
+}
+
+static void book_clear_locks(BookDocument *book) {
+    for (gint i = 0; i < FZ_LOCK_MAX; i++) {
+        g_mutex_clear(&book->mupdf_locks[i]);
+    }
+    g_mutex_clear(&book->context_pool_lock);
+    g_mutex_clear(&book->lock);
+}
+
+// Returns a cloned context owned by the calling thread until released.
+static fz_context* book_acquire_context(BookDocument *doc) {
+    fz_context *ctx = NULL;
+    g_mutex_lock(&doc->context_pool_lock);
+    if (doc->idle_contexts) {
+        ctx = doc->idle_contexts->data;
+        doc->idle_contexts = g_slist_delete_link(doc->idle_contexts, doc->idle_contexts);
+    }
+    g_mutex_unlock(&doc->context_pool_lock);
+    if (ctx) {
+        return ctx;
+    }
+
+    // Cloning reads the base context, which is otherwise guarded by doc->lock.
+    g_mutex_lock(&doc->lock);
+    ctx = fz_clone_context(doc->ctx);
+    g_mutex_unlock(&doc->lock);
+    if (ctx) {
+        fz_set_error_callback(ctx, book_mupdf_error, NULL);
+        fz_set_warning_callback(ctx, book_mupdf_warn, NULL);
+    }
+    return ctx;
+}
+
+// Returns a new reference to the cached list for a page, or NULL.
+static fz_display_list* book_display_list_lookup_locked(BookDocument *doc,
+                                                        fz_context *ctx,
+                                                        gint page_index) {
+    for (GList *link = doc->display_lists.head; link; link = link->next) {
+        BookDisplayListEntry *entry = link->data;
+        if (entry->page_index != page_index) {
+            continue;
+        }
+        if (link != doc->display_lists.head) {
+            g_queue_unlink(&doc->display_lists, link);
+            g_queue_push_head_link(&doc->display_lists, link);
+        }
+        return fz_keep_display_list(ctx, entry->list);
+    }
+    return NULL;
+}
+
+// The newest list always stays, even if it alone is over the byte budget.
+static void book_display_list_trim_locked(BookDocument *doc, fz_context *ctx) {
+    gint max_pages = MAX(doc->display_list_pages, BOOK_DISPLAY_LIST_CACHE_MIN_PAGES);
+    while (doc->display_lists.length > 1 &&
+           ((gint)doc->display_lists.length > max_pages ||
+            doc->display_list_bytes > BOOK_DISPLAY_LIST_CACHE_MAX_BYTES)) {
+        BookDisplayListEntry *evicted = g_queue_pop_tail(&doc->display_lists);
+        doc->display_list_bytes -= evicted->bytes;
+        fz_drop_display_list(ctx, evicted->list);
+        g_free(evicted);
+    }
+}
+
+static void book_display_list_store_locked(BookDocument *doc,
+                                           fz_context *ctx,
+                                           gint page_index,
+                                           fz_display_list *list,
+                                           gsize bytes) {
+    BookDisplayListEntry *entry = g_new0(BookDisplayListEntry, 1);
+    entry->page_index = page_index;
+    entry->list = fz_keep_display_list(ctx, list);
+    entry->bytes = bytes;
+    g_queue_push_head(&doc->display_lists, entry);
+    doc->display_list_bytes += bytes;
+    book_display_list_trim_locked(doc, ctx);
+}
+
+static void book_display_list_clear_locked(BookDocument *doc, fz_context *ctx) {
+    BookDisplayListEntry *entry = NULL;
+    while ((entry = g_queue_pop_head(&doc->display_lists)) != NULL) {
+        fz_drop_display_list(ctx, entry->list);
+        g_free(entry);
+    }
+    doc->display_list_bytes = 0;
+}
+
+static void book_release_context(BookDocument *doc, fz_context *ctx) {
+    if (!ctx) {
+        return;
+    }
+    g_mutex_lock(&doc->context_pool_lock);
+    doc->idle_contexts = g_slist_prepend(doc->idle_contexts, ctx);
+    g_mutex_unlock(&doc->context_pool_lock);
+}
+
 static void book_set_error(ErrorCode *out_error, ErrorCode value) {
     if (out_error) {
         *out_error = value;
@@ -124,8 +527,17 @@ BookDocument* book_open(const char *filepath, ErrorCode *out_error) {
         return NULL;
     }
 
-    fz_context *ctx = fz_new_context(NULL, NULL, FZ_STORE_DEFAULT);
+    BookDocument *book = g_new0(BookDocument, 1);
+    if (!book) {
+        book_set_error(out_error, ERROR_MEMORY_ALLOC);
+        return NULL;
+    }
+    book_init_locks(book);
+
+    fz_context *ctx = fz_new_context(&book_alloc, &book->locks, FZ_STORE_DEFAULT);
     if (!ctx) {
+        book_clear_locks(book);
+        g_free(book);
         book_set_error(out_error, ERROR_MEMORY_ALLOC);
         return NULL;
     }
@@ -153,6 +565,8 @@ BookDocument* book_open(const char *filepath, ErrorCode *out_error) {
             fz_drop_document(ctx, doc);
         }
         fz_drop_context(ctx);
+        book_clear_locks(book);
+        g_free(book);
         book_set_error(out_error, ERROR_INVALID_IMAGE);
         return NULL;
     }
@@ -165,23 +579,23 @@ BookDocument* book_open(const char *filepath, ErrorCode *out_error) {
             fz_drop_document(ctx, doc);
         }
         fz_drop_context(ctx);
+        book_clear_locks(book);
+        g_free(book);
         book_set_error(out_error, ERROR_INVALID_IMAGE);
         return NULL;
     }
 
-    BookDocument *book = g_new0(BookDocument, 1);
-    if (!book) {
-        fz_drop_document(ctx, doc);
-        fz_drop_context(ctx);
-        book_set_error(out_error, ERROR_MEMORY_ALLOC);
-        return NULL;
-    }
-
     book->ctx = ctx;
     book->doc = doc;
     book->page_count = page_count;
     book->path = g_strdup(filepath);
     book->suppress_stderr = suppress_warnings;
+    struct stat st;
+    if (stat(filepath, &st) == 0) {
+        book->mtime_ns = stat_mtime_ns(&st);
+        book->size = (gint64)st.st_size;
+    }
+    g_queue_init(&book->display_lists);
 
     return book;
 }
@@ -190,6 +604,13 @@ void book_close(BookDocument *doc) {
     if (!doc) {
         return;
     }
+    book_display_list_clear_locked(doc, doc->ctx);
+    // Clones share the base context's store, so they must go first.
+    for (GSList *iter = doc->idle_contexts; iter; iter = iter->next) {
+        fz_drop_context(iter->data);
+    }
+    g_slist_free(doc->idle_contexts);
+    doc->idle_contexts = NULL;
     if (doc->doc) {
         fz_drop_document(doc->ctx, doc->doc);
         doc->doc = NULL;
@@ -198,6 +619,7 @@ void book_close(BookDocument *doc) {
         fz_drop_context(doc->ctx);
         doc->ctx = NULL;
     }
+    book_clear_locks(doc);
     g_free(doc->path);
     g_free(doc);
 }
@@ -210,6 +632,26 @@ gint book_get_page_count(const BookDocument *doc) {
     return doc ? doc->page_count : 0;
 }
 
+void book_set_visible_pages(BookDocument *doc, gint count) {
+    if (!doc) {
+        return;
+    }
+    g_mutex_lock(&doc->lock);
+    doc->display_list_pages = MAX(count, 0);
+    book_display_list_trim_locked(doc, doc->ctx);
+    g_mutex_unlock(&doc->lock);
+}
+
+guint book_page_loads_for_test(BookDocument *doc) {
+    if (!doc) {
+        return 0;
+    }
+    g_mutex_lock(&doc->lock);
+    guint loads = doc->page_loads;
+    g_mutex_unlock(&doc->lock);
+    return loads;
+}
+
 static void book_reset_image(BookPageImage *image) {
     if (!image) {
         return;
@@ -237,16 +679,38 @@ static gdouble book_compute_scale(gdouble page_w, gdouble page_h, gint target_px
     return scale;
 }
 
-static gint book_clamped_target_pixels(gint cells, gint cell_px) {
-    const gint max_dim = 4096;
-    gint64 pixels = (gint64)cells * (gint64)cell_px;
-    if (pixels < 1) {
-        return 1;
-    }
-    if (pixels > max_dim) {
-        return max_dim;
+// Returns a new reference to the page's display list, or NULL if it fails to load.
+static fz_display_list* book_load_display_list(BookDocument *doc, fz_context *ctx, gint page_index) {
+    fz_page *page = NULL;
+    fz_display_list *list = NULL;
+    fz_var(page);
+    fz_var(list);
+
+    // Only interpreting the page touches the shared document.
+    g_mutex_lock(&doc->lock);
+    list = book_display_list_lookup_locked(doc, ctx, page_index);
+    if (!list) {
+        // Resources the page pulls into the store are charged to it; the list keeps them alive
+        gssize allocated = 0;
+        g_private_set(&book_alloc_probe, &allocated);
+        fz_try(ctx) {
+            page = fz_load_page(ctx, doc->doc, page_index);
+            list = fz_new_display_list_from_page(ctx, page);
+        }
+        fz_always(ctx) {
+            fz_drop_page(ctx, page);
+        }
+        fz_catch(ctx) {
+            list = NULL;
+        }
+        g_private_set(&book_alloc_probe, NULL);
+        doc->page_loads++;
+        if (list) {
+            book_display_list_store_locked(doc, ctx, page_index, list, (gsize)MAX(allocated, 0));
+        }
     }
-    return (gint)pixels;
+    g_mutex_unlock(&doc->lock);
+    return list;
 }
 
 ErrorCode book_render_page(BookDocument *doc,
@@ -274,11 +738,19 @@ ErrorCode book_render_page(BookDocument *doc,
     gint target_px_w = book_clamped_target_pixels(target_cols, cell_w);
     gint target_px_h = book_clamped_target_pixels(target_rows, cell_h);
 
-    fz_context *ctx = doc->ctx;
-    fz_page *page = NULL;
+    fz_context *ctx = book_acquire_context(doc);
+    if (!ctx) {
+        return ERROR_MEMORY_ALLOC;
+    }
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_BOOK, "page");
+    gint64 start_us = g_get_monotonic_time();
+    fz_display_list *list = NULL;
     fz_pixmap *pix = NULL;
     fz_device *dev = NULL;
     guint8 *buffer = NULL;
+    fz_var(list);
+    fz_var(pix);
+    fz_var(dev);
 
     ErrorCode status = ERROR_NONE;
     StderrSilencer silencer = {0};
@@ -286,69 +758,72 @@ ErrorCode book_render_page(BookDocument *doc,
         book_stderr_silencer_begin(&silencer);
     }
 
-    fz_try(ctx) {
-        page = fz_load_page(ctx, doc->doc, page_index);
-        fz_rect bounds = fz_bound_page(ctx, page);
-        gdouble page_w = bounds.x1 - bounds.x0;
-        gdouble page_h = bounds.y1 - bounds.y0;
-
-        gdouble scale = book_compute_scale(page_w, page_h, target_px_w, target_px_h);
-        gdouble scaled_w = page_w * scale;
-        gdouble scaled_h = page_h * scale;
-        const gdouble max_dim = 4096.0;
-        if (scaled_w > max_dim || scaled_h > max_dim) {
-            gdouble descale = scaled_w / max_dim;
-            gdouble descale_h = scaled_h / max_dim;
-            if (descale_h > descale) {
-                descale = descale_h;
-            }
-            if (descale > 1.0) {
-                scale /= descale;
+    list = book_load_display_list(doc, ctx, page_index);
+    if (!list) {
+        status = ERROR_INVALID_IMAGE;
+    }
+
+    if (status == ERROR_NONE) {
+        fz_try(ctx) {
+            fz_rect bounds = fz_bound_display_list(ctx, list);
+            gdouble page_w = bounds.x1 - bounds.x0;
+            gdouble page_h = bounds.y1 - bounds.y0;
+
+            gdouble scale = book_compute_scale(page_w, page_h, target_px_w, target_px_h);
+            gdouble scaled_w = page_w * scale;
+            gdouble scaled_h = page_h * scale;
+            const gdouble max_dim = 4096.0;
+            if (scaled_w > max_dim || scaled_h > max_dim) {
+                gdouble descale = scaled_w / max_dim;
+                gdouble descale_h = scaled_h / max_dim;
+                if (descale_h > descale) {
+                    descale = descale_h;
+                }
+                if (descale > 1.0) {
+                    scale /= descale;
+                }
             }
-        }
 
-        fz_matrix ctm = fz_scale((float)scale, (float)scale);
-        fz_rect rect = fz_transform_rect(bounds, ctm);
-        fz_irect bbox = fz_round_rect(rect);
+            fz_matrix ctm = fz_scale((float)scale, (float)scale);
+            fz_rect rect = fz_transform_rect(bounds, ctm);
+            fz_irect bbox = fz_round_rect(rect);
 
-        pix = fz_new_pixmap_with_bbox(ctx, fz_device_rgb(ctx), bbox, NULL, 1);
-        fz_clear_pixmap_with_value(ctx, pix, 0xFF);
+            pix = fz_new_pixmap_with_bbox(ctx, fz_device_rgb(ctx), bbox, NULL, 1);
+            fz_clear_pixmap_with_value(ctx, pix, 0xFF);
 
-        dev = fz_new_draw_device(ctx, fz_identity, pix);
-        fz_run_page(ctx, page, dev, ctm, NULL);
-        fz_close_device(ctx, dev);
+            dev = fz_new_draw_device(ctx, fz_identity, pix);
+            fz_run_display_list(ctx, list, dev, ctm, fz_infinite_rect, NULL);
+            fz_close_device(ctx, dev);
 
-        if (pix->n != 3 && pix->n != 4) {
-            status = ERROR_INVALID_IMAGE;
-            goto render_done;
-        }
+            if (pix->n != 3 && pix->n != 4) {
+                status = ERROR_INVALID_IMAGE;
+                goto render_done;
+            }
 
-        if (pix->h > 0 && (gsize)pix->stride > G_MAXSIZE / (gsize)pix->h) {
-            status = ERROR_INVALID_IMAGE;
-            goto render_done;
-        }
-        gsize bytes = (gsize)pix->stride * (gsize)pix->h;
-        buffer = g_malloc(bytes);
-        if (!buffer) {
-            status = ERROR_MEMORY_ALLOC;
-            goto render_done;
-        }
-        memcpy(buffer, pix->samples, bytes);
+            if (pix->h > 0 && (gsize)pix->stride > G_MAXSIZE / (gsize)pix->h) {
+                status = ERROR_INVALID_IMAGE;
+                goto render_done;
+            }
+            gsize bytes = (gsize)pix->stride * (gsize)pix->h;
+            buffer = g_malloc(bytes);
+            if (!buffer) {
+                status = ERROR_MEMORY_ALLOC;
+                goto render_done;
+            }
+            memcpy(buffer, pix->samples, bytes);
 
-        out_image->pixels = buffer;
-        out_image->width = pix->w;
-        out_image->height = pix->h;
-        out_image->stride = pix->stride;
-        out_image->channels = pix->n;
+            out_image->pixels = buffer;
+            out_image->width = pix->w;
+            out_image->height = pix->h;
+            out_image->stride = pix->stride;
+            out_image->channels = pix->n;
 render_done:
-        ;
-    }
-    fz_catch(ctx) {
-        if (silencer.active) {
-            book_stderr_silencer_end(&silencer);
+            ;
         }
-        if (status == ERROR_NONE) {
-            status = ERROR_INVALID_IMAGE;
+        fz_catch(ctx) {
+            if (status == ERROR_NONE) {
+                status = ERROR_INVALID_IMAGE;
+            }
         }
     }
     if (silencer.active) {
@@ -361,9 +836,12 @@ render_done:
     if (pix) {
         fz_drop_pixmap(ctx, pix);
     }
-    if (page) {
-        fz_drop_page(ctx, page);
+    if (list) {
+        fz_drop_display_list(ctx, list);
     }
+    book_release_context(doc, ctx);
+    metrics_set_elapsed(METRIC_DECODE_US, start_us);
+    trace_span_end_arg(&span, "page", page_index);
 
     if (status != ERROR_NONE) {
         book_page_image_free(out_image);
@@ -372,6 +850,166 @@ render_done:
     return status;
 }
 
+ErrorCode book_render_thumbnail(BookDocument *doc,
+                                gint page_index,
+                                gint max_width,
+                                gint max_height,
+                                guint8 *pixels,
+                                gint stride,
+                                gint *out_width,
+                                gint *out_height) {
+    if (!doc || !doc->ctx || !doc->doc || !pixels || !out_width || !out_height) {
+        return ERROR_MEMORY_ALLOC;
+    }
+    *out_width = 0;
+    *out_height = 0;
+    if (max_width < 1 || max_height < 1 || stride < max_width * BOOK_THUMBNAIL_CHANNELS) {
+        return ERROR_INVALID_ARGS;
+    }
+    if (page_index < 0 || page_index >= doc->page_count) {
+        return ERROR_INVALID_IMAGE;
+    }
+
+    if (book_thumbnail_cache_lookup(doc->path, doc->mtime_ns, doc->size, page_index, max_width, max_height,
+                                    pixels, stride, out_width, out_height)) {
+        return ERROR_NONE;
+    }
+
+    fz_context *ctx = book_acquire_context(doc);
+    if (!ctx) {
+        return ERROR_MEMORY_ALLOC;
+    }
+    StderrSilencer silencer = {0};
+    if (doc->suppress_stderr) {
+        book_stderr_silencer_begin(&silencer);
+    }
+
+    ErrorCode status = ERROR_NONE;
+    fz_display_list *list = book_load_display_list(doc, ctx, page_index);
+    fz_pixmap *pix = NULL;
+    fz_device *dev = NULL;
+    gint saved_aa_level = fz_aa_level(ctx);
+    fz_var(pix);
+    fz_var(dev);
+    if (!list) {
+        status = ERROR_INVALID_IMAGE;
+    }
+
+    if (status == ERROR_NONE) {
+        fz_try(ctx) {
+            fz_rect bounds = fz_bound_display_list(ctx, list);
+            gdouble scale = book_compute_scale(bounds.x1 - bounds.x0, bounds.y1 - bounds.y0,
+                                               max_width, max_height);
+            fz_matrix ctm = fz_scale((float)scale, (float)scale);
+            fz_irect bbox = fz_round_rect(fz_transform_rect(bounds, ctm));
+            // Rounding can overshoot the box by a pixel; clip to what the caller allocated.
+            gint width = CLAMP(bbox.x1 - bbox.x0, 1, max_width);
+            gint height = CLAMP(bbox.y1 - bbox.y0, 1, max_height);
+            ctm = fz_concat(ctm, fz_translate((float)-bbox.x0, (float)-bbox.y0));
+
+            // Wrap the caller's buffer so the rasterizer writes straight into it.
+            pix = fz_new_pixmap_with_data(ctx, fz_device_rgb(ctx), width, height, NULL, 0, stride, pixels);
+            fz_clear_pixmap_with_value(ctx, pix, 0xFF);
+
+            fz_set_aa_level(ctx, BOOK_THUMBNAIL_AA_LEVEL);
+            dev = fz_new_draw_device(ctx, fz_identity, pix);
+            fz_run_display_list(ctx, list, dev, ctm, fz_infinite_rect, NULL);
+            fz_close_device(ctx, dev);
+
+            *out_width = width;
+            *out_height = height;
+        }
+        fz_always(ctx) {
+            fz_set_aa_level(ctx, saved_aa_level);
+        }
+        fz_catch(ctx) {
+            status = ERROR_INVALID_IMAGE;
+        }
+    }
+    if (silencer.active) {
+        book_stderr_silencer_end(&silencer);
+    }
+
+    if (dev) {
+        fz_drop_device(ctx, dev);
+    }
+    if (pix) {
+        fz_drop_pixmap(ctx, pix);
+    }
+    if (list) {
+        fz_drop_display_list(ctx, list);
+    }
+    book_release_context(doc, ctx);
+
+    if (status == ERROR_NONE) {
+        book_thumbnail_cache_store(doc->path, doc->mtime_ns, doc->size, page_index, max_width, max_height,
+                                   pixels, stride, *out_width, *out_height);
+    } else {
+        *out_width = 0;
+        *out_height = 0;
+    }
+    return status;
+}
+
+// Slot i is written at pixels + i * stride * max_height.
+typedef struct {
+    BookDocument *doc;
+    const gint *page_indices;
+    gint max_width;
+    gint max_height;
+    guint8 *pixels;
+    gint stride;
+    gint *out_widths;
+    gint *out_heights;
+    ErrorCode *out_errors;
+} BookThumbnailBatch;
+
+static void book_thumbnail_batch_slot(guint slot, gpointer user_data) {
+    BookThumbnailBatch *batch = (BookThumbnailBatch *)user_data;
+    gsize offset = (gsize)slot * (gsize)batch->stride * (gsize)batch->max_height;
+    batch->out_errors[slot] = book_render_thumbnail(batch->doc,
+                                                    batch->page_indices[slot],
+                                                    batch->max_width,
+                                                    batch->max_height,
+                                                    batch->pixels + offset,
+                                                    batch->stride,
+                                                    &batch->out_widths[slot],
+                                                    &batch->out_heights[slot]);
+}
+
+ErrorCode book_render_thumbnails(BookDocument *doc,
+                                 const gint *page_indices,
+                                 gint count,
+                                 gint max_width,
+                                 gint max_height,
+                                 guint8 *pixels,
+                                 gint stride,
+                                 gint *out_widths,
+                                 gint *out_heights,
+                                 ErrorCode *out_errors) {
+    if (!doc || !page_indices || count < 0 || !pixels || !out_widths || !out_heights || !out_errors) {
+        return ERROR_MEMORY_ALLOC;
+    }
+    if (max_width < 1 || max_height < 1 || stride < max_width * BOOK_THUMBNAIL_CHANNELS) {
+        return ERROR_INVALID_ARGS;
+    }
+
+    BookThumbnailBatch batch = {
+        .doc = doc,
+        .page_indices = page_indices,
+        .max_width = max_width,
+        .max_height = max_height,
+        .pixels = pixels,
+        .stride = stride,
+        .out_widths = out_widths,
+        .out_heights = out_heights,
+        .out_errors = out_errors
+    };
+    parallel_for((guint)count, MIN(g_get_num_processors(), BOOK_RENDER_MAX_THREADS),
+                 book_thumbnail_batch_slot, &batch);
+    return ERROR_NONE;
+}
+
 void book_page_image_free(BookPageImage *image) {
     if (!image) {
         return;
@@ -449,16 +1087,19 @@ BookToc* book_load_toc(BookDocument *doc) {
         return NULL;
     }
 
+    g_mutex_lock(&doc->lock);
     fz_outline *outline = NULL;
     fz_var(outline);
     fz_try(doc->ctx) {
         outline = fz_load_outline(doc->ctx, doc->doc);
     }
     fz_catch(doc->ctx) {
+        g_mutex_unlock(&doc->lock);
         return NULL;
     }
 
     if (!outline) {
+        g_mutex_unlock(&doc->lock);
         return NULL;
     }
 
@@ -478,6 +1119,7 @@ BookToc* book_load_toc(BookDocument *doc) {
     }
 
     fz_drop_outline(doc->ctx, outline);
+    g_mutex_unlock(&doc->lock);
     return toc;
 }
 
@@ -544,6 +1186,16 @@ gint book_get_page_count(const BookDocument *doc) {
     return doc ? doc->page_count : 0;
 }
 
+void book_set_visible_pages(BookDocument *doc, gint count) {
+    (void)doc;
+    (void)count;
+}
+
+guint book_page_loads_for_test(BookDocument *doc) {
+    (void)doc;
+    return 0;
+}
+
 ErrorCode book_render_page(BookDocument *doc,
                            gint page_index,
                            gint target_cols,
@@ -557,6 +1209,50 @@ ErrorCode book_render_page(BookDocument *doc,
     return ERROR_INVALID_IMAGE;
 }
 
+ErrorCode book_render_thumbnail(BookDocument *doc,
+                                gint page_index,
+                                gint max_width,
+                                gint max_height,
+                                guint8 *pixels,
+                                gint stride,
+                                gint *out_width,
+                                gint *out_height) {
+    (void)doc;
+    (void)page_index;
+    (void)max_width;
+    (void)max_height;
+    (void)pixels;
+    (void)stride;
+    if (out_width) *out_width = 0;
+    if (out_height) *out_height = 0;
+    return ERROR_INVALID_IMAGE;
+}
+
+ErrorCode book_render_thumbnails(BookDocument *doc,
+                                 const gint *page_indices,
+                                 gint count,
+                                 gint max_width,
+                                 gint max_height,
+                                 guint8 *pixels,
+                                 gint stride,
+                                 gint *out_widths,
+                                 gint *out_heights,
+                                 ErrorCode *out_errors) {
+    if (!page_indices || count < 0 || !pixels || !out_widths || !out_heights || !out_errors) {
+        return ERROR_MEMORY_ALLOC;
+    }
+    for (gint i = 0; i < count; i++) {
+        out_errors[i] = book_render_thumbnail(doc, page_indices[i], max_width, max_height,
+                                              pixels, stride, &out_widths[i], &out_heights[i]);
+    }
+    return ERROR_NONE;
+}
+
+#ifndef PIXELTERM_BOOK_TESTING
+void book_thumbnail_cache_clear(void) {
+}
+#endif
+
 void book_page_image_free(BookPageImage *image) {
     if (!image) {
         return;
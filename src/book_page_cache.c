@@ -0,0 +1,541 @@
+#include "book_page_cache.h"
+#include "metrics.h"
+#include "trace.h"
+
+typedef struct {
+    gint page_index;
+    gint target_cols;
+    gint target_rows;
+} BookPageCacheKey;
+
+typedef struct {
+    BookPageCacheKey key;
+    BookPageImage image;
+    gboolean has_image;
+    GString *rendered;
+    RendererConfig rendered_config;
+    gint rendered_width;
+    gint rendered_height;
+    gboolean graphics_mode;
+} BookPageCacheEntry;
+
+typedef struct {
+    BookPageCacheKey key;
+    RendererConfig config;
+} BookPageCacheTask;
+
+struct BookPageCache {
+    BookDocument *doc;
+    GThread *thread;
+    GMutex mutex;
+    GCond condition;
+    GCond done_condition;
+    GQueue *task_queue;
+    GHashTable *entries;
+    GQueue *lru_queue;
+    gsize cached_bytes;
+    gboolean in_flight;
+    BookPageCacheKey in_flight_key;
+    gboolean stopping;
+};
+
+static guint book_page_cache_key_hash(gconstpointer data) {
+    const BookPageCacheKey *key = (const BookPageCacheKey*)data;
+    guint hash = (guint)key->page_index;
+    hash = hash * 31 + (guint)key->target_cols;
+    hash = hash * 31 + (guint)key->target_rows;
+    return hash;
+}
+
+static gboolean book_page_cache_key_equal(gconstpointer a, gconstpointer b) {
+    const BookPageCacheKey *ka = (const BookPageCacheKey*)a;
+    const BookPageCacheKey *kb = (const BookPageCacheKey*)b;
+    return ka->page_index == kb->page_index &&
+           ka->target_cols == kb->target_cols &&
+           ka->target_rows == kb->target_rows;
+}
+
+static BookPageCacheKey book_page_cache_make_key(gint page_index, gint target_cols, gint target_rows) {
+    // Mirror book_render_page's clamping so equivalent requests share an entry.
+    BookPageCacheKey key = {
+        .page_index = page_index,
+        .target_cols = target_cols < 1 ? 1 : target_cols,
+        .target_rows = target_rows < 1 ? 1 : target_rows
+    };
+    return key;
+}
+
+static gboolean book_page_cache_config_equal(const RendererConfig *a, const RendererConfig *b) {
+    if (!a || !b) {
+        return FALSE;
+    }
+    return a->max_width == b->max_width &&
+           a->max_height == b->max_height &&
+           a->preserve_aspect_ratio == b->preserve_aspect_ratio &&
+           a->dither == b->dither &&
+           a->color_space == b->color_space &&
+           a->work_factor == b->work_factor &&
+           a->force_text == b->force_text &&
+           a->force_sixel == b->force_sixel &&
+           a->force_kitty == b->force_kitty &&
+           a->force_iterm2 == b->force_iterm2 &&
+           a->text_symbol_mode == b->text_symbol_mode &&
+           a->gamma == b->gamma &&
+           a->color_enhance == b->color_enhance &&
+           a->dither_mode == b->dither_mode &&
+           a->color_extractor == b->color_extractor &&
+           a->optimizations == b->optimizations;
+}
+
+static gsize book_page_cache_entry_bytes(const BookPageCacheEntry *entry) {
+    if (!entry) {
+        return 0;
+    }
+    gsize bytes = 0;
+    if (entry->has_image && entry->image.pixels && entry->image.height > 0) {
+        bytes += (gsize)entry->image.stride * (gsize)entry->image.height;
+    }
+    if (entry->rendered) {
+        bytes += entry->rendered->len;
+    }
+    return bytes;
+}
+
+static void book_page_cache_entry_destroy(gpointer data) {
+    BookPageCacheEntry *entry = (BookPageCacheEntry*)data;
+    if (!entry) {
+        return;
+    }
+    book_page_image_free(&entry->image);
+    if (entry->rendered) {
+        g_string_free(entry->rendered, TRUE);
+    }
+    g_free(entry);
+}
+
+static gboolean book_page_cache_copy_image(const BookPageImage *src, BookPageImage *dst) {
+    if (!src || !dst || !src->pixels || src->height <= 0 || src->stride <= 0) {
+        return FALSE;
+    }
+    if ((gsize)src->stride > G_MAXSIZE / (gsize)src->height) {
+        return FALSE;
+    }
+    gsize bytes = (gsize)src->stride * (gsize)src->height;
+    guint8 *pixels = g_malloc(bytes);
+    if (!pixels) {
+        return FALSE;
+    }
+    memcpy(pixels, src->pixels, bytes);
+    *dst = *src;
+    dst->pixels = pixels;
+    return TRUE;
+}
+
+static void book_page_cache_clear_queue_locked(BookPageCache *cache) {
+    while (!g_queue_is_empty(cache->task_queue)) {
+        g_free(g_queue_pop_head(cache->task_queue));
+    }
+}
+
+static void book_page_cache_wait_in_flight_locked(BookPageCache *cache, const BookPageCacheKey *key) {
+    while (cache->in_flight && book_page_cache_key_equal(&cache->in_flight_key, key)) {
+        g_cond_wait(&cache->done_condition, &cache->mutex);
+    }
+}
+
+static void book_page_cache_touch_locked(BookPageCache *cache, BookPageCacheEntry *entry) {
+    g_queue_remove(cache->lru_queue, entry);
+    g_queue_push_head(cache->lru_queue, entry);
+}
+
+static void book_page_cache_evict_locked(BookPageCache *cache) {
+    // Always keep the most recently used entry, even if it alone exceeds the byte budget.
+    while (g_queue_get_length(cache->lru_queue) > 1 &&
+           (g_hash_table_size(cache->entries) > BOOK_PAGE_CACHE_MAX_ENTRIES ||
+            cache->cached_bytes > BOOK_PAGE_CACHE_MAX_BYTES)) {
+        BookPageCacheEntry *entry = (BookPageCacheEntry*)g_queue_pop_tail(cache->lru_queue);
+        if (!entry) {
+            break;
+        }
+        cache->cached_bytes -= MIN(cache->cached_bytes, book_page_cache_entry_bytes(entry));
+        g_hash_table_remove(cache->entries, &entry->key);
+    }
+}
+
+static BookPageCacheEntry* book_page_cache_ensure_entry_locked(BookPageCache *cache,
+                                                               const BookPageCacheKey *key) {
+    BookPageCacheEntry *entry = g_hash_table_lookup(cache->entries, key);
+    if (entry) {
+        return entry;
+    }
+    entry = g_new0(BookPageCacheEntry, 1);
+    entry->key = *key;
+    g_hash_table_insert(cache->entries, &entry->key, entry);
+    g_queue_push_head(cache->lru_queue, entry);
+    return entry;
+}
+
+// Takes ownership of image->pixels.
+static void book_page_cache_store_image_locked(BookPageCache *cache,
+                                               const BookPageCacheKey *key,
+                                               BookPageImage *image) {
+    BookPageCacheEntry *entry = book_page_cache_ensure_entry_locked(cache, key);
+    cache->cached_bytes -= MIN(cache->cached_bytes, book_page_cache_entry_bytes(entry));
+    book_page_image_free(&entry->image);
+    entry->image = *image;
+    entry->has_image = TRUE;
+    cache->cached_bytes += book_page_cache_entry_bytes(entry);
+    book_page_cache_touch_locked(cache, entry);
+    book_page_cache_evict_locked(cache);
+}
+
+static void book_page_cache_store_rendered_locked(BookPageCache *cache,
+                                                  const BookPageCacheKey *key,
+                                                  const RendererConfig *config,
+                                                  const GString *rendered,
+                                                  gint rendered_width,
+                                                  gint rendered_height,
+                                                  gboolean graphics_mode) {
+    BookPageCacheEntry *entry = book_page_cache_ensure_entry_locked(cache, key);
+    cache->cached_bytes -= MIN(cache->cached_bytes, book_page_cache_entry_bytes(entry));
+    if (entry->rendered) {
+        g_string_free(entry->rendered, TRUE);
+    }
+    entry->rendered = g_string_new_len(rendered->str, rendered->len);
+    entry->rendered_config = *config;
+    entry->rendered_width = rendered_width;
+    entry->rendered_height = rendered_height;
+    entry->graphics_mode = graphics_mode;
+    cache->cached_bytes += book_page_cache_entry_bytes(entry);
+    book_page_cache_touch_locked(cache, entry);
+    book_page_cache_evict_locked(cache);
+}
+
+static gboolean book_page_cache_entry_is_complete(const BookPageCacheEntry *entry,
+                                                  const RendererConfig *config) {
+    return entry &&
+           entry->has_image &&
+           entry->rendered &&
+           book_page_cache_config_equal(&entry->rendered_config, config);
+}
+
+static ImageRenderer* book_page_cache_worker_renderer(ImageRenderer *renderer,
+                                                      RendererConfig *current_config,
+                                                      const RendererConfig *config) {
+    if (renderer && book_page_cache_config_equal(current_config, config)) {
+        return renderer;
+    }
+    renderer_destroy(renderer);
+
+    renderer = renderer_create();
+    if (!renderer) {
+        return NULL;
+    }
+    if (renderer_initialize(renderer, config) != ERROR_NONE) {
+        renderer_destroy(renderer);
+        return NULL;
+    }
+    *current_config = *config;
+    return renderer;
+}
+
+static gpointer book_page_cache_worker_thread(gpointer data) {
+    BookPageCache *cache = (BookPageCache*)data;
+    ImageRenderer *renderer = NULL;
+    RendererConfig renderer_config = {0};
+    trace_set_thread_name("book-prefetch");
+
+    while (TRUE) {
+        g_mutex_lock(&cache->mutex);
+        while (!cache->stopping && g_queue_is_empty(cache->task_queue)) {
+            g_cond_wait(&cache->condition, &cache->mutex);
+        }
+        if (cache->stopping) {
+            g_mutex_unlock(&cache->mutex);
+            break;
+        }
+
+        BookPageCacheTask *task = (BookPageCacheTask*)g_queue_pop_head(cache->task_queue);
+        BookPageCacheEntry *entry = g_hash_table_lookup(cache->entries, &task->key);
+        if (book_page_cache_entry_is_complete(entry, &task->config)) {
+            g_mutex_unlock(&cache->mutex);
+            g_free(task);
+            continue;
+        }
+
+        // Work on a private copy so eviction cannot free pixels mid-render.
+        BookPageImage image = {0};
+        gboolean need_image = !(entry && entry->has_image &&
+                                book_page_cache_copy_image(&entry->image, &image));
+        cache->in_flight = TRUE;
+        cache->in_flight_key = task->key;
+        g_mutex_unlock(&cache->mutex);
+
+        gint64 busy_start_us = g_get_monotonic_time();
+        ErrorCode error = ERROR_NONE;
+        if (need_image) {
+            error = book_render_page(cache->doc,
+                                     task->key.page_index,
+                                     task->key.target_cols,
+                                     task->key.target_rows,
+                                     &image);
+        }
+
+        GString *rendered = NULL;
+        gint rendered_width = 0;
+        gint rendered_height = 0;
+        gboolean graphics_mode = FALSE;
+        if (error == ERROR_NONE) {
+            renderer = book_page_cache_worker_renderer(renderer, &renderer_config, &task->config);
+            if (renderer) {
+                rendered = renderer_render_image_data(renderer,
+                                                      image.pixels,
+                                                      image.width,
+                                                      image.height,
+                                                      image.stride,
+                                                      image.channels);
+                if (rendered) {
+                    renderer_get_rendered_dimensions(renderer, &rendered_width, &rendered_height);
+                    graphics_mode = renderer_is_graphics_mode(renderer);
+                }
+            }
+        }
+
+        g_mutex_lock(&cache->mutex);
+        if (error == ERROR_NONE && !cache->stopping) {
+            if (need_image) {
+                book_page_cache_store_image_locked(cache, &task->key, &image);
+            } else {
+                book_page_image_free(&image);
+            }
+            if (rendered) {
+                book_page_cache_store_rendered_locked(cache,
+                                                      &task->key,
+                                                      &task->config,
+                                                      rendered,
+                                                      rendered_width,
+                                                      rendered_height,
+                                                      graphics_mode);
+            }
+        } else {
+            book_page_image_free(&image);
+        }
+        cache->in_flight = FALSE;
+        g_cond_broadcast(&cache->done_condition);
+        g_mutex_unlock(&cache->mutex);
+
+        if (rendered) {
+            g_string_free(rendered, TRUE);
+        }
+        g_free(task);
+        metrics_add(METRIC_WORKER_BUSY_US, g_get_monotonic_time() - busy_start_us);
+    }
+
+    renderer_destroy(renderer);
+    return NULL;
+}
+
+BookPageCache* book_page_cache_create(BookDocument *doc) {
+    if (!doc) {
+        return NULL;
+    }
+
+    BookPageCache *cache = g_new0(BookPageCache, 1);
+    if (!cache) {
+        return NULL;
+    }
+
+    cache->doc = doc;
+    cache->task_queue = g_queue_new();
+    cache->lru_queue = g_queue_new();
+    cache->entries = g_hash_table_new_full(book_page_cache_key_hash,
+                                           book_page_cache_key_equal,
+                                           NULL,
+                                           book_page_cache_entry_destroy);
+    g_mutex_init(&cache->mutex);
+    g_cond_init(&cache->condition);
+    g_cond_init(&cache->done_condition);
+
+    cache->thread = g_thread_new("book-prefetch", book_page_cache_worker_thread, cache);
+    if (!cache->thread) {
+        book_page_cache_destroy(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+void book_page_cache_destroy(BookPageCache *cache) {
+    if (!cache) {
+        return;
+    }
+
+    g_mutex_lock(&cache->mutex);
+    cache->stopping = TRUE;
+    book_page_cache_clear_queue_locked(cache);
+    g_cond_broadcast(&cache->condition);
+    g_mutex_unlock(&cache->mutex);
+
+    if (cache->thread) {
+        g_thread_join(cache->thread);
+        cache->thread = NULL;
+    }
+
+    g_queue_free(cache->task_queue);
+    g_queue_free(cache->lru_queue);
+    g_hash_table_destroy(cache->entries);
+    g_mutex_clear(&cache->mutex);
+    g_cond_clear(&cache->condition);
+    g_cond_clear(&cache->done_condition);
+    g_free(cache);
+}
+
+ErrorCode book_page_cache_render_page(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      BookPageImage *out_image) {
+    if (!cache || !out_image) {
+        return ERROR_MEMORY_ALLOC;
+    }
+
+    BookPageCacheKey key = book_page_cache_make_key(page_index, target_cols, target_rows);
+
+    g_mutex_lock(&cache->mutex);
+    book_page_cache_wait_in_flight_locked(cache, &key);
+    BookPageCacheEntry *entry = g_hash_table_lookup(cache->entries, &key);
+    if (entry && entry->has_image) {
+        gboolean copied = book_page_cache_copy_image(&entry->image, out_image);
+        book_page_cache_touch_locked(cache, entry);
+        g_mutex_unlock(&cache->mutex);
+        return copied ? ERROR_NONE : ERROR_MEMORY_ALLOC;
+    }
+    g_mutex_unlock(&cache->mutex);
+
+    BookPageImage image = {0};
+    ErrorCode error = book_render_page(cache->doc, page_index, target_cols, target_rows, &image);
+    if (error != ERROR_NONE) {
+        return error;
+    }
+    if (!book_page_cache_copy_image(&image, out_image)) {
+        // Hand the only copy to the caller rather than caching it.
+        *out_image = image;
+        return ERROR_NONE;
+    }
+
+    g_mutex_lock(&cache->mutex);
+    book_page_cache_store_image_locked(cache, &key, &image);
+    g_mutex_unlock(&cache->mutex);
+
+    return ERROR_NONE;
+}
+
+GString* book_page_cache_get_rendered(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      const RendererConfig *config,
+                                      gint *out_width,
+                                      gint *out_height,
+                                      gboolean *out_graphics_mode) {
+    if (!cache || !config) {
+        return NULL;
+    }
+
+    BookPageCacheKey key = book_page_cache_make_key(page_index, target_cols, target_rows);
+    GString *rendered = NULL;
+
+    g_mutex_lock(&cache->mutex);
+    book_page_cache_wait_in_flight_locked(cache, &key);
+    BookPageCacheEntry *entry = g_hash_table_lookup(cache->entries, &key);
+    if (entry && entry->rendered && book_page_cache_config_equal(&entry->rendered_config, config)) {
+        rendered = g_string_new_len(entry->rendered->str, entry->rendered->len);
+        if (out_width) {
+            *out_width = entry->rendered_width;
+        }
+        if (out_height) {
+            *out_height = entry->rendered_height;
+        }
+        if (out_graphics_mode) {
+            *out_graphics_mode = entry->graphics_mode;
+        }
+        book_page_cache_touch_locked(cache, entry);
+    }
+    g_mutex_unlock(&cache->mutex);
+
+    return rendered;
+}
+
+void book_page_cache_store_rendered(BookPageCache *cache,
+                                    gint page_index,
+                                    gint target_cols,
+                                    gint target_rows,
+                                    const RendererConfig *config,
+                                    const GString *rendered,
+                                    gint rendered_width,
+                                    gint rendered_height,
+                                    gboolean graphics_mode) {
+    if (!cache || !config || !rendered) {
+        return;
+    }
+
+    BookPageCacheKey key = book_page_cache_make_key(page_index, target_cols, target_rows);
+
+    g_mutex_lock(&cache->mutex);
+    book_page_cache_store_rendered_locked(cache,
+                                          &key,
+                                          config,
+                                          rendered,
+                                          rendered_width,
+                                          rendered_height,
+                                          graphics_mode);
+    g_mutex_unlock(&cache->mutex);
+}
+
+void book_page_cache_prefetch(BookPageCache *cache,
+                              gint page_index,
+                              gint span,
+                              gint direction,
+                              gint target_cols,
+                              gint target_rows,
+                              const RendererConfig *config) {
+    if (!cache || !config) {
+        return;
+    }
+    if (span < 1) {
+        span = 1;
+    }
+
+    gint page_count = book_get_page_count(cache->doc);
+    gint pages[3];
+    if (direction < 0) {
+        pages[0] = page_index - 1;
+        pages[1] = page_index - 2;
+        pages[2] = page_index + span;
+    } else {
+        pages[0] = page_index + span;
+        pages[1] = page_index + span + 1;
+        pages[2] = page_index - 1;
+    }
+
+    g_mutex_lock(&cache->mutex);
+    book_page_cache_clear_queue_locked(cache);
+    for (gsize i = 0; i < G_N_ELEMENTS(pages); i++) {
+        if (pages[i] < 0 || pages[i] >= page_count) {
+            continue;
+        }
+        BookPageCacheKey key = book_page_cache_make_key(pages[i], target_cols, target_rows);
+        BookPageCacheEntry *entry = g_hash_table_lookup(cache->entries, &key);
+        if (book_page_cache_entry_is_complete(entry, config)) {
+            continue;
+        }
+        BookPageCacheTask *task = g_new0(BookPageCacheTask, 1);
+        task->key = key;
+        task->config = *config;
+        g_queue_push_tail(cache->task_queue, task);
+    }
+    if (!g_queue_is_empty(cache->task_queue)) {
+        g_cond_signal(&cache->condition);
+    }
+    g_mutex_unlock(&cache->mutex);
+}
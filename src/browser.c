@@ -1,39 +1,8 @@
 #include "browser.h"
+#include "dir_scan.h"
+#include "path_sort.h"
 #include "renderer.h"
 
-static GList* browser_find_link_with_hint(const FileBrowser *browser, gint target_index) {
-    if (!browser || !browser->image_files || target_index < 0 || target_index >= browser->total_files) {
-        return NULL;
-    }
-
-    GList *cursor = browser->current;
-    gint idx = browser->current_index;
-    if (!cursor || idx < 0 || idx >= browser->total_files) {
-        cursor = browser->image_files;
-        idx = 0;
-    }
-
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    while (cursor && idx > target_index) {
-        cursor = cursor->prev;
-        idx--;
-    }
-    if (cursor && idx == target_index) {
-        return cursor;
-    }
-
-    cursor = browser->image_files;
-    idx = 0;
-    while (cursor && idx < target_index) {
-        cursor = cursor->next;
-        idx++;
-    }
-    return (cursor && idx == target_index) ? cursor : NULL;
-}
-
 // Create a new file browser
 FileBrowser* browser_create(void) {
     FileBrowser *browser = g_new0(FileBrowser, 1);
@@ -42,10 +11,10 @@ FileBrowser* browser_create(void) {
     }
 
     browser->directory_path = NULL;
-    browser->image_files = NULL;
-    browser->current = NULL;
+    browser->image_files = media_index_new(FALSE);
     browser->current_index = -1;
     browser->total_files = 0;
+    browser->defer_validation = FALSE;
 
     return browser;
 }
@@ -57,11 +26,7 @@ void browser_destroy(FileBrowser *browser) {
     }
 
     g_free(browser->directory_path);
-
-    if (browser->image_files) {
-        g_list_free_full(browser->image_files, (GDestroyNotify)g_free);
-    }
-
+    media_index_free(browser->image_files);
     g_free(browser);
 }
 
@@ -78,62 +43,69 @@ ErrorCode browser_scan_directory(FileBrowser *browser, const char *directory) {
 
     // Cleanup existing data
     g_free(browser->directory_path);
-    if (browser->image_files) {
-        g_list_free_full(browser->image_files, (GDestroyNotify)g_free);
-        browser->image_files = NULL;
-    }
+    media_index_clear(browser->image_files);
 
     browser->directory_path = g_strdup(directory);
-    browser->current = NULL;
     browser->current_index = -1;
     browser->total_files = 0;
 
-    // Open directory
-    GDir *dir = g_dir_open(directory, 0, NULL);
-    if (!dir) {
+    GArray *entries = NULL;
+    if (dir_scan_read(directory, &entries) != ERROR_NONE) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    // Collect all files
+    // Classify by extension first; only files that need it are opened
     GList *all_files = NULL;
     gint media_count = 0;
-    const gchar *filename;
-
-    while ((filename = g_dir_read_name(dir)) != NULL) {
-        gchar *full_path = g_build_filename(directory, filename, NULL);
+    GPtrArray *to_sniff = g_ptr_array_new();
+    for (guint i = 0; i < entries->len; i++) {
+        const DirScanEntry *entry = &g_array_index(entries, DirScanEntry, i);
+        if (entry->type != DIR_SCAN_ENTRY_REGULAR) {
+            continue;
+        }
 
-        // Check if it's a regular file and a valid image
-        if (g_file_test(full_path, G_FILE_TEST_IS_REGULAR) &&
-            is_valid_media_file(full_path)) {
+        gchar *full_path = g_build_filename(directory, entry->name, NULL);
+        if (browser->defer_validation && has_media_extension(entry->name)) {
             all_files = g_list_prepend(all_files, full_path);
             media_count++;
         } else {
-            g_free(full_path);
+            g_ptr_array_add(to_sniff, full_path);
         }
     }
+    dir_scan_entries_free(entries);
+
+    if (to_sniff->len > 0) {
+        gboolean *valid = g_new0(gboolean, to_sniff->len);
+        dir_scan_sniff_media((const gchar *const *)to_sniff->pdata, to_sniff->len, valid);
+        for (guint i = 0; i < to_sniff->len; i++) {
+            gchar *full_path = g_ptr_array_index(to_sniff, i);
+            if (valid[i]) {
+                all_files = g_list_prepend(all_files, full_path);
+                media_count++;
+            } else {
+                g_free(full_path);
+            }
+        }
+        g_free(valid);
+    }
+    g_ptr_array_free(to_sniff, TRUE);
 
-    g_dir_close(dir);
-
-    // Sort files alphabetically
-    all_files = g_list_sort(all_files, (GCompareFunc)g_strcmp0);
-
-    // Store the filtered and sorted list
-    browser->image_files = all_files;
-    browser->current = browser->image_files;
-    browser->current_index = browser->current ? 0 : -1;
+    // Sort by name and move the paths into the index
+    all_files = path_sort_list(all_files, FALSE);
+    media_index_merge(browser->image_files, all_files);
     browser->total_files = media_count;
+    browser->current_index = media_count > 0 ? 0 : -1;
 
     return ERROR_NONE;
 }
 
 // Navigate to next file
 ErrorCode browser_next_file(FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser || browser->current_index < 0) {
         return ERROR_INVALID_IMAGE;
     }
 
-    if (browser->current->next) {
-        browser->current = browser->current->next;
+    if (browser->current_index + 1 < browser->total_files) {
         browser->current_index++;
         return ERROR_NONE;
     }
@@ -143,12 +115,11 @@ ErrorCode browser_next_file(FileBrowser *browser) {
 
 // Navigate to previous file
 ErrorCode browser_previous_file(FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser || browser->current_index < 0) {
         return ERROR_INVALID_IMAGE;
     }
 
-    if (browser->current->prev) {
-        browser->current = browser->current->prev;
+    if (browser->current_index > 0) {
         browser->current_index--;
         return ERROR_NONE;
     }
@@ -158,7 +129,7 @@ ErrorCode browser_previous_file(FileBrowser *browser) {
 
 // Go to file by index
 ErrorCode browser_goto_index(FileBrowser *browser, gint index) {
-    if (!browser || !browser->image_files) {
+    if (!browser || browser->total_files <= 0) {
         return ERROR_INVALID_IMAGE;
     }
 
@@ -166,55 +137,34 @@ ErrorCode browser_goto_index(FileBrowser *browser, gint index) {
         return ERROR_INVALID_IMAGE;
     }
 
-    GList *target = browser_find_link_with_hint(browser, index);
-    if (!target) {
-        return ERROR_INVALID_IMAGE;
-    }
-
-    browser->current = target;
     browser->current_index = index;
     return ERROR_NONE;
 }
 
 // Go to file by filename
 ErrorCode browser_goto_filename(FileBrowser *browser, const char *filename) {
-    if (!browser || !browser->image_files || !filename) {
+    if (!browser || browser->total_files <= 0 || !filename) {
         return ERROR_INVALID_IMAGE;
     }
 
-    GList *current = browser->image_files;
     gchar *target_basename = g_path_get_basename(filename);
-
-    gint idx = 0;
-    while (current) {
-        gchar *current_file = (gchar*)current->data;
-        gchar *current_basename = g_path_get_basename(current_file);
-
-        gboolean match = (g_strcmp0(current_basename, target_basename) == 0);
-        g_free(current_basename);
-
-        if (match) {
-            browser->current = current;
-            browser->current_index = idx;
-            g_free(target_basename);
-            return ERROR_NONE;
-        }
-
-        current = g_list_next(current);
-        idx++;
+    gint idx = media_index_find_name(browser->image_files, target_basename);
+    g_free(target_basename);
+    if (idx < 0) {
+        return ERROR_INVALID_IMAGE;
     }
 
-    g_free(target_basename);
-    return ERROR_INVALID_IMAGE;
+    browser->current_index = idx;
+    return ERROR_NONE;
 }
 
 // Get current file path
 const gchar* browser_get_current_file(const FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser) {
         return NULL;
     }
 
-    return (const gchar*)browser->current->data;
+    return media_index_get(browser->image_files, browser->current_index);
 }
 
 // Get directory path
@@ -224,7 +174,7 @@ const gchar* browser_get_directory(const FileBrowser *browser) {
 
 // Get current index
 gint browser_get_current_index(const FileBrowser *browser) {
-    if (!browser || !browser->image_files || !browser->current) {
+    if (!browser || browser->total_files <= 0) {
         return -1;
     }
 
@@ -238,12 +188,12 @@ gint browser_get_total_files(const FileBrowser *browser) {
 
 // Check if browser has files
 gboolean browser_has_files(const FileBrowser *browser) {
-    return browser && browser->image_files && browser->total_files > 0;
+    return browser && browser->total_files > 0;
 }
 
 // Delete current file
 ErrorCode browser_delete_current_file(FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser || browser->current_index < 0) {
         return ERROR_INVALID_IMAGE;
     }
 
@@ -257,56 +207,41 @@ ErrorCode browser_delete_current_file(FileBrowser *browser) {
         return ERROR_FILE_NOT_FOUND;
     }
 
-    // Remove from list
-    GList *to_remove = browser->current;
-    gchar *file_data = (gchar*)to_remove->data;
-
-    // Update current pointer
-    if (to_remove->prev) {
-        browser->current = to_remove->prev;
+    // Remove from the index; the previous file becomes current when there is one
+    media_index_remove(browser->image_files, browser->current_index);
+    browser->total_files--;
+    if (browser->current_index > 0) {
         browser->current_index--;
-    } else if (to_remove->next) {
-        browser->current = to_remove->next;
-        browser->current_index = 0;
-    } else {
-        browser->current = NULL;
-        browser->current_index = -1;
     }
-
-    // Remove from list and free memory
-    browser->image_files = g_list_delete_link(browser->image_files, to_remove);
-    browser->total_files--;
     if (browser->total_files <= 0) {
-        browser->current = NULL;
         browser->current_index = -1;
         browser->total_files = 0;
     }
-    g_free(file_data);
 
     return ERROR_NONE;
 }
 
 // Get all files
-GList* browser_get_all_files(const FileBrowser *browser) {
+const MediaIndex* browser_get_all_files(const FileBrowser *browser) {
     return browser ? browser->image_files : NULL;
 }
 
 // Check if at first file
 gboolean browser_is_at_first(const FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser || browser->current_index < 0) {
         return TRUE;
     }
 
-    return browser->current->prev == NULL;
+    return browser->current_index == 0;
 }
 
 // Check if at last file
 gboolean browser_is_at_last(const FileBrowser *browser) {
-    if (!browser || !browser->current) {
+    if (!browser || browser->current_index < 0) {
         return TRUE;
     }
 
-    return browser->current->next == NULL;
+    return browser->current_index == browser->total_files - 1;
 }
 
 // Reset browser state
@@ -315,6 +250,5 @@ void browser_reset(FileBrowser *browser) {
         return;
     }
 
-    browser->current = browser->image_files;
-    browser->current_index = browser->current ? 0 : -1;
+    browser->current_index = browser->total_files > 0 ? 0 : -1;
 }
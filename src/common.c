@@ -1,3 +1,5 @@
+#define _GNU_SOURCE
+
 #include "common.h"
 #include "process_env.h"
 
@@ -352,6 +354,21 @@ gboolean is_media_file(const char *filename) {
     return is_image_file(filename) || is_video_file(filename);
 }
 
+// Check for a supported image or video extension without touching the file
+gboolean has_media_extension(const char *filename) {
+    const char *ext = get_file_extension(filename);
+    if (!ext) {
+        return FALSE;
+    }
+
+    for (int i = 0; SUPPORTED_EXTENSIONS[i] != NULL; i++) {
+        if (g_ascii_strcasecmp(ext, SUPPORTED_EXTENSIONS[i]) == 0) {
+            return TRUE;
+        }
+    }
+    return is_video_file(filename);
+}
+
 // Check if a file is a book based on its extension
 gboolean is_book_file(const char *filename) {
     if (!filename) {
@@ -555,6 +572,50 @@ gint64 get_file_mtime(const char *path) {
     return st.st_mtime;
 }
 
+gint64 stat_mtime_ns(const struct stat *st) {
+    if (!st) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return (gint64)st->st_mtimespec.tv_sec * G_GINT64_CONSTANT(1000000000) + st->st_mtimespec.tv_nsec;
+#else
+    return (gint64)st->st_mtim.tv_sec * G_GINT64_CONSTANT(1000000000) + st->st_mtim.tv_nsec;
+#endif
+}
+
+typedef struct {
+    ParallelForFunc func;
+    gpointer user_data;
+} ParallelForJob;
+
+static void parallel_for_worker(gpointer data, gpointer user_data) {
+    ParallelForJob *job = (ParallelForJob *)user_data;
+    job->func(GPOINTER_TO_UINT(data) - 1, job->user_data);
+}
+
+void parallel_for(guint count, guint max_threads, ParallelForFunc func, gpointer user_data) {
+    if (!func || count == 0) {
+        return;
+    }
+
+    ParallelForJob job = {func, user_data};
+    GThreadPool *pool = NULL;
+    if (MIN(count, max_threads) > 1) {
+        pool = g_thread_pool_new(parallel_for_worker, &job, (gint)MIN(count, max_threads), FALSE, NULL);
+    }
+    if (!pool) {
+        for (guint i = 0; i < count; i++) {
+            func(i, user_data);
+        }
+        return;
+    }
+    for (guint i = 0; i < count; i++) {
+        // Indices are offset by one so that index 0 is not pushed as NULL.
+        g_thread_pool_push(pool, GUINT_TO_POINTER(i + 1), NULL);
+    }
+    g_thread_pool_free(pool, FALSE, TRUE);
+}
+
 // Cleanup string helper
 void cleanup_string(gchar **str) {
     if (str && *str) {
@@ -0,0 +1,346 @@
+#define _GNU_SOURCE
+
+#include "dir_loader.h"
+#include "dir_scan.h"
+#include "event_loop.h"
+#include "path_sort.h"
+#include "trace.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+typedef struct {
+    gchar *path;
+    gint depth;
+} DirLoaderJob;
+
+typedef struct {
+    dev_t dev;
+    ino_t ino;
+} DirLoaderDirId;
+
+// Results a worker has found but not yet published.
+typedef struct {
+    GList *paths;
+    guint len;
+    guint limit;
+} DirLoaderBatch;
+
+struct DirLoader {
+    gchar *directory;
+    gsize root_len;
+    gchar *skip_name;
+    gboolean natural_sort;
+    gint max_depth;
+    MediaMetaStore *known;  // Private copy, only read by the workers
+    GThread *threads[DIR_LOADER_MAX_WORKERS];
+    guint thread_count;
+    gint cancelled;         // atomic
+
+    GMutex mutex;
+    GCond cond;
+    GQueue batches;         // Sorted GList* batches of owned paths
+    GList *rejected;        // Owned paths whose sniff found no media
+    GQueue jobs;            // DirLoaderJob* still to scan
+    guint busy_workers;     // Workers scanning a directory
+    guint live_workers;     // Workers that have not exited
+    GHashTable *visited;    // DirLoaderDirId of every directory queued
+    gboolean finished;
+};
+
+static guint dir_loader_dir_id_hash(gconstpointer key) {
+    const DirLoaderDirId *id = key;
+    return (guint)id->ino ^ (guint)((guint64)id->ino >> 32) ^ ((guint)id->dev * 31u);
+}
+
+static gboolean dir_loader_dir_id_equal(gconstpointer a, gconstpointer b) {
+    const DirLoaderDirId *id_a = a;
+    const DirLoaderDirId *id_b = b;
+    return id_a->dev == id_b->dev && id_a->ino == id_b->ino;
+}
+
+static void dir_loader_job_free(gpointer data) {
+    DirLoaderJob *job = data;
+    g_free(job->path);
+    g_free(job);
+}
+
+// Queues @p path unless the same directory was reached before, which is what
+// stops symlink loops. Called with the mutex held.
+static void dir_loader_queue_locked(DirLoader *loader, gchar *path, gint depth) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        g_free(path);
+        return;
+    }
+    DirLoaderDirId *id = g_new(DirLoaderDirId, 1);
+    id->dev = st.st_dev;
+    id->ino = st.st_ino;
+    if (!g_hash_table_add(loader->visited, id)) {
+        g_free(path);
+        return;
+    }
+
+    DirLoaderJob *job = g_new(DirLoaderJob, 1);
+    job->path = path;
+    job->depth = depth;
+    g_queue_push_tail(&loader->jobs, job);
+    g_cond_signal(&loader->cond);
+}
+
+static void dir_loader_publish(DirLoader *loader, DirLoaderBatch *batch) {
+    if (!batch->paths) {
+        return;
+    }
+    GList *sorted = path_sort_list_relative(batch->paths, loader->root_len, loader->natural_sort);
+    g_mutex_lock(&loader->mutex);
+    g_queue_push_tail(&loader->batches, sorted);
+    g_mutex_unlock(&loader->mutex);
+    event_loop_wake();
+    batch->paths = NULL;
+    batch->len = 0;
+}
+
+static void dir_loader_add(DirLoader *loader, DirLoaderBatch *batch, gchar *path) {
+    batch->paths = g_list_prepend(batch->paths, path);
+    if (++batch->len >= batch->limit) {
+        dir_loader_publish(loader, batch);
+        batch->limit = MIN(batch->limit * 2, DIR_LOADER_MAX_BATCH);
+    }
+}
+
+static void dir_loader_scan(DirLoader *loader, const DirLoaderJob *job, DirLoaderBatch *batch) {
+    DirScanIter *iter = dir_scan_open(job->path);
+    if (!iter) {
+        return;
+    }
+
+    GPtrArray *to_sniff = g_ptr_array_new_with_free_func(g_free);
+    GPtrArray *subdirs = g_ptr_array_new();
+    const gchar *name = NULL;
+    DirScanEntryType type = DIR_SCAN_ENTRY_REGULAR;
+    while (!g_atomic_int_get(&loader->cancelled) && dir_scan_next(iter, &name, &type)) {
+        if (type == DIR_SCAN_ENTRY_DIRECTORY) {
+            // Hidden directories hold caches and thumbnails, not the collection
+            if (job->depth < loader->max_depth && name[0] != '.') {
+                g_ptr_array_add(subdirs, g_build_filename(job->path, name, NULL));
+            }
+            continue;
+        }
+        if (job->depth == 0 && loader->skip_name && strcmp(name, loader->skip_name) == 0) {
+            continue;
+        }
+
+        gchar *path = g_build_filename(job->path, name, NULL);
+        if (!has_media_extension(name)) {
+            // An unchanged file keeps the verdict it had last time
+            MediaMeta meta;
+            if (!media_meta_store_match(loader->known, path, &meta)) {
+                g_ptr_array_add(to_sniff, path);
+            } else if (meta.kind != MEDIA_KIND_UNKNOWN) {
+                dir_loader_add(loader, batch, path);
+            } else {
+                g_free(path);
+            }
+            continue;
+        }
+        dir_loader_add(loader, batch, path);
+    }
+    dir_scan_close(iter);
+
+    if (subdirs->len > 0) {
+        g_mutex_lock(&loader->mutex);
+        for (guint i = 0; i < subdirs->len; i++) {
+            dir_loader_queue_locked(loader, g_ptr_array_index(subdirs, i), job->depth + 1);
+        }
+        g_mutex_unlock(&loader->mutex);
+    }
+    g_ptr_array_free(subdirs, TRUE);
+
+    // Files without a media extension need their content checked; do them last.
+    if (to_sniff->len > 0 && !g_atomic_int_get(&loader->cancelled)) {
+        gboolean *valid = g_new0(gboolean, to_sniff->len);
+        dir_scan_sniff_media((const gchar *const *)to_sniff->pdata, to_sniff->len, valid);
+        GList *rejected = NULL;
+        for (guint i = 0; i < to_sniff->len; i++) {
+            if (valid[i]) {
+                dir_loader_add(loader, batch, g_ptr_array_index(to_sniff, i));
+            } else {
+                rejected = g_list_prepend(rejected, g_ptr_array_index(to_sniff, i));
+            }
+            to_sniff->pdata[i] = NULL;
+        }
+        g_free(valid);
+        if (rejected) {
+            g_mutex_lock(&loader->mutex);
+            loader->rejected = g_list_concat(rejected, loader->rejected);
+            g_mutex_unlock(&loader->mutex);
+        }
+    }
+    g_ptr_array_free(to_sniff, TRUE);
+}
+
+static gpointer dir_loader_thread(gpointer data) {
+    DirLoader *loader = (DirLoader *)data;
+    DirLoaderBatch batch = {NULL, 0, DIR_LOADER_FIRST_BATCH};
+    trace_set_thread_name("dir-loader");
+
+    g_mutex_lock(&loader->mutex);
+    while (!g_atomic_int_get(&loader->cancelled)) {
+        DirLoaderJob *job = g_queue_pop_head(&loader->jobs);
+        if (!job) {
+            if (loader->busy_workers == 0) {
+                break;  // Nothing queued and nobody left to queue more
+            }
+            // Hand over what this worker has before it sits idle
+            if (batch.paths) {
+                g_mutex_unlock(&loader->mutex);
+                dir_loader_publish(loader, &batch);
+                g_mutex_lock(&loader->mutex);
+                continue;
+            }
+            g_cond_wait(&loader->cond, &loader->mutex);
+            continue;
+        }
+
+        loader->busy_workers++;
+        g_mutex_unlock(&loader->mutex);
+        dir_loader_scan(loader, job, &batch);
+        dir_loader_job_free(job);
+        g_mutex_lock(&loader->mutex);
+        loader->busy_workers--;
+        if (loader->busy_workers == 0 && g_queue_is_empty(&loader->jobs)) {
+            g_cond_broadcast(&loader->cond);
+        }
+    }
+    g_mutex_unlock(&loader->mutex);
+
+    if (g_atomic_int_get(&loader->cancelled)) {
+        g_list_free_full(batch.paths, g_free);
+    } else {
+        dir_loader_publish(loader, &batch);
+    }
+
+    g_mutex_lock(&loader->mutex);
+    if (--loader->live_workers == 0) {
+        loader->finished = TRUE;
+    }
+    g_cond_broadcast(&loader->cond);
+    g_mutex_unlock(&loader->mutex);
+    // The main loop sleeps until told; let it merge the results or finish
+    event_loop_wake();
+    return NULL;
+}
+
+DirLoader* dir_loader_start(const char *directory, const char *skip_name, gboolean natural_sort, gint max_depth,
+                            const MediaMetaStore *known) {
+    if (!directory) {
+        return NULL;
+    }
+
+    DirLoader *loader = g_new0(DirLoader, 1);
+    loader->directory = g_strdup(directory);
+    loader->root_len = strlen(directory);
+    loader->skip_name = g_strdup(skip_name);
+    loader->natural_sort = natural_sort;
+    loader->max_depth = CLAMP(max_depth, 0, DIR_LOADER_MAX_DEPTH);
+    loader->known = media_meta_store_copy(known);
+    g_mutex_init(&loader->mutex);
+    g_cond_init(&loader->cond);
+    g_queue_init(&loader->batches);
+    g_queue_init(&loader->jobs);
+    loader->visited = g_hash_table_new_full(dir_loader_dir_id_hash, dir_loader_dir_id_equal, g_free, NULL);
+
+    g_mutex_lock(&loader->mutex);
+    dir_loader_queue_locked(loader, g_strdup(directory), 0);
+    g_mutex_unlock(&loader->mutex);
+
+    // A single directory is one sequential listing; a tree spreads its
+    // subdirectories over several workers.
+    guint wanted = loader->max_depth > 0
+                   ? (guint)CLAMP(g_get_num_processors(), 2, DIR_LOADER_MAX_WORKERS)
+                   : 1;
+    for (guint i = 0; i < wanted; i++) {
+        g_mutex_lock(&loader->mutex);
+        loader->live_workers++;
+        g_mutex_unlock(&loader->mutex);
+        GThread *thread = g_thread_try_new("dir-loader", dir_loader_thread, loader, NULL);
+        if (!thread) {
+            g_mutex_lock(&loader->mutex);
+            loader->live_workers--;
+            g_mutex_unlock(&loader->mutex);
+            break;
+        }
+        loader->threads[loader->thread_count++] = thread;
+    }
+    if (loader->thread_count == 0) {
+        dir_loader_free(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+void dir_loader_free(DirLoader *loader) {
+    if (!loader) {
+        return;
+    }
+
+    g_atomic_int_set(&loader->cancelled, 1);
+    g_mutex_lock(&loader->mutex);
+    g_cond_broadcast(&loader->cond);
+    g_mutex_unlock(&loader->mutex);
+    for (guint i = 0; i < loader->thread_count; i++) {
+        g_thread_join(loader->threads[i]);
+    }
+
+    GList *batch = NULL;
+    while ((batch = g_queue_pop_head(&loader->batches)) != NULL) {
+        g_list_free_full(batch, g_free);
+    }
+    g_queue_clear_full(&loader->jobs, dir_loader_job_free);
+    g_list_free_full(loader->rejected, g_free);
+    media_meta_store_free(loader->known);
+    g_hash_table_unref(loader->visited);
+    g_cond_clear(&loader->cond);
+    g_mutex_clear(&loader->mutex);
+    g_free(loader->skip_name);
+    g_free(loader->directory);
+    g_free(loader);
+}
+
+GList* dir_loader_take(DirLoader *loader, gboolean *out_done) {
+    if (out_done) {
+        *out_done = FALSE;
+    }
+    if (!loader) {
+        return NULL;
+    }
+
+    g_mutex_lock(&loader->mutex);
+    GQueue pending = loader->batches;
+    g_queue_init(&loader->batches);
+    gboolean finished = loader->finished;
+    g_mutex_unlock(&loader->mutex);
+
+    GList *merged = NULL;
+    GList *batch = NULL;
+    while ((batch = g_queue_pop_head(&pending)) != NULL) {
+        merged = path_sort_merge_relative(merged, batch, loader->root_len, loader->natural_sort);
+    }
+
+    if (out_done) {
+        *out_done = finished;
+    }
+    return merged;
+}
+
+GList* dir_loader_take_rejected(DirLoader *loader) {
+    if (!loader) {
+        return NULL;
+    }
+    g_mutex_lock(&loader->mutex);
+    GList *rejected = loader->rejected;
+    loader->rejected = NULL;
+    g_mutex_unlock(&loader->mutex);
+    return rejected;
+}
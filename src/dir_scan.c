@@ -0,0 +1,144 @@
+#define _GNU_SOURCE
+
+#include "dir_scan.h"
+#include "trace.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+// Below this many paths the thread pool costs more than it saves.
+#define DIR_SCAN_SNIFF_MIN_PARALLEL 4
+
+typedef struct {
+    const gchar *const *paths;
+    gboolean *out_valid;
+} DirScanSniffBatch;
+
+static gboolean dir_scan_resolve_type(int dir_fd, const struct dirent *entry, DirScanEntryType *out_type) {
+#ifdef DT_UNKNOWN
+    if (entry->d_type == DT_REG) {
+        *out_type = DIR_SCAN_ENTRY_REGULAR;
+        return TRUE;
+    }
+    if (entry->d_type == DT_DIR) {
+        *out_type = DIR_SCAN_ENTRY_DIRECTORY;
+        return TRUE;
+    }
+    if (entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN) {
+        return FALSE;
+    }
+#endif
+
+    // Symlinks and DT_UNKNOWN need a stat; follow links like g_file_test does.
+    struct stat st;
+    if (fstatat(dir_fd, entry->d_name, &st, 0) != 0) {
+        return FALSE;
+    }
+    if (S_ISREG(st.st_mode)) {
+        *out_type = DIR_SCAN_ENTRY_REGULAR;
+        return TRUE;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        *out_type = DIR_SCAN_ENTRY_DIRECTORY;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+struct DirScanIter {
+    DIR *dir;
+};
+
+DirScanIter* dir_scan_open(const char *directory) {
+    if (!directory) {
+        return NULL;
+    }
+    DIR *dir = opendir(directory);
+    if (!dir) {
+        return NULL;
+    }
+    DirScanIter *iter = g_new0(DirScanIter, 1);
+    iter->dir = dir;
+    return iter;
+}
+
+gboolean dir_scan_next(DirScanIter *iter, const gchar **out_name, DirScanEntryType *out_type) {
+    if (!iter || !out_name || !out_type) {
+        return FALSE;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(iter->dir)) != NULL) {
+        const char *name = entry->d_name;
+        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+            continue;
+        }
+        if (dir_scan_resolve_type(dirfd(iter->dir), entry, out_type)) {
+            *out_name = name;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+void dir_scan_close(DirScanIter *iter) {
+    if (!iter) {
+        return;
+    }
+    closedir(iter->dir);
+    g_free(iter);
+}
+
+ErrorCode dir_scan_read(const char *directory, GArray **out_entries) {
+    if (!directory || !out_entries) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    *out_entries = NULL;
+
+    DirScanIter *iter = dir_scan_open(directory);
+    if (!iter) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_SCAN, "read");
+    GArray *entries = g_array_new(FALSE, FALSE, sizeof(DirScanEntry));
+    const gchar *name = NULL;
+    DirScanEntry scanned = {0};
+    while (dir_scan_next(iter, &name, &scanned.type)) {
+        scanned.name = g_strdup(name);
+        g_array_append_val(entries, scanned);
+    }
+    dir_scan_close(iter);
+    trace_span_end_arg(&span, "entries", entries->len);
+
+    *out_entries = entries;
+    return ERROR_NONE;
+}
+
+void dir_scan_entries_free(GArray *entries) {
+    if (!entries) {
+        return;
+    }
+    for (guint i = 0; i < entries->len; i++) {
+        g_free(g_array_index(entries, DirScanEntry, i).name);
+    }
+    g_array_free(entries, TRUE);
+}
+
+static void dir_scan_sniff_slot(guint slot, gpointer user_data) {
+    DirScanSniffBatch *batch = (DirScanSniffBatch *)user_data;
+    batch->out_valid[slot] = is_valid_media_file(batch->paths[slot]);
+}
+
+void dir_scan_sniff_media(const gchar *const *paths, guint count, gboolean *out_valid) {
+    if (!paths || !out_valid || count == 0) {
+        return;
+    }
+
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_SCAN, "sniff");
+    DirScanSniffBatch batch = {paths, out_valid};
+    parallel_for(count, count >= DIR_SCAN_SNIFF_MIN_PARALLEL ? DIR_SCAN_SNIFF_MAX_THREADS : 1,
+                 dir_scan_sniff_slot, &batch);
+    trace_span_end_arg(&span, "files", count);
+}
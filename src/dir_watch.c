@@ -0,0 +1,274 @@
+#define _GNU_SOURCE
+
+#include "dir_watch.h"
+#include "dir_scan.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+typedef struct {
+    gint64 mtime_ns;
+    gint64 size;
+    gboolean is_directory;
+} DirWatchStat;
+
+struct DirWatch {
+    gchar *directory;
+    gint dir_fd;            // Directory handle for fstatat
+    gint inotify_fd;        // -1 when polling
+    GHashTable *snapshot;   // name -> DirWatchStat, polling only
+    gint64 poll_interval_us;
+    gint64 next_poll_us;
+};
+
+static void dir_watch_push(GArray *events, DirWatchEventType type, const gchar *name, gboolean is_directory) {
+    DirWatchEvent event = {
+        .type = type,
+        .name = g_strdup(name),
+        .is_directory = is_directory
+    };
+    g_array_append_val(events, event);
+}
+
+static void dir_watch_event_clear(gpointer data) {
+    DirWatchEvent *event = (DirWatchEvent *)data;
+    g_free(event->name);
+}
+
+// Stats @p name relative to the directory, following symlinks the way
+// dir_scan does. Returns FALSE for anything but regular files and directories.
+static gboolean dir_watch_stat(const DirWatch *watch, const gchar *name, DirWatchStat *out_stat) {
+    struct stat st;
+    if (fstatat(watch->dir_fd, name, &st, 0) != 0) {
+        return FALSE;
+    }
+    if (!S_ISREG(st.st_mode) && !S_ISDIR(st.st_mode)) {
+        return FALSE;
+    }
+    out_stat->is_directory = S_ISDIR(st.st_mode);
+    out_stat->size = (gint64)st.st_size;
+    out_stat->mtime_ns = stat_mtime_ns(&st);
+    return TRUE;
+}
+
+static GHashTable* dir_watch_snapshot(const DirWatch *watch) {
+    DirScanIter *iter = dir_scan_open(watch->directory);
+    if (!iter) {
+        return NULL;
+    }
+
+    GHashTable *snapshot = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    const gchar *name = NULL;
+    DirScanEntryType type = DIR_SCAN_ENTRY_REGULAR;
+    while (dir_scan_next(iter, &name, &type)) {
+        DirWatchStat *stat = g_new0(DirWatchStat, 1);
+        stat->is_directory = type == DIR_SCAN_ENTRY_DIRECTORY;
+        // Directory contents are not tracked, so only files need timestamps.
+        if (!stat->is_directory && !dir_watch_stat(watch, name, stat)) {
+            g_free(stat);
+            continue;
+        }
+        g_hash_table_insert(snapshot, g_strdup(name), stat);
+    }
+    dir_scan_close(iter);
+    return snapshot;
+}
+
+static void dir_watch_diff(DirWatch *watch, GArray *events) {
+    GHashTable *current = dir_watch_snapshot(watch);
+    if (!current) {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    g_hash_table_iter_init(&iter, watch->snapshot);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const DirWatchStat *before = value;
+        const DirWatchStat *after = g_hash_table_lookup(current, key);
+        if (!after || after->is_directory != before->is_directory) {
+            dir_watch_push(events, DIR_WATCH_EVENT_REMOVED, key, before->is_directory);
+        } else if (!after->is_directory &&
+                   (after->mtime_ns != before->mtime_ns || after->size != before->size)) {
+            dir_watch_push(events, DIR_WATCH_EVENT_MODIFIED, key, FALSE);
+        }
+    }
+    g_hash_table_iter_init(&iter, current);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const DirWatchStat *after = value;
+        const DirWatchStat *before = g_hash_table_lookup(watch->snapshot, key);
+        if (!before || before->is_directory != after->is_directory) {
+            dir_watch_push(events, DIR_WATCH_EVENT_ADDED, key, after->is_directory);
+        }
+    }
+
+    g_hash_table_unref(watch->snapshot);
+    watch->snapshot = current;
+}
+
+#ifdef __linux__
+static void dir_watch_read_inotify(DirWatch *watch, GArray *events) {
+    gchar buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    for (;;) {
+        ssize_t len = read(watch->inotify_fd, buffer, sizeof(buffer));
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            break;
+        }
+
+        for (const gchar *ptr = buffer; ptr < buffer + len; ) {
+            const struct inotify_event *ev = (const struct inotify_event *)ptr;
+            ptr += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                dir_watch_push(events, DIR_WATCH_EVENT_RESCAN, NULL, FALSE);
+                continue;
+            }
+            if (ev->len == 0 || !ev->name[0]) {
+                continue;
+            }
+
+            gboolean is_directory = (ev->mask & IN_ISDIR) != 0;
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+                // Resolve symlinks and skip sockets and fifos, matching dir_scan
+                DirWatchStat stat;
+                if (dir_watch_stat(watch, ev->name, &stat)) {
+                    dir_watch_push(events, DIR_WATCH_EVENT_ADDED, ev->name, stat.is_directory);
+                }
+            } else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                dir_watch_push(events, DIR_WATCH_EVENT_REMOVED, ev->name, is_directory);
+            } else if ((ev->mask & IN_CLOSE_WRITE) && !is_directory) {
+                dir_watch_push(events, DIR_WATCH_EVENT_MODIFIED, ev->name, FALSE);
+            }
+        }
+    }
+}
+
+static gint dir_watch_open_inotify(const char *directory) {
+    gint fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                          IN_CLOSE_WRITE | IN_ONLYDIR;
+    if (inotify_add_watch(fd, directory, mask) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+#endif
+
+DirWatch* dir_watch_new(const char *directory, DirWatchBackend backend) {
+    if (!directory) {
+        return NULL;
+    }
+    gint dir_fd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        return NULL;
+    }
+
+    DirWatch *watch = g_new0(DirWatch, 1);
+    watch->directory = g_strdup(directory);
+    watch->dir_fd = dir_fd;
+    watch->inotify_fd = -1;
+    watch->poll_interval_us = DIR_WATCH_POLL_INTERVAL_US;
+
+#ifdef __linux__
+    if (backend == DIR_WATCH_BACKEND_AUTO) {
+        watch->inotify_fd = dir_watch_open_inotify(directory);
+    }
+#else
+    (void)backend;
+#endif
+
+    if (watch->inotify_fd < 0) {
+        watch->snapshot = dir_watch_snapshot(watch);
+        if (!watch->snapshot) {
+            dir_watch_free(watch);
+            return NULL;
+        }
+        watch->next_poll_us = g_get_monotonic_time() + watch->poll_interval_us;
+    }
+    return watch;
+}
+
+void dir_watch_free(DirWatch *watch) {
+    if (!watch) {
+        return;
+    }
+    if (watch->inotify_fd >= 0) {
+        close(watch->inotify_fd);
+    }
+    if (watch->dir_fd >= 0) {
+        close(watch->dir_fd);
+    }
+    if (watch->snapshot) {
+        g_hash_table_unref(watch->snapshot);
+    }
+    g_free(watch->directory);
+    g_free(watch);
+}
+
+const gchar* dir_watch_get_directory(const DirWatch *watch) {
+    return watch ? watch->directory : NULL;
+}
+
+gboolean dir_watch_is_polling(const DirWatch *watch) {
+    return watch && watch->inotify_fd < 0;
+}
+
+gint dir_watch_get_fd(const DirWatch *watch) {
+    return watch ? watch->inotify_fd : -1;
+}
+
+void dir_watch_set_poll_interval(DirWatch *watch, gint64 interval_us) {
+    if (!watch) {
+        return;
+    }
+    watch->poll_interval_us = MAX(interval_us, 0);
+    watch->next_poll_us = MIN(watch->next_poll_us, g_get_monotonic_time() + watch->poll_interval_us);
+}
+
+GArray* dir_watch_take_events(DirWatch *watch) {
+    if (!watch) {
+        return NULL;
+    }
+
+    GArray *events = g_array_new(FALSE, FALSE, sizeof(DirWatchEvent));
+    g_array_set_clear_func(events, dir_watch_event_clear);
+
+#ifdef __linux__
+    if (watch->inotify_fd >= 0) {
+        dir_watch_read_inotify(watch, events);
+    }
+#endif
+    if (watch->inotify_fd < 0) {
+        gint64 now = g_get_monotonic_time();
+        if (now >= watch->next_poll_us) {
+            dir_watch_diff(watch, events);
+            watch->next_poll_us = now + watch->poll_interval_us;
+        }
+    }
+
+    if (events->len == 0) {
+        g_array_free(events, TRUE);
+        return NULL;
+    }
+    return events;
+}
+
+void dir_watch_events_free(GArray *events) {
+    if (events) {
+        g_array_free(events, TRUE);
+    }
+}
@@ -0,0 +1,158 @@
+#define _GNU_SOURCE
+
+#include "event_loop.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+// Our descriptors come first in the poll set, the context's after them.
+enum {
+    EVENT_LOOP_SLOT_INPUT = 0,
+    EVENT_LOOP_SLOT_SIGNAL,
+    EVENT_LOOP_SLOT_WATCH,
+    EVENT_LOOP_OWN_SLOTS
+};
+
+struct EventLoop {
+    gint input_fd;
+    gint watch_fd;
+    gint signal_pipe[2];
+    GPollFD *fds;
+    gint fds_alloc;
+};
+
+// Write end of the current loop's signal pipe, read by signal handlers.
+static volatile sig_atomic_t g_event_loop_signal_fd = -1;
+
+static gboolean event_loop_open_pipe(gint fds[2]) {
+    // macOS has O_CLOEXEC but no pipe2
+#ifdef __linux__
+    if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) == 0) {
+        return TRUE;
+    }
+#endif
+    if (pipe(fds) != 0) {
+        return FALSE;
+    }
+    for (gint i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[i], F_SETFL, fcntl(fds[i], F_GETFL) | O_NONBLOCK);
+    }
+    return TRUE;
+}
+
+EventLoop* event_loop_new(gint input_fd) {
+    EventLoop *loop = g_new0(EventLoop, 1);
+    loop->input_fd = input_fd;
+    loop->watch_fd = -1;
+    if (!event_loop_open_pipe(loop->signal_pipe)) {
+        g_free(loop);
+        return NULL;
+    }
+    loop->fds_alloc = EVENT_LOOP_OWN_SLOTS + 8;
+    loop->fds = g_new0(GPollFD, loop->fds_alloc);
+    g_event_loop_signal_fd = loop->signal_pipe[1];
+    return loop;
+}
+
+void event_loop_free(EventLoop *loop) {
+    if (!loop) {
+        return;
+    }
+    if (g_event_loop_signal_fd == loop->signal_pipe[1]) {
+        g_event_loop_signal_fd = -1;
+    }
+    close(loop->signal_pipe[0]);
+    close(loop->signal_pipe[1]);
+    g_free(loop->fds);
+    g_free(loop);
+}
+
+void event_loop_set_watch_fd(EventLoop *loop, gint fd) {
+    if (loop) {
+        loop->watch_fd = fd;
+    }
+}
+
+void event_loop_notify_signal(int signum) {
+    int saved_errno = errno;
+    int fd = g_event_loop_signal_fd;
+    if (fd >= 0) {
+        unsigned char byte = (unsigned char)signum;
+        // A full pipe already guarantees a wakeup; the byte can be dropped
+        ssize_t written = write(fd, &byte, 1);
+        (void)written;
+    }
+    errno = saved_errno;
+}
+
+void event_loop_wake(void) {
+    g_main_context_wakeup(NULL);
+}
+
+static guint event_loop_drain_signals(EventLoop *loop) {
+    guint ready = EVENT_LOOP_READY_NONE;
+    unsigned char bytes[64];
+    ssize_t n = 0;
+    while ((n = read(loop->signal_pipe[0], bytes, sizeof(bytes))) > 0) {
+        for (ssize_t i = 0; i < n; i++) {
+            ready |= bytes[i] == SIGWINCH ? EVENT_LOOP_READY_RESIZE : EVENT_LOOP_READY_SIGNAL;
+        }
+    }
+    return ready;
+}
+
+guint event_loop_wait(EventLoop *loop, gint timeout_ms) {
+    if (!loop) {
+        return EVENT_LOOP_READY_NONE;
+    }
+
+    GMainContext *context = g_main_context_default();
+    gboolean owns_context = g_main_context_acquire(context);
+    gint max_priority = G_PRIORITY_DEFAULT;
+    gint context_timeout = -1;
+    gint context_fds = 0;
+    if (owns_context) {
+        g_main_context_prepare(context, &max_priority);
+        while ((context_fds = g_main_context_query(context, max_priority, &context_timeout,
+                                                   loop->fds + EVENT_LOOP_OWN_SLOTS,
+                                                   loop->fds_alloc - EVENT_LOOP_OWN_SLOTS)) >
+               loop->fds_alloc - EVENT_LOOP_OWN_SLOTS) {
+            loop->fds_alloc = EVENT_LOOP_OWN_SLOTS + context_fds;
+            loop->fds = g_renew(GPollFD, loop->fds, loop->fds_alloc);
+        }
+    }
+
+    loop->fds[EVENT_LOOP_SLOT_INPUT] = (GPollFD){loop->input_fd, G_IO_IN | G_IO_HUP | G_IO_ERR, 0};
+    loop->fds[EVENT_LOOP_SLOT_SIGNAL] = (GPollFD){loop->signal_pipe[0], G_IO_IN, 0};
+    loop->fds[EVENT_LOOP_SLOT_WATCH] = (GPollFD){loop->watch_fd, G_IO_IN, 0};
+
+    gint timeout = timeout_ms;
+    if (context_timeout >= 0 && (timeout < 0 || context_timeout < timeout)) {
+        timeout = context_timeout;
+    }
+    // Negative descriptors are ignored by poll, so unused slots stay in place.
+    // A signal interrupts the poll with EINTR; its byte is read on the next wait.
+    (void)g_poll(loop->fds, EVENT_LOOP_OWN_SLOTS + context_fds, timeout);
+
+    if (owns_context) {
+        if (g_main_context_check(context, max_priority, loop->fds + EVENT_LOOP_OWN_SLOTS, context_fds)) {
+            g_main_context_dispatch(context);
+        }
+        g_main_context_release(context);
+    }
+
+    guint ready = EVENT_LOOP_READY_NONE;
+    if (loop->input_fd >= 0 && loop->fds[EVENT_LOOP_SLOT_INPUT].revents) {
+        ready |= EVENT_LOOP_READY_INPUT;
+    }
+    if (loop->watch_fd >= 0 && loop->fds[EVENT_LOOP_SLOT_WATCH].revents) {
+        ready |= EVENT_LOOP_READY_WATCH;
+    }
+    if (loop->fds[EVENT_LOOP_SLOT_SIGNAL].revents) {
+        ready |= event_loop_drain_signals(loop);
+    }
+    return ready;
+}
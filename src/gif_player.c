@@ -2,6 +2,11 @@
 
 #include "gif_player.h"
 #include "common.h"
+#include "term_output.h"
+#include "kitty_animation.h"
+#include "kitty_graphics.h"
+#include "metrics.h"
+#include "trace.h"
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include <chafa.h>
 #include <unistd.h>
@@ -20,6 +25,41 @@ static void gif_player_clear_line_cache(GifPlayer *player) {
     player->last_frame_lines = NULL;
 }
 
+static void gif_player_write_commands(const GString *commands) {
+    if (!commands || commands->len == 0) {
+        return;
+    }
+    term_output_begin_frame();
+    fwrite(commands->str, 1, commands->len, stdout);
+    (void)term_output_end_frame();
+}
+
+// Frees the kitty animation and appends the delete for the terminal's copy.
+static void gif_player_kitty_release(GifPlayer *player, GString *out) {
+    if (!player) {
+        return;
+    }
+    if (player->kitty_animation) {
+        kitty_animation_append_delete(player->kitty_animation, out);
+        g_clear_pointer(&player->kitty_animation, kitty_animation_free);
+    }
+    g_clear_object(&player->kitty_iter);
+    player->kitty_iter_time_ms = 0;
+}
+
+static gint gif_player_frame_delay(GdkPixbufAnimationIter *iter) {
+    gint delay = gdk_pixbuf_animation_iter_get_delay_time(iter);
+    if (delay < 0) {
+        return delay;
+    }
+    return delay < 10 ? 10 : delay; // Minimum delay guard
+}
+
+static void gif_player_time_from_ms(gint64 ms, GTimeVal *out) {
+    out->tv_sec = (glong)(ms / 1000);
+    out->tv_usec = (glong)((ms % 1000) * 1000);
+}
+
 static void gif_player_present_rendered_frame(GifPlayer *player,
                                               const GString *result,
                                               gint rendered_w,
@@ -29,6 +69,7 @@ static void gif_player_present_rendered_frame(GifPlayer *player,
         return;
     }
 
+    term_output_begin_frame();
     if (player->render_layout_valid && player->render_area_top_row > 0 && player->render_area_height > 0) {
         gint term_w = player->render_term_width > 0 ? player->render_term_width : player->render_max_width;
         gint term_h = player->render_term_height;
@@ -165,7 +206,7 @@ static void gif_player_present_rendered_frame(GifPlayer *player,
         player->last_frame_height = 0;
     }
 
-    fflush(stdout);
+    (void)term_output_end_frame();
 }
 
 // Create a new GIF player instance
@@ -201,6 +242,12 @@ GifPlayer* gif_player_new(gint work_factor, gboolean force_text, gboolean force_
     player->fixed_frame_valid = FALSE;
     player->last_frame_lines = NULL;
     player->owns_renderer = FALSE;
+    player->kitty_animation = NULL;
+    player->kitty_iter = NULL;
+    player->kitty_iter_time_ms = 0;
+    player->kitty_loop_frames = 0;
+    player->kitty_loop_count = 0;
+    player->kitty_unsupported = FALSE;
     
     // Initialize internal renderer
     player->renderer = renderer_create();
@@ -294,6 +341,11 @@ void gif_player_destroy(GifPlayer *player) {
     }
 
     gif_player_stop(player);
+
+    GString *deletes = g_string_new(NULL);
+    gif_player_kitty_release(player, deletes);
+    gif_player_write_commands(deletes);
+    g_string_free(deletes, TRUE);
     
     g_free(player->filepath);
     if (player->canvas) {
@@ -327,6 +379,13 @@ ErrorCode gif_player_load(GifPlayer *player, const gchar *filepath) {
     gif_player_stop(player);
     
     // Clean up previous resources
+    GString *deletes = g_string_new(NULL);
+    gif_player_kitty_release(player, deletes);
+    gif_player_write_commands(deletes);
+    g_string_free(deletes, TRUE);
+    player->kitty_loop_frames = 0;
+    player->kitty_loop_count = 0;
+    player->kitty_unsupported = FALSE;
     if (player->iter) {
         g_object_unref(player->iter);
         player->iter = NULL;
@@ -354,7 +413,11 @@ ErrorCode gif_player_load(GifPlayer *player, const gchar *filepath) {
         return ERROR_FILE_NOT_FOUND;
     }
 
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_DECODE, "animation");
+    gint64 start_us = g_get_monotonic_time();
     player->animation = gdk_pixbuf_animation_new_from_stream(G_INPUT_STREAM(stream), NULL, &error);
+    metrics_set_elapsed(METRIC_DECODE_US, start_us);
+    trace_span_end(&span);
     g_object_unref(stream);
 
     if (error) {
@@ -426,6 +489,191 @@ void gif_player_present_rendered_frame_for_test(GifPlayer *player,
                                       graphics_mode);
 }
 
+static gboolean gif_player_uses_kitty_animation(const GifPlayer *player) {
+    if (!player || !player->renderer || !player->animation || !player->is_animated ||
+        player->kitty_unsupported || !player->render_layout_valid) {
+        return FALSE;
+    }
+    const RendererConfig *config = &player->renderer->config;
+    return config->force_kitty && !config->force_text && !config->force_sixel && !config->force_iterm2;
+}
+
+// Plays the animation on a clock of its own, frame by frame, until it
+// starts over or ends, to learn how many frames to upload.
+static gboolean gif_player_kitty_measure(GifPlayer *player) {
+    GTimeVal time = {0, 0};
+    GdkPixbufAnimationIter *iter = gdk_pixbuf_animation_get_iter(player->animation, &time);
+    GArray *hashes = g_array_new(FALSE, FALSE, sizeof(guint64));
+    gint64 elapsed_ms = 0;
+    gboolean found = FALSE;
+
+    while (hashes->len < KITTY_ANIMATION_MAX_FRAMES * 2) {
+        gint delay = gif_player_frame_delay(iter);
+        if (delay < 0) {
+            // Finite loop count: the last frame stays
+            found = kitty_animation_find_loop((const guint64 *)(gpointer)hashes->data, hashes->len, TRUE,
+                                              &player->kitty_loop_frames, &player->kitty_loop_count);
+            break;
+        }
+        GdkPixbuf *frame = gdk_pixbuf_animation_iter_get_pixbuf(iter);
+        if (!frame || gdk_pixbuf_get_n_channels(frame) != 4 || gdk_pixbuf_get_bits_per_sample(frame) != 8) {
+            break;
+        }
+        guint64 hash = kitty_animation_hash_frame(gdk_pixbuf_read_pixels(frame),
+                                                  gdk_pixbuf_get_width(frame),
+                                                  gdk_pixbuf_get_height(frame),
+                                                  gdk_pixbuf_get_rowstride(frame),
+                                                  4,
+                                                  delay);
+        g_array_append_val(hashes, hash);
+        if (kitty_animation_find_loop((const guint64 *)(gpointer)hashes->data, hashes->len, FALSE,
+                                      &player->kitty_loop_frames, &player->kitty_loop_count)) {
+            found = TRUE;
+            break;
+        }
+        elapsed_ms += delay;
+        gif_player_time_from_ms(elapsed_ms, &time);
+        gdk_pixbuf_animation_iter_advance(iter, &time);
+    }
+
+    g_array_free(hashes, TRUE);
+    g_object_unref(iter);
+    if (!found || player->kitty_loop_frames <= 0 || player->kitty_loop_frames > KITTY_ANIMATION_MAX_FRAMES) {
+        player->kitty_loop_frames = 0;
+        player->kitty_loop_count = 0;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Appends the frame at kitty_iter and steps it to the next one.
+// Returns the frame's delay, or 0 if it could not be added.
+static gint gif_player_kitty_append_next(GifPlayer *player, GString *out) {
+    gint delay = gif_player_frame_delay(player->kitty_iter);
+    GdkPixbuf *frame = gdk_pixbuf_animation_iter_get_pixbuf(player->kitty_iter);
+    if (delay < 0 || !frame || gdk_pixbuf_get_n_channels(frame) != 4 ||
+        !kitty_animation_append_frame(player->kitty_animation,
+                                      gdk_pixbuf_read_pixels(frame),
+                                      gdk_pixbuf_get_width(frame),
+                                      gdk_pixbuf_get_height(frame),
+                                      gdk_pixbuf_get_rowstride(frame),
+                                      delay,
+                                      out)) {
+        return 0;
+    }
+    GTimeVal time;
+    player->kitty_iter_time_ms += delay;
+    gif_player_time_from_ms(player->kitty_iter_time_ms, &time);
+    gdk_pixbuf_animation_iter_advance(player->kitty_iter, &time);
+    return delay;
+}
+
+static gboolean render_next_frame(gpointer user_data);
+
+static gboolean gif_player_kitty_upload_next(gpointer user_data) {
+    GifPlayer *player = (GifPlayer *)user_data;
+    if (!player) {
+        return G_SOURCE_REMOVE;
+    }
+    player->timer_id = 0;
+    if (!player->is_playing || !player->kitty_animation || !player->kitty_iter) {
+        return G_SOURCE_REMOVE;
+    }
+
+    GString *out = g_string_new(NULL);
+    gint delay = gif_player_kitty_append_next(player, out);
+    if (delay == 0) {
+        // Fall back to drawing every frame
+        player->kitty_unsupported = TRUE;
+        gif_player_kitty_release(player, out);
+        gif_player_write_commands(out);
+        g_string_free(out, TRUE);
+        player->fixed_frame_valid = FALSE;
+        player->timer_id = g_timeout_add(10, render_next_frame, player);
+        return G_SOURCE_REMOVE;
+    }
+    gboolean complete = kitty_animation_frame_count(player->kitty_animation) >= (guint)player->kitty_loop_frames;
+    if (complete) {
+        // Every frame is in; the terminal plays on by itself
+        kitty_animation_append_state(player->kitty_animation, KITTY_ANIMATION_RUNNING,
+                                     player->kitty_loop_count, out);
+        g_clear_object(&player->kitty_iter);
+    } else {
+        player->timer_id = g_timeout_add(delay, gif_player_kitty_upload_next, player);
+    }
+    gif_player_write_commands(out);
+    g_string_free(out, TRUE);
+    return G_SOURCE_REMOVE;
+}
+
+// Shows the animation as a kitty animation: uploads the first frame and
+// schedules the rest, or places an uploaded one again.
+static gboolean gif_player_kitty_start(GifPlayer *player) {
+    if (!gif_player_uses_kitty_animation(player)) {
+        return FALSE;
+    }
+    if (player->kitty_loop_frames == 0 && !gif_player_kitty_measure(player)) {
+        player->kitty_unsupported = TRUE;
+        return FALSE;
+    }
+
+    renderer_update_terminal_size(player->renderer);
+    player->renderer->config.max_width = player->render_max_width;
+    player->renderer->config.max_height = player->render_max_height;
+    gint source_width = gdk_pixbuf_animation_get_width(player->animation);
+    gint source_height = gdk_pixbuf_animation_get_height(player->animation);
+    if (renderer_setup_canvas(player->renderer, source_width, source_height) != ERROR_NONE) {
+        return FALSE;
+    }
+    gint columns = 0;
+    gint rows = 0;
+    renderer_get_rendered_dimensions(player->renderer, &columns, &rows);
+    gint width = 0;
+    gint height = 0;
+    kitty_graphics_get_transfer_size(source_width, source_height, columns, rows, &width, &height);
+
+    GString *out = g_string_new(NULL);
+    if (!kitty_animation_matches(player->kitty_animation, width, height, columns, rows)) {
+        gif_player_kitty_release(player, out);
+        gsize bytes = 0;
+        if (columns > 0 && rows > 0 &&
+            g_size_checked_mul(&bytes, (gsize)width, (gsize)height) &&
+            g_size_checked_mul(&bytes, bytes, (gsize)4 * (gsize)player->kitty_loop_frames) &&
+            bytes <= KITTY_ANIMATION_MAX_BYTES) {
+            player->kitty_animation = kitty_animation_new(width, height, columns, rows);
+        }
+        if (player->kitty_animation) {
+            GTimeVal start = {0, 0};
+            player->kitty_iter = gdk_pixbuf_animation_get_iter(player->animation, &start);
+            player->kitty_iter_time_ms = 0;
+        }
+        if (!player->kitty_animation || gif_player_kitty_append_next(player, out) == 0) {
+            gif_player_kitty_release(player, out);
+            gif_player_write_commands(out);
+            g_string_free(out, TRUE);
+            return FALSE;
+        }
+    } else {
+        kitty_animation_append_place(player->kitty_animation, out);
+    }
+
+    gboolean complete = kitty_animation_frame_count(player->kitty_animation) >= (guint)player->kitty_loop_frames;
+    kitty_animation_append_state(player->kitty_animation,
+                                 complete ? KITTY_ANIMATION_RUNNING : KITTY_ANIMATION_LOADING,
+                                 player->kitty_loop_count,
+                                 out);
+    gif_player_present_rendered_frame(player, out, columns, rows, TRUE);
+    g_string_free(out, TRUE);
+
+    if (complete) {
+        g_clear_object(&player->kitty_iter);
+    } else if (player->kitty_iter) {
+        gint delay = gif_player_frame_delay(player->kitty_iter);
+        player->timer_id = g_timeout_add(delay > 0 ? delay : 10, gif_player_kitty_upload_next, player);
+    }
+    return TRUE;
+}
+
 // Timer callback
 static gboolean render_next_frame(gpointer user_data) {
     GifPlayer *player = (GifPlayer *)user_data;
@@ -462,7 +710,8 @@ ErrorCode gif_player_play(GifPlayer *player) {
         return ERROR_INVALID_IMAGE;
     }
     
-    if (player->is_playing) {
+    // A kitty animation is placed again; the caller cleared the screen
+    if (player->is_playing && !player->kitty_animation) {
         return ERROR_NONE;
     }
     
@@ -476,7 +725,15 @@ ErrorCode gif_player_play(GifPlayer *player) {
     player->last_frame_top_row = 0;
     player->last_frame_height = 0;
     gif_player_clear_line_cache(player);
-    
+    if (player->timer_id != 0) {
+        g_source_remove(player->timer_id);
+        player->timer_id = 0;
+    }
+
+    if (gif_player_kitty_start(player)) {
+        return ERROR_NONE;
+    }
+
     // Render the first frame immediately
     render_current_frame_internal(player);
     
@@ -484,20 +741,29 @@ ErrorCode gif_player_play(GifPlayer *player) {
     int delay = gdk_pixbuf_animation_iter_get_delay_time(player->iter);
     if (delay < 10) delay = 10;
     
-    if (player->timer_id != 0) {
-        g_source_remove(player->timer_id);
-    }
     player->timer_id = g_timeout_add(delay, render_next_frame, player);
     
     return ERROR_NONE;
 }
 
+// Stops the terminal looping the kitty animation; it keeps the frames.
+static void gif_player_kitty_halt(GifPlayer *player) {
+    if (!player->is_playing || !player->kitty_animation) {
+        return;
+    }
+    GString *out = g_string_new(NULL);
+    kitty_animation_append_state(player->kitty_animation, KITTY_ANIMATION_STOPPED, 0, out);
+    gif_player_write_commands(out);
+    g_string_free(out, TRUE);
+}
+
 // Pause playback
 ErrorCode gif_player_pause(GifPlayer *player) {
     if (!player) {
         return ERROR_INVALID_IMAGE;
     }
     
+    gif_player_kitty_halt(player);
     player->is_playing = FALSE;
     
     if (player->timer_id != 0) {
@@ -514,6 +780,7 @@ ErrorCode gif_player_stop(GifPlayer *player) {
         return ERROR_INVALID_IMAGE;
     }
     
+    gif_player_kitty_halt(player);
     player->is_playing = FALSE;
     
     if (player->timer_id != 0) {
@@ -13,6 +13,10 @@ void input_dispatch_process_pending(PixelTermApp *app) {
     input_dispatch_core_process_pending(app);
 }
 
+gint input_dispatch_next_timeout_ms(const PixelTermApp *app) {
+    return input_dispatch_core_next_timeout_ms(app);
+}
+
 void input_dispatch_process_animations(PixelTermApp *app) {
     input_dispatch_core_process_animations(app);
 }
@@ -9,6 +9,7 @@
 #include "input_dispatch_mouse_modes_internal.h"
 #include "input_dispatch_pending_clicks_internal.h"
 #include "common.h"
+#include "ui_render_utils.h"
 
 typedef void (*ModeKeyPressHandler)(PixelTermApp *app,
                                     InputHandler *input_handler,
@@ -220,6 +221,8 @@ static gboolean handle_key_press_common(PixelTermApp *app,
                                      app->force_text, app->force_sixel, app->force_kitty, app->force_iterm2, app->text_symbol_mode, app->gamma, app->color_enhance);
                 preloader_start(app->preloader);
             }
+            // Images kept in the terminal were rendered with the old setting
+            ui_release_kitty_images(app);
             app_render_by_mode(app);
             return TRUE;
         case (KeyCode)'i':
@@ -240,7 +243,7 @@ static gboolean handle_key_press_common(PixelTermApp *app,
             return TRUE;
         case (KeyCode)'f':
         case (KeyCode)'F':
-            input_dispatch_key_modes_toggle_video_fps(app);
+            input_dispatch_key_modes_toggle_perf_hud(app);
             return TRUE;
         case (KeyCode)'~':
         case (KeyCode)'`':
@@ -412,6 +415,10 @@ void input_dispatch_core_process_pending(PixelTermApp *app) {
     input_dispatch_process_pending_clicks(app);
 }
 
+gint input_dispatch_core_next_timeout_ms(const PixelTermApp *app) {
+    return input_dispatch_pending_clicks_timeout_ms(app);
+}
+
 void input_dispatch_core_process_animations(PixelTermApp *app) {
     process_animation_events(app);
 }
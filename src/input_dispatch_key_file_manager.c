@@ -32,45 +32,12 @@ static void skip_queued_navigation(InputHandler *input_handler,
     }
 }
 
-static const gchar* file_manager_selected_path(PixelTermApp *app) {
-    if (!app || !app->file_manager.entries || app->file_manager.selected_entry < 0) {
+static const gchar* file_manager_selected_path(const PixelTermApp *app) {
+    if (!app || !app->file_manager.entries || app->file_manager.selected_entry < 0 ||
+        (guint)app->file_manager.selected_entry >= app->file_manager.entries->len) {
         return NULL;
     }
-    if (app->file_manager.entries_count > 0 &&
-        app->file_manager.selected_entry >= app->file_manager.entries_count) {
-        return NULL;
-    }
-
-    GList *cursor = app->file_manager.selected_link;
-    gint idx = app->file_manager.selected_link_index;
-    if (!cursor || idx < 0) {
-        cursor = app->file_manager.entries;
-        idx = 0;
-    }
-
-    while (cursor && idx < app->file_manager.selected_entry) {
-        cursor = cursor->next;
-        idx++;
-    }
-    while (cursor && idx > app->file_manager.selected_entry) {
-        cursor = cursor->prev;
-        idx--;
-    }
-    if (!cursor || idx != app->file_manager.selected_entry) {
-        cursor = app->file_manager.entries;
-        idx = 0;
-        while (cursor && idx < app->file_manager.selected_entry) {
-            cursor = cursor->next;
-            idx++;
-        }
-    }
-    if (!cursor || idx != app->file_manager.selected_entry) {
-        return NULL;
-    }
-
-    app->file_manager.selected_link = cursor;
-    app->file_manager.selected_link_index = idx;
-    return (const gchar*)cursor->data;
+    return g_ptr_array_index(app->file_manager.entries, app->file_manager.selected_entry);
 }
 
 void input_dispatch_handle_key_press_file_manager(PixelTermApp *app,
@@ -80,7 +47,7 @@ void input_dispatch_handle_key_press_file_manager(PixelTermApp *app,
         case KEY_LEFT: {
             gint old_selected = app->file_manager.selected_entry;
             gint old_scroll = app->file_manager.scroll_offset;
-            GList *old_entries = app->file_manager.entries;
+            GPtrArray *old_entries = app->file_manager.entries;
             gchar *old_dir = app->file_manager.directory ? g_strdup(app->file_manager.directory) : NULL;
             ErrorCode err = app_file_manager_left(app);
             gboolean dir_changed = (g_strcmp0(old_dir, app->file_manager.directory) != 0);
@@ -97,7 +64,7 @@ void input_dispatch_handle_key_press_file_manager(PixelTermApp *app,
         case KEY_RIGHT: {
             gint old_selected = app->file_manager.selected_entry;
             gint old_scroll = app->file_manager.scroll_offset;
-            GList *old_entries = app->file_manager.entries;
+            GPtrArray *old_entries = app->file_manager.entries;
             gchar *old_dir = app->file_manager.directory ? g_strdup(app->file_manager.directory) : NULL;
             ErrorCode err = app_file_manager_right(app);
             gboolean dir_changed = (g_strcmp0(old_dir, app->file_manager.directory) != 0);
@@ -167,15 +134,7 @@ void input_dispatch_handle_key_press_file_manager(PixelTermApp *app,
                                           is_valid_media_file(selected_path);
             if (selection_is_media) {
                 app->return_to_mode = RETURN_MODE_PREVIEW;
-                gint selected_image_index = -1;
-                gint idx = 0;
-                for (GList *cur = app->image_files; cur; cur = cur->next, idx++) {
-                    const gchar *image_path = (const gchar*)cur->data;
-                    if (g_strcmp0(selected_path, image_path) == 0) {
-                        selected_image_index = idx;
-                        break;
-                    }
-                }
+                gint selected_image_index = media_index_find_path(app->image_files, selected_path);
                 if (selected_image_index >= 0) {
                     app->current_index = selected_image_index;
                 }
@@ -114,11 +114,19 @@ void input_dispatch_key_modes_toggle_video_playback(PixelTermApp *app) {
     }
 }
 
-void input_dispatch_key_modes_toggle_video_fps(PixelTermApp *app) {
-    if (!app || !input_dispatch_current_is_video(app) || !app->video_player) {
+void input_dispatch_key_modes_toggle_perf_hud(PixelTermApp *app) {
+    if (!app || app_is_file_manager_mode(app)) {
         return;
     }
     app->show_fps = !app->show_fps;
+    if (app->show_fps) {
+        app_render_perf_hud(app, TRUE);
+    } else {
+        app_clear_perf_hud(app);
+    }
+    if (!input_dispatch_current_is_video(app) || !app->video_player) {
+        return;
+    }
     app->video_player->show_stats = app->show_fps && !app->ui_text_hidden;
     if (!app->show_fps && !app->ui_text_hidden) {
         gint stats_row = VIDEO_PLAYER_STATS_ROW;
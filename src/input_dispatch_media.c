@@ -12,8 +12,8 @@ gboolean input_dispatch_current_is_video(const PixelTermApp *app) {
     if (!filepath) {
         return FALSE;
     }
-    MediaKind media_kind = media_classify(filepath);
-    return media_is_video(media_kind);
+    MediaMeta meta;
+    return app_get_media_meta(app, filepath, &meta) && media_is_video(meta.kind);
 }
 
 gboolean input_dispatch_current_is_animated_image(const PixelTermApp *app) {
@@ -24,8 +24,8 @@ gboolean input_dispatch_current_is_animated_image(const PixelTermApp *app) {
     if (!filepath) {
         return FALSE;
     }
-    MediaKind media_kind = media_classify(filepath);
-    if (!media_is_animated_image(media_kind)) {
+    MediaMeta meta;
+    if (!app_get_media_meta(app, filepath, &meta) || !media_is_animated_image(meta.kind)) {
         return FALSE;
     }
     if (app->gif_player && app->gif_player->filepath &&
@@ -97,3 +97,30 @@ void input_dispatch_process_pending_clicks(PixelTermApp *app) {
         app->input.file_manager_click.pending = FALSE;
     }
 }
+
+gint input_dispatch_pending_clicks_timeout_ms(const PixelTermApp *app) {
+    if (!app) {
+        return -1;
+    }
+    gint64 deadline = -1;
+    if (app->input.single_click.pending) {
+        deadline = app->input.single_click.pending_time + k_click_threshold_us;
+    }
+    if (app->input.preview_click.pending) {
+        gint64 preview_deadline = app->input.preview_click.pending_time + k_click_threshold_us;
+        deadline = deadline < 0 ? preview_deadline : MIN(deadline, preview_deadline);
+    }
+    if (app->input.file_manager_click.pending) {
+        gint64 file_manager_deadline = app->input.file_manager_click.pending_time + k_click_threshold_us;
+        deadline = deadline < 0 ? file_manager_deadline : MIN(deadline, file_manager_deadline);
+    }
+    if (deadline < 0) {
+        return -1;
+    }
+    // A click resolves once strictly past the threshold
+    gint64 remaining_us = deadline + 1 - g_get_monotonic_time();
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    return (gint)MIN((remaining_us + 999) / 1000, (gint64)G_MAXINT);
+}
@@ -0,0 +1,309 @@
+#include "kitty_animation.h"
+#include "kitty_command_internal.h"
+#include "kitty_graphics_scale_internal.h"
+
+#include <string.h>
+
+// Above the IDs handed out by the image registry
+#define KITTY_ANIMATION_ID_BASE ((guint32)1 << 24)
+
+struct KittyAnimation {
+    guint32 id;
+    gint width;
+    gint height;
+    gint columns;
+    gint rows;
+    guint appended;         // Frames given to append_frame
+    guint frames;           // Frames the terminal holds
+    gint last_gap;          // Gap of the terminal's newest frame
+    guint8 *previous;       // Newest frame, tightly packed RGBA
+    guint8 *scratch;
+};
+
+static guint32 kitty_animation_next_id(void) {
+    static guint32 next_id = 0;
+    if (next_id == 0) {
+        next_id = KITTY_ANIMATION_ID_BASE + (guint32)g_random_int_range(0, 1 << 24);
+    }
+    guint32 id = next_id++;
+    if (next_id == 0) {
+        next_id = KITTY_ANIMATION_ID_BASE;
+    }
+    return id;
+}
+
+// Finds the bounding box of the pixels that differ between two frames.
+static gboolean kitty_animation_find_change(const guint8 *a,
+                                            const guint8 *b,
+                                            gint width,
+                                            gint height,
+                                            gint *out_x,
+                                            gint *out_y,
+                                            gint *out_width,
+                                            gint *out_height) {
+    gsize stride = (gsize)width * 4;
+    gint top = 0;
+    while (top < height && memcmp(a + (gsize)top * stride, b + (gsize)top * stride, stride) == 0) {
+        top++;
+    }
+    if (top == height) {
+        return FALSE;
+    }
+    gint bottom = height - 1;
+    while (bottom > top && memcmp(a + (gsize)bottom * stride, b + (gsize)bottom * stride, stride) == 0) {
+        bottom--;
+    }
+
+    gint left = width;
+    gint right = -1;
+    for (gint y = top; y <= bottom; y++) {
+        const guint8 *row_a = a + (gsize)y * stride;
+        const guint8 *row_b = b + (gsize)y * stride;
+        for (gint x = 0; x < left; x++) {
+            if (memcmp(row_a + (gsize)x * 4, row_b + (gsize)x * 4, 4) != 0) {
+                left = x;
+                break;
+            }
+        }
+        for (gint x = width - 1; x > right; x--) {
+            if (memcmp(row_a + (gsize)x * 4, row_b + (gsize)x * 4, 4) != 0) {
+                right = x;
+                break;
+            }
+        }
+    }
+    *out_x = left;
+    *out_y = top;
+    *out_width = right - left + 1;
+    *out_height = bottom - top + 1;
+    return TRUE;
+}
+
+KittyAnimation* kitty_animation_new(gint width, gint height, gint columns, gint rows) {
+    gsize bytes = 0;
+    if (width <= 0 || height <= 0 || columns <= 0 || rows <= 0 ||
+        !g_size_checked_mul(&bytes, (gsize)width, (gsize)height) ||
+        !g_size_checked_mul(&bytes, bytes, 4)) {
+        return NULL;
+    }
+    KittyAnimation *animation = g_new0(KittyAnimation, 1);
+    animation->id = kitty_animation_next_id();
+    animation->width = width;
+    animation->height = height;
+    animation->columns = columns;
+    animation->rows = rows;
+    animation->previous = g_malloc(bytes);
+    animation->scratch = g_malloc(bytes);
+    return animation;
+}
+
+void kitty_animation_free(KittyAnimation *animation) {
+    if (!animation) {
+        return;
+    }
+    g_free(animation->previous);
+    g_free(animation->scratch);
+    g_free(animation);
+}
+
+gboolean kitty_animation_matches(const KittyAnimation *animation,
+                                 gint width,
+                                 gint height,
+                                 gint columns,
+                                 gint rows) {
+    return animation && animation->width == width && animation->height == height &&
+           animation->columns == columns && animation->rows == rows;
+}
+
+guint kitty_animation_frame_count(const KittyAnimation *animation) {
+    return animation ? animation->appended : 0;
+}
+
+guint32 kitty_animation_get_id(const KittyAnimation *animation) {
+    return animation ? animation->id : 0;
+}
+
+gboolean kitty_animation_append_frame(KittyAnimation *animation,
+                                      const guint8 *pixels,
+                                      gint width,
+                                      gint height,
+                                      gint rowstride,
+                                      gint gap_ms,
+                                      GString *out) {
+    if (!animation || !pixels || !out || width <= 0 || height <= 0 || rowstride < width * 4) {
+        return FALSE;
+    }
+    gsize stride = (gsize)animation->width * 4;
+    if (width == animation->width && height == animation->height) {
+        for (gint y = 0; y < height; y++) {
+            memcpy(animation->scratch + (gsize)y * stride, pixels + (gsize)y * (gsize)rowstride, stride);
+        }
+    } else {
+        kitty_graphics_scale_rgba_area(animation->scratch,
+                                       animation->width,
+                                       animation->height,
+                                       pixels,
+                                       width,
+                                       height,
+                                       rowstride);
+    }
+    gint gap = MAX(gap_ms, 1);
+    gchar *control = NULL;
+
+    if (animation->frames == 0) {
+        control = g_strdup_printf("a=T,i=%u,f=32,s=%d,v=%d,c=%d,r=%d,C=1,q=2",
+                                  animation->id,
+                                  animation->width,
+                                  animation->height,
+                                  animation->columns,
+                                  animation->rows);
+        kitty_command_append_payload(out, control, animation->scratch, stride * (gsize)animation->height);
+        // The root frame's gap can only be set once it exists
+        g_string_append_printf(out, "\033_Ga=a,i=%u,r=1,z=%d,q=2\033\\", animation->id, gap);
+    } else {
+        gint x = 0;
+        gint y = 0;
+        gint w = 0;
+        gint h = 0;
+        if (!kitty_animation_find_change(animation->previous, animation->scratch,
+                                         animation->width, animation->height, &x, &y, &w, &h)) {
+            // Nothing new to show: hold the newest frame longer
+            animation->last_gap += gap;
+            g_string_append_printf(out, "\033_Ga=a,i=%u,r=%u,z=%d,q=2\033\\",
+                                   animation->id, animation->frames, animation->last_gap);
+            animation->appended++;
+            return TRUE;
+        }
+
+        if (w == animation->width && h == animation->height) {
+            control = g_strdup_printf("a=f,i=%u,f=32,s=%d,v=%d,z=%d,q=2",
+                                      animation->id, w, h, gap);
+            kitty_command_append_payload(out, control, animation->scratch, stride * (gsize)h);
+        } else {
+            // Only the changed rectangle, replacing pixels of a copy of the
+            // previous frame
+            gsize rect_stride = (gsize)w * 4;
+            guint8 *rect = g_malloc(rect_stride * (gsize)h);
+            for (gint row = 0; row < h; row++) {
+                memcpy(rect + (gsize)row * rect_stride,
+                       animation->scratch + (gsize)(y + row) * stride + (gsize)x * 4,
+                       rect_stride);
+            }
+            control = g_strdup_printf("a=f,i=%u,f=32,s=%d,v=%d,x=%d,y=%d,c=%u,X=1,z=%d,q=2",
+                                      animation->id, w, h, x, y, animation->frames, gap);
+            kitty_command_append_payload(out, control, rect, rect_stride * (gsize)h);
+            g_free(rect);
+        }
+    }
+    g_free(control);
+
+    guint8 *newest = animation->scratch;
+    animation->scratch = animation->previous;
+    animation->previous = newest;
+    animation->frames++;
+    animation->appended++;
+    animation->last_gap = gap;
+    return TRUE;
+}
+
+void kitty_animation_append_place(const KittyAnimation *animation, GString *out) {
+    if (!animation || !out) {
+        return;
+    }
+    g_string_append_printf(out, "\033_Ga=p,i=%u,c=%d,r=%d,C=1,q=2\033\\",
+                           animation->id, animation->columns, animation->rows);
+}
+
+void kitty_animation_append_state(const KittyAnimation *animation,
+                                  KittyAnimationState state,
+                                  gint loops,
+                                  GString *out) {
+    if (!animation || !out) {
+        return;
+    }
+    if (state == KITTY_ANIMATION_STOPPED) {
+        g_string_append_printf(out, "\033_Ga=a,i=%u,s=1,q=2\033\\", animation->id);
+        return;
+    }
+    // v=1 loops forever; v=n plays n-1 times
+    gint loop_value = loops > 0 ? loops + 1 : 1;
+    g_string_append_printf(out, "\033_Ga=a,i=%u,s=%d,v=%d,q=2\033\\", animation->id, (gint)state, loop_value);
+}
+
+void kitty_animation_append_delete(const KittyAnimation *animation, GString *out) {
+    if (!animation || !out) {
+        return;
+    }
+    g_string_append_printf(out, "\033_Ga=d,d=I,i=%u,q=2\033\\", animation->id);
+}
+
+guint64 kitty_animation_hash_frame(const guint8 *pixels,
+                                   gint width,
+                                   gint height,
+                                   gint rowstride,
+                                   gint n_channels,
+                                   gint delay_ms) {
+    const guint64 multiplier = G_GUINT64_CONSTANT(0x9E3779B97F4A7C15);
+    guint64 hash = ((guint64)(guint32)width << 32) ^ (guint64)(guint32)height;
+    gsize row_bytes = (gsize)MAX(width, 0) * (gsize)MAX(n_channels, 0);
+    for (gint y = 0; pixels && y < height; y++) {
+        const guint8 *row = pixels + (gsize)y * (gsize)rowstride;
+        gsize i = 0;
+        for (; i + 8 <= row_bytes; i += 8) {
+            guint64 word = 0;
+            memcpy(&word, row + i, 8);
+            hash = (hash ^ word) * multiplier;
+            hash ^= hash >> 29;
+        }
+        for (; i < row_bytes; i++) {
+            hash = (hash ^ row[i]) * multiplier;
+        }
+    }
+    hash = (hash ^ (guint64)(guint32)delay_ms) * multiplier;
+    return hash ^ (hash >> 32);
+}
+
+gboolean kitty_animation_find_loop(const guint64 *hashes,
+                                   gsize count,
+                                   gboolean ended,
+                                   gint *out_frames,
+                                   gint *out_loops) {
+    if (!hashes || count == 0) {
+        return FALSE;
+    }
+    // Shortest period of the sequence, from the longest border (KMP)
+    gsize *border = g_new(gsize, count);
+    border[0] = 0;
+    for (gsize i = 1; i < count; i++) {
+        gsize k = border[i - 1];
+        while (k > 0 && hashes[i] != hashes[k]) {
+            k = border[k - 1];
+        }
+        border[i] = hashes[i] == hashes[k] ? k + 1 : k;
+    }
+    gsize period = count - border[count - 1];
+    g_free(border);
+
+    if (ended) {
+        if (count % period != 0) {
+            period = count;
+        }
+        if (out_frames) {
+            *out_frames = (gint)period;
+        }
+        if (out_loops) {
+            *out_loops = (gint)(count / period);
+        }
+        return TRUE;
+    }
+    if (count < period * 2) {
+        return FALSE;
+    }
+    if (out_frames) {
+        *out_frames = (gint)period;
+    }
+    if (out_loops) {
+        *out_loops = 0;
+    }
+    return TRUE;
+}
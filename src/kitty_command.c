@@ -0,0 +1,111 @@
+#include "kitty_command_internal.h"
+
+#include <string.h>
+
+gboolean kitty_command_next(const GString *s, gsize from, KittyCommand *cmd) {
+    if (!s || from >= s->len) {
+        return FALSE;
+    }
+    const char *start = g_strstr_len(s->str + from, (gssize)(s->len - from), "\033_G");
+    if (!start) {
+        return FALSE;
+    }
+    gsize control = (gsize)(start - s->str) + 3;
+    const char *terminator = g_strstr_len(s->str + control, (gssize)(s->len - control), "\033\\");
+    if (!terminator) {
+        return FALSE;
+    }
+    gsize terminator_pos = (gsize)(terminator - s->str);
+    const char *semicolon = memchr(s->str + control, ';', terminator_pos - control);
+
+    cmd->start = (gsize)(start - s->str);
+    cmd->control = control;
+    cmd->control_end = semicolon ? (gsize)(semicolon - s->str) : terminator_pos;
+    cmd->payload = semicolon ? cmd->control_end + 1 : terminator_pos;
+    cmd->payload_len = terminator_pos - cmd->payload;
+    cmd->end = terminator_pos + 2;
+    return TRUE;
+}
+
+gboolean kitty_command_get(const GString *s,
+                           const KittyCommand *cmd,
+                           char key,
+                           const char **out_value,
+                           gsize *out_len) {
+    gsize pos = cmd->control;
+    while (pos < cmd->control_end) {
+        const char *field = s->str + pos;
+        const char *comma = memchr(field, ',', cmd->control_end - pos);
+        gsize field_len = comma ? (gsize)(comma - field) : cmd->control_end - pos;
+        if (field_len >= 2 && field[0] == key && field[1] == '=') {
+            *out_value = field + 2;
+            *out_len = field_len - 2;
+            return TRUE;
+        }
+        pos += field_len + 1;
+    }
+    return FALSE;
+}
+
+gint64 kitty_command_get_int(const GString *s, const KittyCommand *cmd, char key, gint64 fallback) {
+    const char *value = NULL;
+    gsize len = 0;
+    if (!kitty_command_get(s, cmd, key, &value, &len) || len == 0 || len > 20) {
+        return fallback;
+    }
+    gchar buffer[24];
+    memcpy(buffer, value, len);
+    buffer[len] = '\0';
+    gchar *end = NULL;
+    gint64 parsed = g_ascii_strtoll(buffer, &end, 10);
+    return (end && *end == '\0') ? parsed : fallback;
+}
+
+gboolean kitty_command_has(const GString *s, const KittyCommand *cmd, char key, const char *value) {
+    const char *found = NULL;
+    gsize len = 0;
+    return kitty_command_get(s, cmd, key, &found, &len) && len == strlen(value) &&
+           memcmp(found, value, len) == 0;
+}
+
+gboolean kitty_command_first_untagged_transmit(const GString *s, KittyCommand *out_first) {
+    KittyCommand cmd;
+    if (!s || !out_first || !kitty_command_next(s, 0, &cmd) || !kitty_command_has(s, &cmd, 'a', "T")) {
+        return FALSE;
+    }
+    const char *value = NULL;
+    gsize len = 0;
+    if (kitty_command_get(s, &cmd, 'i', &value, &len) || kitty_command_get(s, &cmd, 'I', &value, &len)) {
+        return FALSE;
+    }
+    *out_first = cmd;
+    return TRUE;
+}
+
+void kitty_command_append_id_tag(GString *out, const GString *s, const KittyCommand *cmd, guint32 id) {
+    const char *value = NULL;
+    gsize len = 0;
+    // Tagged transmits are acknowledged unless quieted; replies would
+    // arrive as input
+    gboolean has_quiet = kitty_command_get(s, cmd, 'q', &value, &len);
+    g_string_append_printf(out, has_quiet ? "i=%u," : "i=%u,q=2,", id);
+}
+
+void kitty_command_append_payload(GString *out, const char *control, const guint8 *data, gsize len) {
+    gchar *encoded = g_base64_encode(data, len);
+    gsize encoded_len = strlen(encoded);
+    gsize offset = 0;
+    do {
+        gsize chunk = MIN((gsize)KITTY_COMMAND_CHUNK, encoded_len - offset);
+        gboolean more = offset + chunk < encoded_len;
+        if (offset == 0) {
+            g_string_append_printf(out, "\033_G%s%s;", control, more ? ",m=1" : "");
+        } else {
+            g_string_append(out, more ? "\033_Gm=1;" : "\033_Gm=0;");
+        }
+        g_string_append_len(out, encoded + offset, (gssize)chunk);
+        g_string_append(out, "\033\\");
+        offset += chunk;
+    } while (offset < encoded_len);
+    g_free(encoded);
+}
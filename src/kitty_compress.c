@@ -0,0 +1,269 @@
+#include "kitty_compress.h"
+#include "kitty_command_internal.h"
+#include "process_env.h"
+#include "term_output.h"
+
+#include <string.h>
+#include <zlib.h>
+
+// Most base64 kitty accepts in one chunk
+#define KITTY_COMPRESS_CHUNK 4096
+// Smaller images go out raw; chunking and latency dominate
+#define KITTY_COMPRESS_MIN_BYTES (32 * 1024)
+#define KITTY_COMPRESS_SMOOTHING 0.25
+
+typedef struct {
+    gint level;
+    gdouble bytes_per_sec;          // Deflate input rate
+    gdouble ratio;                  // Output over input size
+} KittyCompressLevel;
+
+// Starting estimates for screenshot-like RGBA, refined as images are compressed
+#define KITTY_COMPRESS_DEFAULT_LEVELS \
+    { { 1, 150e6, 0.30 }, { 3, 90e6, 0.27 }, { 6, 30e6, 0.24 }, { 9, 8e6, 0.23 } }
+
+static GMutex g_kitty_compress_mutex;
+static KittyCompressionMode g_kitty_compress_mode = KITTY_COMPRESSION_AUTO;
+static KittyCompressLevel g_kitty_compress_levels[] = KITTY_COMPRESS_DEFAULT_LEVELS;
+
+static gboolean kitty_compress_is_remote(void) {
+    return pixelterm_getenv("SSH_CONNECTION") || pixelterm_getenv("SSH_CLIENT") || pixelterm_getenv("SSH_TTY");
+}
+
+// Finds a transmit of raw pixels sent inline and returns their size.
+static gsize kitty_compress_find_transmit(const GString *rendered, KittyCommand *out_first) {
+    KittyCommand first;
+    if (!rendered || !kitty_command_next(rendered, 0, &first)) {
+        return 0;
+    }
+    // A doubled escape means tmux passthrough, which this does not rewrite
+    if (first.start > 0 && rendered->str[first.start - 1] == '\033') {
+        return 0;
+    }
+    if (!kitty_command_has(rendered, &first, 'a', "T") && !kitty_command_has(rendered, &first, 'a', "t")) {
+        return 0;
+    }
+    const char *value = NULL;
+    gsize len = 0;
+    if (kitty_command_get(rendered, &first, 'o', &value, &len) ||
+        (kitty_command_get(rendered, &first, 't', &value, &len) && !kitty_command_has(rendered, &first, 't', "d"))) {
+        return 0;
+    }
+    gint64 format = kitty_command_get_int(rendered, &first, 'f', 32);
+    gint64 width = kitty_command_get_int(rendered, &first, 's', 0);
+    gint64 height = kitty_command_get_int(rendered, &first, 'v', 0);
+    if ((format != 32 && format != 24) || width <= 0 || height <= 0 || width > G_MAXINT32 || height > G_MAXINT32) {
+        return 0;
+    }
+    gsize raw_size = 0;
+    if (!g_size_checked_mul(&raw_size, (gsize)width, (gsize)height) ||
+        !g_size_checked_mul(&raw_size, raw_size, (gsize)(format / 8))) {
+        return 0;
+    }
+    *out_first = first;
+    return raw_size;
+}
+
+// Decodes the base64 payload of @p first and its continuation chunks.
+static guint8* kitty_compress_decode(const GString *rendered,
+                                     const KittyCommand *first,
+                                     gsize *out_len,
+                                     gsize *out_transmit_end) {
+    gsize encoded_len = 0;
+    KittyCommand cmd = *first;
+    while (TRUE) {
+        encoded_len += cmd.payload_len;
+        if (kitty_command_get_int(rendered, &cmd, 'm', 0) != 1) {
+            break;
+        }
+        if (!kitty_command_next(rendered, cmd.end, &cmd)) {
+            return NULL;
+        }
+    }
+    *out_transmit_end = cmd.end;
+
+    guint8 *decoded = g_malloc(encoded_len / 4 * 3 + 3);
+    gsize decoded_len = 0;
+    gint state = 0;
+    guint save = 0;
+    cmd = *first;
+    while (TRUE) {
+        decoded_len += g_base64_decode_step(rendered->str + cmd.payload, cmd.payload_len,
+                                            decoded + decoded_len, &state, &save);
+        if (cmd.end == *out_transmit_end) {
+            break;
+        }
+        (void)kitty_command_next(rendered, cmd.end, &cmd);
+    }
+    *out_len = decoded_len;
+    return decoded;
+}
+
+static GString* kitty_compress_transmit_internal(const GString *rendered,
+                                                 gint level,
+                                                 gsize *out_raw_bytes,
+                                                 gsize *out_packed_bytes) {
+    KittyCommand first;
+    gsize raw_size = kitty_compress_find_transmit(rendered, &first);
+    if (raw_size == 0 || level < 1 || level > 9) {
+        return NULL;
+    }
+    gsize transmit_end = 0;
+    gsize raw_len = 0;
+    guint8 *raw = kitty_compress_decode(rendered, &first, &raw_len, &transmit_end);
+    if (!raw || raw_len != raw_size) {
+        g_free(raw);
+        return NULL;
+    }
+    if (out_raw_bytes) {
+        *out_raw_bytes = raw_size;
+    }
+
+    uLongf packed_len = compressBound((uLong)raw_size);
+    guint8 *packed = g_malloc(packed_len);
+    gboolean ok = compress2(packed, &packed_len, raw, (uLong)raw_size, level) == Z_OK && packed_len < raw_size;
+    g_free(raw);
+    if (out_packed_bytes) {
+        *out_packed_bytes = ok ? (gsize)packed_len : raw_size;
+    }
+    if (!ok) {
+        g_free(packed);
+        return NULL;
+    }
+    gchar *encoded = g_base64_encode(packed, packed_len);
+    g_free(packed);
+    gsize encoded_len = strlen(encoded);
+
+    GString *out = g_string_sized_new(first.start + encoded_len + encoded_len / KITTY_COMPRESS_CHUNK * 16 + 128 +
+                                      (rendered->len - transmit_end));
+    g_string_append_len(out, rendered->str, (gssize)first.start);
+    // Same shape as Chafa's output: a header without data, then the chunks
+    g_string_append(out, "\033_G");
+    gsize pos = first.control;
+    gboolean need_comma = FALSE;
+    while (pos < first.control_end) {
+        const char *field = rendered->str + pos;
+        const char *comma = memchr(field, ',', first.control_end - pos);
+        gsize field_len = comma ? (gsize)(comma - field) : first.control_end - pos;
+        if (field_len > 0 && field[0] != 'm') {
+            if (need_comma) {
+                g_string_append_c(out, ',');
+            }
+            g_string_append_len(out, field, (gssize)field_len);
+            need_comma = TRUE;
+        }
+        pos += field_len + 1;
+    }
+    g_string_append(out, need_comma ? ",o=z,m=1\033\\" : "o=z,m=1\033\\");
+    for (gsize offset = 0; offset < encoded_len; offset += KITTY_COMPRESS_CHUNK) {
+        gsize chunk = MIN((gsize)KITTY_COMPRESS_CHUNK, encoded_len - offset);
+        g_string_append(out, offset + chunk < encoded_len ? "\033_Gm=1;" : "\033_Gm=0;");
+        g_string_append_len(out, encoded + offset, (gssize)chunk);
+        g_string_append(out, "\033\\");
+    }
+    g_string_append_len(out, rendered->str + transmit_end, (gssize)(rendered->len - transmit_end));
+    g_free(encoded);
+    return out;
+}
+
+static void kitty_compress_observe(gint level, gsize raw_bytes, gsize packed_bytes, gint64 elapsed_us) {
+    if (raw_bytes == 0) {
+        return;
+    }
+    gdouble rate = (gdouble)raw_bytes * G_USEC_PER_SEC / (gdouble)MAX(elapsed_us, 1);
+    gdouble ratio = (gdouble)packed_bytes / (gdouble)raw_bytes;
+    g_mutex_lock(&g_kitty_compress_mutex);
+    for (gsize i = 0; i < G_N_ELEMENTS(g_kitty_compress_levels); i++) {
+        KittyCompressLevel *entry = &g_kitty_compress_levels[i];
+        if (entry->level == level) {
+            entry->bytes_per_sec += (rate - entry->bytes_per_sec) * KITTY_COMPRESS_SMOOTHING;
+            entry->ratio += (ratio - entry->ratio) * KITTY_COMPRESS_SMOOTHING;
+            break;
+        }
+    }
+    g_mutex_unlock(&g_kitty_compress_mutex);
+}
+
+void kitty_compress_set_mode(KittyCompressionMode mode) {
+    g_mutex_lock(&g_kitty_compress_mutex);
+    g_kitty_compress_mode = mode;
+    g_mutex_unlock(&g_kitty_compress_mutex);
+}
+
+KittyCompressionMode kitty_compress_get_mode(void) {
+    g_mutex_lock(&g_kitty_compress_mutex);
+    KittyCompressionMode mode = g_kitty_compress_mode;
+    g_mutex_unlock(&g_kitty_compress_mutex);
+    return mode;
+}
+
+gint kitty_compress_pick_level(KittyCompressionMode mode,
+                               gsize raw_bytes,
+                               gdouble link_bytes_per_sec,
+                               gboolean remote) {
+    if (mode == KITTY_COMPRESSION_NEVER || raw_bytes < KITTY_COMPRESS_MIN_BYTES) {
+        return 0;
+    }
+    if (link_bytes_per_sec <= 0.0) {
+        return (mode == KITTY_COMPRESSION_ALWAYS || remote) ? 1 : 0;
+    }
+
+    // Seconds to deflate and send, against sending raw; base64 inflates both alike
+    gdouble size = (gdouble)raw_bytes;
+    gint best_level = mode == KITTY_COMPRESSION_ALWAYS ? 1 : 0;
+    gdouble best_cost = mode == KITTY_COMPRESSION_ALWAYS ? G_MAXDOUBLE : size / link_bytes_per_sec;
+    g_mutex_lock(&g_kitty_compress_mutex);
+    for (gsize i = 0; i < G_N_ELEMENTS(g_kitty_compress_levels); i++) {
+        const KittyCompressLevel *entry = &g_kitty_compress_levels[i];
+        gdouble cost = size / entry->bytes_per_sec + size * entry->ratio / link_bytes_per_sec;
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_level = entry->level;
+        }
+    }
+    g_mutex_unlock(&g_kitty_compress_mutex);
+    return best_level;
+}
+
+GString* kitty_compress_transmit(const GString *rendered, gint level, gsize *out_raw_bytes) {
+    return kitty_compress_transmit_internal(rendered, level, out_raw_bytes, NULL);
+}
+
+gboolean kitty_compress_rendered(GString *rendered) {
+    KittyCompressionMode mode = kitty_compress_get_mode();
+    KittyCommand first;
+    if (mode == KITTY_COMPRESSION_NEVER) {
+        return FALSE;
+    }
+    gsize raw_size = kitty_compress_find_transmit(rendered, &first);
+    if (raw_size == 0) {
+        return FALSE;
+    }
+    TermOutputStats stats;
+    term_output_get_stats(&stats);
+    gint level = kitty_compress_pick_level(mode, raw_size, stats.write_bytes_per_sec, kitty_compress_is_remote());
+    if (level == 0) {
+        return FALSE;
+    }
+
+    gsize raw_bytes = 0;
+    gsize packed_bytes = 0;
+    gint64 start_us = g_get_monotonic_time();
+    GString *packed = kitty_compress_transmit_internal(rendered, level, &raw_bytes, &packed_bytes);
+    kitty_compress_observe(level, raw_bytes, packed_bytes, g_get_monotonic_time() - start_us);
+    if (!packed) {
+        return FALSE;
+    }
+    g_string_truncate(rendered, 0);
+    g_string_append_len(rendered, packed->str, (gssize)packed->len);
+    g_string_free(packed, TRUE);
+    return TRUE;
+}
+
+void kitty_compress_reset(void) {
+    static const KittyCompressLevel defaults[] = KITTY_COMPRESS_DEFAULT_LEVELS;
+    g_mutex_lock(&g_kitty_compress_mutex);
+    g_kitty_compress_mode = KITTY_COMPRESSION_AUTO;
+    memcpy(g_kitty_compress_levels, defaults, sizeof(defaults));
+    g_mutex_unlock(&g_kitty_compress_mutex);
+}
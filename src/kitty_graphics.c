@@ -1,8 +1,12 @@
+#define _GNU_SOURCE
+
 #include "kitty_graphics.h"
+#include "kitty_graphics_scale_internal.h"
 #include "process_env.h"
 
 #include <errno.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -81,27 +85,31 @@ gboolean kitty_graphics_should_use_shm(KittyTransferMode mode) {
     return kitty_graphics_shm_auto_enabled();
 }
 
-GString *kitty_graphics_build_shm_command(const gchar *shm_name,
-                                          gint width,
-                                          gint height,
-                                          gint display_width_cells,
-                                          gint display_height_cells,
-                                          gsize payload_size) {
-    if (!shm_name || shm_name[0] == '\0' || width <= 0 || height <= 0 ||
+// Immediate transmit of raw RGBA read by the terminal from a named object:
+// a shared memory object (t=s) or a file (t=f).
+static GString *kitty_graphics_build_transfer_command(char medium,
+                                                      const gchar *name,
+                                                      gint width,
+                                                      gint height,
+                                                      gint display_width_cells,
+                                                      gint display_height_cells,
+                                                      gsize payload_size) {
+    if (!name || name[0] == '\0' || width <= 0 || height <= 0 ||
         display_width_cells <= 0 || display_height_cells <= 0 || payload_size == 0) {
         return NULL;
     }
 
-    gchar *encoded_name = g_base64_encode((const guchar *)shm_name, strlen(shm_name));
+    gchar *encoded_name = g_base64_encode((const guchar *)name, strlen(name));
     if (!encoded_name) {
         return NULL;
     }
 
     GString *command = g_string_new(NULL);
     g_string_printf(command,
-                    "\033_Ga=T,f=32,s=%d,v=%d,t=s,S=%" G_GSIZE_FORMAT ",c=%d,r=%d,C=1,q=2;%s\033\\",
+                    "\033_Ga=T,f=32,s=%d,v=%d,t=%c,S=%" G_GSIZE_FORMAT ",c=%d,r=%d,C=1,q=2;%s\033\\",
                     width,
                     height,
+                    medium,
                     payload_size,
                     display_width_cells,
                     display_height_cells,
@@ -110,18 +118,33 @@ GString *kitty_graphics_build_shm_command(const gchar *shm_name,
     return command;
 }
 
+GString *kitty_graphics_build_shm_command(const gchar *shm_name,
+                                          gint width,
+                                          gint height,
+                                          gint display_width_cells,
+                                          gint display_height_cells,
+                                          gsize payload_size) {
+    return kitty_graphics_build_transfer_command('s',
+                                                 shm_name,
+                                                 width,
+                                                 height,
+                                                 display_width_cells,
+                                                 display_height_cells,
+                                                 payload_size);
+}
+
 static gchar *kitty_graphics_make_shm_name(void) {
     static gint counter = 0;
     gint serial = g_atomic_int_add(&counter, 1);
     return g_strdup_printf("/pixelterm-kitty-%ld-%d", (long)getpid(), serial);
 }
 
-static void kitty_graphics_get_transfer_size(gint src_width,
-                                             gint src_height,
-                                             gint display_width_cells,
-                                             gint display_height_cells,
-                                             gint *width_out,
-                                             gint *height_out) {
+void kitty_graphics_get_transfer_size(gint src_width,
+                                      gint src_height,
+                                      gint display_width_cells,
+                                      gint display_height_cells,
+                                      gint *width_out,
+                                      gint *height_out) {
     gint cell_width = 0;
     gint cell_height = 0;
     get_terminal_cell_geometry(&cell_width, &cell_height);
@@ -149,44 +172,28 @@ static void kitty_graphics_get_transfer_size(gint src_width,
     if (height_out) *height_out = target_height;
 }
 
-static void kitty_graphics_copy_scaled_rgba(guint8 *dest,
-                                            gint dest_width,
-                                            gint dest_height,
-                                            const guint8 *src,
-                                            gint src_width,
-                                            gint src_height,
-                                            gint src_rowstride) {
-    for (gint y = 0; y < dest_height; y++) {
-        gint src_y = (gint)(((gint64)y * src_height) / dest_height);
-        if (src_y >= src_height) src_y = src_height - 1;
-        const guint8 *src_row = src + ((gsize)src_y * (gsize)src_rowstride);
-        guint8 *dest_row = dest + ((gsize)y * (gsize)dest_width * 4);
-        for (gint x = 0; x < dest_width; x++) {
-            gint src_x = (gint)(((gint64)x * src_width) / dest_width);
-            if (src_x >= src_width) src_x = src_width - 1;
-            memcpy(dest_row + ((gsize)x * 4), src_row + ((gsize)src_x * 4), 4);
-        }
-    }
-}
-
 void kitty_graphics_shm_unlink(const gchar *shm_name) {
     if (shm_name && shm_name[0] != '\0') {
         shm_unlink(shm_name);
     }
 }
 
-KittyGraphicsFrame *kitty_graphics_frame_new_shm_rgba(const guint8 *pixels,
-                                                       gint width,
-                                                       gint height,
-                                                       gint rowstride,
-                                                       gint display_width_cells,
-                                                       gint display_height_cells) {
+// Validates a frame and works out the pixel size sent to the terminal.
+static gboolean kitty_graphics_plan_transfer(const guint8 *pixels,
+                                             gint width,
+                                             gint height,
+                                             gint rowstride,
+                                             gint display_width_cells,
+                                             gint display_height_cells,
+                                             gint *transfer_width_out,
+                                             gint *transfer_height_out,
+                                             gsize *payload_size_out) {
     gsize required_rowstride = 0;
     if (!pixels || width <= 0 || height <= 0 || rowstride <= 0 ||
         !g_size_checked_mul(&required_rowstride, (gsize)width, (gsize)4) ||
         required_rowstride > (gsize)G_MAXINT || (gsize)rowstride < required_rowstride ||
         display_width_cells <= 0 || display_height_cells <= 0) {
-        return NULL;
+        return FALSE;
     }
 
     gint transfer_width = 0;
@@ -201,9 +208,59 @@ KittyGraphicsFrame *kitty_graphics_frame_new_shm_rgba(const guint8 *pixels,
     gsize payload_size = 0;
     if (!g_size_checked_mul(&payload_size, (gsize)transfer_width, (gsize)transfer_height) ||
         !g_size_checked_mul(&payload_size, payload_size, (gsize)4)) {
-        return NULL;
+        return FALSE;
     }
     if (payload_size > KITTY_GRAPHICS_SHM_MAX_PAYLOAD_BYTES) {
+        return FALSE;
+    }
+
+    *transfer_width_out = transfer_width;
+    *transfer_height_out = transfer_height;
+    *payload_size_out = payload_size;
+    return TRUE;
+}
+
+static void kitty_graphics_write_rgba(guint8 *dest,
+                                      gint transfer_width,
+                                      gint transfer_height,
+                                      const guint8 *pixels,
+                                      gint width,
+                                      gint height,
+                                      gint rowstride) {
+    if (transfer_width == width && transfer_height == height) {
+        for (gint y = 0; y < height; y++) {
+            memcpy(dest + ((gsize)y * (gsize)width * 4), pixels + ((gsize)y * (gsize)rowstride), (gsize)width * 4);
+        }
+    } else {
+        // Area-average so text and fine detail survive the downscale
+        kitty_graphics_scale_rgba_area(dest,
+                                       transfer_width,
+                                       transfer_height,
+                                       pixels,
+                                       width,
+                                       height,
+                                       rowstride);
+    }
+}
+
+KittyGraphicsFrame *kitty_graphics_frame_new_shm_rgba(const guint8 *pixels,
+                                                       gint width,
+                                                       gint height,
+                                                       gint rowstride,
+                                                       gint display_width_cells,
+                                                       gint display_height_cells) {
+    gint transfer_width = 0;
+    gint transfer_height = 0;
+    gsize payload_size = 0;
+    if (!kitty_graphics_plan_transfer(pixels,
+                                      width,
+                                      height,
+                                      rowstride,
+                                      display_width_cells,
+                                      display_height_cells,
+                                      &transfer_width,
+                                      &transfer_height,
+                                      &payload_size)) {
         return NULL;
     }
 
@@ -247,20 +304,7 @@ KittyGraphicsFrame *kitty_graphics_frame_new_shm_rgba(const guint8 *pixels,
         return NULL;
     }
 
-    if (transfer_width == width && transfer_height == height) {
-        guint8 *dest = mapped;
-        for (gint y = 0; y < height; y++) {
-            memcpy(dest + ((gsize)y * (gsize)width * 4), pixels + ((gsize)y * (gsize)rowstride), (gsize)width * 4);
-        }
-    } else {
-        kitty_graphics_copy_scaled_rgba(mapped,
-                                        transfer_width,
-                                        transfer_height,
-                                        pixels,
-                                        width,
-                                        height,
-                                        rowstride);
-    }
+    kitty_graphics_write_rgba(mapped, transfer_width, transfer_height, pixels, width, height, rowstride);
     munmap(mapped, payload_size);
     close(fd);
 
@@ -290,6 +334,350 @@ KittyGraphicsFrame *kitty_graphics_frame_new_shm_rgba(const guint8 *pixels,
     return frame;
 }
 
+/*
+ * Ring of persistent frame buffers for kitty video. POSIX shm objects are
+ * unlinked by the terminal once read (the protocol requires it), so they
+ * cannot be reused. Files in a tmpfs directory sent with t=f stay put:
+ * each slot is created, sized and faulted in once, and later frames are
+ * written into its mapping in place.
+ *
+ * A slot is free again when its frame was dropped unshown, or once the
+ * settle time has passed after the terminal was handed its command. A
+ * terminal that deletes the file anyway is detected from the link count and
+ * the slot's file is created again.
+ *
+ * The settle time is a heuristic, not a consumption signal. Frames are sent
+ * with q=2, so the terminal never says when it has read one; asking would
+ * put replies on stdin, where the input handler reads keys. The slot is
+ * rewritten in place through the shared mapping, so a terminal still
+ * copying it after the settle time can show a torn frame, part old and
+ * part new. Reusing the slot submitted longest ago keeps that window as
+ * wide as the ring allows.
+ *
+ * Files outlive a killed process. Creating a ring removes files left in its
+ * directory by pixelterm processes that no longer exist.
+ */
+
+// Submitted frames are left alone this long so the terminal can read them
+#define KITTY_SHM_RING_SETTLE_US (100 * 1000)
+#define KITTY_SHM_RING_FILE_PREFIX "pixelterm-kitty-"
+// Frames queued ahead plus frames still settling
+#define KITTY_SHM_RING_MAX_SLOTS 16
+
+typedef enum {
+    KITTY_SHM_SLOT_FREE = 0,
+    KITTY_SHM_SLOT_HELD,            // Owned by a frame not yet shown
+    KITTY_SHM_SLOT_SUBMITTED        // Handed to the terminal
+} KittyShmSlotState;
+
+struct KittyShmSlot {
+    KittyShmRing *ring;
+    gchar *path;
+    int fd;
+    guint8 *map;
+    gsize size;
+    KittyShmSlotState state;
+    gint64 submitted_us;
+};
+
+struct KittyShmRing {
+    GMutex mutex;
+    gchar *directory;
+    GPtrArray *slots;
+    guint serial;
+    gboolean closing;               // Freed; the last held slot frees the ring
+};
+
+static void kitty_shm_slot_unmap(KittyShmSlot *slot) {
+    if (slot->map) {
+        munmap(slot->map, slot->size);
+        slot->map = NULL;
+    }
+    if (slot->fd >= 0) {
+        close(slot->fd);
+        slot->fd = -1;
+    }
+}
+
+static void kitty_shm_slot_destroy(KittyShmSlot *slot) {
+    kitty_shm_slot_unmap(slot);
+    // The terminal may have deleted it already
+    (void)unlink(slot->path);
+    g_free(slot->path);
+    g_free(slot);
+}
+
+// Creates the slot's file at its path, sized and faulted in.
+static gboolean kitty_shm_slot_open(KittyShmSlot *slot) {
+    int flags = O_CREAT | O_EXCL | O_RDWR;
+#ifdef O_CLOEXEC
+    flags |= O_CLOEXEC;
+#endif
+    int fd = open(slot->path, flags, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        return FALSE;
+    }
+    if (ftruncate(fd, (off_t)slot->size) != 0) {
+        close(fd);
+        (void)unlink(slot->path);
+        return FALSE;
+    }
+    int map_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    map_flags |= MAP_POPULATE;
+#endif
+    void *mapped = mmap(NULL, slot->size, PROT_READ | PROT_WRITE, map_flags, fd, 0);
+    if (mapped == MAP_FAILED) {
+        close(fd);
+        (void)unlink(slot->path);
+        return FALSE;
+    }
+#ifndef MAP_POPULATE
+    memset(mapped, 0, slot->size);
+#endif
+    slot->fd = fd;
+    slot->map = mapped;
+    return TRUE;
+}
+
+static KittyShmSlot *kitty_shm_slot_new(KittyShmRing *ring, gsize size) {
+    KittyShmSlot *slot = g_new0(KittyShmSlot, 1);
+    slot->ring = ring;
+    slot->fd = -1;
+    slot->size = size;
+    slot->path = g_strdup_printf("%s/" KITTY_SHM_RING_FILE_PREFIX "%ld-%u",
+                                 ring->directory, (long)getpid(), ring->serial++);
+    if (!kitty_shm_slot_open(slot)) {
+        g_free(slot->path);
+        g_free(slot);
+        return NULL;
+    }
+    return slot;
+}
+
+// Recreates the file if the terminal deleted it after reading.
+static gboolean kitty_shm_slot_ensure_linked(KittyShmSlot *slot) {
+    struct stat st;
+    if (fstat(slot->fd, &st) == 0 && st.st_nlink > 0) {
+        return TRUE;
+    }
+    kitty_shm_slot_unmap(slot);
+    (void)unlink(slot->path);
+    return kitty_shm_slot_open(slot);
+}
+
+static KittyShmSlot *kitty_shm_ring_acquire(KittyShmRing *ring, gsize size) {
+    g_mutex_lock(&ring->mutex);
+    gint64 now = g_get_monotonic_time();
+    KittyShmSlot *chosen = NULL;
+    for (guint i = 0; i < ring->slots->len;) {
+        KittyShmSlot *slot = g_ptr_array_index(ring->slots, i);
+        gboolean available = slot->state == KITTY_SHM_SLOT_FREE ||
+                             (slot->state == KITTY_SHM_SLOT_SUBMITTED &&
+                              now - slot->submitted_us >= KITTY_SHM_RING_SETTLE_US);
+        if (available && slot->size != size) {
+            // Left over from another resolution
+            g_ptr_array_remove_index_fast(ring->slots, i);
+            kitty_shm_slot_destroy(slot);
+            continue;
+        }
+        if (available && (!chosen || slot->state == KITTY_SHM_SLOT_FREE ||
+                          (chosen->state == KITTY_SHM_SLOT_SUBMITTED &&
+                           slot->submitted_us < chosen->submitted_us))) {
+            chosen = slot;
+        }
+        i++;
+    }
+
+    if (chosen && !kitty_shm_slot_ensure_linked(chosen)) {
+        g_ptr_array_remove_fast(ring->slots, chosen);
+        kitty_shm_slot_destroy(chosen);
+        chosen = NULL;
+    }
+    if (!chosen && ring->slots->len < KITTY_SHM_RING_MAX_SLOTS) {
+        chosen = kitty_shm_slot_new(ring, size);
+        if (chosen) {
+            g_ptr_array_add(ring->slots, chosen);
+        }
+    }
+    if (chosen) {
+        chosen->state = KITTY_SHM_SLOT_HELD;
+    }
+    g_mutex_unlock(&ring->mutex);
+    return chosen;
+}
+
+static void kitty_shm_ring_destroy(KittyShmRing *ring) {
+    g_ptr_array_free(ring->slots, TRUE);
+    g_free(ring->directory);
+    g_mutex_clear(&ring->mutex);
+    g_free(ring);
+}
+
+// Removes slot files, and shm objects named the same way, whose process is gone.
+static void kitty_shm_ring_remove_stale(const gchar *directory) {
+    GDir *dir = g_dir_open(directory, 0, NULL);
+    if (!dir) {
+        return;
+    }
+    const gchar *name = NULL;
+    while ((name = g_dir_read_name(dir)) != NULL) {
+        if (!g_str_has_prefix(name, KITTY_SHM_RING_FILE_PREFIX)) {
+            continue;
+        }
+        const gchar *pid_text = name + strlen(KITTY_SHM_RING_FILE_PREFIX);
+        gchar *end = NULL;
+        gint64 pid = g_ascii_strtoll(pid_text, &end, 10);
+        if (end == pid_text || *end != '-' || pid <= 0 || pid > G_MAXINT || pid == getpid()) {
+            continue;
+        }
+        if (kill((pid_t)pid, 0) == 0 || errno != ESRCH) {
+            continue;
+        }
+        gchar *path = g_build_filename(directory, name, NULL);
+        (void)unlink(path);
+        g_free(path);
+    }
+    g_dir_close(dir);
+}
+
+KittyShmRing *kitty_shm_ring_new(const gchar *directory) {
+    if (!directory) {
+        directory = "/dev/shm";
+    }
+    if (!g_file_test(directory, G_FILE_TEST_IS_DIR) || access(directory, W_OK) != 0) {
+        return NULL;
+    }
+    kitty_shm_ring_remove_stale(directory);
+    KittyShmRing *ring = g_new0(KittyShmRing, 1);
+    g_mutex_init(&ring->mutex);
+    ring->directory = g_strdup(directory);
+    ring->slots = g_ptr_array_new();
+    return ring;
+}
+
+void kitty_shm_ring_free(KittyShmRing *ring) {
+    if (!ring) {
+        return;
+    }
+    g_mutex_lock(&ring->mutex);
+    for (guint i = 0; i < ring->slots->len;) {
+        KittyShmSlot *slot = g_ptr_array_index(ring->slots, i);
+        if (slot->state == KITTY_SHM_SLOT_HELD) {
+            i++;
+            continue;
+        }
+        g_ptr_array_remove_index_fast(ring->slots, i);
+        kitty_shm_slot_destroy(slot);
+    }
+    gboolean empty = ring->slots->len == 0;
+    ring->closing = TRUE;
+    g_mutex_unlock(&ring->mutex);
+    if (empty) {
+        kitty_shm_ring_destroy(ring);
+    }
+}
+
+guint kitty_shm_ring_slot_count(KittyShmRing *ring) {
+    if (!ring) {
+        return 0;
+    }
+    g_mutex_lock(&ring->mutex);
+    guint count = ring->slots->len;
+    g_mutex_unlock(&ring->mutex);
+    return count;
+}
+
+const gchar *kitty_shm_slot_get_path(const KittyShmSlot *slot) {
+    return slot ? slot->path : NULL;
+}
+
+void kitty_shm_slot_submitted(KittyShmSlot *slot) {
+    if (!slot) {
+        return;
+    }
+    KittyShmRing *ring = slot->ring;
+    g_mutex_lock(&ring->mutex);
+    slot->state = KITTY_SHM_SLOT_SUBMITTED;
+    slot->submitted_us = g_get_monotonic_time();
+    gboolean closing = ring->closing;
+    g_mutex_unlock(&ring->mutex);
+    if (closing) {
+        kitty_shm_slot_release(slot);
+    }
+}
+
+void kitty_shm_slot_release(KittyShmSlot *slot) {
+    if (!slot) {
+        return;
+    }
+    KittyShmRing *ring = slot->ring;
+    g_mutex_lock(&ring->mutex);
+    if (!ring->closing) {
+        // Never shown: the terminal has not seen it, so it is free right away
+        if (slot->state == KITTY_SHM_SLOT_HELD) {
+            slot->state = KITTY_SHM_SLOT_FREE;
+        }
+        g_mutex_unlock(&ring->mutex);
+        return;
+    }
+    g_ptr_array_remove_fast(ring->slots, slot);
+    kitty_shm_slot_destroy(slot);
+    gboolean empty = ring->slots->len == 0;
+    g_mutex_unlock(&ring->mutex);
+    if (empty) {
+        kitty_shm_ring_destroy(ring);
+    }
+}
+
+KittyGraphicsFrame *kitty_graphics_frame_new_ring_rgba(KittyShmRing *ring,
+                                                        const guint8 *pixels,
+                                                        gint width,
+                                                        gint height,
+                                                        gint rowstride,
+                                                        gint display_width_cells,
+                                                        gint display_height_cells) {
+    gint transfer_width = 0;
+    gint transfer_height = 0;
+    gsize payload_size = 0;
+    if (!ring || !kitty_graphics_plan_transfer(pixels,
+                                               width,
+                                               height,
+                                               rowstride,
+                                               display_width_cells,
+                                               display_height_cells,
+                                               &transfer_width,
+                                               &transfer_height,
+                                               &payload_size)) {
+        return NULL;
+    }
+
+    KittyShmSlot *slot = kitty_shm_ring_acquire(ring, payload_size);
+    if (!slot) {
+        return NULL;
+    }
+    kitty_graphics_write_rgba(slot->map, transfer_width, transfer_height, pixels, width, height, rowstride);
+
+    GString *command = kitty_graphics_build_transfer_command('f',
+                                                             slot->path,
+                                                             transfer_width,
+                                                             transfer_height,
+                                                             display_width_cells,
+                                                             display_height_cells,
+                                                             payload_size);
+    if (!command) {
+        kitty_shm_slot_release(slot);
+        return NULL;
+    }
+
+    KittyGraphicsFrame *frame = g_new0(KittyGraphicsFrame, 1);
+    frame->command = command;
+    frame->slot = slot;
+    frame->display_width_cells = display_width_cells;
+    frame->display_height_cells = display_height_cells;
+    return frame;
+}
+
 void kitty_graphics_frame_free(KittyGraphicsFrame *frame) {
     if (!frame) {
         return;
@@ -297,6 +685,9 @@ void kitty_graphics_frame_free(KittyGraphicsFrame *frame) {
     if (frame->command) {
         g_string_free(frame->command, TRUE);
     }
+    if (frame->slot) {
+        kitty_shm_slot_release(frame->slot);
+    }
     if (frame->shm_name) {
         kitty_graphics_shm_unlink(frame->shm_name);
         g_free(frame->shm_name);
@@ -0,0 +1,361 @@
+#include "kitty_graphics_scale_internal.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KITTY_SCALE_HAVE_X86 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#define KITTY_SCALE_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Fixed-point weight totals. Row sums stay below 2^15 (255 * 128), so the
+// column pass can use signed 16-bit multiply-adds.
+#define KITTY_SCALE_ROW_ONE 128
+#define KITTY_SCALE_COLUMN_ONE 256
+#define KITTY_SCALE_SHIFT 15        // log2(ROW_ONE * COLUMN_ONE)
+
+// Source pixels feeding each destination pixel along one axis.
+typedef struct {
+    gint *start;                    // First source index
+    gint *count;
+    guint16 *weights;               // count weights per entry, stride taps
+    gint taps;
+} KittyScaleAxis;
+
+// Per-variant inner loops: sum weighted source rows (the first one
+// overwrites), then weighted columns
+typedef struct {
+    void (*accumulate)(guint16 *acc, const guint8 *row, gsize len, guint16 weight, gboolean first);
+    void (*resolve)(guint8 *dest, gint dest_width, const guint16 *acc, const KittyScaleAxis *columns);
+} KittyScaleKernels;
+
+// Splits each destination pixel over the source pixels it covers. With n
+// source and m destination pixels, source s spans [s*m, (s+1)*m) and
+// destination d spans [d*n, (d+1)*n); weights are cumulative overlaps
+// rounded to @p one so every destination sums exactly to it. With
+// @p pairs, counts are padded to even with zero weights, which may reach
+// one pixel past the source.
+static void kitty_scale_axis_init(KittyScaleAxis *axis, gint n, gint m, guint one, gboolean pairs) {
+    axis->taps = (n + m - 1) / m + 1;
+    if (pairs) {
+        axis->taps += axis->taps & 1;
+    }
+    axis->start = g_new(gint, m);
+    axis->count = g_new(gint, m);
+    axis->weights = g_new0(guint16, (gsize)m * (gsize)axis->taps);
+
+    for (gint d = 0; d < m; d++) {
+        gint64 lo = (gint64)d * n;
+        gint64 hi = lo + n;
+        gint first = (gint)(lo / m);
+        gint count = 0;
+        gint64 covered = 0;
+        guint prev = 0;
+        guint16 *weights = axis->weights + (gsize)d * (gsize)axis->taps;
+        for (gint s = first; s < n && (gint64)s * m < hi && count < axis->taps; s++) {
+            gint64 s_lo = MAX((gint64)s * m, lo);
+            gint64 s_hi = MIN((gint64)(s + 1) * m, hi);
+            covered += s_hi - s_lo;
+            guint next = (guint)((covered * one + n / 2) / n);
+            if (count == 0 && next == prev) {
+                // Leading sliver too thin to carry weight
+                first = s + 1;
+                continue;
+            }
+            weights[count++] = (guint16)(next - prev);
+            prev = next;
+        }
+        // Trailing slivers that rounded to nothing
+        while (count > 1 && weights[count - 1] == 0) {
+            count--;
+        }
+        if (pairs) {
+            count += count & 1;
+        }
+        axis->start[d] = first;
+        axis->count[d] = count;
+    }
+}
+
+static void kitty_scale_axis_clear(KittyScaleAxis *axis) {
+    g_free(axis->start);
+    g_free(axis->count);
+    g_free(axis->weights);
+}
+
+static void kitty_scale_accumulate_row_scalar(guint16 *acc, const guint8 *row, gsize len, guint16 weight, gboolean first) {
+    if (first) {
+        for (gsize i = 0; i < len; i++) {
+            acc[i] = (guint16)(row[i] * weight);
+        }
+    } else {
+        for (gsize i = 0; i < len; i++) {
+            acc[i] = (guint16)(acc[i] + row[i] * weight);
+        }
+    }
+}
+
+// Collapses one accumulated row into destination pixels.
+static void kitty_scale_resolve_row_scalar(guint8 *dest, gint dest_width, const guint16 *acc, const KittyScaleAxis *columns) {
+    for (gint x = 0; x < dest_width; x++) {
+        const guint16 *px = acc + (gsize)columns->start[x] * 4;
+        const guint16 *weights = columns->weights + (gsize)x * (gsize)columns->taps;
+        guint32 r = 1u << (KITTY_SCALE_SHIFT - 1);
+        guint32 g = r;
+        guint32 b = r;
+        guint32 a = r;
+        for (gint k = 0; k < columns->count[x]; k++, px += 4) {
+            guint32 w = weights[k];
+            r += px[0] * w;
+            g += px[1] * w;
+            b += px[2] * w;
+            a += px[3] * w;
+        }
+        guint8 *out = dest + (gsize)x * 4;
+        out[0] = (guint8)(r >> KITTY_SCALE_SHIFT);
+        out[1] = (guint8)(g >> KITTY_SCALE_SHIFT);
+        out[2] = (guint8)(b >> KITTY_SCALE_SHIFT);
+        out[3] = (guint8)(a >> KITTY_SCALE_SHIFT);
+    }
+}
+
+#ifdef KITTY_SCALE_HAVE_X86
+__attribute__((target("sse2")))
+static void kitty_scale_accumulate_row_sse2(guint16 *acc, const guint8 *row, gsize len, guint16 weight, gboolean first) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w = _mm_set1_epi16((short)weight);
+    gsize i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i px = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(px, zero), w);
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(px, zero), w);
+        __m128i *out = (__m128i *)(acc + i);
+        if (!first) {
+            lo = _mm_add_epi16(_mm_loadu_si128(out), lo);
+            hi = _mm_add_epi16(_mm_loadu_si128(out + 1), hi);
+        }
+        _mm_storeu_si128(out, lo);
+        _mm_storeu_si128(out + 1, hi);
+    }
+    kitty_scale_accumulate_row_scalar(acc + i, row + i, len - i, weight, first);
+}
+
+// Two source pixels per step: their channels are interleaved so one
+// multiply-add applies both weights.
+__attribute__((target("sse2")))
+static void kitty_scale_resolve_row_sse2(guint8 *dest, gint dest_width, const guint16 *acc, const KittyScaleAxis *columns) {
+    const __m128i round = _mm_set1_epi32(1 << (KITTY_SCALE_SHIFT - 1));
+    for (gint x = 0; x < dest_width; x++) {
+        const guint16 *px = acc + (gsize)columns->start[x] * 4;
+        const guint16 *weights = columns->weights + (gsize)x * (gsize)columns->taps;
+        __m128i sum = round;
+        for (gint k = 0; k < columns->count[x]; k += 2, px += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)px);
+            v = _mm_unpacklo_epi16(v, _mm_srli_si128(v, 8));
+            gint32 pair;
+            memcpy(&pair, weights + k, sizeof(pair));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(v, _mm_set1_epi32(pair)));
+        }
+        __m128i out = _mm_srli_epi32(sum, KITTY_SCALE_SHIFT);
+        out = _mm_packs_epi32(out, out);
+        out = _mm_packus_epi16(out, out);
+        gint32 packed = _mm_cvtsi128_si32(out);
+        memcpy(dest + (gsize)x * 4, &packed, 4);
+    }
+}
+
+__attribute__((target("avx2")))
+static void kitty_scale_accumulate_row_avx2(guint16 *acc, const guint8 *row, gsize len, guint16 weight, gboolean first) {
+    const __m256i w = _mm256_set1_epi16((short)weight);
+    gsize i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m256i px = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(row + i)));
+        __m256i *out = (__m256i *)(acc + i);
+        __m256i sum = _mm256_mullo_epi16(px, w);
+        if (!first) {
+            sum = _mm256_add_epi16(_mm256_loadu_si256(out), sum);
+        }
+        _mm256_storeu_si256(out, sum);
+    }
+    kitty_scale_accumulate_row_scalar(acc + i, row + i, len - i, weight, first);
+}
+#endif
+
+#ifdef KITTY_SCALE_HAVE_NEON
+static void kitty_scale_accumulate_row_neon(guint16 *acc, const guint8 *row, gsize len, guint16 weight, gboolean first) {
+    gsize i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint16x8_t px = vmovl_u8(vld1_u8(row + i));
+        uint16x8_t sum = first ? vmulq_n_u16(px, weight) : vmlaq_n_u16(vld1q_u16(acc + i), px, weight);
+        vst1q_u16(acc + i, sum);
+    }
+    kitty_scale_accumulate_row_scalar(acc + i, row + i, len - i, weight, first);
+}
+
+static void kitty_scale_resolve_row_neon(guint8 *dest, gint dest_width, const guint16 *acc, const KittyScaleAxis *columns) {
+    for (gint x = 0; x < dest_width; x++) {
+        const guint16 *px = acc + (gsize)columns->start[x] * 4;
+        const guint16 *weights = columns->weights + (gsize)x * (gsize)columns->taps;
+        uint32x4_t sum = vdupq_n_u32(1u << (KITTY_SCALE_SHIFT - 1));
+        for (gint k = 0; k < columns->count[x]; k++, px += 4) {
+            sum = vmlal_n_u16(sum, vld1_u16(px), weights[k]);
+        }
+        uint16x4_t narrow = vshrn_n_u32(sum, KITTY_SCALE_SHIFT);
+        uint8x8_t out = vmovn_u16(vcombine_u16(narrow, narrow));
+        vst1_lane_u32((uint32_t *)(void *)(dest + (gsize)x * 4), vreinterpret_u32_u8(out), 0);
+    }
+}
+#endif
+
+static gboolean kitty_scale_cpu_has(KittyScaleImpl impl) {
+    switch (impl) {
+        case KITTY_SCALE_IMPL_SCALAR:
+            return TRUE;
+#ifdef KITTY_SCALE_HAVE_X86
+        case KITTY_SCALE_IMPL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case KITTY_SCALE_IMPL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef KITTY_SCALE_HAVE_NEON
+        case KITTY_SCALE_IMPL_NEON:
+            return TRUE;
+#endif
+        default:
+            return FALSE;
+    }
+}
+
+KittyScaleImpl kitty_graphics_scale_best_impl(void) {
+    static const KittyScaleImpl order[] = {
+        KITTY_SCALE_IMPL_AVX2, KITTY_SCALE_IMPL_NEON, KITTY_SCALE_IMPL_SSE2
+    };
+    for (gsize i = 0; i < G_N_ELEMENTS(order); i++) {
+        if (kitty_scale_cpu_has(order[i])) {
+            return order[i];
+        }
+    }
+    return KITTY_SCALE_IMPL_SCALAR;
+}
+
+const char *kitty_graphics_scale_impl_name(KittyScaleImpl impl) {
+    switch (impl) {
+        case KITTY_SCALE_IMPL_AUTO: return "auto";
+        case KITTY_SCALE_IMPL_SCALAR: return "scalar";
+        case KITTY_SCALE_IMPL_SSE2: return "sse2";
+        case KITTY_SCALE_IMPL_AVX2: return "avx2";
+        case KITTY_SCALE_IMPL_NEON: return "neon";
+    }
+    return "unknown";
+}
+
+static KittyScaleKernels kitty_scale_kernels(KittyScaleImpl impl) {
+    KittyScaleKernels kernels = { kitty_scale_accumulate_row_scalar, kitty_scale_resolve_row_scalar };
+    switch (impl) {
+#ifdef KITTY_SCALE_HAVE_X86
+        case KITTY_SCALE_IMPL_SSE2:
+            kernels.accumulate = kitty_scale_accumulate_row_sse2;
+            kernels.resolve = kitty_scale_resolve_row_sse2;
+            break;
+        case KITTY_SCALE_IMPL_AVX2:
+            kernels.accumulate = kitty_scale_accumulate_row_avx2;
+            kernels.resolve = kitty_scale_resolve_row_sse2;
+            break;
+#endif
+#ifdef KITTY_SCALE_HAVE_NEON
+        case KITTY_SCALE_IMPL_NEON:
+            kernels.accumulate = kitty_scale_accumulate_row_neon;
+            kernels.resolve = kitty_scale_resolve_row_neon;
+            break;
+#endif
+        default:
+            break;
+    }
+    return kernels;
+}
+
+gboolean kitty_graphics_scale_rgba_area_with(KittyScaleImpl impl,
+                                             guint8 *dest,
+                                             gint dest_width,
+                                             gint dest_height,
+                                             const guint8 *src,
+                                             gint src_width,
+                                             gint src_height,
+                                             gint src_rowstride) {
+    if (impl == KITTY_SCALE_IMPL_AUTO) {
+        static gsize resolved = 0;
+        if (g_once_init_enter(&resolved)) {
+            g_once_init_leave(&resolved, (gsize)kitty_graphics_scale_best_impl() + 1);
+        }
+        impl = (KittyScaleImpl)(resolved - 1);
+    }
+    if (!kitty_scale_cpu_has(impl)) {
+        return FALSE;
+    }
+    if (!dest || !src || dest_width <= 0 || dest_height <= 0 || src_width <= 0 || src_height <= 0) {
+        return TRUE;
+    }
+
+    KittyScaleAxis rows;
+    KittyScaleAxis columns;
+    kitty_scale_axis_init(&rows, src_height, dest_height, KITTY_SCALE_ROW_ONE, FALSE);
+    kitty_scale_axis_init(&columns, src_width, dest_width, KITTY_SCALE_COLUMN_ONE, TRUE);
+    KittyScaleKernels kernels = kitty_scale_kernels(impl);
+
+    gsize row_len = (gsize)src_width * 4;
+    // The zeroed pixel past the end backs column padding
+    guint16 *acc = g_new0(guint16, row_len + 4);
+    for (gint y = 0; y < dest_height; y++) {
+        const guint16 *weights = rows.weights + (gsize)y * (gsize)rows.taps;
+        for (gint k = 0; k < rows.count[y]; k++) {
+            const guint8 *row = src + (gsize)(rows.start[y] + k) * (gsize)src_rowstride;
+            kernels.accumulate(acc, row, row_len, weights[k], k == 0);
+        }
+        kernels.resolve(dest + (gsize)y * (gsize)dest_width * 4, dest_width, acc, &columns);
+    }
+
+    g_free(acc);
+    kitty_scale_axis_clear(&rows);
+    kitty_scale_axis_clear(&columns);
+    return TRUE;
+}
+
+void kitty_graphics_scale_rgba_area(guint8 *dest,
+                                    gint dest_width,
+                                    gint dest_height,
+                                    const guint8 *src,
+                                    gint src_width,
+                                    gint src_height,
+                                    gint src_rowstride) {
+    (void)kitty_graphics_scale_rgba_area_with(KITTY_SCALE_IMPL_AUTO,
+                                              dest,
+                                              dest_width,
+                                              dest_height,
+                                              src,
+                                              src_width,
+                                              src_height,
+                                              src_rowstride);
+}
+
+void kitty_graphics_scale_rgba_nearest(guint8 *dest,
+                                       gint dest_width,
+                                       gint dest_height,
+                                       const guint8 *src,
+                                       gint src_width,
+                                       gint src_height,
+                                       gint src_rowstride) {
+    for (gint y = 0; y < dest_height; y++) {
+        gint src_y = (gint)(((gint64)y * src_height) / dest_height);
+        if (src_y >= src_height) src_y = src_height - 1;
+        const guint8 *src_row = src + ((gsize)src_y * (gsize)src_rowstride);
+        guint8 *dest_row = dest + ((gsize)y * (gsize)dest_width * 4);
+        for (gint x = 0; x < dest_width; x++) {
+            gint src_x = (gint)(((gint64)x * src_width) / dest_width);
+            if (src_x >= src_width) src_x = src_width - 1;
+            memcpy(dest_row + ((gsize)x * 4), src_row + ((gsize)src_x * 4), 4);
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include "kitty_registry.h"
+#include "kitty_command_internal.h"
+
+#include <string.h>
+
+// Keys copied from a transmit into its placements: cell size, cursor
+// movement, offsets and source rectangle.
+static const char k_placement_keys[] = "crCzXYxywh";
+
+typedef struct {
+    gchar *key;
+    gchar *path;
+    guint32 id;
+    gint width;
+    gint height;
+    gsize bytes;
+    gchar *placement;       // Output replacing the transmit on later draws
+} KittyRegistryEntry;
+
+struct KittyRegistry {
+    GHashTable *entries;    // key -> GList link in lru
+    GQueue lru;             // KittyRegistryEntry*, most recently used first
+    gsize budget;
+    gsize resident_bytes;
+    guint32 next_id;
+};
+
+static gchar* kitty_registry_make_key(const char *path, gint target_width, gint target_height) {
+    return g_strdup_printf("%s|%dx%d", path, target_width, target_height);
+}
+
+static void kitty_registry_entry_free(KittyRegistryEntry *entry) {
+    if (!entry) {
+        return;
+    }
+    g_free(entry->key);
+    g_free(entry->path);
+    g_free(entry->placement);
+    g_free(entry);
+}
+
+static void kitty_registry_append_delete(GString *out, guint32 id) {
+    if (out) {
+        g_string_append_printf(out, "\033_Ga=d,d=I,i=%u,q=2\033\\", id);
+    }
+}
+
+// Locates an untagged immediate transmit (`a=T` without an ID) and the end
+// of its last chunk.
+static gboolean kitty_registry_parse_transmit(const GString *rendered,
+                                              KittyCommand *out_first,
+                                              gsize *out_end,
+                                              gsize *out_payload_len) {
+    KittyCommand cmd;
+    if (!kitty_command_first_untagged_transmit(rendered, &cmd)) {
+        return FALSE;
+    }
+
+    *out_first = cmd;
+    gsize payload_len = cmd.payload_len;
+    // Chunked transmissions continue while m=1
+    while (kitty_command_get_int(rendered, &cmd, 'm', 0) == 1) {
+        if (!kitty_command_next(rendered, cmd.end, &cmd)) {
+            return FALSE;
+        }
+        payload_len += cmd.payload_len;
+    }
+    *out_end = cmd.end;
+    *out_payload_len = payload_len;
+    return TRUE;
+}
+
+// Pixel data the terminal keeps for the image.
+static gsize kitty_registry_estimate_bytes(const GString *rendered, const KittyCommand *first, gsize payload_len) {
+    gint64 format = kitty_command_get_int(rendered, first, 'f', 32);
+    gint64 width = kitty_command_get_int(rendered, first, 's', 0);
+    gint64 height = kitty_command_get_int(rendered, first, 'v', 0);
+    if ((format == 32 || format == 24) && width > 0 && height > 0) {
+        return (gsize)width * (gsize)height * (format == 32 ? 4u : 3u);
+    }
+    // Compressed or PNG data: use the decoded payload size
+    return payload_len / 4 * 3;
+}
+
+static gchar* kitty_registry_build_placement(const GString *rendered,
+                                             const KittyCommand *first,
+                                             gsize transmit_end,
+                                             guint32 id) {
+    GString *placement = g_string_new(NULL);
+    g_string_append_len(placement, rendered->str, (gssize)first->start);
+    g_string_append_printf(placement, "\033_Ga=p,i=%u", id);
+    for (const char *key = k_placement_keys; *key; key++) {
+        const char *value = NULL;
+        gsize len = 0;
+        if (kitty_command_get(rendered, first, *key, &value, &len)) {
+            g_string_append_c(placement, ',');
+            g_string_append_c(placement, *key);
+            g_string_append_c(placement, '=');
+            g_string_append_len(placement, value, (gssize)len);
+        }
+    }
+    g_string_append(placement, ",q=2\033\\");
+    g_string_append_len(placement, rendered->str + transmit_end, (gssize)(rendered->len - transmit_end));
+    return g_string_free(placement, FALSE);
+}
+
+static void kitty_registry_remove_link(KittyRegistry *registry, GList *link, GString *out) {
+    KittyRegistryEntry *entry = link->data;
+    kitty_registry_append_delete(out, entry->id);
+    registry->resident_bytes -= entry->bytes;
+    g_hash_table_remove(registry->entries, entry->key);
+    g_queue_delete_link(&registry->lru, link);
+    kitty_registry_entry_free(entry);
+}
+
+KittyRegistry* kitty_registry_new(gsize budget_bytes) {
+    KittyRegistry *registry = g_new0(KittyRegistry, 1);
+    registry->entries = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&registry->lru);
+    registry->budget = budget_bytes;
+    // Start somewhere random so another program sharing the terminal is
+    // unlikely to be using the same IDs
+    registry->next_id = (guint32)g_random_int_range(1, 1 << 24);
+    return registry;
+}
+
+void kitty_registry_free(KittyRegistry *registry) {
+    if (!registry) {
+        return;
+    }
+    g_hash_table_destroy(registry->entries);
+    g_queue_clear_full(&registry->lru, (GDestroyNotify)kitty_registry_entry_free);
+    g_free(registry);
+}
+
+gboolean kitty_registry_place(KittyRegistry *registry,
+                              const char *path,
+                              gint target_width,
+                              gint target_height,
+                              GString *out,
+                              gint *out_width,
+                              gint *out_height) {
+    if (!registry || !path || !out) {
+        return FALSE;
+    }
+    gchar *key = kitty_registry_make_key(path, target_width, target_height);
+    GList *link = g_hash_table_lookup(registry->entries, key);
+    g_free(key);
+    if (!link) {
+        return FALSE;
+    }
+
+    g_queue_unlink(&registry->lru, link);
+    g_queue_push_head_link(&registry->lru, link);
+    KittyRegistryEntry *entry = link->data;
+    g_string_append(out, entry->placement);
+    if (out_width) {
+        *out_width = entry->width;
+    }
+    if (out_height) {
+        *out_height = entry->height;
+    }
+    return TRUE;
+}
+
+gboolean kitty_registry_transmit(KittyRegistry *registry,
+                                 const char *path,
+                                 gint target_width,
+                                 gint target_height,
+                                 gint width,
+                                 gint height,
+                                 const GString *rendered,
+                                 GString *out) {
+    if (!registry || !path || !out) {
+        return FALSE;
+    }
+    KittyCommand first;
+    gsize transmit_end = 0;
+    gsize payload_len = 0;
+    if (!kitty_registry_parse_transmit(rendered, &first, &transmit_end, &payload_len)) {
+        return FALSE;
+    }
+    gsize bytes = kitty_registry_estimate_bytes(rendered, &first, payload_len);
+    if (bytes > registry->budget) {
+        return FALSE;
+    }
+
+    gchar *key = kitty_registry_make_key(path, target_width, target_height);
+    GList *existing = g_hash_table_lookup(registry->entries, key);
+    if (existing) {
+        kitty_registry_remove_link(registry, existing, out);
+    }
+
+    guint32 id = registry->next_id++;
+    if (registry->next_id == 0) {
+        registry->next_id = 1;
+    }
+
+    KittyRegistryEntry *entry = g_new0(KittyRegistryEntry, 1);
+    entry->key = key;
+    entry->path = g_strdup(path);
+    entry->id = id;
+    entry->width = width;
+    entry->height = height;
+    entry->bytes = bytes;
+    entry->placement = kitty_registry_build_placement(rendered, &first, transmit_end, id);
+    g_queue_push_head(&registry->lru, entry);
+    g_hash_table_insert(registry->entries, entry->key, registry->lru.head);
+    registry->resident_bytes += bytes;
+
+    // The new image is the most recent; older ones make room for it
+    while (registry->resident_bytes > registry->budget && registry->lru.length > 1) {
+        kitty_registry_remove_link(registry, registry->lru.tail, out);
+    }
+
+    g_string_append_len(out, rendered->str, (gssize)first.control);
+    kitty_command_append_id_tag(out, rendered, &first, id);
+    g_string_append_len(out, rendered->str + first.control, (gssize)(rendered->len - first.control));
+    return TRUE;
+}
+
+void kitty_registry_forget(KittyRegistry *registry, const char *path, GString *out) {
+    if (!registry || !path) {
+        return;
+    }
+    GList *link = registry->lru.head;
+    while (link) {
+        GList *next = link->next;
+        KittyRegistryEntry *entry = link->data;
+        if (g_strcmp0(entry->path, path) == 0) {
+            kitty_registry_remove_link(registry, link, out);
+        }
+        link = next;
+    }
+}
+
+void kitty_registry_clear(KittyRegistry *registry, GString *out) {
+    if (!registry) {
+        return;
+    }
+    while (registry->lru.tail) {
+        kitty_registry_remove_link(registry, registry->lru.tail, out);
+    }
+}
+
+guint kitty_registry_count(const KittyRegistry *registry) {
+    return registry ? registry->lru.length : 0;
+}
+
+gsize kitty_registry_resident_bytes(const KittyRegistry *registry) {
+    return registry ? registry->resident_bytes : 0;
+}
@@ -13,32 +13,55 @@
 #include "app_startup.h"
 #include "app_cli.h"
 #include "app_config_runtime.h"
+#include "event_loop.h"
 #include "input.h"
 #include "input_dispatch.h"
+#include "preload_control.h"
+#include "term_output.h"
 #include "common.h"
 #include "ui_render_utils.h"
 #include "text_utils.h"
+#include "trace.h"
 
 // Global application instance
 static PixelTermApp *g_app = NULL;
 static volatile sig_atomic_t g_terminate_requested = 0;
 static volatile sig_atomic_t g_last_signal = 0;
-static const useconds_t k_input_poll_sleep_us = 10000;
-static const useconds_t k_resize_sleep_us = 100000;
+// Quiet time after the last size change before the frame is repainted
+static const gint64 k_resize_settle_us = 100000;
 
 
 // Signal handler for graceful shutdown
 static void signal_handler(int sig) {
-    (void)sig; // Suppress unused parameter warning
     g_terminate_requested = 1;
     g_last_signal = sig;
+    event_loop_notify_signal(sig);
 }
 
-static void run_application_cleanup(InputHandler *input_handler) {
+static void resize_signal_handler(int sig) {
+    event_loop_notify_signal(sig);
+}
+
+// Milliseconds until @p deadline_us, rounded up; 0 once it has passed.
+static gint timeout_until(gint64 deadline_us) {
+    gint64 remaining = deadline_us - g_get_monotonic_time();
+    return remaining > 0 ? (gint)((remaining + 999) / 1000) : 0;
+}
+
+static gint min_timeout(gint a, gint b) {
+    if (a < 0) {
+        return b;
+    }
+    return (b < 0 || a < b) ? a : b;
+}
+
+static void run_application_cleanup(PixelTermApp *app, InputHandler *input_handler) {
     if (!input_handler) {
         return;
     }
 
+    // Images kept for reuse would otherwise hold terminal memory after exit
+    ui_release_kitty_images(app);
     printf("\033[2J\033[H\033[0m");
     printf("\033[?25h");
     fflush(stdout);
@@ -46,6 +69,7 @@ static void run_application_cleanup(InputHandler *input_handler) {
     input_disable_mouse(input_handler);
     input_disable_raw_mode(input_handler);
     input_handler_destroy(input_handler);
+    term_output_uninstall();
 }
 
 static ErrorCode run_application(PixelTermApp *app, gboolean alt_screen_enabled) {
@@ -80,6 +104,10 @@ static ErrorCode run_application(PixelTermApp *app, gboolean alt_screen_enabled)
     // which would otherwise immediately trigger an action like exit.
     input_flush_buffer(input_handler);
 
+    // Screen updates are composed in memory and written once per frame. If
+    // the stream cannot be set up, stdout is used as it is.
+    (void)term_output_install(STDOUT_FILENO);
+
     // Initial render
     if (input_handler->alt_screen_enabled) {
         app->suppress_full_clear = TRUE;
@@ -89,64 +117,45 @@ static ErrorCode run_application(PixelTermApp *app, gboolean alt_screen_enabled)
         app->suppress_full_clear = FALSE;
     }
     if (error != ERROR_NONE) {
-        run_application_cleanup(input_handler);
+        run_application_cleanup(app, input_handler);
         return error;
     }
 
-    // Main event loop
+    EventLoop *event_loop = event_loop_new(STDIN_FILENO);
+    if (!event_loop) {
+        run_application_cleanup(app, input_handler);
+        return ERROR_MEMORY_ALLOC;
+    }
+
+    // Main event loop: handle whatever is ready, then sleep in one poll until
+    // input, a signal, a worker, a timer or the directory watch has more
     InputEvent event;
-    static gint last_term_width = 0, last_term_height = 0;
     gboolean resize_pending = FALSE;
-    // Initialize terminal size tracking
-    last_term_width = input_handler->terminal_width;
-    last_term_height = input_handler->terminal_height;
-        
+    gint64 resize_deadline_us = 0;
+
     while (app->running && !input_handler->should_exit) {
         if (g_terminate_requested) {
             app->running = FALSE;
             input_handler->should_exit = TRUE;
             break;
         }
-        
-        // Check for terminal size changes
-        input_update_terminal_size(input_handler);
-        if (last_term_width != input_handler->terminal_width || 
-            last_term_height != input_handler->terminal_height) {
-            // Wait for resize events to settle before repainting heavy image frames.
-            last_term_width = input_handler->terminal_width;
-            last_term_height = input_handler->terminal_height;
-            app->term_width = last_term_width;
-            app->term_height = last_term_height;
-
-            input_dispatch_pause_video_for_resize(app);
-            if (app->gif_player && gif_player_is_playing(app->gif_player)) {
-                gif_player_pause(app->gif_player);
-            }
-            if (app_is_preview_mode(app)) {
-                app->needs_screen_clear = TRUE;
-            }
-            ui_clear_kitty_images(app);
-            ui_clear_screen_for_refresh(app);
-            fflush(stdout);
-            resize_pending = TRUE;
-            usleep(k_resize_sleep_us);
-            continue;
-        }
 
-        if (resize_pending) {
+        if (resize_pending && g_get_monotonic_time() >= resize_deadline_us) {
+            // The size settled: repaint once. Renders cached for this
+            // geometry (e.g. after resizing back) are reused as they are.
             resize_pending = FALSE;
             gboolean resume_video_after_resize = app->video_was_playing_before_resize;
             app->video_was_playing_before_resize = FALSE;
             get_terminal_size(&app->term_width, &app->term_height);
             app->suppress_full_clear = FALSE;
             app_render_by_mode(app);
+            if (app_is_single_mode(app)) {
+                app_preloader_queue_directory(app);
+            }
             if (resume_video_after_resize && app->video_player) {
                 video_player_play(app->video_player);
             }
-            continue;
         }
-        
-        gboolean handled_input = FALSE;
 
         input_dispatch_process_pending(app);
 
@@ -157,30 +166,68 @@ static ErrorCode run_application(PixelTermApp *app, gboolean alt_screen_enabled)
             }
 
             input_dispatch_handle_event(app, input_handler, &event);
-            handled_input = TRUE;
         }
 
         input_dispatch_process_animations(app);
         app_process_async_render(app);
+        app_process_directory_loader(app);
+        app_process_directory_changes(app);
+        app_render_perf_hud(app, FALSE);
 
-        if (handled_input) {
+        if (!app->running || input_handler->should_exit || input_has_pending_input(input_handler)) {
             continue;
         }
 
-        if (!input_has_pending_input(input_handler)) {
-            usleep(k_input_poll_sleep_us);
+        gint timeout_ms = input_dispatch_next_timeout_ms(app);
+        if (resize_pending) {
+            timeout_ms = min_timeout(timeout_ms, timeout_until(resize_deadline_us));
+        }
+        if (app->dir_watch && dir_watch_is_polling(app->dir_watch)) {
+            timeout_ms = min_timeout(timeout_ms, (gint)(DIR_WATCH_POLL_INTERVAL_US / 1000));
+        }
+        timeout_ms = min_timeout(timeout_ms, app_perf_hud_timeout_ms(app));
+        event_loop_set_watch_fd(event_loop, dir_watch_get_fd(app->dir_watch));
+        // Nothing may stay buffered while the loop sleeps
+        term_output_flush();
+
+        guint ready = event_loop_wait(event_loop, timeout_ms);
+        if (!(ready & EVENT_LOOP_READY_RESIZE)) {
             continue;
         }
 
-        error = input_get_event(input_handler, &event);
-        if (error != ERROR_NONE) {
-            break;
+        // Size changes arrive as SIGWINCH; only then is the size queried
+        gint old_width = input_handler->terminal_width;
+        gint old_height = input_handler->terminal_height;
+        input_update_terminal_size(input_handler);
+        if (old_width == input_handler->terminal_width && old_height == input_handler->terminal_height) {
+            continue;
+        }
+        // Wait for resize events to settle before repainting heavy image frames.
+        // Each further SIGWINCH of a window drag only pushes the deadline out.
+        app->term_width = input_handler->terminal_width;
+        app->term_height = input_handler->terminal_height;
+        resize_deadline_us = g_get_monotonic_time() + k_resize_settle_us;
+        if (resize_pending) {
+            continue;
         }
 
-        input_dispatch_handle_event(app, input_handler, &event);
+        // First change of a burst: stop everything drawing for the old size
+        input_dispatch_pause_video_for_resize(app);
+        if (app->gif_player && gif_player_is_playing(app->gif_player)) {
+            gif_player_pause(app->gif_player);
+        }
+        app_preloader_cancel_pending(app);
+        if (app_is_preview_mode(app)) {
+            app->needs_screen_clear = TRUE;
+        }
+        ui_clear_kitty_images(app);
+        ui_clear_screen_for_refresh(app);
+        fflush(stdout);
+        resize_pending = TRUE;
     }
 
-    run_application_cleanup(input_handler);
+    event_loop_free(event_loop);
+    run_application_cleanup(app, input_handler);
 
     return error;
 }
@@ -189,9 +236,10 @@ int main(int argc, char *argv[]) {
     // Set locale for proper character handling
     setlocale(LC_ALL, "");
 
-    // Setup signal handlers
+    // Setup signal handlers; each also wakes the main loop
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
+    signal(SIGWINCH, resize_signal_handler);
 
     // Parse command line arguments
     char *path = NULL;
@@ -202,11 +250,16 @@ int main(int argc, char *argv[]) {
     ErrorCode error = app_parse_arguments(argc, argv, &path, &config);
     if (error != ERROR_NONE) {
         if (path) g_free(path);
+        g_free(config.trace_path);
         if (error == ERROR_HELP_EXIT || error == ERROR_VERSION_EXIT) {
             return 0;
         }
         return 1;
     }
+
+    // Spans are written out at exit
+    trace_init(config.trace_path);
+    g_clear_pointer(&config.trace_path, g_free);
     
     app_config_resolve_protocol(&config);
 
@@ -252,7 +305,7 @@ int main(int argc, char *argv[]) {
     gboolean is_directory = startup.kind == APP_STARTUP_PATH_DIRECTORY;
 
     if (startup.kind == APP_STARTUP_PATH_DIRECTORY) {
-        error = app_load_directory(g_app, path);
+        error = app_load_directory_async(g_app, path, NULL);
         if (error == ERROR_NONE) {
             // Always start in file manager for directories
             error = app_enter_file_manager(g_app);
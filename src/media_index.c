@@ -0,0 +1,243 @@
+#include "media_index.h"
+#include "path_sort.h"
+
+#include <string.h>
+
+struct MediaIndex {
+    GArray *entries;         // MediaIndexEntry, sorted
+    GStringChunk *strings;   // Backing storage for every path
+    gsize string_bytes;      // Bytes stored in strings, removed paths included
+    gsize dead_bytes;        // Bytes of removed paths still in strings
+    gboolean natural_sort;
+    gchar *root;             // Names are relative to this; NULL for basenames
+    gsize root_len;
+};
+
+// Path strings are short; a chunk this size holds a few hundred of them.
+#define MEDIA_INDEX_CHUNK_SIZE 16384
+// Removed paths are reclaimed once they fill a chunk and half of the strings
+#define MEDIA_INDEX_COMPACT_MIN_BYTES MEDIA_INDEX_CHUNK_SIZE
+
+// The sort name of @p path: its basename, or the part below the root.
+// NULL if the path is not below the root.
+static const gchar* media_index_name_of(const MediaIndex *index, const gchar *path) {
+    if (!index->root) {
+        const gchar *slash = strrchr(path, G_DIR_SEPARATOR);
+        return slash ? slash + 1 : path;
+    }
+    if (strncmp(path, index->root, index->root_len) != 0 ||
+        (path[index->root_len] != G_DIR_SEPARATOR && index->root_len > 0 &&
+         index->root[index->root_len - 1] != G_DIR_SEPARATOR)) {
+        return NULL;
+    }
+    const gchar *name = path + index->root_len;
+    while (*name == G_DIR_SEPARATOR) {
+        name++;
+    }
+    return name;
+}
+
+// Names never contain the root, so they compare from their first byte.
+static gint media_index_compare_names(const MediaIndex *index, const gchar *name_a, const gchar *name_b) {
+    return path_sort_compare_relative(name_a, name_b, 0, index->natural_sort);
+}
+
+static MediaIndexEntry media_index_make_entry(MediaIndex *index, const gchar *path) {
+    MediaIndexEntry entry;
+    entry.path = g_string_chunk_insert(index->strings, path);
+    index->string_bytes += strlen(path) + 1;
+    entry.name = media_index_name_of(index, entry.path);
+    if (!entry.name) {
+        // Outside the root; keep it, ordered by its full path
+        entry.name = entry.path;
+    }
+    return entry;
+}
+
+// First position whose name does not sort before @p name.
+static guint media_index_lower_bound(const MediaIndex *index, const gchar *name) {
+    guint low = 0;
+    guint high = index->entries->len;
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        const MediaIndexEntry *entry = &g_array_index(index->entries, MediaIndexEntry, mid);
+        if (media_index_compare_names(index, entry->name, name) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+MediaIndex* media_index_new(gboolean natural_sort) {
+    return media_index_new_relative(NULL, natural_sort);
+}
+
+MediaIndex* media_index_new_relative(const gchar *root, gboolean natural_sort) {
+    MediaIndex *index = g_new0(MediaIndex, 1);
+    index->entries = g_array_new(FALSE, FALSE, sizeof(MediaIndexEntry));
+    index->strings = g_string_chunk_new(MEDIA_INDEX_CHUNK_SIZE);
+    index->natural_sort = natural_sort;
+    index->root = g_strdup(root);
+    index->root_len = root ? strlen(root) : 0;
+    return index;
+}
+
+void media_index_free(MediaIndex *index) {
+    if (!index) {
+        return;
+    }
+    g_array_free(index->entries, TRUE);
+    g_string_chunk_free(index->strings);
+    g_free(index->root);
+    g_free(index);
+}
+
+void media_index_clear(MediaIndex *index) {
+    if (!index) {
+        return;
+    }
+    g_array_set_size(index->entries, 0);
+    g_string_chunk_clear(index->strings);
+    index->string_bytes = 0;
+    index->dead_bytes = 0;
+}
+
+const gchar* media_index_get_root(const MediaIndex *index) {
+    return index ? index->root : NULL;
+}
+
+gint media_index_length(const MediaIndex *index) {
+    return index ? (gint)index->entries->len : 0;
+}
+
+const gchar* media_index_get(const MediaIndex *index, gint position) {
+    if (!index || position < 0 || (guint)position >= index->entries->len) {
+        return NULL;
+    }
+    return g_array_index(index->entries, MediaIndexEntry, position).path;
+}
+
+const gchar* media_index_get_name(const MediaIndex *index, gint position) {
+    if (!index || position < 0 || (guint)position >= index->entries->len) {
+        return NULL;
+    }
+    return g_array_index(index->entries, MediaIndexEntry, position).name;
+}
+
+gint media_index_find_name(const MediaIndex *index, const gchar *name) {
+    if (!index || !name) {
+        return -1;
+    }
+    guint position = media_index_lower_bound(index, name);
+    if (position < index->entries->len &&
+        strcmp(g_array_index(index->entries, MediaIndexEntry, position).name, name) == 0) {
+        return (gint)position;
+    }
+    return -1;
+}
+
+gint media_index_find_path(const MediaIndex *index, const gchar *path) {
+    if (!index || !path) {
+        return -1;
+    }
+    const gchar *name = media_index_name_of(index, path);
+    gint position = media_index_find_name(index, name ? name : path);
+    if (position >= 0 && strcmp(media_index_get(index, position), path) != 0) {
+        return -1;
+    }
+    return position;
+}
+
+gint media_index_insert(MediaIndex *index, const gchar *path) {
+    if (!index || !path) {
+        return -1;
+    }
+    const gchar *name = media_index_name_of(index, path);
+    if (!name) {
+        name = path;
+    }
+    guint position = media_index_lower_bound(index, name);
+    if (position < index->entries->len &&
+        strcmp(g_array_index(index->entries, MediaIndexEntry, position).name, name) == 0) {
+        return (gint)position;
+    }
+    MediaIndexEntry entry = media_index_make_entry(index, path);
+    g_array_insert_val(index->entries, position, entry);
+    return (gint)position;
+}
+
+void media_index_append(MediaIndex *index, const gchar *path) {
+    if (!index || !path) {
+        return;
+    }
+    MediaIndexEntry entry = media_index_make_entry(index, path);
+    g_array_append_val(index->entries, entry);
+}
+
+gint media_index_merge(MediaIndex *index, GList *sorted_paths) {
+    if (!index) {
+        g_list_free_full(sorted_paths, g_free);
+        return 0;
+    }
+    if (!sorted_paths) {
+        return 0;
+    }
+
+    guint batch_len = g_list_length(sorted_paths);
+    GArray *merged = g_array_sized_new(FALSE, FALSE, sizeof(MediaIndexEntry), index->entries->len + batch_len);
+    guint i = 0;
+    GList *cur = sorted_paths;
+    while (i < index->entries->len || cur) {
+        const MediaIndexEntry *existing = i < index->entries->len
+            ? &g_array_index(index->entries, MediaIndexEntry, i) : NULL;
+        const gchar *batch_name = cur ? media_index_name_of(index, cur->data) : NULL;
+        if (cur && !batch_name) {
+            batch_name = cur->data;
+        }
+        // Existing entries win ties, like path_sort_merge
+        if (existing && (!cur || media_index_compare_names(index, existing->name, batch_name) <= 0)) {
+            g_array_append_val(merged, *existing);
+            i++;
+        } else {
+            MediaIndexEntry entry = media_index_make_entry(index, cur->data);
+            g_array_append_val(merged, entry);
+            cur = cur->next;
+        }
+    }
+    g_list_free_full(sorted_paths, g_free);
+
+    g_array_free(index->entries, TRUE);
+    index->entries = merged;
+    return (gint)batch_len;
+}
+
+// Copies the live paths into a fresh chunk and drops the old one.
+static void media_index_compact(MediaIndex *index) {
+    GStringChunk *strings = g_string_chunk_new(MEDIA_INDEX_CHUNK_SIZE);
+    gsize string_bytes = 0;
+    for (guint i = 0; i < index->entries->len; i++) {
+        MediaIndexEntry *entry = &g_array_index(index->entries, MediaIndexEntry, i);
+        gsize name_offset = (gsize)(entry->name - entry->path);
+        entry->path = g_string_chunk_insert(strings, entry->path);
+        entry->name = entry->path + name_offset;
+        string_bytes += strlen(entry->path) + 1;
+    }
+    g_string_chunk_free(index->strings);
+    index->strings = strings;
+    index->string_bytes = string_bytes;
+    index->dead_bytes = 0;
+}
+
+void media_index_remove(MediaIndex *index, gint position) {
+    if (!index || position < 0 || (guint)position >= index->entries->len) {
+        return;
+    }
+    index->dead_bytes += strlen(g_array_index(index->entries, MediaIndexEntry, position).path) + 1;
+    g_array_remove_index(index->entries, (guint)position);
+    if (index->dead_bytes >= MEDIA_INDEX_COMPACT_MIN_BYTES &&
+        index->dead_bytes >= index->string_bytes / 2) {
+        media_index_compact(index);
+    }
+}
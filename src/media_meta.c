@@ -0,0 +1,314 @@
+#include "media_meta.h"
+#include "common.h"
+#include "process_env.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#define MEDIA_META_MAGIC "PTMM"
+#define MEDIA_META_VERSION 1u
+#define MEDIA_META_FLAG_ANIMATED 0x01u
+
+typedef struct {
+    guint64 inode;
+    gint64 size;
+    gint64 mtime_ns;
+    MediaMeta meta;
+} MediaMetaRecord;
+
+// On-disk record header; the name follows without a terminator.
+typedef struct {
+    guint64 inode;
+    gint64 size;
+    gint64 mtime_ns;
+    gint64 duration_ms;
+    gint32 width;
+    gint32 height;
+    guint8 kind;
+    guint8 flags;
+    guint16 name_len;
+} MediaMetaFileRecord;
+
+struct MediaMetaStore {
+    gchar *directory;
+    gsize directory_len;
+    gchar *cache_file;
+    GHashTable *records;    // Name below the directory -> MediaMetaRecord
+    gboolean dirty;
+};
+
+static gboolean media_meta_stat(const gchar *path, guint64 *out_inode, gint64 *out_size, gint64 *out_mtime_ns) {
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return FALSE;
+    }
+    *out_inode = (guint64)st.st_ino;
+    *out_size = (gint64)st.st_size;
+    *out_mtime_ns = stat_mtime_ns(&st);
+    return TRUE;
+}
+
+// The record key for @p path: the part below the directory, or the whole
+// path for files elsewhere.
+static const gchar* media_meta_key(const MediaMetaStore *store, const gchar *path) {
+    gsize len = store->directory_len;
+    if (len > 0 && strncmp(path, store->directory, len) == 0 &&
+        (path[len] == G_DIR_SEPARATOR || store->directory[len - 1] == G_DIR_SEPARATOR)) {
+        const gchar *key = path + len;
+        while (*key == G_DIR_SEPARATOR) {
+            key++;
+        }
+        if (*key) {
+            return key;
+        }
+    }
+    return path;
+}
+
+gchar* media_meta_cache_path(const gchar *directory) {
+    if (!directory) {
+        return NULL;
+    }
+    gchar *base = NULL;
+    const gchar *cache_dir = pixelterm_getenv("XDG_CACHE_HOME");
+    if (cache_dir && cache_dir[0] != '\0') {
+        base = g_build_filename(cache_dir, "pixelterm", "media-meta", NULL);
+    } else {
+        const gchar *home = pixelterm_getenv("HOME");
+        if (!home || home[0] == '\0') {
+            home = g_get_home_dir();
+        }
+        if (!home || home[0] == '\0') {
+            return NULL;
+        }
+        base = g_build_filename(home, ".cache", "pixelterm", "media-meta", NULL);
+    }
+
+    gchar *digest = g_compute_checksum_for_string(G_CHECKSUM_SHA1, directory, -1);
+    gchar *name = g_strconcat(digest, ".bin", NULL);
+    gchar *path = g_build_filename(base, name, NULL);
+    g_free(name);
+    g_free(digest);
+    g_free(base);
+    return path;
+}
+
+static void media_meta_store_load(MediaMetaStore *store) {
+    gchar *contents = NULL;
+    gsize length = 0;
+    if (!store->cache_file || !g_file_get_contents(store->cache_file, &contents, &length, NULL)) {
+        return;
+    }
+
+    const gsize header_len = 4 + sizeof(guint32) * 2;
+    guint32 version = 0;
+    guint32 count = 0;
+    if (length < header_len || memcmp(contents, MEDIA_META_MAGIC, 4) != 0) {
+        g_free(contents);
+        return;
+    }
+    memcpy(&version, contents + 4, sizeof(version));
+    memcpy(&count, contents + 4 + sizeof(version), sizeof(count));
+    if (version != MEDIA_META_VERSION) {
+        g_free(contents);
+        return;
+    }
+
+    gsize offset = header_len;
+    for (guint32 i = 0; i < count; i++) {
+        MediaMetaFileRecord file_record;
+        if (length - offset < sizeof(file_record)) {
+            break;
+        }
+        memcpy(&file_record, contents + offset, sizeof(file_record));
+        offset += sizeof(file_record);
+        if (length - offset < file_record.name_len || file_record.name_len == 0 ||
+            file_record.kind >= MEDIA_KIND_COUNT) {
+            break;
+        }
+
+        MediaMetaRecord *record = g_new(MediaMetaRecord, 1);
+        record->inode = file_record.inode;
+        record->size = file_record.size;
+        record->mtime_ns = file_record.mtime_ns;
+        record->meta.kind = (MediaKind)file_record.kind;
+        record->meta.width = file_record.width;
+        record->meta.height = file_record.height;
+        record->meta.animated = (file_record.flags & MEDIA_META_FLAG_ANIMATED) != 0;
+        record->meta.duration_ms = file_record.duration_ms;
+        g_hash_table_replace(store->records, g_strndup(contents + offset, file_record.name_len), record);
+        offset += file_record.name_len;
+    }
+    g_free(contents);
+}
+
+MediaMetaStore* media_meta_store_open_file(const gchar *directory, const gchar *cache_file) {
+    if (!directory) {
+        return NULL;
+    }
+    MediaMetaStore *store = g_new0(MediaMetaStore, 1);
+    store->directory = g_strdup(directory);
+    store->directory_len = strlen(directory);
+    store->cache_file = g_strdup(cache_file);
+    store->records = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    media_meta_store_load(store);
+    return store;
+}
+
+MediaMetaStore* media_meta_store_open(const gchar *directory) {
+    if (!directory) {
+        return NULL;
+    }
+    gchar *cache_file = media_meta_cache_path(directory);
+    MediaMetaStore *store = media_meta_store_open_file(directory, cache_file);
+    g_free(cache_file);
+    return store;
+}
+
+gboolean media_meta_store_save(MediaMetaStore *store) {
+    if (!store || !store->dirty) {
+        return TRUE;
+    }
+    if (!store->cache_file) {
+        return FALSE;
+    }
+
+    guint32 version = MEDIA_META_VERSION;
+    guint32 count = 0;
+    GByteArray *bytes = g_byte_array_new();
+    g_byte_array_append(bytes, (const guint8 *)MEDIA_META_MAGIC, 4);
+    g_byte_array_append(bytes, (const guint8 *)&version, sizeof(version));
+    g_byte_array_append(bytes, (const guint8 *)&count, sizeof(count));
+
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    g_hash_table_iter_init(&iter, store->records);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const gchar *name = key;
+        const MediaMetaRecord *record = value;
+        gsize name_len = strlen(name);
+        if (name_len == 0 || name_len > G_MAXUINT16) {
+            continue;
+        }
+        MediaMetaFileRecord file_record;
+        memset(&file_record, 0, sizeof(file_record));
+        file_record.inode = record->inode;
+        file_record.size = record->size;
+        file_record.mtime_ns = record->mtime_ns;
+        file_record.duration_ms = record->meta.duration_ms;
+        file_record.width = record->meta.width;
+        file_record.height = record->meta.height;
+        file_record.kind = (guint8)record->meta.kind;
+        file_record.flags = record->meta.animated ? MEDIA_META_FLAG_ANIMATED : 0;
+        file_record.name_len = (guint16)name_len;
+        g_byte_array_append(bytes, (const guint8 *)&file_record, sizeof(file_record));
+        g_byte_array_append(bytes, (const guint8 *)name, (guint)name_len);
+        count++;
+    }
+    memcpy(bytes->data + 4 + sizeof(version), &count, sizeof(count));
+
+    gchar *parent = g_path_get_dirname(store->cache_file);
+    gboolean saved = g_mkdir_with_parents(parent, 0700) == 0 &&
+                     g_file_set_contents(store->cache_file, (const gchar *)bytes->data, bytes->len, NULL);
+    g_free(parent);
+    g_byte_array_unref(bytes);
+    if (saved) {
+        store->dirty = FALSE;
+    }
+    return saved;
+}
+
+void media_meta_store_free(MediaMetaStore *store) {
+    if (!store) {
+        return;
+    }
+    (void)media_meta_store_save(store);
+    g_hash_table_unref(store->records);
+    g_free(store->cache_file);
+    g_free(store->directory);
+    g_free(store);
+}
+
+MediaMetaStore* media_meta_store_copy(const MediaMetaStore *store) {
+    if (!store) {
+        return NULL;
+    }
+    MediaMetaStore *copy = media_meta_store_open_file(store->directory, NULL);
+    GHashTableIter iter;
+    gpointer key = NULL;
+    gpointer value = NULL;
+    g_hash_table_iter_init(&iter, store->records);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        MediaMetaRecord *record = g_new(MediaMetaRecord, 1);
+        *record = *(const MediaMetaRecord *)value;
+        g_hash_table_replace(copy->records, g_strdup(key), record);
+    }
+    return copy;
+}
+
+// Whether @p record still describes the file at @p path.
+static gboolean media_meta_record_is_current(const MediaMetaRecord *record, const gchar *path) {
+    guint64 inode = 0;
+    gint64 size = 0;
+    gint64 mtime_ns = 0;
+    return media_meta_stat(path, &inode, &size, &mtime_ns) &&
+           inode == record->inode && size == record->size && mtime_ns == record->mtime_ns;
+}
+
+gboolean media_meta_store_lookup(MediaMetaStore *store, const gchar *path, MediaMeta *out) {
+    if (!store || !path || !out) {
+        return FALSE;
+    }
+    const gchar *key = media_meta_key(store, path);
+    MediaMetaRecord *record = g_hash_table_lookup(store->records, key);
+    if (!record) {
+        return FALSE;
+    }
+    if (!media_meta_record_is_current(record, path)) {
+        g_hash_table_remove(store->records, key);
+        store->dirty = TRUE;
+        return FALSE;
+    }
+    *out = record->meta;
+    return TRUE;
+}
+
+gboolean media_meta_store_match(const MediaMetaStore *store, const gchar *path, MediaMeta *out) {
+    if (!store || !path || !out) {
+        return FALSE;
+    }
+    const MediaMetaRecord *record = g_hash_table_lookup(store->records, media_meta_key(store, path));
+    if (!record || !media_meta_record_is_current(record, path)) {
+        return FALSE;
+    }
+    *out = record->meta;
+    return TRUE;
+}
+
+void media_meta_store_put(MediaMetaStore *store, const gchar *path, const MediaMeta *meta) {
+    if (!store || !path || !meta) {
+        return;
+    }
+    MediaMetaRecord *record = g_new(MediaMetaRecord, 1);
+    if (!media_meta_stat(path, &record->inode, &record->size, &record->mtime_ns)) {
+        g_free(record);
+        return;
+    }
+    record->meta = *meta;
+    g_hash_table_replace(store->records, g_strdup(media_meta_key(store, path)), record);
+    store->dirty = TRUE;
+}
+
+void media_meta_store_forget(MediaMetaStore *store, const gchar *path) {
+    if (!store || !path) {
+        return;
+    }
+    if (g_hash_table_remove(store->records, media_meta_key(store, path))) {
+        store->dirty = TRUE;
+    }
+}
+
+guint media_meta_store_size(const MediaMetaStore *store) {
+    return store ? g_hash_table_size(store->records) : 0;
+}
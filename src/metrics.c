@@ -0,0 +1,45 @@
+#include "metrics.h"
+
+#include <string.h>
+
+static GMutex metrics_mutex;
+static gint64 metrics_values[METRIC_COUNT];
+
+void metrics_set(MetricId id, gint64 value) {
+    if (id < 0 || id >= METRIC_COUNT) {
+        return;
+    }
+    g_mutex_lock(&metrics_mutex);
+    metrics_values[id] = value;
+    g_mutex_unlock(&metrics_mutex);
+}
+
+void metrics_add(MetricId id, gint64 delta) {
+    if (id < 0 || id >= METRIC_COUNT) {
+        return;
+    }
+    g_mutex_lock(&metrics_mutex);
+    metrics_values[id] += delta;
+    g_mutex_unlock(&metrics_mutex);
+}
+
+gint64 metrics_set_elapsed(MetricId id, gint64 start_us) {
+    gint64 elapsed_us = MAX(g_get_monotonic_time() - start_us, 0);
+    metrics_set(id, elapsed_us);
+    return elapsed_us;
+}
+
+void metrics_snapshot(gint64 out[METRIC_COUNT]) {
+    if (!out) {
+        return;
+    }
+    g_mutex_lock(&metrics_mutex);
+    memcpy(out, metrics_values, sizeof(metrics_values));
+    g_mutex_unlock(&metrics_mutex);
+}
+
+void metrics_reset_for_test(void) {
+    g_mutex_lock(&metrics_mutex);
+    memset(metrics_values, 0, sizeof(metrics_values));
+    g_mutex_unlock(&metrics_mutex);
+}
@@ -0,0 +1,340 @@
+#include "path_sort.h"
+
+#include <string.h>
+
+// Every non-letter byte sorts after all letters; digit runs take the '0' slot.
+#define PATH_SORT_OTHER_BASE 1000u
+#define PATH_SORT_NUMBER_MARK (PATH_SORT_OTHER_BASE + (guint32)'0')
+// Keys are taken from the basename unless a root length is given.
+#define PATH_SORT_BASENAME G_MAXSIZE
+
+typedef enum {
+    PATH_SORT_RUN_NONE = 0,
+    PATH_SORT_RUN_LENGTH,
+    PATH_SORT_RUN_DIGITS
+} PathSortRunPhase;
+
+/*
+ * Produces collation weights for one name. In natural mode a digit run is
+ * emitted as a marker, its significant length, then its significant digits,
+ * which orders runs by numeric value. Leading zeros are left to the final
+ * byte-wise tie break.
+ */
+typedef struct {
+    const gchar *cursor;
+    const gchar *end;
+    gboolean natural;
+    const gchar *run_digits;
+    const gchar *run_end;
+    PathSortRunPhase run_phase;
+} PathSortCursor;
+
+typedef struct {
+    gpointer data;
+    const gchar *name;
+    gsize name_len;
+    gsize key_offset;
+    gsize key_len;
+} PathSortItem;
+
+static void path_sort_basename(const gchar *path, const gchar **out_name, gsize *out_len) {
+    gsize len = strlen(path);
+    while (len > 1 && path[len - 1] == G_DIR_SEPARATOR) {
+        len--;
+    }
+    const gchar *start = path + len;
+    while (start > path && start[-1] != G_DIR_SEPARATOR) {
+        start--;
+    }
+    if (len == 0) {
+        *out_name = ".";
+        *out_len = 1;
+    } else if (start == path + len) {
+        // The path is only separators; match g_path_get_basename's "/".
+        *out_name = path;
+        *out_len = 1;
+    } else {
+        *out_name = start;
+        *out_len = (gsize)(path + len - start);
+    }
+}
+
+// The part of @p path that is compared: its basename, or everything below
+// the first @p root_len bytes.
+static void path_sort_key_name(const gchar *path, gsize root_len, const gchar **out_name, gsize *out_len) {
+    if (root_len == PATH_SORT_BASENAME) {
+        path_sort_basename(path, out_name, out_len);
+        return;
+    }
+    gsize len = strlen(path);
+    const gchar *start = path + MIN(root_len, len);
+    while (*start == G_DIR_SEPARATOR) {
+        start++;
+    }
+    *out_name = start;
+    *out_len = (gsize)(path + len - start);
+}
+
+static void path_sort_cursor_init(PathSortCursor *cursor, const gchar *name, gsize len, gboolean natural) {
+    cursor->cursor = name;
+    cursor->end = name + len;
+    cursor->natural = natural;
+    cursor->run_digits = NULL;
+    cursor->run_end = NULL;
+    cursor->run_phase = PATH_SORT_RUN_NONE;
+}
+
+static gboolean path_sort_next_weight(PathSortCursor *cursor, guint32 *out_weight) {
+    if (cursor->run_phase == PATH_SORT_RUN_LENGTH) {
+        *out_weight = (guint32)(cursor->run_end - cursor->run_digits);
+        cursor->run_phase = cursor->run_digits < cursor->run_end ? PATH_SORT_RUN_DIGITS : PATH_SORT_RUN_NONE;
+        return TRUE;
+    }
+    if (cursor->run_phase == PATH_SORT_RUN_DIGITS) {
+        *out_weight = (guint32)(*cursor->run_digits++ - '0');
+        if (cursor->run_digits == cursor->run_end) {
+            cursor->run_phase = PATH_SORT_RUN_NONE;
+        }
+        return TRUE;
+    }
+    if (cursor->cursor >= cursor->end) {
+        return FALSE;
+    }
+
+    guchar ch = (guchar)*cursor->cursor;
+    if (cursor->natural && g_ascii_isdigit(ch)) {
+        while (cursor->cursor < cursor->end && *cursor->cursor == '0') {
+            cursor->cursor++;
+        }
+        cursor->run_digits = cursor->cursor;
+        while (cursor->cursor < cursor->end && g_ascii_isdigit(*cursor->cursor)) {
+            cursor->cursor++;
+        }
+        cursor->run_end = cursor->cursor;
+        cursor->run_phase = PATH_SORT_RUN_LENGTH;
+        *out_weight = PATH_SORT_NUMBER_MARK;
+        return TRUE;
+    }
+
+    cursor->cursor++;
+    if (ch == G_DIR_SEPARATOR) {
+        // Only relative names contain separators; a directory's entries sort
+        // before names that merely share its prefix.
+        *out_weight = 0;
+    } else if (g_ascii_isalpha(ch)) {
+        // AaBb…: uppercase directly before the lowercase form of the same letter.
+        *out_weight = (guint32)(g_ascii_tolower(ch) - 'a') * 2u + (g_ascii_isupper(ch) ? 1u : 2u);
+    } else {
+        *out_weight = PATH_SORT_OTHER_BASE + ch;
+    }
+    return TRUE;
+}
+
+static gsize path_sort_emit_key(const gchar *name, gsize len, gboolean natural, guint32 *out_key) {
+    PathSortCursor cursor;
+    path_sort_cursor_init(&cursor, name, len, natural);
+    gsize count = 0;
+    guint32 weight = 0;
+    while (path_sort_next_weight(&cursor, &weight)) {
+        if (out_key) {
+            out_key[count] = weight;
+        }
+        count++;
+    }
+    return count;
+}
+
+static gint path_sort_compare_names_raw(const gchar *name_a, gsize len_a, const gchar *name_b, gsize len_b) {
+    gint result = memcmp(name_a, name_b, MIN(len_a, len_b));
+    if (result != 0) {
+        return result;
+    }
+    return (len_a > len_b) - (len_a < len_b);
+}
+
+static gint path_sort_compare_with(const gchar *path_a, const gchar *path_b, gsize root_len, gboolean natural) {
+    if (!path_a || !path_b) {
+        return path_a ? 1 : (path_b ? -1 : 0);
+    }
+
+    const gchar *name_a = NULL;
+    const gchar *name_b = NULL;
+    gsize len_a = 0;
+    gsize len_b = 0;
+    path_sort_key_name(path_a, root_len, &name_a, &len_a);
+    path_sort_key_name(path_b, root_len, &name_b, &len_b);
+
+    PathSortCursor cursor_a;
+    PathSortCursor cursor_b;
+    path_sort_cursor_init(&cursor_a, name_a, len_a, natural);
+    path_sort_cursor_init(&cursor_b, name_b, len_b, natural);
+    while (TRUE) {
+        guint32 weight_a = 0;
+        guint32 weight_b = 0;
+        gboolean has_a = path_sort_next_weight(&cursor_a, &weight_a);
+        gboolean has_b = path_sort_next_weight(&cursor_b, &weight_b);
+        if (!has_a || !has_b) {
+            // All compared weights matched; shorter key wins.
+            if (has_a != has_b) {
+                return has_a ? 1 : -1;
+            }
+            break;
+        }
+        if (weight_a != weight_b) {
+            return weight_a < weight_b ? -1 : 1;
+        }
+    }
+    return path_sort_compare_names_raw(name_a, len_a, name_b, len_b);
+}
+
+gint path_sort_compare(const gchar *path_a, const gchar *path_b, gboolean natural) {
+    return path_sort_compare_with(path_a, path_b, PATH_SORT_BASENAME, natural);
+}
+
+gint path_sort_compare_relative(const gchar *path_a, const gchar *path_b, gsize root_len, gboolean natural) {
+    return path_sort_compare_with(path_a, path_b, root_len, natural);
+}
+
+static gint path_sort_compare_items(const PathSortItem *a, const PathSortItem *b, const guint32 *keys) {
+    const guint32 *key_a = keys + a->key_offset;
+    const guint32 *key_b = keys + b->key_offset;
+    gsize common = MIN(a->key_len, b->key_len);
+    for (gsize i = 0; i < common; i++) {
+        if (key_a[i] != key_b[i]) {
+            return key_a[i] < key_b[i] ? -1 : 1;
+        }
+    }
+    if (a->key_len != b->key_len) {
+        return a->key_len < b->key_len ? -1 : 1;
+    }
+    return path_sort_compare_names_raw(a->name, a->name_len, b->name, b->name_len);
+}
+
+// Bottom-up merge sort: stable, sequential passes over contiguous arrays.
+static void path_sort_merge_items(PathSortItem *items, gsize count, const guint32 *keys) {
+    PathSortItem *scratch = g_new(PathSortItem, count);
+    PathSortItem *src = items;
+    PathSortItem *dst = scratch;
+
+    for (gsize width = 1; width < count; width *= 2) {
+        for (gsize lo = 0; lo < count; lo += 2 * width) {
+            gsize mid = MIN(lo + width, count);
+            gsize hi = MIN(lo + 2 * width, count);
+            gsize i = lo;
+            gsize j = mid;
+            gsize k = lo;
+            while (i < mid && j < hi) {
+                if (path_sort_compare_items(&src[j], &src[i], keys) < 0) {
+                    dst[k++] = src[j++];
+                } else {
+                    dst[k++] = src[i++];
+                }
+            }
+            while (i < mid) {
+                dst[k++] = src[i++];
+            }
+            while (j < hi) {
+                dst[k++] = src[j++];
+            }
+        }
+        PathSortItem *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != items) {
+        memcpy(items, src, count * sizeof(*items));
+    }
+    g_free(scratch);
+}
+
+static GList* path_sort_list_with(GList *paths, gsize root_len, gboolean natural) {
+    guint count = g_list_length(paths);
+    if (count < 2) {
+        return paths;
+    }
+
+    PathSortItem *items = g_new(PathSortItem, count);
+    gsize total_weights = 0;
+    guint index = 0;
+    for (GList *link = paths; link; link = link->next, index++) {
+        PathSortItem *item = &items[index];
+        const gchar *path = link->data;
+        item->data = link->data;
+        if (path) {
+            path_sort_key_name(path, root_len, &item->name, &item->name_len);
+        } else {
+            item->name = "";
+            item->name_len = 0;
+        }
+        item->key_offset = total_weights;
+        item->key_len = path_sort_emit_key(item->name, item->name_len, natural, NULL);
+        total_weights += item->key_len;
+    }
+
+    guint32 *keys = g_new(guint32, MAX(total_weights, 1));
+    for (guint i = 0; i < count; i++) {
+        path_sort_emit_key(items[i].name, items[i].name_len, natural, keys + items[i].key_offset);
+    }
+
+    path_sort_merge_items(items, count, keys);
+
+    index = 0;
+    for (GList *link = paths; link; link = link->next, index++) {
+        link->data = items[index].data;
+    }
+
+    g_free(keys);
+    g_free(items);
+    return paths;
+}
+
+GList* path_sort_list(GList *paths, gboolean natural) {
+    return path_sort_list_with(paths, PATH_SORT_BASENAME, natural);
+}
+
+GList* path_sort_list_relative(GList *paths, gsize root_len, gboolean natural) {
+    return path_sort_list_with(paths, root_len, natural);
+}
+
+static GList* path_sort_merge_with(GList *sorted, GList *batch, gsize root_len, gboolean natural) {
+    if (!batch) {
+        return sorted;
+    }
+    if (!sorted) {
+        return batch;
+    }
+
+    GList head = {0};
+    GList *tail = &head;
+    GList *a = sorted;
+    GList *b = batch;
+    while (a && b) {
+        GList *next = NULL;
+        // Existing entries win ties, which keeps repeated merges stable.
+        if (path_sort_compare_with(b->data, a->data, root_len, natural) < 0) {
+            next = b;
+            b = b->next;
+        } else {
+            next = a;
+            a = a->next;
+        }
+        tail->next = next;
+        next->prev = tail;
+        tail = next;
+    }
+
+    GList *rest = a ? a : b;
+    tail->next = rest;
+    rest->prev = tail;
+    head.next->prev = NULL;
+    return head.next;
+}
+
+GList* path_sort_merge(GList *sorted, GList *batch, gboolean natural) {
+    return path_sort_merge_with(sorted, batch, PATH_SORT_BASENAME, natural);
+}
+
+GList* path_sort_merge_relative(GList *sorted, GList *batch, gsize root_len, gboolean natural) {
+    return path_sort_merge_with(sorted, batch, root_len, natural);
+}
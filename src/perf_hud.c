@@ -0,0 +1,67 @@
+#include "perf_hud.h"
+
+void perf_hud_sample(PerfHud *hud, const gint64 metrics[METRIC_COUNT], gint64 now_us) {
+    if (!hud || !metrics) {
+        return;
+    }
+    gint64 busy_us = metrics[METRIC_WORKER_BUSY_US];
+    if (hud->sample_us > 0 && now_us > hud->sample_us) {
+        gdouble busy = (gdouble)MAX(busy_us - hud->busy_us, 0);
+        hud->worker_percent = busy * 100.0 / (gdouble)(now_us - hud->sample_us);
+        hud->worker_measured = TRUE;
+    }
+    hud->sample_us = now_us;
+    hud->busy_us = busy_us;
+}
+
+// "812B", "45.2K", "12.4M"
+static void perf_hud_format_bytes(gint64 bytes, gchar *out, gsize out_size) {
+    if (bytes < 1024) {
+        g_snprintf(out, out_size, "%" G_GINT64_FORMAT "B", MAX(bytes, 0));
+    } else if (bytes < 1024 * 1024) {
+        g_snprintf(out, out_size, "%.1fK", (gdouble)bytes / 1024.0);
+    } else {
+        g_snprintf(out, out_size, "%.1fM", (gdouble)bytes / (1024.0 * 1024.0));
+    }
+}
+
+void perf_hud_format(const PerfHud *hud, const gint64 metrics[METRIC_COUNT], gchar *out, gsize out_size) {
+    if (!out || out_size == 0) {
+        return;
+    }
+    if (!metrics) {
+        out[0] = '\0';
+        return;
+    }
+
+    gchar frame[32];
+    gchar cache[32];
+    gchar hits[16];
+    gchar workers[16];
+    perf_hud_format_bytes(metrics[METRIC_FRAME_BYTES], frame, sizeof(frame));
+    perf_hud_format_bytes(metrics[METRIC_CACHE_BYTES], cache, sizeof(cache));
+
+    gint64 lookups = metrics[METRIC_PRELOAD_HITS] + metrics[METRIC_PRELOAD_MISSES];
+    if (lookups > 0) {
+        g_snprintf(hits, sizeof(hits), "%d%%", (gint)(metrics[METRIC_PRELOAD_HITS] * 100 / lookups));
+    } else {
+        g_strlcpy(hits, "--", sizeof(hits));
+    }
+    if (hud && hud->worker_measured) {
+        g_snprintf(workers, sizeof(workers), "%.0f%%", hud->worker_percent);
+    } else {
+        g_strlcpy(workers, "--", sizeof(workers));
+    }
+
+    g_snprintf(out, out_size,
+               "decode %.1fms  chafa %.1fms  write %.1fms  %s/frame  queue %" G_GINT64_FORMAT
+               "  hit %s  cache %s  workers %s",
+               (gdouble)metrics[METRIC_DECODE_US] / 1000.0,
+               (gdouble)metrics[METRIC_RENDER_US] / 1000.0,
+               (gdouble)metrics[METRIC_WRITE_US] / 1000.0,
+               frame,
+               metrics[METRIC_PRELOAD_QUEUE],
+               hits,
+               cache,
+               workers);
+}
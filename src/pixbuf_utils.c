@@ -1,4 +1,6 @@
 #include "pixbuf_utils.h"
+#include "metrics.h"
+#include "trace.h"
 
 #include <gio/gio.h>
 
@@ -18,7 +20,11 @@ GdkPixbuf* pixbuf_utils_load_from_stream(const char *filepath, GError **error) {
         return NULL;
     }
 
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_DECODE, "image");
+    gint64 start_us = g_get_monotonic_time();
     GdkPixbuf *pixbuf = gdk_pixbuf_new_from_stream(G_INPUT_STREAM(stream), NULL, error);
+    metrics_set_elapsed(METRIC_DECODE_US, start_us);
+    trace_span_end(&span);
     g_object_unref(stream);
     return pixbuf;
 }
@@ -1,5 +1,6 @@
 #include "preload_control.h"
 
+#include "kitty_registry.h"
 #include "preloader.h"
 
 void app_preloader_reset(PixelTermApp *app) {
@@ -70,6 +71,30 @@ void app_preloader_clear_queue(PixelTermApp *app) {
     preloader_clear_queue(app->preloader);
 }
 
+void app_preloader_cancel_pending(PixelTermApp *app) {
+    if (!app || !app->preloader || !app->preload_enabled) {
+        return;
+    }
+    preloader_cancel_pending(app->preloader);
+}
+
+void app_preloader_invalidate(PixelTermApp *app, const char *filepath) {
+    if (!app || !filepath) {
+        return;
+    }
+    if (app->kitty_images) {
+        // The terminal's copy shows the old contents as well
+        GString *deletes = g_string_new(NULL);
+        kitty_registry_forget(app->kitty_images, filepath, deletes);
+        fwrite(deletes->str, 1, deletes->len, stdout);
+        g_string_free(deletes, TRUE);
+    }
+    if (!app->preloader) {
+        return;
+    }
+    preloader_cache_remove(app->preloader, filepath);
+}
+
 void app_preloader_queue_directory(PixelTermApp *app) {
     if (!app || !app->preloader || !app->preload_enabled || !app_has_images(app)) {
         return;
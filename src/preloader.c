@@ -1,5 +1,8 @@
 #include "preloader.h"
 #include "renderer.h"
+#include "event_loop.h"
+#include "metrics.h"
+#include "trace.h"
 
 typedef struct {
     gchar *filepath;
@@ -42,12 +45,28 @@ static PreloadCacheKey* preload_cache_key_new(const char *filepath, gint width,
     return key;
 }
 
+// Publishes the queue depth and cached bytes after either changes.
+static void preloader_publish_metrics_locked(ImagePreloader *preloader) {
+    metrics_set(METRIC_PRELOAD_QUEUE, (gint64)g_queue_get_length(preloader->task_queue));
+    metrics_set(METRIC_CACHE_BYTES, (gint64)preloader->cache_bytes);
+}
+
+// Removes one cache entry and its bytes from the running total.
+static void preloader_cache_evict_locked(ImagePreloader *preloader, gconstpointer key) {
+    const CachedImageData *data = g_hash_table_lookup(preloader->preload_cache, key);
+    if (data && data->rendered) {
+        preloader->cache_bytes -= MIN(preloader->cache_bytes, data->rendered->len);
+    }
+    g_hash_table_remove(preloader->preload_cache, key);
+}
+
 static void preloader_clear_queue_locked(ImagePreloader *preloader) {
     while (!g_queue_is_empty(preloader->task_queue)) {
         PreloadTask *task = (PreloadTask*)g_queue_pop_head(preloader->task_queue);
         g_free(task->filepath);
         g_free(task);
     }
+    preloader_publish_metrics_locked(preloader);
 }
 
 static void preloader_cache_cleanup_locked(ImagePreloader *preloader) {
@@ -61,7 +80,7 @@ static void preloader_cache_cleanup_locked(ImagePreloader *preloader) {
         if (!key) {
             break;
         }
-        g_hash_table_remove(preloader->preload_cache, key);
+        preloader_cache_evict_locked(preloader, key);
     }
 }
 
@@ -131,9 +150,11 @@ static void cached_image_data_set(CachedImageData *data,
     }
 
     if (data->rendered) {
+        preloader->cache_bytes -= MIN(preloader->cache_bytes, data->rendered->len);
         g_string_free(data->rendered, TRUE);
     }
     data->rendered = g_string_new_len(rendered->str, rendered->len);
+    preloader->cache_bytes += rendered->len;
 
     /*
      * Cached render metadata prefers renderer-reported size first.
@@ -229,6 +250,8 @@ void preloader_destroy(ImagePreloader *preloader) {
     if (preloader->lru_queue) {
         g_queue_free(preloader->lru_queue);
     }
+    metrics_set(METRIC_PRELOAD_QUEUE, 0);
+    metrics_set(METRIC_CACHE_BYTES, 0);
 
     // Cleanup synchronization objects
     g_mutex_clear(&preloader->mutex);
@@ -390,6 +413,7 @@ ErrorCode preloader_add_task(ImagePreloader *preloader, const char *filepath, gi
 
         g_queue_push_nth(preloader->task_queue, task, position);
     }
+    preloader_publish_metrics_locked(preloader);
 
     g_cond_signal(&preloader->condition);
     g_mutex_unlock(&preloader->mutex);
@@ -398,7 +422,7 @@ ErrorCode preloader_add_task(ImagePreloader *preloader, const char *filepath, gi
 }
 
 // Add tasks for adjacent images
-ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, GList *files, gint current_index, gint target_width, gint target_height) {
+ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, const MediaIndex *files, gint current_index, gint target_width, gint target_height) {
     if (!preloader || !files || !preloader->enabled) {
         return ERROR_MEMORY_ALLOC;
     }
@@ -413,30 +437,22 @@ ErrorCode preloader_add_tasks_for_directory(ImagePreloader *preloader, GList *fi
         return ERROR_NONE;
     }
 
-    GList *current = files;
-    for (gint idx = 0; current && idx < current_index; idx++) {
-        current = current->next;
-    }
-    if (!current) {
+    gint total = media_index_length(files);
+    if (current_index >= total || total < 2) {
         return ERROR_NONE;
     }
-    if (!current->prev && !current->next) {
-        return ERROR_NONE;
-    }
-    GList *walker = current ? current->next : NULL;
-    for (gint priority = 1; walker && priority <= 3; priority++) {
-        if (is_image_file((gchar*)walker->data)) {
-            preloader_add_task(preloader, (gchar*)walker->data, priority, task_width, task_height);
+    for (gint priority = 1; priority <= 3 && current_index + priority < total; priority++) {
+        const gchar *path = media_index_get(files, current_index + priority);
+        if (is_image_file(path)) {
+            preloader_add_task(preloader, path, priority, task_width, task_height);
         }
-        walker = walker->next;
     }
 
-    walker = current ? current->prev : NULL;
-    for (gint distance = 1; walker && distance <= 2; distance++) {
-        if (is_image_file((gchar*)walker->data)) {
-            preloader_add_task(preloader, (gchar*)walker->data, 10 + distance, task_width, task_height);
+    for (gint distance = 1; distance <= 2 && current_index - distance >= 0; distance++) {
+        const gchar *path = media_index_get(files, current_index - distance);
+        if (is_image_file(path)) {
+            preloader_add_task(preloader, path, 10 + distance, task_width, task_height);
         }
-        walker = walker->prev;
     }
 
     return ERROR_NONE;
@@ -457,6 +473,17 @@ ErrorCode preloader_clear_queue(ImagePreloader *preloader) {
     return ERROR_NONE;
 }
 
+void preloader_cancel_pending(ImagePreloader *preloader) {
+    if (!preloader) {
+        return;
+    }
+
+    g_mutex_lock(&preloader->mutex);
+    preloader_clear_queue_locked(preloader);
+    preloader->generation++;
+    g_mutex_unlock(&preloader->mutex);
+}
+
 // Check if there are pending tasks
 // Get cached image
 GString* preloader_get_cached_image(ImagePreloader *preloader, const char *filepath, gint target_width, gint target_height) {
@@ -485,6 +512,7 @@ GString* preloader_get_cached_image(ImagePreloader *preloader, const char *filep
         rendered = g_string_new_len(cached_data->rendered->str, cached_data->rendered->len);
     }
     g_mutex_unlock(&preloader->mutex);
+    metrics_add(rendered ? METRIC_PRELOAD_HITS : METRIC_PRELOAD_MISSES, 1);
 
     return rendered;
 }
@@ -581,6 +609,7 @@ void preloader_cache_add(ImagePreloader *preloader,
             g_queue_remove(preloader->lru_queue, stored_key);
             g_queue_push_head(preloader->lru_queue, stored_key);
         }
+        preloader_publish_metrics_locked(preloader);
         g_mutex_unlock(&preloader->mutex);
         return;
     }
@@ -601,6 +630,7 @@ void preloader_cache_add(ImagePreloader *preloader,
     if (!key || !value) {
         preload_cache_key_destroy(key);
         if (value && value->rendered) {
+            preloader->cache_bytes -= MIN(preloader->cache_bytes, value->rendered->len);
             g_string_free(value->rendered, TRUE);
         }
         g_free(value);
@@ -611,6 +641,7 @@ void preloader_cache_add(ImagePreloader *preloader,
     g_queue_remove(preloader->lru_queue, key);
     g_queue_push_head(preloader->lru_queue, key);
     preloader_cache_cleanup_locked(preloader);
+    preloader_publish_metrics_locked(preloader);
 
     g_mutex_unlock(&preloader->mutex);
 }
@@ -627,10 +658,11 @@ void preloader_cache_remove(ImagePreloader *preloader, const char *filepath) {
         PreloadCacheKey *key = (PreloadCacheKey*)link->data;
         if (key && g_strcmp0(key->filepath, filepath) == 0) {
             g_queue_delete_link(preloader->lru_queue, link);
-            g_hash_table_remove(preloader->preload_cache, key);
+            preloader_cache_evict_locked(preloader, key);
         }
         link = next;
     }
+    preloader_publish_metrics_locked(preloader);
     g_mutex_unlock(&preloader->mutex);
 }
 
@@ -643,8 +675,9 @@ void preloader_cache_clear(ImagePreloader *preloader) {
     g_mutex_lock(&preloader->mutex);
     while (!g_queue_is_empty(preloader->lru_queue)) {
         gpointer key = g_queue_pop_head(preloader->lru_queue);
-        g_hash_table_remove(preloader->preload_cache, key);
+        preloader_cache_evict_locked(preloader, key);
     }
+    preloader_publish_metrics_locked(preloader);
     g_mutex_unlock(&preloader->mutex);
 }
 
@@ -656,6 +689,7 @@ void preloader_cache_cleanup(ImagePreloader *preloader) {
 
     g_mutex_lock(&preloader->mutex);
     preloader_cache_cleanup_locked(preloader);
+    preloader_publish_metrics_locked(preloader);
     g_mutex_unlock(&preloader->mutex);
 }
 
@@ -719,6 +753,7 @@ gpointer preloader_worker_thread(gpointer data) {
     if (!preloader) {
         return NULL;
     }
+    trace_set_thread_name("preloader");
 
     // Create renderer for this thread
     ImageRenderer *renderer = renderer_create();
@@ -806,17 +841,21 @@ gpointer preloader_worker_thread(gpointer data) {
 
         // Get next task
         PreloadTask *task = NULL;
+        guint task_generation = preloader->generation;
         if (preloader->status == PRELOADER_ACTIVE &&
             preloader->enabled &&
             !g_queue_is_empty(preloader->task_queue)) {
             task = (PreloadTask*)g_queue_pop_head(preloader->task_queue);
             preloader->active_tasks++;
+            preloader_publish_metrics_locked(preloader);
         }
 
         g_mutex_unlock(&preloader->mutex);
 
         // Process task
         if (task) {
+            TraceSpan span = trace_span_begin(TRACE_CATEGORY_PRELOAD, "task");
+            gint64 busy_start_us = g_get_monotonic_time();
             gint task_width = task->target_width;
             gint task_height = task->target_height;
 
@@ -832,6 +871,15 @@ gpointer preloader_worker_thread(gpointer data) {
             // Render the image
             GString *rendered = renderer_render_image_file(renderer, task->filepath);
 
+            // Drop the result if the task was cancelled while it rendered
+            g_mutex_lock(&preloader->mutex);
+            gboolean cancelled = preloader->generation != task_generation;
+            g_mutex_unlock(&preloader->mutex);
+            if (rendered && cancelled) {
+                g_string_free(rendered, TRUE);
+                rendered = NULL;
+            }
+
             if (rendered) {
                 // Get the actual rendered dimensions
                 gint rendered_width, rendered_height;
@@ -846,6 +894,8 @@ gpointer preloader_worker_thread(gpointer data) {
                                     renderer_is_graphics_mode(renderer),
                                     task_width,
                                     task_height);
+                // A pending asynchronous render may be waiting for this entry
+                event_loop_wake();
 
                 // Free the original GString
                 g_string_free(rendered, TRUE);
@@ -858,6 +908,8 @@ gpointer preloader_worker_thread(gpointer data) {
             // Cleanup task
             g_free(task->filepath);
             g_free(task);
+            metrics_add(METRIC_WORKER_BUSY_US, g_get_monotonic_time() - busy_start_us);
+            trace_span_end(&span);
 
             // Update active task count
             g_mutex_lock(&preloader->mutex);
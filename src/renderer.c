@@ -6,6 +6,9 @@
 #include "video_player.h"
 #include "media_buffer.h"
 #include "pixbuf_utils.h"
+#include "kitty_compress.h"
+#include "metrics.h"
+#include "trace.h"
 
 #if defined(CHAFA_MAJOR_VERSION) && defined(CHAFA_MINOR_VERSION)
 #define PIXELTERM_CHAFA_AT_LEAST(major, minor) \
@@ -488,6 +491,8 @@ GString* renderer_render_image_data(ImageRenderer *renderer,
         pixels_to_draw = enhanced;
     }
 
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_RENDER, "image");
+    gint64 start_us = g_get_monotonic_time();
     // Draw pixels to canvas
     chafa_canvas_draw_all_pixels(renderer->canvas, pixel_type,
                                 pixels_to_draw, width, height, rowstride);
@@ -496,7 +501,64 @@ GString* renderer_render_image_data(ImageRenderer *renderer,
 
     // Generate output - use NULL for term_info to force generic ANSI output with RGB
     GString *output = chafa_canvas_print(renderer->canvas, renderer->term_info);
+    // Deflate inline kitty data here, on the rendering thread, when the link is slow
+    if (output && chafa_canvas_config_get_pixel_mode(renderer->canvas_config) == CHAFA_PIXEL_MODE_KITTY) {
+        (void)kitty_compress_rendered(output);
+    }
+    metrics_set_elapsed(METRIC_RENDER_US, start_us);
+    trace_span_end_arg(&span, "bytes", output ? (gint64)output->len : 0);
+
+    return output;
+}
+
+// Render video frame data as sixels with a palette reused across frames
+GString* renderer_render_sixel_data(ImageRenderer *renderer,
+                                    SixelPaletteCache *palettes,
+                                    const guint8 *pixel_data,
+                                    gint width,
+                                    gint height,
+                                    gint rowstride) {
+    if (!renderer || !palettes || !pixel_data || renderer->config.dither || !renderer->canvas_config ||
+        chafa_canvas_config_get_pixel_mode(renderer->canvas_config) != CHAFA_PIXEL_MODE_SIXELS ||
+        !renderer_validate_pixel_data(width, height, rowstride, 4, NULL)) {
+        return NULL;
+    }
+    if (renderer_setup_canvas(renderer, width, height) != ERROR_NONE) {
+        return NULL;
+    }
+
+    gint columns = 0;
+    gint rows = 0;
+    gint pixel_width = 0;
+    gint pixel_height = 0;
+    renderer_get_rendered_dimensions(renderer, &columns, &rows);
+    if (!sixel_get_image_size(columns, rows, &pixel_width, &pixel_height)) {
+        return NULL;
+    }
+
+    const guint8 *pixels_to_draw = pixel_data;
+    guint8 *adjusted = NULL;
+    guint8 *enhanced = NULL;
+    if (renderer_should_apply_gamma(renderer)) {
+        adjusted = renderer_apply_gamma_copy(pixel_data, width, height, rowstride, 4, renderer->config.gamma);
+        if (adjusted) {
+            pixels_to_draw = adjusted;
+        }
+    }
+    enhanced = renderer_apply_color_enhance_copy(pixels_to_draw, width, height, rowstride, 4,
+                                                 renderer->config.color_enhance);
+    if (enhanced) {
+        pixels_to_draw = enhanced;
+    }
 
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_RENDER, "sixel");
+    gint64 start_us = g_get_monotonic_time();
+    GString *output = sixel_encode_rgba(palettes, pixels_to_draw, width, height, rowstride,
+                                        pixel_width, pixel_height);
+    metrics_set_elapsed(METRIC_RENDER_US, start_us);
+    trace_span_end_arg(&span, "bytes", output ? (gint64)output->len : 0);
+    g_free(enhanced);
+    g_free(adjusted);
     return output;
 }
 
@@ -710,6 +772,35 @@ ErrorCode renderer_get_media_dimensions(const char *filepath, gint *width, gint
     return image_error;
 }
 
+ErrorCode renderer_probe_media(const char *filepath, MediaMeta *out) {
+    if (!filepath || !out) {
+        return ERROR_INVALID_IMAGE;
+    }
+
+    out->kind = media_classify(filepath);
+    out->width = 0;
+    out->height = 0;
+    out->animated = FALSE;
+    out->duration_ms = -1;
+
+    if (media_is_video(out->kind)) {
+        (void)video_player_probe(filepath, &out->width, &out->height, &out->duration_ms);
+    } else if (media_is_animated_image(out->kind)) {
+        GdkPixbufAnimation *animation = gdk_pixbuf_animation_new_from_file(filepath, NULL);
+        if (animation) {
+            out->width = gdk_pixbuf_animation_get_width(animation);
+            out->height = gdk_pixbuf_animation_get_height(animation);
+            out->animated = !gdk_pixbuf_animation_is_static_image(animation);
+            g_object_unref(animation);
+        }
+    } else if (media_is_image(out->kind)) {
+        (void)renderer_get_image_dimensions(filepath, &out->width, &out->height);
+    } else {
+        return ERROR_INVALID_IMAGE;
+    }
+    return ERROR_NONE;
+}
+
 // Get rendered image dimensions
 void renderer_get_rendered_dimensions(ImageRenderer *renderer, gint *width, gint *height) {
     if (!renderer || !width || !height) {
@@ -0,0 +1,489 @@
+#include "sixel_encoder.h"
+#include "common.h"
+#include "kitty_graphics_scale_internal.h"
+
+#include <string.h>
+
+#define SIXEL_MAX_COLORS 256
+// Colors are binned at 5 bits per channel for the histogram and lookup table
+#define SIXEL_BIN_BITS 5
+#define SIXEL_BIN_COUNT (1 << (SIXEL_BIN_BITS * 3))
+// Every 4th pixel of every 4th row is compared against the palette
+#define SIXEL_ERROR_STEP 4
+// A frame this much worse than the palette's own frame is a new scene
+#define SIXEL_SCENE_ERROR_FACTOR 1.5
+#define SIXEL_SCENE_ERROR_SLACK 64.0
+// Peak-to-peak spread of the ordered dither, in 8-bit levels
+#define SIXEL_DITHER_SPREAD 16
+
+typedef struct {
+    gint ref_count;
+    guint count;
+    guint8 colors[SIXEL_MAX_COLORS][3];
+    guint8 lut[SIXEL_BIN_COUNT];    // Bin key -> nearest palette index
+    gdouble error;                  // Sampled error of the frame it was built from
+} SixelPalette;
+
+struct SixelPaletteCache {
+    GMutex mutex;
+    SixelPalette *palette;
+    guint builds;
+};
+
+typedef struct {
+    guint32 key;
+    guint32 count;
+} SixelBin;
+
+typedef struct {
+    guint start;        // Range of bins
+    guint end;
+    guint64 count;      // Pixels in the box
+    gint axis;          // Channel with the widest range
+    gint range;
+} SixelBox;
+
+static const guint8 k_sixel_bayer4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5}
+};
+
+static inline guint32 sixel_bin_key(const guint8 *pixel) {
+    return ((guint32)(pixel[0] >> 3) << 10) | ((guint32)(pixel[1] >> 3) << 5) | (guint32)(pixel[2] >> 3);
+}
+
+static inline gint sixel_bin_channel(guint32 key, gint channel) {
+    return (gint)((key >> (10 - channel * 5)) & 0x1F);
+}
+
+static SixelPalette* sixel_palette_ref(SixelPalette *palette) {
+    if (palette) {
+        g_atomic_int_inc(&palette->ref_count);
+    }
+    return palette;
+}
+
+static void sixel_palette_unref(SixelPalette *palette) {
+    if (palette && g_atomic_int_dec_and_test(&palette->ref_count)) {
+        g_free(palette);
+    }
+}
+
+static void sixel_box_measure(SixelBox *box, const SixelBin *bins) {
+    gint low[3] = {31, 31, 31};
+    gint high[3] = {0, 0, 0};
+    box->count = 0;
+    for (guint i = box->start; i < box->end; i++) {
+        for (gint c = 0; c < 3; c++) {
+            gint v = sixel_bin_channel(bins[i].key, c);
+            low[c] = MIN(low[c], v);
+            high[c] = MAX(high[c], v);
+        }
+        box->count += bins[i].count;
+    }
+    box->axis = 0;
+    box->range = high[0] - low[0];
+    for (gint c = 1; c < 3; c++) {
+        if (high[c] - low[c] > box->range) {
+            box->axis = c;
+            box->range = high[c] - low[c];
+        }
+    }
+}
+
+// Orders a box's bins along its widest channel (counting sort over 32 levels).
+static void sixel_box_sort(const SixelBox *box, SixelBin *bins, SixelBin *scratch) {
+    guint offsets[33] = {0};
+    for (guint i = box->start; i < box->end; i++) {
+        offsets[sixel_bin_channel(bins[i].key, box->axis) + 1]++;
+    }
+    for (gint v = 0; v < 32; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    for (guint i = box->start; i < box->end; i++) {
+        scratch[offsets[sixel_bin_channel(bins[i].key, box->axis)]++] = bins[i];
+    }
+    memcpy(bins + box->start, scratch, (box->end - box->start) * sizeof(SixelBin));
+}
+
+// Median cut over a 5-bit histogram of @p image.
+static SixelPalette* sixel_palette_build(const guint8 *image, gint width, gint height, gsize stride) {
+    guint32 *counts = g_new0(guint32, SIXEL_BIN_COUNT);
+    guint64 *sums = g_new0(guint64, (gsize)SIXEL_BIN_COUNT * 3);
+    for (gint y = 0; y < height; y++) {
+        const guint8 *row = image + (gsize)y * stride;
+        for (gint x = 0; x < width; x++) {
+            const guint8 *pixel = row + (gsize)x * 4;
+            guint32 key = sixel_bin_key(pixel);
+            counts[key]++;
+            sums[key * 3] += pixel[0];
+            sums[key * 3 + 1] += pixel[1];
+            sums[key * 3 + 2] += pixel[2];
+        }
+    }
+
+    guint n_bins = 0;
+    for (guint32 key = 0; key < SIXEL_BIN_COUNT; key++) {
+        n_bins += counts[key] > 0;
+    }
+    SixelBin *bins = g_new(SixelBin, n_bins);
+    SixelBin *scratch = g_new(SixelBin, n_bins);
+    n_bins = 0;
+    for (guint32 key = 0; key < SIXEL_BIN_COUNT; key++) {
+        if (counts[key] > 0) {
+            bins[n_bins].key = key;
+            bins[n_bins].count = counts[key];
+            n_bins++;
+        }
+    }
+
+    SixelBox boxes[SIXEL_MAX_COLORS];
+    guint n_boxes = 1;
+    boxes[0].start = 0;
+    boxes[0].end = n_bins;
+    sixel_box_measure(&boxes[0], bins);
+    while (n_boxes < SIXEL_MAX_COLORS) {
+        // Split the box spanning the most pixels times the widest range
+        gint best = -1;
+        gdouble best_score = 0.0;
+        for (guint i = 0; i < n_boxes; i++) {
+            gdouble score = (gdouble)boxes[i].count * boxes[i].range;
+            if (boxes[i].end - boxes[i].start > 1 && score > best_score) {
+                best = (gint)i;
+                best_score = score;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        SixelBox *box = &boxes[best];
+        sixel_box_sort(box, bins, scratch);
+        guint64 half = box->count / 2;
+        guint64 seen = 0;
+        guint split = box->start;
+        while (split < box->end - 1 && seen + bins[split].count <= half) {
+            seen += bins[split].count;
+            split++;
+        }
+        if (split == box->start) {
+            split++;
+        }
+        SixelBox *upper = &boxes[n_boxes++];
+        upper->start = split;
+        upper->end = box->end;
+        box->end = split;
+        sixel_box_measure(box, bins);
+        sixel_box_measure(upper, bins);
+    }
+
+    SixelPalette *palette = g_new0(SixelPalette, 1);
+    palette->ref_count = 1;
+    palette->count = n_boxes;
+    for (guint i = 0; i < n_boxes; i++) {
+        guint64 total[3] = {0, 0, 0};
+        guint64 count = 0;
+        for (guint b = boxes[i].start; b < boxes[i].end; b++) {
+            guint32 key = bins[b].key;
+            total[0] += sums[key * 3];
+            total[1] += sums[key * 3 + 1];
+            total[2] += sums[key * 3 + 2];
+            count += counts[key];
+        }
+        for (gint c = 0; c < 3; c++) {
+            palette->colors[i][c] = count > 0 ? (guint8)((total[c] + count / 2) / count) : 0;
+        }
+    }
+
+    // Nearest palette color for the center of every bin
+    for (guint32 key = 0; key < SIXEL_BIN_COUNT; key++) {
+        gint center[3];
+        for (gint c = 0; c < 3; c++) {
+            center[c] = (sixel_bin_channel(key, c) << 3) | 4;
+        }
+        guint nearest = 0;
+        gint nearest_distance = G_MAXINT;
+        for (guint i = 0; i < palette->count; i++) {
+            gint dr = center[0] - palette->colors[i][0];
+            gint dg = center[1] - palette->colors[i][1];
+            gint db = center[2] - palette->colors[i][2];
+            gint distance = dr * dr + dg * dg + db * db;
+            if (distance < nearest_distance) {
+                nearest = i;
+                nearest_distance = distance;
+            }
+        }
+        palette->lut[key] = (guint8)nearest;
+    }
+
+    g_free(scratch);
+    g_free(bins);
+    g_free(sums);
+    g_free(counts);
+    return palette;
+}
+
+// Mean squared error of a sample of @p image mapped through @p palette.
+static gdouble sixel_palette_error(const SixelPalette *palette,
+                                   const guint8 *image,
+                                   gint width,
+                                   gint height,
+                                   gsize stride) {
+    guint64 total = 0;
+    guint64 samples = 0;
+    for (gint y = 0; y < height; y += SIXEL_ERROR_STEP) {
+        const guint8 *row = image + (gsize)y * stride;
+        for (gint x = 0; x < width; x += SIXEL_ERROR_STEP) {
+            const guint8 *pixel = row + (gsize)x * 4;
+            const guint8 *color = palette->colors[palette->lut[sixel_bin_key(pixel)]];
+            gint dr = pixel[0] - color[0];
+            gint dg = pixel[1] - color[1];
+            gint db = pixel[2] - color[2];
+            total += (guint64)(dr * dr + dg * dg + db * db);
+            samples++;
+        }
+    }
+    return samples > 0 ? (gdouble)total / (gdouble)samples : 0.0;
+}
+
+static inline guint8 sixel_clamp(gint value) {
+    return (guint8)(value < 0 ? 0 : value > 255 ? 255 : value);
+}
+
+static void sixel_palette_map(const SixelPalette *palette,
+                              const guint8 *image,
+                              gint width,
+                              gint height,
+                              gsize stride,
+                              guint8 *indices) {
+    gint offsets[16];
+    for (gint i = 0; i < 16; i++) {
+        offsets[i] = (i * 2 - 15) * SIXEL_DITHER_SPREAD / 32;
+    }
+    for (gint y = 0; y < height; y++) {
+        const guint8 *row = image + (gsize)y * stride;
+        const guint8 *bayer = k_sixel_bayer4[y & 3];
+        guint8 *out = indices + (gsize)y * (gsize)width;
+        for (gint x = 0; x < width; x++) {
+            const guint8 *pixel = row + (gsize)x * 4;
+            gint offset = offsets[bayer[x & 3]];
+            guint8 dithered[3] = {
+                sixel_clamp(pixel[0] + offset),
+                sixel_clamp(pixel[1] + offset),
+                sixel_clamp(pixel[2] + offset)
+            };
+            out[x] = palette->lut[sixel_bin_key(dithered)];
+        }
+    }
+}
+
+static void sixel_append_run(GString *out, gchar sixel, gint count) {
+    if (count >= 4) {
+        g_string_append_printf(out, "!%d%c", count, sixel);
+        return;
+    }
+    while (count-- > 0) {
+        g_string_append_c(out, sixel);
+    }
+}
+
+static void sixel_append_image(GString *out,
+                               const SixelPalette *palette,
+                               const guint8 *indices,
+                               gint width,
+                               gint height) {
+    // Pixel aspect 1:1, unset pixels left as they are
+    g_string_append_printf(out, "\033P0;1;0q\"1;1;%d;%d", width, height);
+    for (guint i = 0; i < palette->count; i++) {
+        g_string_append_printf(out, "#%u;2;%u;%u;%u", i,
+                               (palette->colors[i][0] * 100 + 127) / 255,
+                               (palette->colors[i][1] * 100 + 127) / 255,
+                               (palette->colors[i][2] * 100 + 127) / 255);
+    }
+
+    // One row of sixels per palette color, cleared again after each band
+    guint8 *bits = g_malloc0((gsize)SIXEL_MAX_COLORS * (gsize)width);
+    gint last_x[SIXEL_MAX_COLORS];
+    guint8 used[SIXEL_MAX_COLORS];
+    gboolean in_band[SIXEL_MAX_COLORS] = {FALSE};
+    for (gint band = 0; band < height; band += 6) {
+        guint n_used = 0;
+        gint band_rows = MIN(6, height - band);
+        for (gint r = 0; r < band_rows; r++) {
+            const guint8 *row = indices + (gsize)(band + r) * (gsize)width;
+            guint8 bit = (guint8)(1 << r);
+            for (gint x = 0; x < width; x++) {
+                guint8 color = row[x];
+                if (!in_band[color]) {
+                    in_band[color] = TRUE;
+                    used[n_used++] = color;
+                    last_x[color] = x;
+                } else if (x > last_x[color]) {
+                    last_x[color] = x;
+                }
+                bits[(gsize)color * (gsize)width + (gsize)x] |= bit;
+            }
+        }
+
+        for (guint u = 0; u < n_used; u++) {
+            guint8 color = used[u];
+            guint8 *sixels = bits + (gsize)color * (gsize)width;
+            if (u > 0) {
+                g_string_append_c(out, '$');
+            }
+            g_string_append_printf(out, "#%u", color);
+            gint x = 0;
+            while (x <= last_x[color]) {
+                guint8 value = sixels[x];
+                gint run = 1;
+                while (x + run <= last_x[color] && sixels[x + run] == value) {
+                    run++;
+                }
+                sixel_append_run(out, (gchar)(63 + value), run);
+                x += run;
+            }
+            memset(sixels, 0, (gsize)last_x[color] + 1);
+            in_band[color] = FALSE;
+        }
+        if (band + 6 < height) {
+            g_string_append_c(out, '-');
+        }
+    }
+    g_free(bits);
+    g_string_append(out, "\033\\");
+}
+
+SixelPaletteCache* sixel_palette_cache_new(void) {
+    SixelPaletteCache *cache = g_new0(SixelPaletteCache, 1);
+    g_mutex_init(&cache->mutex);
+    return cache;
+}
+
+void sixel_palette_cache_free(SixelPaletteCache *cache) {
+    if (!cache) {
+        return;
+    }
+    sixel_palette_unref(cache->palette);
+    g_mutex_clear(&cache->mutex);
+    g_free(cache);
+}
+
+void sixel_palette_cache_reset(SixelPaletteCache *cache) {
+    if (!cache) {
+        return;
+    }
+    g_mutex_lock(&cache->mutex);
+    SixelPalette *palette = cache->palette;
+    cache->palette = NULL;
+    g_mutex_unlock(&cache->mutex);
+    sixel_palette_unref(palette);
+}
+
+guint sixel_palette_cache_get_builds(SixelPaletteCache *cache) {
+    if (!cache) {
+        return 0;
+    }
+    g_mutex_lock(&cache->mutex);
+    guint builds = cache->builds;
+    g_mutex_unlock(&cache->mutex);
+    return builds;
+}
+
+gboolean sixel_get_image_size(gint columns, gint rows, gint *out_width, gint *out_height) {
+    gint cell_width = 0;
+    gint cell_height = 0;
+    if (columns <= 0 || rows <= 0) {
+        return FALSE;
+    }
+    // The same cell size the renderer gives chafa, so both encoders agree
+    get_terminal_cell_geometry(&cell_width, &cell_height);
+    gint width = columns * cell_width;
+    gint height = rows * cell_height / 6 * 6;
+    if (width <= 0 || height <= 0) {
+        return FALSE;
+    }
+    if (out_width) {
+        *out_width = width;
+    }
+    if (out_height) {
+        *out_height = height;
+    }
+    return TRUE;
+}
+
+static GString* sixel_encode(SixelPaletteCache *cache,
+                             const guint8 *pixels,
+                             gint src_width,
+                             gint src_height,
+                             gint src_rowstride,
+                             gint width,
+                             gint height,
+                             gboolean detect_scene) {
+    gsize area = 0;
+    if (!cache || !pixels || src_width <= 0 || src_height <= 0 || src_rowstride < src_width * 4 ||
+        width <= 0 || height <= 0 || !g_size_checked_mul(&area, (gsize)width, (gsize)height) ||
+        area > PIXELTERM_MAX_DECODED_PIXELS) {
+        return NULL;
+    }
+
+    const guint8 *image = pixels;
+    gsize stride = (gsize)src_rowstride;
+    guint8 *scaled = NULL;
+    if (width != src_width || height != src_height) {
+        scaled = g_malloc(area * 4);
+        kitty_graphics_scale_rgba_area(scaled, width, height, pixels, src_width, src_height, src_rowstride);
+        image = scaled;
+        stride = (gsize)width * 4;
+    }
+
+    g_mutex_lock(&cache->mutex);
+    SixelPalette *palette = sixel_palette_ref(cache->palette);
+    g_mutex_unlock(&cache->mutex);
+
+    if (palette && detect_scene) {
+        gdouble error = sixel_palette_error(palette, image, width, height, stride);
+        if (error > palette->error * SIXEL_SCENE_ERROR_FACTOR + SIXEL_SCENE_ERROR_SLACK) {
+            sixel_palette_unref(palette);
+            palette = NULL;
+        }
+    }
+    if (!palette) {
+        palette = sixel_palette_build(image, width, height, stride);
+        palette->error = sixel_palette_error(palette, image, width, height, stride);
+        g_mutex_lock(&cache->mutex);
+        SixelPalette *previous = cache->palette;
+        cache->palette = sixel_palette_ref(palette);
+        cache->builds++;
+        g_mutex_unlock(&cache->mutex);
+        sixel_palette_unref(previous);
+    }
+
+    guint8 *indices = g_malloc(area);
+    sixel_palette_map(palette, image, width, height, stride, indices);
+    GString *out = g_string_sized_new(area / 2 + 4096);
+    sixel_append_image(out, palette, indices, width, height);
+
+    g_free(indices);
+    sixel_palette_unref(palette);
+    g_free(scaled);
+    return out;
+}
+
+GString* sixel_encode_rgba(SixelPaletteCache *cache,
+                           const guint8 *pixels,
+                           gint src_width,
+                           gint src_height,
+                           gint src_rowstride,
+                           gint width,
+                           gint height) {
+    return sixel_encode(cache, pixels, src_width, src_height, src_rowstride, width, height, TRUE);
+}
+
+GString* sixel_encode_rgba_patch(SixelPaletteCache *cache,
+                                 const guint8 *pixels,
+                                 gint width,
+                                 gint height,
+                                 gint rowstride) {
+    return sixel_encode(cache, pixels, width, height, rowstride, width, height, FALSE);
+}
@@ -0,0 +1,221 @@
+#define _GNU_SOURCE
+
+#include "term_output.h"
+#include "metrics.h"
+#include "trace.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define TERM_OUTPUT_STREAM_BUFFER (64 * 1024)
+// Frame buffers above this size are released after the write
+#define TERM_OUTPUT_RETAINED_CAPACITY (4 * 1024 * 1024)
+// Smaller frames fit in kernel buffers and say nothing about the link
+#define TERM_OUTPUT_RATE_MIN_BYTES (256 * 1024)
+#define TERM_OUTPUT_RATE_SMOOTHING 0.3
+
+typedef struct {
+    gint fd;
+    FILE *stream;           // Composing stream installed as stdout
+    FILE *original;         // stdout before install
+    GByteArray *frame;      // Output of the open frame
+    gint depth;
+    TraceSpan frame_span;   // From opening the outermost frame to its write
+    TermOutputStats stats;
+} TermOutput;
+
+// Guards g_term_output; stream writes may come from any thread.
+static GMutex g_term_output_mutex;
+static TermOutput g_term_output = {.fd = -1};
+
+// Writes all of @p data, retrying interrupted and short writes.
+static gboolean term_output_write_all(gint fd, const char *data, gsize len, guint *out_syscalls) {
+    guint syscalls = 0;
+    gboolean ok = TRUE;
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        syscalls++;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                (void)poll(&pfd, 1, -1);
+                continue;
+            }
+            ok = FALSE;
+            break;
+        }
+        data += written;
+        len -= (gsize)written;
+    }
+    *out_syscalls = syscalls;
+    return ok;
+}
+
+static ssize_t term_output_stream_write(void *cookie, const char *buf, size_t size) {
+    TermOutput *output = cookie;
+    g_mutex_lock(&g_term_output_mutex);
+    if (output->depth > 0) {
+        g_byte_array_append(output->frame, (const guint8 *)buf, (guint)size);
+        g_mutex_unlock(&g_term_output_mutex);
+        return (ssize_t)size;
+    }
+    guint syscalls = 0;
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_WRITE, "terminal");
+    gboolean ok = term_output_write_all(output->fd, buf, size, &syscalls);
+    trace_span_end_arg(&span, "bytes", (gint64)size);
+    output->stats.syscalls += syscalls;
+    if (ok) {
+        output->stats.bytes += size;
+    }
+    g_mutex_unlock(&g_term_output_mutex);
+    return ok ? (ssize_t)size : -1;
+}
+
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+static int term_output_funopen_write(void *cookie, const char *buf, int size) {
+    return (int)term_output_stream_write(cookie, buf, (size_t)size);
+}
+
+static FILE* term_output_open_stream(TermOutput *output) {
+    return funopen(output, NULL, term_output_funopen_write, NULL, NULL);
+}
+#else
+static FILE* term_output_open_stream(TermOutput *output) {
+    cookie_io_functions_t io = {NULL, term_output_stream_write, NULL, NULL};
+    return fopencookie(output, "w", io);
+}
+#endif
+
+gboolean term_output_install(gint fd) {
+    if (fd < 0 || g_term_output.stream) {
+        return FALSE;
+    }
+    FILE *stream = term_output_open_stream(&g_term_output);
+    if (!stream) {
+        return FALSE;
+    }
+    setvbuf(stream, NULL, _IOFBF, TERM_OUTPUT_STREAM_BUFFER);
+    fflush(stdout);
+
+    g_mutex_lock(&g_term_output_mutex);
+    g_term_output.fd = fd;
+    g_term_output.frame = g_byte_array_new();
+    g_term_output.depth = 0;
+    g_term_output.stats = (TermOutputStats){0};
+    g_term_output.original = stdout;
+    g_term_output.stream = stream;
+    g_mutex_unlock(&g_term_output_mutex);
+    stdout = stream;
+    return TRUE;
+}
+
+void term_output_uninstall(void) {
+    if (!g_term_output.stream) {
+        return;
+    }
+    term_output_flush();
+    stdout = g_term_output.original;
+    fclose(g_term_output.stream);
+
+    g_mutex_lock(&g_term_output_mutex);
+    g_byte_array_unref(g_term_output.frame);
+    g_term_output.frame = NULL;
+    g_term_output.stream = NULL;
+    g_term_output.original = NULL;
+    g_term_output.fd = -1;
+    g_term_output.depth = 0;
+    g_mutex_unlock(&g_term_output_mutex);
+}
+
+void term_output_begin_frame(void) {
+    g_mutex_lock(&g_term_output_mutex);
+    if (g_term_output.depth == 0) {
+        g_term_output.frame_span = trace_span_begin(TRACE_CATEGORY_PRESENT, "frame");
+    }
+    g_term_output.depth++;
+    g_mutex_unlock(&g_term_output_mutex);
+}
+
+gboolean term_output_end_frame(void) {
+    g_mutex_lock(&g_term_output_mutex);
+    gint depth = g_term_output.depth;
+    if (depth > 1) {
+        g_term_output.depth--;
+    }
+    g_mutex_unlock(&g_term_output_mutex);
+    if (depth > 1) {
+        return TRUE;
+    }
+
+    // While the frame is open this only moves stdio's buffer into the frame
+    gboolean ok = fflush(stdout) == 0;
+    if (depth == 0) {
+        return ok;
+    }
+
+    g_mutex_lock(&g_term_output_mutex);
+    g_term_output.depth = 0;
+    GByteArray *frame = g_term_output.frame;
+    if (frame && frame->len > 0) {
+        guint syscalls = 0;
+        TraceSpan span = trace_span_begin(TRACE_CATEGORY_WRITE, "terminal");
+        gint64 start_us = g_get_monotonic_time();
+        gboolean written = term_output_write_all(g_term_output.fd, (const char *)frame->data, frame->len,
+                                                 &syscalls);
+        gint64 elapsed_us = g_get_monotonic_time() - start_us;
+        trace_span_end_arg(&span, "bytes", (gint64)frame->len);
+        if (written && frame->len >= TERM_OUTPUT_RATE_MIN_BYTES) {
+            gdouble rate = (gdouble)frame->len * G_USEC_PER_SEC / (gdouble)MAX(elapsed_us, 1);
+            gdouble previous = g_term_output.stats.write_bytes_per_sec;
+            g_term_output.stats.write_bytes_per_sec =
+                previous > 0.0 ? previous + (rate - previous) * TERM_OUTPUT_RATE_SMOOTHING : rate;
+        }
+        g_term_output.stats.frames++;
+        g_term_output.stats.syscalls += syscalls;
+        g_term_output.stats.last_frame_syscalls = syscalls;
+        g_term_output.stats.last_frame_bytes = written ? frame->len : 0;
+        if (written) {
+            g_term_output.stats.bytes += frame->len;
+        }
+        metrics_set(METRIC_WRITE_US, elapsed_us);
+        metrics_set(METRIC_FRAME_BYTES, (gint64)g_term_output.stats.last_frame_bytes);
+        ok = ok && written;
+        if (frame->len > TERM_OUTPUT_RETAINED_CAPACITY) {
+            g_byte_array_unref(frame);
+            g_term_output.frame = g_byte_array_new();
+        } else {
+            g_byte_array_set_size(frame, 0);
+        }
+    }
+    trace_span_end(&g_term_output.frame_span);
+    g_mutex_unlock(&g_term_output_mutex);
+    return ok;
+}
+
+void term_output_flush(void) {
+    g_mutex_lock(&g_term_output_mutex);
+    gboolean open = g_term_output.depth > 0;
+    if (open) {
+        g_term_output.depth = 1;
+    }
+    g_mutex_unlock(&g_term_output_mutex);
+    if (open) {
+        (void)term_output_end_frame();
+    } else {
+        fflush(stdout);
+    }
+}
+
+void term_output_get_stats(TermOutputStats *out) {
+    if (!out) {
+        return;
+    }
+    g_mutex_lock(&g_term_output_mutex);
+    *out = g_term_output.stats;
+    g_mutex_unlock(&g_term_output_mutex);
+}
@@ -0,0 +1,270 @@
+#include "trace.h"
+#include "process_env.h"
+#include "text_utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    const char *category;
+    const char *name;
+    const char *arg_name;
+    gint64 arg_value;
+    gint64 start_us;
+    gint64 duration_us;
+} TraceEvent;
+
+typedef struct {
+    TraceEvent *events;         // TRACE_RING_CAPACITY slots
+    guint64 count;              // Spans recorded; the ring holds the last ones
+    gint tid;
+    const char *thread_name;    // Interned
+} TraceRing;
+
+gint trace_active = 0;
+
+// Guards everything below except the contents of a ring, which only its
+// thread writes while tracing runs.
+static GMutex trace_mutex;
+// Rings are kept until exit so spans of finished threads reach the file.
+static GPtrArray *trace_rings = NULL;
+// Rings of exited threads, oldest first. A new thread takes an empty one, or
+// once TRACE_RETIRED_RINGS_MAX hold spans, the oldest, whose spans are dropped.
+static GPtrArray *trace_idle_rings = NULL;
+static gint trace_next_tid = 1;
+static guint64 trace_retired_dropped = 0;
+static gchar *trace_output_path = NULL;
+static gint64 trace_origin_us = 0;
+
+static void trace_ring_release(gpointer data) {
+    g_mutex_lock(&trace_mutex);
+    g_ptr_array_add(trace_idle_rings, data);
+    g_mutex_unlock(&trace_mutex);
+}
+
+// Caller holds trace_mutex.
+static TraceRing* trace_take_idle_ring_locked(void) {
+    for (guint i = 0; i < trace_idle_rings->len; i++) {
+        TraceRing *ring = g_ptr_array_index(trace_idle_rings, i);
+        if (ring->count == 0) {
+            return g_ptr_array_steal_index(trace_idle_rings, i);
+        }
+    }
+    if (trace_idle_rings->len < TRACE_RETIRED_RINGS_MAX) {
+        return NULL;
+    }
+    TraceRing *ring = g_ptr_array_steal_index(trace_idle_rings, 0);
+    trace_retired_dropped += ring->count;
+    ring->count = 0;
+    return ring;
+}
+
+static GPrivate trace_thread_ring = G_PRIVATE_INIT(trace_ring_release);
+
+static TraceRing* trace_thread_ring_get(void) {
+    TraceRing *ring = g_private_get(&trace_thread_ring);
+    if (ring) {
+        return ring;
+    }
+
+    g_mutex_lock(&trace_mutex);
+    if (!trace_rings) {
+        trace_rings = g_ptr_array_new();
+        trace_idle_rings = g_ptr_array_new();
+    }
+    ring = trace_take_idle_ring_locked();
+    if (!ring) {
+        ring = g_new0(TraceRing, 1);
+        ring->events = g_new(TraceEvent, TRACE_RING_CAPACITY);
+        g_ptr_array_add(trace_rings, ring);
+    }
+    // A reused ring is a new track: its spans never mix with the old thread's
+    ring->tid = trace_next_tid++;
+    ring->thread_name = NULL;
+    g_mutex_unlock(&trace_mutex);
+
+    g_private_set(&trace_thread_ring, ring);
+    return ring;
+}
+
+void trace_span_end_arg(const TraceSpan *span, const char *arg_name, gint64 arg_value) {
+    if (!span || span->start_us == 0 || !trace_enabled()) {
+        return;
+    }
+    gint64 end_us = g_get_monotonic_time();
+    TraceRing *ring = trace_thread_ring_get();
+    TraceEvent *event = &ring->events[ring->count % TRACE_RING_CAPACITY];
+    event->category = span->category;
+    event->name = span->name;
+    event->arg_name = arg_name;
+    event->arg_value = arg_value;
+    event->start_us = span->start_us;
+    event->duration_us = end_us - span->start_us;
+    ring->count++;
+}
+
+void trace_set_thread_name(const char *name) {
+    if (!name || !trace_enabled()) {
+        return;
+    }
+    trace_thread_ring_get()->thread_name = g_intern_string(name);
+}
+
+static void trace_finish_at_exit(void) {
+    (void)trace_finish();
+}
+
+static void trace_register_atexit(void) {
+    static gsize registered = 0;
+
+    if (g_once_init_enter(&registered)) {
+        atexit(trace_finish_at_exit);
+        g_once_init_leave(&registered, 1);
+    }
+}
+
+void trace_init(const char *path) {
+    gchar *resolved = NULL;
+    if (path && *path) {
+        resolved = g_strdup(path);
+    } else {
+        const gchar *env = pixelterm_getenv(TRACE_ENV);
+        if (!env || !*env || strcmp(env, "0") == 0) {
+            return;
+        }
+        resolved = strcmp(env, "1") == 0 ? g_build_filename(g_get_tmp_dir(), TRACE_DEFAULT_FILE, NULL)
+                                         : g_strdup(env);
+    }
+
+    g_mutex_lock(&trace_mutex);
+    if (trace_output_path) {
+        g_mutex_unlock(&trace_mutex);
+        g_free(resolved);
+        return;
+    }
+    trace_output_path = resolved;
+    trace_origin_us = g_get_monotonic_time();
+    g_mutex_unlock(&trace_mutex);
+
+    trace_register_atexit();
+    g_atomic_int_set(&trace_active, 1);
+    trace_set_thread_name("main");
+}
+
+static void trace_append_string(GString *out, const char *value) {
+    g_string_append_c(out, '"');
+    for (const char *p = value; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            g_string_append_c(out, '\\');
+            g_string_append_c(out, *p);
+        } else if ((guchar)*p < 0x20) {
+            g_string_append_printf(out, "\\u%04x", (guint)(guchar)*p);
+        } else {
+            g_string_append_c(out, *p);
+        }
+    }
+    g_string_append_c(out, '"');
+}
+
+static void trace_append_metadata(GString *out, const char *kind, gint pid, gint tid, const char *name) {
+    g_string_append_printf(out, "{\"name\":\"%s\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                           kind, pid, tid);
+    trace_append_string(out, name);
+    g_string_append(out, "}},\n");
+}
+
+static void trace_append_event(GString *out, const TraceEvent *event, gint pid, gint tid) {
+    g_string_append(out, "{\"name\":");
+    trace_append_string(out, event->name);
+    g_string_append(out, ",\"cat\":");
+    trace_append_string(out, event->category);
+    g_string_append_printf(out, ",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%" G_GINT64_FORMAT
+                           ",\"dur\":%" G_GINT64_FORMAT,
+                           pid, tid, event->start_us - trace_origin_us, event->duration_us);
+    if (event->arg_name) {
+        g_string_append(out, ",\"args\":{");
+        trace_append_string(out, event->arg_name);
+        g_string_append_printf(out, ":%" G_GINT64_FORMAT "}", event->arg_value);
+    }
+    g_string_append(out, "},\n");
+}
+
+// Caller holds trace_mutex and has stopped recording.
+static GString* trace_build_json_locked(void) {
+    gint pid = (gint)getpid();
+    guint64 dropped = trace_retired_dropped;
+    GString *out = g_string_new("{\"traceEvents\":[\n");
+    trace_append_metadata(out, "process_name", pid, 0, "pixelterm");
+
+    for (guint i = 0; trace_rings && i < trace_rings->len; i++) {
+        const TraceRing *ring = g_ptr_array_index(trace_rings, i);
+        if (ring->count == 0) {
+            continue;
+        }
+        gchar *fallback_name = NULL;
+        if (!ring->thread_name) {
+            fallback_name = g_strdup_printf("thread %d", ring->tid);
+        }
+        trace_append_metadata(out, "thread_name", pid, ring->tid,
+                              ring->thread_name ? ring->thread_name : fallback_name);
+        g_free(fallback_name);
+
+        // Oldest first once the ring has wrapped
+        guint64 kept = MIN(ring->count, (guint64)TRACE_RING_CAPACITY);
+        guint64 first = ring->count - kept;
+        for (guint64 n = first; n < ring->count; n++) {
+            trace_append_event(out, &ring->events[n % TRACE_RING_CAPACITY], pid, ring->tid);
+        }
+        dropped += first;
+    }
+
+    // Every entry above ends in ",\n"; close the array after the last one
+    g_string_truncate(out, out->len - 2);
+    g_string_append_printf(out, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_spans\":%"
+                           G_GUINT64_FORMAT "}}\n",
+                           dropped);
+    return out;
+}
+
+gboolean trace_finish(void) {
+    g_atomic_int_set(&trace_active, 0);
+
+    g_mutex_lock(&trace_mutex);
+    gchar *path = g_steal_pointer(&trace_output_path);
+    if (!path) {
+        g_mutex_unlock(&trace_mutex);
+        return TRUE;
+    }
+    GString *json = trace_build_json_locked();
+    g_mutex_unlock(&trace_mutex);
+
+    GError *error = NULL;
+    gboolean ok = g_file_set_contents(path, json->str, (gssize)json->len, &error);
+    if (!ok) {
+        gchar *safe_path = sanitize_for_terminal(path);
+        gchar *safe_message = sanitize_for_terminal(error ? error->message : "unknown error");
+        fprintf(stderr, "Failed to write trace '%s': %s\n", safe_path, safe_message);
+        g_free(safe_path);
+        g_free(safe_message);
+        g_clear_error(&error);
+    }
+    g_string_free(json, TRUE);
+    g_free(path);
+    return ok;
+}
+
+void trace_reset_for_test(void) {
+    g_atomic_int_set(&trace_active, 0);
+    g_mutex_lock(&trace_mutex);
+    g_clear_pointer(&trace_output_path, g_free);
+    for (guint i = 0; trace_rings && i < trace_rings->len; i++) {
+        TraceRing *ring = g_ptr_array_index(trace_rings, i);
+        ring->count = 0;
+        ring->thread_name = NULL;
+    }
+    trace_retired_dropped = 0;
+    trace_origin_us = 0;
+    g_mutex_unlock(&trace_mutex);
+}
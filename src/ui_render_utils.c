@@ -1,5 +1,6 @@
 #include "ui_render_utils.h"
 
+#include "term_output.h"
 #include "text_utils.h"
 
 void ui_render_centered_row(gint row, gint term_width, const char *text, const char *style) {
@@ -161,12 +162,15 @@ void ui_print_centered_help_line(gint row, gint term_width, const HelpSegment *s
 }
 
 void ui_begin_sync_update(void) {
-    // Use terminal synchronized output to reduce flicker during full-frame draws.
+    // Compose the frame in memory and present it with terminal synchronized
+    // output to reduce flicker during full-frame draws.
+    term_output_begin_frame();
     printf("\033[?2026h");
 }
 
 void ui_end_sync_update(void) {
     printf("\033[?2026l");
+    (void)term_output_end_frame();
 }
 
 void ui_clear_screen_for_refresh(const PixelTermApp *app) {
@@ -196,9 +200,21 @@ void ui_clear_kitty_images(const PixelTermApp *app) {
         return;
     }
     // Delete all kitty image placements (quiet) so old images don't linger.
+    // Images registered in app->kitty_images keep their data for reuse.
     printf("\033_Ga=d,q=2\033\\");
 }
 
+void ui_release_kitty_images(PixelTermApp *app) {
+    if (!app || !app->kitty_images) {
+        return;
+    }
+    // Free the image data kept for reuse, not just the placements
+    GString *deletes = g_string_new(NULL);
+    kitty_registry_clear(app->kitty_images, deletes);
+    fwrite(deletes->str, 1, deletes->len, stdout);
+    g_string_free(deletes, TRUE);
+}
+
 void ui_clear_single_view_lines(const PixelTermApp *app) {
     if (!app || app->term_height <= 0) {
         return;
@@ -0,0 +1,262 @@
+#include "video_dirty.h"
+#include "kitty_command_internal.h"
+#include "kitty_graphics_scale_internal.h"
+
+#include <gdk-pixbuf/gdk-pixbuf.h>
+#include <string.h>
+
+// Above the registry's IDs (below 1 << 24) and the animations' (below 2 << 24)
+#define VIDEO_DIRTY_KITTY_ID_BASE ((guint32)2 << 24)
+
+static gint video_dirty_x_edge(const VideoDirtyFrame *frame, gint column) {
+    return (gint)((gint64)column * frame->width / frame->columns);
+}
+
+static gint video_dirty_y_edge(const VideoDirtyFrame *frame, gint row) {
+    if (frame->cell_height > 0) {
+        return (gint)MIN((gint64)row * frame->cell_height, (gint64)frame->height);
+    }
+    return (gint)((gint64)row * frame->height / frame->rows);
+}
+
+VideoDirtyFrame* video_dirty_frame_new(const guint8 *pixels,
+                                       gint src_width,
+                                       gint src_height,
+                                       gint src_rowstride,
+                                       gint width,
+                                       gint height,
+                                       gint columns,
+                                       gint rows,
+                                       gint cell_height) {
+    gsize bytes = 0;
+    if (!pixels || src_width <= 0 || src_height <= 0 || src_rowstride < src_width * 4 ||
+        width <= 0 || height <= 0 || columns <= 0 || rows <= 0 || cell_height < 0 ||
+        !g_size_checked_mul(&bytes, (gsize)width, (gsize)height) ||
+        !g_size_checked_mul(&bytes, bytes, 4)) {
+        return NULL;
+    }
+    VideoDirtyFrame *frame = g_new0(VideoDirtyFrame, 1);
+    frame->pixels = g_malloc(bytes);
+    frame->width = width;
+    frame->height = height;
+    frame->columns = columns;
+    frame->rows = rows;
+    frame->cell_height = cell_height;
+    if (width == src_width && height == src_height) {
+        for (gint y = 0; y < height; y++) {
+            memcpy(frame->pixels + (gsize)y * (gsize)width * 4,
+                   pixels + (gsize)y * (gsize)src_rowstride,
+                   (gsize)width * 4);
+        }
+    } else {
+        kitty_graphics_scale_rgba_area(frame->pixels, width, height, pixels, src_width, src_height, src_rowstride);
+    }
+    return frame;
+}
+
+void video_dirty_frame_free(VideoDirtyFrame *frame) {
+    if (!frame) {
+        return;
+    }
+    g_free(frame->pixels);
+    g_free(frame);
+}
+
+// Appends a rectangle for @p span on @p row, or grows the one directly above.
+static void video_dirty_add_span(GArray *rects, gint row, gint column, gint columns) {
+    for (guint i = 0; i < rects->len; i++) {
+        VideoDirtyRect *rect = &g_array_index(rects, VideoDirtyRect, i);
+        if (rect->column == column && rect->columns == columns && rect->row + rect->rows == row) {
+            rect->rows++;
+            return;
+        }
+    }
+    VideoDirtyRect rect = {column, row, columns, 1};
+    g_array_append_val(rects, rect);
+}
+
+gboolean video_dirty_find_rects(const VideoDirtyFrame *previous,
+                                const VideoDirtyFrame *current,
+                                GArray *rects,
+                                gdouble *out_changed) {
+    if (!previous || !current || !rects || previous->width != current->width ||
+        previous->height != current->height || previous->columns != current->columns ||
+        previous->rows != current->rows || previous->cell_height != current->cell_height) {
+        return FALSE;
+    }
+    g_array_set_size(rects, 0);
+
+    const VideoDirtyFrame *frame = current;
+    gsize stride = (gsize)frame->width * 4;
+    gboolean *dirty = g_new(gboolean, frame->columns);
+    gint changed_cells = 0;
+    for (gint row = 0; row < frame->rows; row++) {
+        memset(dirty, 0, sizeof(gboolean) * (gsize)frame->columns);
+        gboolean row_dirty = FALSE;
+        gint y_end = video_dirty_y_edge(frame, row + 1);
+        for (gint y = video_dirty_y_edge(frame, row); y < y_end; y++) {
+            const guint8 *a = previous->pixels + (gsize)y * stride;
+            const guint8 *b = current->pixels + (gsize)y * stride;
+            if (memcmp(a, b, stride) == 0) {
+                continue;
+            }
+            for (gint column = 0; column < frame->columns; column++) {
+                if (dirty[column]) {
+                    continue;
+                }
+                gsize x0 = (gsize)video_dirty_x_edge(frame, column) * 4;
+                gsize x1 = (gsize)video_dirty_x_edge(frame, column + 1) * 4;
+                if (memcmp(a + x0, b + x0, x1 - x0) != 0) {
+                    dirty[column] = TRUE;
+                    row_dirty = TRUE;
+                }
+            }
+        }
+        if (!row_dirty) {
+            continue;
+        }
+
+        gint column = 0;
+        while (column < frame->columns) {
+            if (!dirty[column]) {
+                column++;
+                continue;
+            }
+            gint start = column;
+            gint end = column + 1;
+            for (gint next = end; next < frame->columns && next <= end + VIDEO_DIRTY_JOIN_GAP; next++) {
+                if (dirty[next]) {
+                    end = next + 1;
+                }
+            }
+            video_dirty_add_span(rects, row, start, end - start);
+            changed_cells += end - start;
+            column = end;
+        }
+    }
+    g_free(dirty);
+
+    if (out_changed) {
+        *out_changed = (gdouble)changed_cells / ((gdouble)frame->columns * (gdouble)frame->rows);
+    }
+    return TRUE;
+}
+
+void video_dirty_get_pixel_rect(const VideoDirtyFrame *frame,
+                                const VideoDirtyRect *rect,
+                                gint *out_x,
+                                gint *out_y,
+                                gint *out_width,
+                                gint *out_height) {
+    gint x = video_dirty_x_edge(frame, rect->column);
+    gint y = video_dirty_y_edge(frame, rect->row);
+    if (out_x) {
+        *out_x = x;
+    }
+    if (out_y) {
+        *out_y = y;
+    }
+    if (out_width) {
+        *out_width = video_dirty_x_edge(frame, rect->column + rect->columns) - x;
+    }
+    if (out_height) {
+        *out_height = video_dirty_y_edge(frame, rect->row + rect->rows) - y;
+    }
+}
+
+static void video_dirty_append_iterm2(GString *out, const guint8 *pixels, gint width, gint height,
+                                      const VideoDirtyRect *rect) {
+    GdkPixbuf *pixbuf = gdk_pixbuf_new_from_data(pixels, GDK_COLORSPACE_RGB, TRUE, 8, width, height, width * 4,
+                                                 NULL, NULL);
+    gchar *png = NULL;
+    gsize png_len = 0;
+    // Speed over size: the tile is written once and is usually small
+    if (pixbuf && gdk_pixbuf_save_to_buffer(pixbuf, &png, &png_len, "png", NULL, "compression", "1", NULL)) {
+        gchar *encoded = g_base64_encode((const guchar *)png, png_len);
+        g_string_append_printf(out,
+                               "\033]1337;File=inline=1;size=%" G_GSIZE_FORMAT
+                               ";width=%d;height=%d;preserveAspectRatio=0:%s\a",
+                               png_len, rect->columns, rect->rows, encoded);
+        g_free(encoded);
+        g_free(png);
+    }
+    if (pixbuf) {
+        g_object_unref(pixbuf);
+    }
+}
+
+void video_dirty_append_updates(GString *out,
+                                const VideoDirtyTarget *target,
+                                const VideoDirtyFrame *frame,
+                                const GArray *rects) {
+    if (!out || !target || !frame || !rects) {
+        return;
+    }
+    for (guint i = 0; i < rects->len; i++) {
+        const VideoDirtyRect *rect = &g_array_index(rects, VideoDirtyRect, i);
+        gint x = 0;
+        gint y = 0;
+        gint width = 0;
+        gint height = 0;
+        video_dirty_get_pixel_rect(frame, rect, &x, &y, &width, &height);
+        if (width <= 0 || height <= 0) {
+            continue;
+        }
+        gsize rect_stride = (gsize)width * 4;
+        guint8 *pixels = g_malloc(rect_stride * (gsize)height);
+        for (gint row = 0; row < height; row++) {
+            memcpy(pixels + (gsize)row * rect_stride,
+                   frame->pixels + ((gsize)(y + row) * (gsize)frame->width + (gsize)x) * 4,
+                   rect_stride);
+        }
+
+        if (target->pixel_mode == CHAFA_PIXEL_MODE_KITTY) {
+            // Overwrite part of the shown image; placements redraw by themselves
+            gchar *control = g_strdup_printf("a=f,i=%u,r=1,x=%d,y=%d,s=%d,v=%d,f=32,X=1,q=2",
+                                             target->kitty_image_id, x, y, width, height);
+            kitty_command_append_payload(out, control, pixels, rect_stride * (gsize)height);
+            g_free(control);
+        } else {
+            g_string_append_printf(out, "\033[%d;%dH",
+                                   target->top_row + rect->row, target->left_column + rect->column);
+            if (target->pixel_mode == CHAFA_PIXEL_MODE_SIXELS) {
+                GString *sixel = sixel_encode_rgba_patch(target->sixel_palettes, pixels, width, height,
+                                                         (gint)rect_stride);
+                if (sixel) {
+                    g_string_append_len(out, sixel->str, (gssize)sixel->len);
+                    g_string_free(sixel, TRUE);
+                }
+            } else if (target->pixel_mode == CHAFA_PIXEL_MODE_ITERM2) {
+                video_dirty_append_iterm2(out, pixels, width, height, rect);
+            }
+        }
+        g_free(pixels);
+    }
+}
+
+guint32 video_dirty_new_kitty_id(void) {
+    return VIDEO_DIRTY_KITTY_ID_BASE + (guint32)g_random_int_range(0, 1 << 24);
+}
+
+gboolean video_dirty_tag_kitty(GString *rendered, guint32 image_id, gint *out_width, gint *out_height) {
+    KittyCommand first;
+    if (!kitty_command_first_untagged_transmit(rendered, &first)) {
+        return FALSE;
+    }
+    gint64 width = kitty_command_get_int(rendered, &first, 's', 0);
+    gint64 height = kitty_command_get_int(rendered, &first, 'v', 0);
+    if (width <= 0 || height <= 0 || width > G_MAXINT || height > G_MAXINT) {
+        return FALSE;
+    }
+    GString *tag = g_string_new(NULL);
+    kitty_command_append_id_tag(tag, rendered, &first, image_id);
+    g_string_insert_len(rendered, (gssize)first.control, tag->str, (gssize)tag->len);
+    g_string_free(tag, TRUE);
+    if (out_width) {
+        *out_width = (gint)width;
+    }
+    if (out_height) {
+        *out_height = (gint)height;
+    }
+    return TRUE;
+}
@@ -9,6 +9,9 @@
 #include "video_player_seek_internal.h"
 #include "kitty_graphics.h"
 #include "media_buffer.h"
+#include "term_output.h"
+#include "metrics.h"
+#include "trace.h"
 
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
@@ -189,6 +192,8 @@ void video_frame_destroy(VideoFrame *frame) {
         kitty_graphics_shm_unlink(frame->kitty_shm_name);
         g_free(frame->kitty_shm_name);
     }
+    kitty_shm_slot_release(frame->kitty_shm_slot);
+    video_dirty_frame_free(frame->dirty);
     g_free(frame);
 }
 
@@ -200,6 +205,11 @@ static void video_frame_mark_kitty_shm_submitted(VideoFrame *frame) {
          * up in video_frame_destroy(). */
         g_clear_pointer(&frame->kitty_shm_name, g_free);
     }
+    if (frame && frame->kitty_shm_slot) {
+        // The ring leaves the slot alone until the terminal has read it
+        kitty_shm_slot_submitted(frame->kitty_shm_slot);
+        frame->kitty_shm_slot = NULL;
+    }
 }
 
 void video_player_queue_clear(VideoPlayer *player) {
@@ -580,6 +590,7 @@ static void video_player_reset_media_state(VideoPlayer *player) {
     video_player_clear_line_cache(player);
     video_player_clear_decode(player);
     video_player_reset_timing_state(player);
+    sixel_palette_cache_reset(player->sixel_palettes);
 }
 
 VideoPlayer* video_player_new(gint work_factor, gboolean force_text, gboolean force_sixel, gboolean force_kitty,
@@ -649,6 +660,10 @@ VideoPlayer* video_player_new(gint work_factor, gboolean force_text, gboolean fo
     player->color_enhance = COLOR_ENHANCE_OFF;
     player->kitty_transfer = kitty_transfer;
     player->kitty_shm_enabled = kitty_graphics_should_use_shm(kitty_transfer);
+    player->kitty_shm_ring = player->kitty_shm_enabled ? kitty_shm_ring_new(NULL) : NULL;
+    player->sixel_palettes = sixel_palette_cache_new();
+    player->dirty_threshold = VIDEO_DIRTY_DEFAULT_THRESHOLD;
+    player->kitty_image_id = video_dirty_new_kitty_id();
 
     if (work_factor < 1) {
         work_factor = 1;
@@ -1091,6 +1106,7 @@ static gpointer video_player_worker_thread(gpointer user_data) {
     if (!player) {
         return NULL;
     }
+    trace_set_thread_name("video-decode");
 
     for (;;) {
         if (video_player_should_stop(player)) {
@@ -1108,6 +1124,7 @@ static gpointer video_player_worker_thread(gpointer user_data) {
         }
 
         gboolean frame_ready = FALSE;
+        TraceSpan decode_span = trace_span_begin(TRACE_CATEGORY_DECODE, "video-frame");
         gint64 decode_start_us = g_get_monotonic_time();
         while (!frame_ready && !video_player_should_stop(player)) {
             gboolean draining = video_player_get_draining(player);
@@ -1160,7 +1177,9 @@ static gpointer video_player_worker_thread(gpointer user_data) {
         if (!frame_ready || video_player_should_stop(player)) {
             continue;
         }
-        gint64 decode_elapsed_us = g_get_monotonic_time() - decode_start_us;
+        gint64 decode_elapsed_us = metrics_set_elapsed(METRIC_DECODE_US, decode_start_us);
+        metrics_add(METRIC_WORKER_BUSY_US, decode_elapsed_us);
+        trace_span_end(&decode_span);
 
         gint frame_delay = player->frame_delay_ms;
         if (frame_delay < 1) {
@@ -1245,11 +1264,62 @@ static gpointer video_player_worker_thread(gpointer user_data) {
     return NULL;
 }
 
+// Keeps the frame's pixels at the size the terminal is sent, so the next
+// frame can be sent as the cells that changed. Kitty transmits get the
+// player's image ID, which makes each frame replace the last one and lets
+// later frames edit it in place.
+static VideoDirtyFrame *video_player_render_worker_dirty_frame(VideoPlayer *player,
+                                                               ImageRenderer *renderer,
+                                                               const DecodedFrame *decoded,
+                                                               GString *rendered,
+                                                               ChafaPixelMode pixel_mode,
+                                                               gboolean own_sixel,
+                                                               gint columns,
+                                                               gint rows) {
+    // Changed cells are cut from unadjusted pixels
+    if (player->dirty_threshold <= 0 || columns <= 0 || rows <= 0 ||
+        (renderer->config.gamma > 0.0 && renderer->config.gamma != 1.0) ||
+        renderer->config.color_enhance != COLOR_ENHANCE_OFF) {
+        return NULL;
+    }
+
+    gint width = 0;
+    gint height = 0;
+    gint cell_width = 0;
+    gint cell_height = 0;
+    switch (pixel_mode) {
+        case CHAFA_PIXEL_MODE_KITTY:
+            if (!video_dirty_tag_kitty(rendered, player->kitty_image_id, &width, &height)) {
+                return NULL;
+            }
+            cell_height = 0;
+            break;
+        case CHAFA_PIXEL_MODE_SIXELS:
+            // Chafa's own sixel palette is not known, so only our frames qualify
+            if (!own_sixel || !sixel_get_image_size(columns, rows, &width, &height)) {
+                return NULL;
+            }
+            get_terminal_cell_geometry(&cell_width, &cell_height);
+            break;
+        case CHAFA_PIXEL_MODE_ITERM2:
+            get_terminal_cell_geometry(&cell_width, &cell_height);
+            width = columns * cell_width;
+            height = rows * cell_height;
+            cell_height = 0;
+            break;
+        default:
+            return NULL;
+    }
+    return video_dirty_frame_new(decoded->pixels, decoded->width, decoded->height, decoded->rowstride,
+                                 width, height, columns, rows, cell_height);
+}
+
 static gpointer video_player_render_worker_thread(gpointer user_data) {
     VideoPlayer *player = (VideoPlayer *)user_data;
     if (!player) {
         return NULL;
     }
+    trace_set_thread_name("video-render");
 
     ImageRenderer *renderer = renderer_create();
     if (!renderer) {
@@ -1282,6 +1352,8 @@ static gpointer video_player_render_worker_thread(gpointer user_data) {
         ChafaPixelMode pixel_mode = CHAFA_PIXEL_MODE_SYMBOLS;
         GString *rendered = NULL;
         gchar *kitty_shm_name = NULL;
+        KittyShmSlot *kitty_shm_slot = NULL;
+        gboolean own_sixel = FALSE;
         gboolean try_kitty_shm = renderer->config.force_kitty &&
                                  !renderer->config.force_text &&
                                  !renderer->config.force_sixel &&
@@ -1289,21 +1361,47 @@ static gpointer video_player_render_worker_thread(gpointer user_data) {
                                  player->kitty_shm_enabled;
         if (try_kitty_shm && renderer_setup_canvas(renderer, decoded->width, decoded->height) == ERROR_NONE) {
             renderer_get_rendered_dimensions(renderer, &rendered_w, &rendered_h);
-            KittyGraphicsFrame *kitty_frame = kitty_graphics_frame_new_shm_rgba(decoded->pixels,
-                                                                               decoded->width,
-                                                                               decoded->height,
-                                                                               decoded->rowstride,
-                                                                               rendered_w,
-                                                                               rendered_h);
+            // Ring slots are written in place; a new shm object per frame
+            // is the fallback when the ring is unavailable or exhausted
+            KittyGraphicsFrame *kitty_frame = kitty_graphics_frame_new_ring_rgba(player->kitty_shm_ring,
+                                                                                decoded->pixels,
+                                                                                decoded->width,
+                                                                                decoded->height,
+                                                                                decoded->rowstride,
+                                                                                rendered_w,
+                                                                                rendered_h);
+            if (!kitty_frame) {
+                kitty_frame = kitty_graphics_frame_new_shm_rgba(decoded->pixels,
+                                                                decoded->width,
+                                                                decoded->height,
+                                                                decoded->rowstride,
+                                                                rendered_w,
+                                                                rendered_h);
+            }
             if (kitty_frame) {
                 rendered = kitty_frame->command;
                 kitty_shm_name = kitty_frame->shm_name;
+                kitty_shm_slot = kitty_frame->slot;
                 kitty_frame->command = NULL;
                 kitty_frame->shm_name = NULL;
+                kitty_frame->slot = NULL;
                 pixel_mode = CHAFA_PIXEL_MODE_KITTY;
                 kitty_graphics_frame_free(kitty_frame);
             }
         }
+        if (!rendered) {
+            rendered = renderer_render_sixel_data(renderer,
+                                                  player->sixel_palettes,
+                                                  decoded->pixels,
+                                                  decoded->width,
+                                                  decoded->height,
+                                                  decoded->rowstride);
+            if (rendered) {
+                renderer_get_rendered_dimensions(renderer, &rendered_w, &rendered_h);
+                pixel_mode = CHAFA_PIXEL_MODE_SIXELS;
+                own_sixel = TRUE;
+            }
+        }
         if (!rendered) {
             g_clear_pointer(&kitty_shm_name, g_free);
             rendered = renderer_render_image_data(renderer,
@@ -1319,7 +1417,13 @@ static gpointer video_player_render_worker_thread(gpointer user_data) {
                 }
             }
         }
-        gint64 render_elapsed_us = g_get_monotonic_time() - render_start_us;
+        VideoDirtyFrame *dirty = NULL;
+        if (rendered && pixel_mode != CHAFA_PIXEL_MODE_SYMBOLS) {
+            dirty = video_player_render_worker_dirty_frame(player, renderer, decoded, rendered, pixel_mode,
+                                                           own_sixel, rendered_w, rendered_h);
+        }
+        gint64 render_elapsed_us = metrics_set_elapsed(METRIC_RENDER_US, render_start_us);
+        metrics_add(METRIC_WORKER_BUSY_US, render_elapsed_us);
         video_player_debug_log(player, "worker-render-time", decoded->pts_ms, render_elapsed_us, rendered_w, rendered_h);
 
         if (!rendered) {
@@ -1332,16 +1436,20 @@ static gpointer video_player_render_worker_thread(gpointer user_data) {
         VideoFrame *frame = g_new0(VideoFrame, 1);
         if (!frame) {
             g_string_free(rendered, TRUE);
+            video_dirty_frame_free(dirty);
             if (kitty_shm_name) {
                 kitty_graphics_shm_unlink(kitty_shm_name);
                 g_free(kitty_shm_name);
             }
+            kitty_shm_slot_release(kitty_shm_slot);
             decoded_frame_destroy(decoded);
             video_player_render_work_finished(player);
             continue;
         }
         frame->rendered = rendered;
         frame->kitty_shm_name = kitty_shm_name;
+        frame->kitty_shm_slot = kitty_shm_slot;
+        frame->dirty = dirty;
         frame->rendered_width = rendered_w;
         frame->rendered_height = rendered_h;
         frame->pts_ms = decoded->pts_ms;
@@ -1358,6 +1466,36 @@ static gpointer video_player_render_worker_thread(gpointer user_data) {
     return NULL;
 }
 
+// Writes only the cells that changed since the frame on screen, when few
+// enough did. Called with the state lock held.
+static gboolean video_player_write_dirty_update(VideoPlayer *player, VideoFrame *frame, gint row, gint column) {
+    if (!frame->dirty || !player->dirty_shown || player->dirty_shown_mode != frame->pixel_mode ||
+        player->dirty_shown_row != row || player->dirty_shown_column != column) {
+        return FALSE;
+    }
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    gdouble changed = 0.0;
+    gboolean partial = video_dirty_find_rects(player->dirty_shown, frame->dirty, rects, &changed) &&
+                       changed * 100.0 <= (gdouble)player->dirty_threshold;
+    if (partial && rects->len > 0) {
+        VideoDirtyTarget target = {
+            .pixel_mode = frame->pixel_mode,
+            .kitty_image_id = player->kitty_image_id,
+            .sixel_palettes = player->sixel_palettes,
+            .top_row = row,
+            .left_column = column
+        };
+        GString *update = g_string_new(NULL);
+        video_dirty_append_updates(update, &target, frame->dirty, rects);
+        if (update->len > 0) {
+            fwrite(update->str, 1, update->len, stdout);
+        }
+        g_string_free(update, TRUE);
+    }
+    g_array_free(rects, TRUE);
+    return partial;
+}
+
 static gboolean video_player_render_frame(VideoPlayer *player) {
     if (!player || !video_player_has_renderer(player) || !player->format_context || !player->codec_context) {
         return FALSE;
@@ -1419,6 +1557,7 @@ static gboolean video_player_render_frame(VideoPlayer *player) {
     video_player_debug_log(player, "render-frame", frame->pts_ms, rendered_w, rendered_h, graphics_mode ? 1 : 0);
 
     gint64 io_start_us = g_get_monotonic_time();
+    term_output_begin_frame();
     g_mutex_lock(&player->state_mutex);
     if (player->render_layout_valid && player->render_area_top_row > 0 && player->render_area_height > 0) {
         gint term_w = player->render_term_width > 0 ? player->render_term_width : player->render_max_width;
@@ -1456,17 +1595,28 @@ static gboolean video_player_render_frame(VideoPlayer *player) {
         gboolean has_newline = !graphics_mode && memchr(result->str, '\n', result->len) != NULL;
 
         if (graphics_mode) {
-            video_player_clear_line_cache(player);
+            if (player->last_frame_lines) {
+                g_ptr_array_free(player->last_frame_lines, TRUE);
+                player->last_frame_lines = NULL;
+            }
             gint col = 1 + left_pad;
             if (col < 1) {
                 col = 1;
             }
-            printf("\033[%d;%dH", row, col);
-            size_t written = 0;
-            if (result->len > 0) {
-                written = fwrite(result->str, 1, result->len, stdout);
+            if (!video_player_write_dirty_update(player, frame, row, col)) {
+                printf("\033[%d;%dH", row, col);
+                size_t written = 0;
+                if (result->len > 0) {
+                    written = fwrite(result->str, 1, result->len, stdout);
+                }
+                kitty_shm_written = (frame->kitty_shm_name || frame->kitty_shm_slot) && written == result->len;
             }
-            kitty_shm_written = frame->kitty_shm_name && written == result->len;
+            video_dirty_frame_free(player->dirty_shown);
+            player->dirty_shown = frame->dirty;
+            player->dirty_shown_mode = frame->pixel_mode;
+            player->dirty_shown_row = row;
+            player->dirty_shown_column = col;
+            frame->dirty = NULL;
             lines_printed = rendered_h > 0 ? rendered_h : 1;
         } else if (!has_newline) {
             video_player_clear_line_cache(player);
@@ -1586,14 +1736,14 @@ static gboolean video_player_render_frame(VideoPlayer *player) {
         if (result->len > 0) {
             written = fwrite(result->str, 1, result->len, stdout);
         }
-        kitty_shm_written = frame->kitty_shm_name && written == result->len;
+        kitty_shm_written = (frame->kitty_shm_name || frame->kitty_shm_slot) && written == result->len;
         printf("\033[J");
         player->last_frame_top_row = 0;
         player->last_frame_height = 0;
     }
     g_mutex_unlock(&player->state_mutex);
 
-    if (fflush(stdout) == 0 && kitty_shm_written) {
+    if (term_output_end_frame() && kitty_shm_written) {
         video_frame_mark_kitty_shm_submitted(frame);
     }
     gint64 io_end_us = g_get_monotonic_time();
@@ -1944,6 +2094,10 @@ ErrorCode video_player_update_terminal_size(VideoPlayer *player) {
 }
 
 ErrorCode video_player_get_dimensions(const gchar *filepath, gint *width, gint *height) {
+    return video_player_probe(filepath, width, height, NULL);
+}
+
+ErrorCode video_player_probe(const gchar *filepath, gint *width, gint *height, gint64 *duration_ms) {
     if (!filepath || !width || !height) {
         return ERROR_INVALID_IMAGE;
     }
@@ -1970,6 +2124,11 @@ ErrorCode video_player_get_dimensions(const gchar *filepath, gint *width, gint *
         }
     }
 
+    gint64 found_duration_ms = -1;
+    if (format_context->duration != AV_NOPTS_VALUE && format_context->duration > 0) {
+        found_duration_ms = av_rescale_q(format_context->duration, AV_TIME_BASE_Q, (AVRational){1, 1000});
+    }
+
     avformat_close_input(&format_context);
 
     if (found_w <= 0 || found_h <= 0) {
@@ -1978,6 +2137,9 @@ ErrorCode video_player_get_dimensions(const gchar *filepath, gint *width, gint *
 
     *width = found_w;
     *height = found_h;
+    if (duration_ms) {
+        *duration_ms = found_duration_ms;
+    }
     return ERROR_NONE;
 }
 
@@ -2172,6 +2334,8 @@ void video_player_destroy(VideoPlayer *player) {
         video_player_decode_queue_clear(player);
         g_queue_free(player->decode_queue);
     }
+    kitty_shm_ring_free(player->kitty_shm_ring);
+    sixel_palette_cache_free(player->sixel_palettes);
     g_cond_clear(&player->decode_queue_has_items);
     g_cond_clear(&player->decode_queue_has_space);
     g_cond_clear(&player->frame_queue_has_space);
@@ -19,7 +19,12 @@ const char *video_player_pixel_mode_label(ChafaPixelMode mode) {
 /* ───── Line cache ───── */
 
 void video_player_clear_line_cache(VideoPlayer *player) {
-    if (!player || !player->last_frame_lines) {
+    if (!player) {
+        return;
+    }
+    // What is on screen is no longer known, so the next frame is sent whole
+    g_clear_pointer(&player->dirty_shown, video_dirty_frame_free);
+    if (!player->last_frame_lines) {
         return;
     }
     g_ptr_array_free(player->last_frame_lines, TRUE);
@@ -18,6 +18,8 @@ typedef struct {
     gint refresh_display_calls;
     gint display_image_info_calls;
     gint display_help_calls;
+    gint perf_hud_render_calls;
+    gint perf_hud_clear_calls;
     gint book_change_page_calls;
     gint delete_calls;
     gint render_by_mode_calls;
@@ -6,6 +6,7 @@
 #include "input.h"
 #include "process_env.h"
 #include "terminal_probe.h"
+#include "video_dirty.h"
 
 #include <stdlib.h>
 #include <string.h>
@@ -789,11 +790,15 @@ static void test_cli_apply_runtime_copies_app_owned_config_fields(AppCliFixture
     config.gamma = 1.75;
     config.color_enhance = COLOR_ENHANCE_VIVID;
     config.kitty_transfer = KITTY_TRANSFER_SHM;
+    config.kitty_compression = KITTY_COMPRESSION_NEVER;
+    config.video_dirty_threshold = 15;
     config.force_text = TRUE;
     config.force_sixel = FALSE;
     config.force_kitty = TRUE;
     config.force_iterm2 = FALSE;
     config.text_symbol_mode = TEXT_SYMBOL_MODE_QUARTER;
+    config.natural_sort = TRUE;
+    config.recursive_depth = 2;
 
     app.running = TRUE;
     app.video_scale = 2.0;
@@ -807,11 +812,15 @@ static void test_cli_apply_runtime_copies_app_owned_config_fields(AppCliFixture
     g_assert_cmpfloat_with_epsilon(app.gamma, 1.75, 0.0001);
     g_assert_cmpint(app.color_enhance, ==, COLOR_ENHANCE_VIVID);
     g_assert_cmpint(app.kitty_transfer, ==, KITTY_TRANSFER_SHM);
+    g_assert_cmpint(app.kitty_compression, ==, KITTY_COMPRESSION_NEVER);
+    g_assert_cmpint(app.video_dirty_threshold, ==, 15);
     g_assert_true(app.force_text);
     g_assert_false(app.force_sixel);
     g_assert_true(app.force_kitty);
     g_assert_false(app.force_iterm2);
     g_assert_cmpint(app.text_symbol_mode, ==, TEXT_SYMBOL_MODE_QUARTER);
+    g_assert_true(app.natural_sort);
+    g_assert_cmpint(app.recursive_depth, ==, 2);
     g_assert_true(app.running);
     g_assert_cmpfloat_with_epsilon(app.video_scale, 2.0, 0.0001);
 }
@@ -839,13 +848,16 @@ static void test_cli_default_config_applies_terminal_specific_precedence(AppCliF
         "protocol=kitty\n"
         "text_symbols=half\n"
         "kitty_transfer=shm\n"
-        "color_enhance=vivid\n");
+        "color_enhance=vivid\n"
+        "natural_sort=true\n"
+        "recursive=4\n");
 
     pixelterm_env_set_for_test("TERM_PROGRAM", "WarpTerminal");
 
     AppConfig config;
     gchar *path = NULL;
     app_config_init(&config);
+    g_assert_false(config.natural_sort);
 
     char *argv[] = {"pixelterm", NULL};
 
@@ -859,6 +871,8 @@ static void test_cli_default_config_applies_terminal_specific_precedence(AppCliF
     g_assert_cmpint(config.text_symbol_mode, ==, TEXT_SYMBOL_MODE_HALF);
     g_assert_cmpint(config.kitty_transfer, ==, KITTY_TRANSFER_SHM);
     g_assert_cmpint(config.color_enhance, ==, COLOR_ENHANCE_VIVID);
+    g_assert_true(config.natural_sort);
+    g_assert_cmpint(config.recursive_depth, ==, 4);
     g_assert_true(config.gamma_set);
     g_assert_cmpfloat_with_epsilon(config.gamma, 1.25, 0.0001);
     g_free(path);
@@ -1197,6 +1211,185 @@ static void test_cli_kitty_transfer_argument_rejects_unknown_mode(AppCliFixture
     g_free(stderr_output);
 }
 
+static void test_cli_kitty_compression_reads_config_and_argument(AppCliFixture *fixture,
+                                                                gconstpointer user_data) {
+    (void)fixture;
+    (void)user_data;
+
+    gchar *config_path = write_temp_config_file(
+        "[default]\n"
+        "kitty_compression=never\n");
+    AppConfig config;
+    gchar *path = NULL;
+    app_config_init(&config);
+    g_assert_cmpint(config.kitty_compression, ==, KITTY_COMPRESSION_AUTO);
+
+    char *config_argv[] = {"pixelterm", "--config", config_path, NULL};
+    g_assert_cmpint(parse_cli_args(config_argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpint(config.kitty_compression, ==, KITTY_COMPRESSION_NEVER);
+
+    // The command line wins over the file
+    app_config_init(&config);
+    char *argv[] = {"pixelterm", "--config", config_path, "--kitty-compression", "ALWAYS", NULL};
+    g_assert_cmpint(parse_cli_args(argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpint(config.kitty_compression, ==, KITTY_COMPRESSION_ALWAYS);
+    g_free(path);
+    g_free(config_path);
+
+    AppCliParseInvocation invocation = {0};
+    char *bad_argv[] = {"pixelterm", "--kitty-compression", "gzip", NULL};
+    path = NULL;
+    app_config_init(&config);
+    invocation.argv = bad_argv;
+    invocation.path_out = &path;
+    invocation.config = &config;
+
+    gchar *stderr_output = capture_stderr(invoke_parse_cli_args, &invocation);
+    g_assert_cmpint(invocation.error, ==, ERROR_INVALID_ARGS);
+    g_assert_null(path);
+    g_assert_cmpstr(stderr_output,
+                    ==,
+                    "Invalid --kitty-compression value: gzip (expected auto, always, or never)\n");
+    g_free(stderr_output);
+}
+
+static void test_cli_video_dirty_threshold_reads_config_and_argument(AppCliFixture *fixture,
+                                                                    gconstpointer user_data) {
+    (void)fixture;
+    (void)user_data;
+
+    gchar *config_path = write_temp_config_file(
+        "[default]\n"
+        "video_dirty_threshold=0\n");
+    AppConfig config;
+    gchar *path = NULL;
+    app_config_init(&config);
+    g_assert_cmpint(config.video_dirty_threshold, ==, VIDEO_DIRTY_DEFAULT_THRESHOLD);
+
+    char *config_argv[] = {"pixelterm", "--config", config_path, NULL};
+    g_assert_cmpint(parse_cli_args(config_argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpint(config.video_dirty_threshold, ==, 0);
+
+    app_config_init(&config);
+    char *argv[] = {"pixelterm", "--config", config_path, "--video-dirty-threshold", "75", NULL};
+    g_assert_cmpint(parse_cli_args(argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpint(config.video_dirty_threshold, ==, 75);
+    g_free(path);
+    g_free(config_path);
+
+    AppCliParseInvocation invocation = {0};
+    char *bad_argv[] = {"pixelterm", "--video-dirty-threshold", "101", NULL};
+    path = NULL;
+    app_config_init(&config);
+    invocation.argv = bad_argv;
+    invocation.path_out = &path;
+    invocation.config = &config;
+
+    gchar *stderr_output = capture_stderr(invoke_parse_cli_args, &invocation);
+    g_assert_cmpint(invocation.error, ==, ERROR_INVALID_ARGS);
+    g_assert_null(path);
+    g_assert_cmpstr(stderr_output,
+                    ==,
+                    "Invalid --video-dirty-threshold value: 101 (expected 0-100)\n");
+    g_free(stderr_output);
+}
+
+static void test_cli_trace_argument_takes_path(AppCliFixture *fixture,
+                                               gconstpointer user_data) {
+    (void)fixture;
+    (void)user_data;
+
+    AppConfig config;
+    gchar *path = NULL;
+    app_config_init(&config);
+    g_assert_null(config.trace_path);
+
+    char *argv[] = {"pixelterm", "--trace", "/tmp/first.json", "--trace=/tmp/trace.json", NULL};
+    g_assert_cmpint(parse_cli_args(argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpstr(config.trace_path, ==, "/tmp/trace.json");
+    g_free(config.trace_path);
+    g_free(path);
+
+    AppCliParseInvocation invocation = {0};
+    char *bad_argv[] = {"pixelterm", "--trace=", NULL};
+    path = NULL;
+    app_config_init(&config);
+    invocation.argv = bad_argv;
+    invocation.path_out = &path;
+    invocation.config = &config;
+
+    gchar *stderr_output = capture_stderr(invoke_parse_cli_args, &invocation);
+    g_assert_cmpint(invocation.error, ==, ERROR_INVALID_ARGS);
+    g_assert_null(config.trace_path);
+    g_assert_cmpstr(stderr_output, ==, "Invalid --trace value: (expected path)\n");
+    g_free(stderr_output);
+}
+
+static void test_cli_natural_sort_argument_parses_boolean(AppCliFixture *fixture,
+                                                         gconstpointer user_data) {
+    (void)fixture;
+    (void)user_data;
+
+    AppConfig config;
+    gchar *path = NULL;
+    AppCliParseInvocation invocation = {0};
+    app_config_init(&config);
+
+    char *argv[] = {"pixelterm", "--natural-sort", "on", "photos", NULL};
+
+    g_assert_cmpint(parse_cli_args(argv, &path, &config), ==, ERROR_NONE);
+    g_assert_true(config.natural_sort);
+    g_assert_cmpstr(path, ==, "photos");
+    g_clear_pointer(&path, g_free);
+
+    char *invalid_argv[] = {"pixelterm", "--natural-sort", "sometimes", NULL};
+
+    invocation.argv = invalid_argv;
+    invocation.path_out = &path;
+    invocation.config = &config;
+
+    gchar *stderr_output = capture_stderr(invoke_parse_cli_args, &invocation);
+
+    g_assert_cmpint(invocation.error, ==, ERROR_INVALID_ARGS);
+    g_assert_null(path);
+    g_assert_cmpstr(stderr_output,
+                    ==,
+                    "Invalid --natural-sort value: sometimes (expected true/false, yes/no, on/off, or 1/0)\n");
+    g_free(stderr_output);
+}
+
+static void test_cli_recursive_argument_parses_depth(AppCliFixture *fixture,
+                                                   gconstpointer user_data) {
+    (void)fixture;
+    (void)user_data;
+
+    AppConfig config;
+    gchar *path = NULL;
+    AppCliParseInvocation invocation = {0};
+    app_config_init(&config);
+    g_assert_cmpint(config.recursive_depth, ==, 0);
+
+    char *argv[] = {"pixelterm", "--recursive", "3", "photos", NULL};
+
+    g_assert_cmpint(parse_cli_args(argv, &path, &config), ==, ERROR_NONE);
+    g_assert_cmpint(config.recursive_depth, ==, 3);
+    g_assert_cmpstr(path, ==, "photos");
+    g_clear_pointer(&path, g_free);
+
+    char *invalid_argv[] = {"pixelterm", "--recursive", "65", NULL};
+
+    invocation.argv = invalid_argv;
+    invocation.path_out = &path;
+    invocation.config = &config;
+
+    gchar *stderr_output = capture_stderr(invoke_parse_cli_args, &invocation);
+
+    g_assert_cmpint(invocation.error, ==, ERROR_INVALID_ARGS);
+    g_assert_null(path);
+    g_assert_cmpstr(stderr_output, ==, "Invalid --recursive value: 65 (expected 0-64)\n");
+    g_free(stderr_output);
+}
+
 static void test_cli_color_enhance_argument_rejects_unknown_mode(AppCliFixture *fixture,
                                                                  gconstpointer user_data) {
     (void)fixture;
@@ -1607,6 +1800,15 @@ void register_app_cli_tests(void) {
                      test_cli_kitty_transfer_argument_parses_supported_modes);
     add_app_cli_test("/app_cli/parse/kitty_transfer_invalid",
                      test_cli_kitty_transfer_argument_rejects_unknown_mode);
+    add_app_cli_test("/app_cli/parse/kitty_compression",
+                     test_cli_kitty_compression_reads_config_and_argument);
+    add_app_cli_test("/app_cli/parse/video_dirty_threshold",
+                     test_cli_video_dirty_threshold_reads_config_and_argument);
+    add_app_cli_test("/app_cli/parse/trace", test_cli_trace_argument_takes_path);
+    add_app_cli_test("/app_cli/parse/natural_sort",
+                     test_cli_natural_sort_argument_parses_boolean);
+    add_app_cli_test("/app_cli/parse/recursive",
+                     test_cli_recursive_argument_parses_depth);
     add_app_cli_test("/app_cli/protocol_resolution/auto_prefers_affirmative_signal_before_generic_probe_order",
                      test_cli_protocol_resolution_auto_prefers_affirmative_signal_before_generic_probe_order);
     add_app_cli_test("/app_cli/protocol_resolution/auto_accepts_libghostty_xtversion_as_kitty_signal",
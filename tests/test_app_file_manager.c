@@ -12,7 +12,7 @@
 static const guint8 k_png_data[] = {
     0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A
 };
-static GList *g_browser_test_files = NULL;
+static MediaIndex *g_browser_test_files = NULL;
 
 typedef void (*RenderCaptureFunc)(gpointer user_data);
 
@@ -62,14 +62,14 @@ ErrorCode browser_scan_directory(FileBrowser *browser, const char *directory) {
     return ERROR_NONE;
 }
 
-GList *browser_get_all_files(const FileBrowser *browser) {
+const MediaIndex *browser_get_all_files(const FileBrowser *browser) {
     (void)browser;
     return g_browser_test_files;
 }
 
 gint browser_get_total_files(const FileBrowser *browser) {
     (void)browser;
-    return g_list_length(g_browser_test_files);
+    return media_index_length(g_browser_test_files);
 }
 
 BookDocument *book_open(const char *filepath, ErrorCode *out_error) {
@@ -89,6 +89,15 @@ gint book_get_page_count(const BookDocument *doc) {
     return 0;
 }
 
+BookPageCache *book_page_cache_create(BookDocument *doc) {
+    (void)doc;
+    return NULL;
+}
+
+void book_page_cache_destroy(BookPageCache *cache) {
+    (void)cache;
+}
+
 BookToc *book_load_toc(BookDocument *doc) {
     (void)doc;
     return NULL;
@@ -108,6 +117,24 @@ void app_preloader_reset(PixelTermApp *app) {
     (void)app;
 }
 
+void app_preloader_queue_directory(PixelTermApp *app) {
+    (void)app;
+}
+
+void app_preloader_invalidate(PixelTermApp *app, const char *filepath) {
+    (void)app;
+    (void)filepath;
+}
+
+void app_render_single_index_line(PixelTermApp *app) {
+    (void)app;
+}
+
+ErrorCode app_render_preview_grid(PixelTermApp *app) {
+    (void)app;
+    return ERROR_NONE;
+}
+
 void app_media_stop_inactive_players(PixelTermApp *app, MediaKind active_kind) {
     (void)app;
     (void)active_kind;
@@ -128,6 +155,16 @@ ErrorCode app_render_current_image(PixelTermApp *app) {
     return ERROR_NONE;
 }
 
+ErrorCode renderer_probe_media(const char *filepath, MediaMeta *out) {
+    (void)filepath;
+    out->kind = MEDIA_KIND_UNKNOWN;
+    out->width = 0;
+    out->height = 0;
+    out->animated = FALSE;
+    out->duration_ms = -1;
+    return ERROR_INVALID_IMAGE;
+}
+
 static void remove_dir_tree(gpointer data) {
     gchar *dir = data;
     if (!dir) {
@@ -205,7 +242,6 @@ static void init_file_manager_app(PixelTermApp *app, const gchar *directory, gin
     app->term_height = term_height;
     app->return_to_mode = RETURN_MODE_NONE;
     app->file_manager.directory = g_strdup(directory);
-    app->file_manager.selected_link_index = -1;
 }
 
 static void cleanup_file_manager_app(PixelTermApp *app) {
@@ -213,26 +249,22 @@ static void cleanup_file_manager_app(PixelTermApp *app) {
         return;
     }
 
-    if (app->file_manager.entries) {
-        g_list_free_full(app->file_manager.entries, (GDestroyNotify)g_free);
-        app->file_manager.entries = NULL;
-    }
+    g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
     g_clear_pointer(&app->file_manager.directory, g_free);
 }
 
 static void clear_browser_test_files(gpointer data) {
     (void)data;
-    g_list_free_full(g_browser_test_files, g_free);
-    g_browser_test_files = NULL;
+    g_clear_pointer(&g_browser_test_files, media_index_free);
 }
 
 static const gchar *selected_path(const PixelTermApp *app) {
-    if (!app || app->file_manager.selected_entry < 0) {
+    if (!app || !app->file_manager.entries || app->file_manager.selected_entry < 0 ||
+        (guint)app->file_manager.selected_entry >= app->file_manager.entries->len) {
         return NULL;
     }
 
-    GList *node = g_list_nth(app->file_manager.entries, app->file_manager.selected_entry);
-    return node ? (const gchar *)node->data : NULL;
+    return g_ptr_array_index(app->file_manager.entries, app->file_manager.selected_entry);
 }
 
 static void test_refresh_handles_empty_directory(void) {
@@ -374,7 +406,7 @@ static void test_refresh_failure_preserves_previous_directory_and_entries(void)
     gchar *missing_dir = g_build_filename(dir, "missing", NULL);
     PixelTermApp app = {0};
     gchar *old_directory = NULL;
-    GList *old_entries = NULL;
+    GPtrArray *old_entries = NULL;
     gint old_entries_count = 0;
 
     init_file_manager_app(&app, dir, 24);
@@ -440,8 +472,9 @@ static void test_toggle_hidden_clamps_selection_when_hidden_entry_disappears_aft
     app.show_hidden_files = TRUE;
     app.return_to_mode = RETURN_MODE_PREVIEW;
     app.current_directory = g_strdup(dir);
-    app.image_files = g_list_append(app.image_files, g_strdup(a_png));
-    app.image_files = g_list_append(app.image_files, g_strdup(b_png));
+    app.image_files = media_index_new(FALSE);
+    media_index_append(app.image_files, a_png);
+    media_index_append(app.image_files, b_png);
     app.total_images = 2;
     app.current_index = 0;
 
@@ -457,7 +490,7 @@ static void test_toggle_hidden_clamps_selection_when_hidden_entry_disappears_aft
     g_assert_cmpint(app.file_manager.selected_entry, ==, 2);
 
     cleanup_file_manager_app(&app);
-    g_list_free_full(app.image_files, g_free);
+    media_index_free(app.image_files);
     g_free(app.current_directory);
     g_free(a_png);
     g_free(b_png);
@@ -558,16 +591,19 @@ static void test_load_single_file_matches_full_canonical_path_before_basename(vo
 
     clear_browser_test_files(NULL);
     g_test_queue_destroy(clear_browser_test_files, NULL);
-    g_browser_test_files = g_list_append(g_browser_test_files, g_strdup(other_png));
-    g_browser_test_files = g_list_append(g_browser_test_files, g_strdup(target_png));
+    g_browser_test_files = media_index_new(FALSE);
+    media_index_append(g_browser_test_files, other_png);
+    media_index_append(g_browser_test_files, target_png);
 
     app.preload_enabled = FALSE;
-    app.preview.selected_link_index = -1;
 
     g_assert_cmpint(app_load_single_file(&app, target_png), ==, ERROR_NONE);
-    g_assert_cmpstr((const gchar *)g_list_nth_data(app.image_files, app.current_index), ==, target_png);
+    g_assert_cmpstr(media_index_get(app.image_files, app.current_index), ==, target_png);
 
-    g_list_free_full(app.image_files, g_free);
+    g_clear_pointer(&app.dir_loader, dir_loader_free);
+    g_clear_pointer(&app.dir_watch, dir_watch_free);
+    g_clear_pointer(&app.media_meta, media_meta_store_free);
+    media_index_free(app.image_files);
     g_free(app.current_directory);
     g_free(target_png);
     g_free(other_png);
@@ -575,6 +611,152 @@ static void test_load_single_file_matches_full_canonical_path_before_basename(vo
     g_free(other_dir);
 }
 
+static void test_apply_change_inserts_and_removes_in_place(void) {
+    gchar *dir = create_temp_dir();
+    gchar *sub = create_dir_in_dir(dir, "m_dir");
+    gchar *b_png = write_file_in_dir(dir, "b.png", k_png_data, sizeof(k_png_data));
+    gchar *d_png = write_file_in_dir(dir, "d.png", k_png_data, sizeof(k_png_data));
+    PixelTermApp app = {0};
+
+    init_file_manager_app(&app, dir, 24);
+    g_assert_cmpint(app_file_manager_refresh(&app), ==, ERROR_NONE);
+    g_assert_cmpint(app_file_manager_select_path(&app, d_png), ==, ERROR_NONE);
+    g_assert_cmpint(app.file_manager.directory_count, ==, 2);
+
+    // A new directory lands among directories, a new file among files
+    DirWatchEvent add_dir = {DIR_WATCH_EVENT_ADDED, "a_dir", TRUE};
+    DirWatchEvent add_file = {DIR_WATCH_EVENT_ADDED, "c.png", FALSE};
+    DirWatchEvent hidden = {DIR_WATCH_EVENT_ADDED, ".cache", TRUE};
+    g_assert_true(app_file_manager_apply_change(&app, &add_dir));
+    g_assert_true(app_file_manager_apply_change(&app, &add_file));
+    g_assert_true(app_file_manager_apply_change(&app, &add_file));
+    g_assert_false(app_file_manager_apply_change(&app, &hidden));
+    g_assert_cmpint(app.file_manager.entries_count, ==, 6);
+    g_assert_cmpint(app.file_manager.directory_count, ==, 3);
+    g_assert_cmpstr(selected_path(&app), ==, d_png);
+
+    const gchar *expected[] = {"..", "a_dir", "m_dir", "b.png", "c.png", "d.png"};
+    g_assert_cmpuint(app.file_manager.entries->len, ==, G_N_ELEMENTS(expected));
+    for (guint idx = 0; idx < app.file_manager.entries->len; idx++) {
+        gchar *base = g_path_get_basename(g_ptr_array_index(app.file_manager.entries, idx));
+        g_assert_cmpstr(base, ==, expected[idx]);
+        g_free(base);
+    }
+
+    // Removing the selected last entry moves the selection to the new last entry
+    DirWatchEvent remove_selected = {DIR_WATCH_EVENT_REMOVED, "d.png", FALSE};
+    DirWatchEvent remove_dir = {DIR_WATCH_EVENT_REMOVED, "a_dir", TRUE};
+    g_assert_true(app_file_manager_apply_change(&app, &remove_selected));
+    g_assert_true(app_file_manager_apply_change(&app, &remove_dir));
+    g_assert_false(app_file_manager_apply_change(&app, &remove_dir));
+    g_assert_cmpint(app.file_manager.entries_count, ==, 4);
+    g_assert_cmpint(app.file_manager.directory_count, ==, 2);
+    gchar *base = g_path_get_basename(selected_path(&app));
+    g_assert_cmpstr(base, ==, "c.png");
+    g_free(base);
+
+    cleanup_file_manager_app(&app);
+    g_free(sub);
+    g_free(b_png);
+    g_free(d_png);
+    g_free(dir);
+}
+
+static void test_directory_changes_update_image_list_and_keep_current(void) {
+    gchar *dir = create_temp_dir();
+    gchar *a_png = write_png_file_in_dir(dir, "a.png");
+    gchar *c_png = write_png_file_in_dir(dir, "c.png");
+    gchar *e_png = write_png_file_in_dir(dir, "e.png");
+    PixelTermApp app = {0};
+
+    app.mode = APP_MODE_SINGLE;
+    app.current_directory = g_canonicalize_filename(dir, NULL);
+    app.image_files = media_index_new(FALSE);
+    media_index_append(app.image_files, a_png);
+    media_index_append(app.image_files, c_png);
+    media_index_append(app.image_files, e_png);
+    app.total_images = 3;
+    app.current_index = 1;
+
+    app_process_directory_changes(&app);
+    g_assert_nonnull(app.dir_watch);
+    if (dir_watch_is_polling(app.dir_watch)) {
+        dir_watch_set_poll_interval(app.dir_watch, 0);
+    }
+
+    gchar *b_png = write_png_file_in_dir(dir, "b.png");
+    g_assert_cmpint(g_remove(a_png), ==, 0);
+    // inotify reports both changes at once; the polling fallback may need two passes
+    for (gint attempt = 0; attempt < 400; attempt++) {
+        app_process_directory_changes(&app);
+        if (app.total_images == 3 && g_strcmp0(media_index_get(app.image_files, 0), b_png) == 0) {
+            break;
+        }
+        g_usleep(5000);
+    }
+
+    g_assert_cmpint(app.total_images, ==, 3);
+    g_assert_cmpstr(media_index_get(app.image_files, 0), ==, b_png);
+    g_assert_cmpstr(app_get_current_filepath(&app), ==, c_png);
+    g_assert_cmpint(app.current_index, ==, 1);
+
+    g_clear_pointer(&app.dir_watch, dir_watch_free);
+    media_index_free(app.image_files);
+    g_free(app.current_directory);
+    g_free(a_png);
+    g_free(b_png);
+    g_free(c_png);
+    g_free(e_png);
+    g_free(dir);
+}
+
+static void test_directory_changes_during_scan_are_applied_after_it(void) {
+    gchar *dir = create_temp_dir();
+    gchar *a_png = write_png_file_in_dir(dir, "a.png");
+    gchar *shown_png = write_png_file_in_dir(dir, "shown.png");
+    PixelTermApp app = {0};
+
+    app.preload_enabled = FALSE;
+    g_assert_cmpint(app_load_single_file(&app, shown_png), ==, ERROR_NONE);
+    // The watch exists before the scan has been merged
+    g_assert_nonnull(app.dir_loader);
+    g_assert_nonnull(app.dir_watch);
+    if (dir_watch_is_polling(app.dir_watch)) {
+        dir_watch_set_poll_interval(app.dir_watch, 0);
+    }
+
+    // The scan may or may not list b.png as well; it must show up once either way
+    gchar *b_png = write_png_file_in_dir(dir, "b.png");
+    app_process_directory_changes(&app);
+    g_assert_cmpint(app.total_images, ==, 1);
+
+    for (gint attempt = 0; attempt < 400; attempt++) {
+        app_process_directory_loader(&app);
+        app_process_directory_changes(&app);
+        if (!app.dir_loader && app.total_images >= 3) {
+            break;
+        }
+        g_usleep(5000);
+    }
+
+    g_assert_null(app.dir_loader);
+    g_assert_cmpint(app.total_images, ==, 3);
+    g_assert_cmpstr(media_index_get(app.image_files, 0), ==, a_png);
+    g_assert_cmpstr(media_index_get(app.image_files, 1), ==, b_png);
+    g_assert_cmpstr(media_index_get(app.image_files, 2), ==, shown_png);
+    g_assert_cmpstr(app_get_current_filepath(&app), ==, shown_png);
+
+    g_clear_pointer(&app.dir_watch, dir_watch_free);
+    g_clear_pointer(&app.dir_watch_pending, dir_watch_events_free);
+    g_clear_pointer(&app.media_meta, media_meta_store_free);
+    media_index_free(app.image_files);
+    g_free(app.current_directory);
+    g_free(a_png);
+    g_free(b_png);
+    g_free(shown_png);
+    g_free(dir);
+}
+
 static void test_render_selected_row_uses_full_width_highlight_with_size(void) {
     gchar *dir = create_temp_dir();
     gchar *a_png = write_file_in_dir(dir, "a.png", k_png_data, sizeof(k_png_data));
@@ -650,6 +832,12 @@ int main(int argc, char **argv) {
                     test_enter_parent_entry_selects_directory_just_left);
     g_test_add_func("/app_core/load_single_file/matches_full_canonical_path_before_basename",
                     test_load_single_file_matches_full_canonical_path_before_basename);
+    g_test_add_func("/app_file_manager/apply_change/inserts_and_removes_in_place",
+                    test_apply_change_inserts_and_removes_in_place);
+    g_test_add_func("/app_core/directory_changes/update_image_list_and_keep_current",
+                    test_directory_changes_update_image_list_and_keep_current);
+    g_test_add_func("/app_core/directory_changes/during_scan_are_applied_after_it",
+                    test_directory_changes_during_scan_are_applied_after_it);
     g_test_add_func("/app_file_manager/render/selected_row_uses_full_width_highlight_with_size",
                     test_render_selected_row_uses_full_width_highlight_with_size);
     g_test_add_func("/app_file_manager/render/marks_directory_containing_media",
@@ -129,8 +129,9 @@ static void test_transition_common_round_trip_paths(void) {
 static void test_media_navigation_clears_overlays(void) {
     PixelTermApp app = {0};
     app.mode = APP_MODE_SINGLE;
-    app.image_files = g_list_append(app.image_files, g_strdup("one.png"));
-    app.image_files = g_list_append(app.image_files, g_strdup("two.png"));
+    app.image_files = media_index_new(FALSE);
+    media_index_append(app.image_files, "one.png");
+    media_index_append(app.image_files, "two.png");
     app.total_images = 2;
     app.current_index = 0;
     app.info_visible = TRUE;
@@ -148,7 +149,7 @@ static void test_media_navigation_clears_overlays(void) {
     g_assert_false(app.info_visible);
     g_assert_false(app.help_visible);
 
-    g_list_free_full(app.image_files, g_free);
+    media_index_free(app.image_files);
 }
 
 static void test_mode_transition_clears_overlays(void) {
@@ -10,6 +10,7 @@ typedef struct {
     gint create_grid_renderer_calls;
     gint grid_render_calls;
     gint renderer_initialize_calls;
+    gint visible_pages;
     gint term_width;
     gint term_height;
     gboolean last_force_text;
@@ -80,6 +81,9 @@ static void test_scroll_pages_persists_destination_page_after_render(void) {
     g_assert_cmpint(app.book.preview_scroll, ==, 3);
     g_assert_cmpint(g_book_preview_stub_state.create_grid_renderer_calls, ==, 1);
     g_assert_cmpint(g_book_preview_stub_state.grid_render_calls, ==, 1);
+    // Every page drawn stays interpreted for the next zoom step
+    g_assert_cmpint(g_book_preview_stub_state.visible_pages, >, 0);
+    g_assert_cmpint(g_book_preview_stub_state.visible_pages, <=, 10);
 
     cleanup_book_preview_app(&app);
 }
@@ -313,10 +317,106 @@ ErrorCode book_render_page(BookDocument *doc,
     return ERROR_NONE;
 }
 
+void book_set_visible_pages(BookDocument *doc, gint count) {
+    (void)doc;
+    g_book_preview_stub_state.visible_pages = count;
+}
+
+void book_get_thumbnail_size(gint target_cols, gint target_rows, gint *out_width, gint *out_height) {
+    if (out_width) *out_width = MAX(target_cols, 1);
+    if (out_height) *out_height = MAX(target_rows, 1);
+}
+
+ErrorCode book_render_thumbnails(BookDocument *doc,
+                                 const gint *page_indices,
+                                 gint count,
+                                 gint max_width,
+                                 gint max_height,
+                                 guint8 *pixels,
+                                 gint stride,
+                                 gint *out_widths,
+                                 gint *out_heights,
+                                 ErrorCode *out_errors) {
+    (void)doc;
+    (void)page_indices;
+    (void)pixels;
+    (void)stride;
+    for (gint i = 0; i < count; i++) {
+        out_widths[i] = max_width;
+        out_heights[i] = max_height;
+        out_errors[i] = ERROR_NONE;
+    }
+    return ERROR_NONE;
+}
+
 void book_page_image_free(BookPageImage *image) {
     (void)image;
 }
 
+ErrorCode book_page_cache_render_page(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      BookPageImage *out_image) {
+    (void)cache;
+    return book_render_page(NULL, page_index, target_cols, target_rows, out_image);
+}
+
+GString *book_page_cache_get_rendered(BookPageCache *cache,
+                                      gint page_index,
+                                      gint target_cols,
+                                      gint target_rows,
+                                      const RendererConfig *config,
+                                      gint *out_width,
+                                      gint *out_height,
+                                      gboolean *out_graphics_mode) {
+    (void)cache;
+    (void)page_index;
+    (void)target_cols;
+    (void)target_rows;
+    (void)config;
+    (void)out_width;
+    (void)out_height;
+    (void)out_graphics_mode;
+    return NULL;
+}
+
+void book_page_cache_store_rendered(BookPageCache *cache,
+                                    gint page_index,
+                                    gint target_cols,
+                                    gint target_rows,
+                                    const RendererConfig *config,
+                                    const GString *rendered,
+                                    gint rendered_width,
+                                    gint rendered_height,
+                                    gboolean graphics_mode) {
+    (void)cache;
+    (void)page_index;
+    (void)target_cols;
+    (void)target_rows;
+    (void)config;
+    (void)rendered;
+    (void)rendered_width;
+    (void)rendered_height;
+    (void)graphics_mode;
+}
+
+void book_page_cache_prefetch(BookPageCache *cache,
+                              gint page_index,
+                              gint span,
+                              gint direction,
+                              gint target_cols,
+                              gint target_rows,
+                              const RendererConfig *config) {
+    (void)cache;
+    (void)page_index;
+    (void)span;
+    (void)direction;
+    (void)target_cols;
+    (void)target_rows;
+    (void)config;
+}
+
 GString *renderer_render_image_data(ImageRenderer *renderer,
                                     const guint8 *pixel_data,
                                     gint width,
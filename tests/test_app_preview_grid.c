@@ -38,11 +38,12 @@ static void init_preview_app(PixelTermApp *app,
     app->term_width = term_width;
     app->term_height = term_height;
     app->preview.zoom = zoom;
-    app->preview.selected_link_index = -1;
 
+    app->image_files = media_index_new(FALSE);
     for (gint index = 0; index < total_images; index++) {
-        app->image_files = g_list_append(app->image_files,
-                                         g_strdup_printf("img-%d", index));
+        gchar *path = g_strdup_printf("img-%d", index);
+        media_index_append(app->image_files, path);
+        g_free(path);
     }
     app->total_images = total_images;
 
@@ -56,11 +57,8 @@ static void cleanup_preview_app(PixelTermApp *app) {
         return;
     }
 
-    g_list_free_full(app->image_files, g_free);
-    app->image_files = NULL;
+    g_clear_pointer(&app->image_files, media_index_free);
     app->total_images = 0;
-    app->preview.selected_link = NULL;
-    app->preview.selected_link_index = -1;
 }
 
 static gchar *capture_output(PreviewGridCaptureFunc draw_func, gpointer user_data) {
@@ -105,7 +103,7 @@ static void test_move_selection_normalizes_selection_and_scroll_before_moving(vo
     g_assert_cmpint(app_preview_move_selection(&app, -1, 0), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 4);
     g_assert_cmpint(app.preview.scroll, ==, 2);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 4);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-4");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-4");
 
     cleanup_preview_app(&app);
@@ -153,7 +151,7 @@ static void test_change_zoom_normalizes_invalid_selection_and_scroll_before_refr
     g_assert_cmpint(g_preview_grid_stub_state.create_grid_renderer_calls, ==, 1);
     g_assert_cmpint(app.preview.selected, ==, 6);
     g_assert_cmpint(app.preview.scroll, ==, 2);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 6);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-6");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-6");
 
     cleanup_preview_app(&app);
@@ -168,7 +166,7 @@ static void test_page_move_preserves_relative_row_and_column(void) {
     g_assert_cmpint(app_preview_page_move(&app, 1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 13);
     g_assert_cmpint(app.preview.scroll, ==, 2);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 13);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-13");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-13");
 
     cleanup_preview_app(&app);
@@ -186,7 +184,7 @@ static void test_page_move_round_trip_restores_selection_cache_state(void) {
     g_assert_cmpint(app_preview_page_move(&app, -1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 5);
     g_assert_cmpint(app.preview.scroll, ==, 0);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 5);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-5");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, initial_path);
 
     g_free(initial_path);
@@ -202,7 +200,7 @@ static void test_move_selection_advances_to_non_overlapping_last_page(void) {
     g_assert_cmpint(app_preview_move_selection(&app, 1, 0), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 7);
     g_assert_cmpint(app.preview.scroll, ==, 3);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 7);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
 
     cleanup_preview_app(&app);
@@ -217,7 +215,7 @@ static void test_page_move_keeps_last_page_non_overlapping(void) {
     g_assert_cmpint(app_preview_page_move(&app, 1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 9);
     g_assert_cmpint(app.preview.scroll, ==, 3);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 9);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-9");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-9");
 
     cleanup_preview_app(&app);
@@ -238,7 +236,7 @@ static void test_page_move_round_trip_restores_selection_on_short_last_page(void
     g_assert_cmpint(app_preview_page_move(&app, -1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 5);
     g_assert_cmpint(app.preview.scroll, ==, 0);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 5);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-5");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, initial_path);
 
     g_free(initial_path);
@@ -256,13 +254,13 @@ static void test_page_move_round_trip_restores_middle_row_on_short_last_page(voi
     g_assert_cmpint(app_preview_page_move(&app, 1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 7);
     g_assert_cmpint(app.preview.scroll, ==, 3);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 7);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
 
     g_assert_cmpint(app_preview_page_move(&app, -1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 3);
     g_assert_cmpint(app.preview.scroll, ==, 0);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 3);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-3");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, initial_path);
 
     g_free(initial_path);
@@ -278,13 +276,13 @@ static void test_page_move_clamps_top_slot_on_short_last_page_after_render(void)
     g_assert_cmpint(app_preview_page_move(&app, 1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 7);
     g_assert_cmpint(app.preview.scroll, ==, 3);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 7);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
 
     g_assert_cmpint(app_render_preview_grid(&app), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 7);
     g_assert_cmpint(app.preview.scroll, ==, 3);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 7);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-7");
 
     cleanup_preview_app(&app);
@@ -300,14 +298,14 @@ static void test_page_move_round_trip_uses_clamped_column_on_partial_final_row(v
     g_assert_cmpint(app_preview_page_move(&app, 1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 14);
     g_assert_cmpint(app.preview.scroll, ==, 2);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 14);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-14");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-14");
     clamped_path = g_strdup(app_preview_get_selected_filepath(&app));
 
     g_assert_cmpint(app_preview_page_move(&app, -1), ==, ERROR_NONE);
     g_assert_cmpint(app.preview.selected, ==, 6);
     g_assert_cmpint(app.preview.scroll, ==, 0);
-    g_assert_cmpint(app.preview.selected_link_index, ==, 6);
+    g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-6");
     g_assert_nonnull(clamped_path);
     g_assert_cmpstr(clamped_path, ==, "img-14");
     g_assert_cmpstr(app_preview_get_selected_filepath(&app), ==, "img-6");
@@ -408,12 +406,10 @@ void app_preview_draw_cell_border(const PixelTermApp *app,
 
 void app_preview_render_cells(const GridRenderContext *context,
                               PixelTermApp *app,
-                              ImageRenderer *renderer,
-                              GList *cursor) {
+                              ImageRenderer *renderer) {
     (void)context;
     (void)app;
     (void)renderer;
-    (void)cursor;
 }
 
 void app_preview_render_selected_filename(PixelTermApp *app) {
@@ -449,8 +445,14 @@ ErrorCode gif_player_stop(GifPlayer *player) {
     return ERROR_NONE;
 }
 
-gboolean is_valid_media_file(const char *filepath) {
+gboolean app_get_media_meta(const PixelTermApp *app, const gchar *filepath, MediaMeta *out) {
+    (void)app;
     (void)filepath;
+    out->kind = MEDIA_KIND_IMAGE;
+    out->width = 0;
+    out->height = 0;
+    out->animated = FALSE;
+    out->duration_ms = -1;
     return TRUE;
 }
 
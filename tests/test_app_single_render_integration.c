@@ -113,8 +113,7 @@ static void destroy_render_test_app(PixelTermApp *app) {
         return;
     }
 
-    g_list_free_full(app->image_files, g_free);
-    app->image_files = NULL;
+    g_clear_pointer(&app->image_files, media_index_free);
     app->total_images = 0;
     app->current_index = 0;
 
@@ -144,10 +143,11 @@ static gboolean init_render_test_app(PixelTermApp *app) {
         return FALSE;
     }
 
-    app->image_files = g_list_append(app->image_files, g_strdup("clip.mp4"));
-    app->image_files = g_list_append(app->image_files, g_strdup("anim.gif"));
-    app->image_files = g_list_append(app->image_files, g_strdup("still.png"));
-    app->total_images = g_list_length(app->image_files);
+    app->image_files = media_index_new(FALSE);
+    media_index_append(app->image_files, "clip.mp4");
+    media_index_append(app->image_files, "anim.gif");
+    media_index_append(app->image_files, "still.png");
+    app->total_images = media_index_length(app->image_files);
     app->current_index = 0;
     app->mode = APP_MODE_SINGLE;
     app->term_width = 120;
@@ -574,7 +574,7 @@ const gchar *app_get_current_filepath(const PixelTermApp *app) {
     if (!app) {
         return NULL;
     }
-    return g_list_nth_data(app->image_files, app->current_index);
+    return media_index_get(app->image_files, app->current_index);
 }
 
 gint app_get_current_index(const PixelTermApp *app) {
@@ -608,6 +608,13 @@ void app_preloader_update_terminal(PixelTermApp *app) {
     (void)app;
 }
 
+gboolean app_get_media_meta(const PixelTermApp *app, const gchar *filepath, MediaMeta *out) {
+    (void)app;
+    (void)filepath;
+    (void)out;
+    return FALSE;
+}
+
 ErrorCode app_render_book_page(PixelTermApp *app) {
     (void)app;
     g_input_dispatch_stub_state.book_page_render_calls++;
@@ -20,8 +20,14 @@ static void book_fallback_test_g_free(gpointer data) {
 #define book_close fallback_book_close
 #define book_get_path fallback_book_get_path
 #define book_get_page_count fallback_book_get_page_count
+#define book_set_visible_pages fallback_book_set_visible_pages
+#define book_page_loads_for_test fallback_book_page_loads_for_test
 #define book_render_page fallback_book_render_page
 #define book_page_image_free fallback_book_page_image_free
+#define book_get_thumbnail_size fallback_book_get_thumbnail_size
+#define book_render_thumbnail fallback_book_render_thumbnail
+#define book_render_thumbnails fallback_book_render_thumbnails
+#define book_thumbnail_cache_clear fallback_book_thumbnail_cache_clear
 #define book_load_toc fallback_book_load_toc
 #define book_toc_free fallback_book_toc_free
 #ifdef g_free
@@ -39,8 +45,14 @@ static void book_fallback_test_g_free(gpointer data) {
 #undef book_close
 #undef book_get_path
 #undef book_get_page_count
+#undef book_set_visible_pages
+#undef book_page_loads_for_test
 #undef book_render_page
 #undef book_page_image_free
+#undef book_get_thumbnail_size
+#undef book_render_thumbnail
+#undef book_render_thumbnails
+#undef book_thumbnail_cache_clear
 #undef book_load_toc
 #undef book_toc_free
 
@@ -192,6 +204,47 @@ static gchar *make_missing_temp_path(const gchar *suffix) {
     return path;
 }
 
+// Writes a PDF of @p pages square pages, each filled with one rectangle.
+static gchar *write_test_pdf(gint pages) {
+    GString *pdf = g_string_new("%PDF-1.4\n");
+    gint object_count = 2 + pages * 2;
+    gsize *offsets = g_new0(gsize, object_count + 1);
+
+    offsets[1] = pdf->len;
+    g_string_append(pdf, "1 0 obj\n<< /Type /Catalog /Pages 2 0 R >>\nendobj\n");
+    offsets[2] = pdf->len;
+    g_string_append_printf(pdf, "2 0 obj\n<< /Type /Pages /Count %d /Kids [", pages);
+    for (gint i = 0; i < pages; i++) {
+        g_string_append_printf(pdf, " %d 0 R", 3 + i * 2);
+    }
+    g_string_append(pdf, " ] >>\nendobj\n");
+    for (gint i = 0; i < pages; i++) {
+        static const gchar k_content[] = "0 0 1 rg 10 10 80 80 re f";
+        gint page_object = 3 + i * 2;
+        offsets[page_object] = pdf->len;
+        g_string_append_printf(pdf,
+                               "%d 0 obj\n<< /Type /Page /Parent 2 0 R /MediaBox [0 0 100 100]"
+                               " /Contents %d 0 R >>\nendobj\n",
+                               page_object, page_object + 1);
+        offsets[page_object + 1] = pdf->len;
+        g_string_append_printf(pdf, "%d 0 obj\n<< /Length %d >>\nstream\n%s\nendstream\nendobj\n",
+                               page_object + 1, (gint)strlen(k_content), k_content);
+    }
+
+    gsize xref_offset = pdf->len;
+    g_string_append_printf(pdf, "xref\n0 %d\n0000000000 65535 f \n", object_count + 1);
+    for (gint i = 1; i <= object_count; i++) {
+        g_string_append_printf(pdf, "%010lu 00000 n \n", (gulong)offsets[i]);
+    }
+    g_string_append_printf(pdf, "trailer\n<< /Size %d /Root 1 0 R >>\nstartxref\n%lu\n%%%%EOF\n",
+                           object_count + 1, (gulong)xref_offset);
+
+    gchar *path = write_temp_file(".pdf", (const guint8 *)pdf->str, pdf->len);
+    g_string_free(pdf, TRUE);
+    g_free(offsets);
+    return path;
+}
+
 static void test_book_open_rejects_null_path(void) {
     ErrorCode error = ERROR_NONE;
     BookDocument *doc = book_open(NULL, &error);
@@ -304,6 +357,94 @@ static void test_book_fallback_page_image_free_frees_pixels(void) {
     g_assert_cmpint(g_book_fallback_free_calls, ==, 1);
 }
 
+static void test_book_render_page_reuses_display_list_across_sizes(void) {
+    gchar *path = write_test_pdf(1);
+    ErrorCode error = ERROR_NONE;
+    BookDocument *doc = book_open(path, &error);
+    if (!doc) {
+        g_test_skip("built without MuPDF");
+        return;
+    }
+    BookPageImage image = {0};
+
+    g_assert_cmpint(book_render_page(doc, 0, 20, 10, &image), ==, ERROR_NONE);
+    gint first_width = image.width;
+    book_page_image_free(&image);
+    g_assert_cmpuint(book_page_loads_for_test(doc), ==, 1);
+
+    // A new size rasterizes the same list again without loading the page
+    g_assert_cmpint(book_render_page(doc, 0, 40, 20, &image), ==, ERROR_NONE);
+    g_assert_cmpint(image.width, >, first_width);
+    book_page_image_free(&image);
+    g_assert_cmpuint(book_page_loads_for_test(doc), ==, 1);
+
+    book_close(doc);
+}
+
+static void test_book_display_lists_cover_visible_pages(void) {
+    const gint visible = 24;
+    gchar *path = write_test_pdf(visible);
+    ErrorCode error = ERROR_NONE;
+    BookDocument *doc = book_open(path, &error);
+    if (!doc) {
+        g_test_skip("built without MuPDF");
+        return;
+    }
+    BookPageImage image = {0};
+
+    // A zoomed book preview draws every cell again at the new size
+    book_set_visible_pages(doc, visible);
+    for (gint i = 0; i < visible; i++) {
+        g_assert_cmpint(book_render_page(doc, i, 4, 2, &image), ==, ERROR_NONE);
+        book_page_image_free(&image);
+    }
+    for (gint i = 0; i < visible; i++) {
+        g_assert_cmpint(book_render_page(doc, i, 6, 3, &image), ==, ERROR_NONE);
+        book_page_image_free(&image);
+    }
+    g_assert_cmpuint(book_page_loads_for_test(doc), ==, (guint)visible);
+
+    // Fewer pages on screen shrink the cache back down
+    book_set_visible_pages(doc, 1);
+    g_assert_cmpint(book_render_page(doc, 0, 4, 2, &image), ==, ERROR_NONE);
+    book_page_image_free(&image);
+    g_assert_cmpuint(book_page_loads_for_test(doc), ==, (guint)visible + 1);
+
+    book_close(doc);
+}
+
+static void test_book_thumbnail_cache_round_trip(void) {
+    const gint src_stride = 8;
+    guint8 src[2 * 8] = {
+        1, 2, 3, 4, 5, 6, 0xEE, 0xEE,
+        7, 8, 9, 10, 11, 12, 0xEE, 0xEE
+    };
+    guint8 dst[2 * 6];
+    gint width = -1;
+    gint height = -1;
+
+    fallback_book_thumbnail_cache_clear();
+    g_assert_false(book_thumbnail_cache_lookup("/books/a.pdf", 10, 100, 3, 4, 4, dst, 6, &width, &height));
+
+    book_thumbnail_cache_store("/books/a.pdf", 10, 100, 3, 4, 4, src, src_stride, 2, 2);
+    memset(dst, 0, sizeof(dst));
+    g_assert_true(book_thumbnail_cache_lookup("/books/a.pdf", 10, 100, 3, 4, 4, dst, 6, &width, &height));
+    g_assert_cmpint(width, ==, 2);
+    g_assert_cmpint(height, ==, 2);
+    g_assert_cmpint(dst[0], ==, 1);
+    g_assert_cmpint(dst[5], ==, 6);
+    g_assert_cmpint(dst[6], ==, 7);
+    g_assert_cmpint(dst[11], ==, 12);
+
+    g_assert_false(book_thumbnail_cache_lookup("/books/a.pdf", 11, 100, 3, 4, 4, dst, 6, &width, &height));
+    g_assert_false(book_thumbnail_cache_lookup("/books/a.pdf", 10, 101, 3, 4, 4, dst, 6, &width, &height));
+    g_assert_false(book_thumbnail_cache_lookup("/books/a.pdf", 10, 100, 3, 5, 4, dst, 6, &width, &height));
+    g_assert_false(book_thumbnail_cache_lookup("/books/b.pdf", 10, 100, 3, 4, 4, dst, 6, &width, &height));
+
+    fallback_book_thumbnail_cache_clear();
+    g_assert_false(book_thumbnail_cache_lookup("/books/a.pdf", 10, 100, 3, 4, 4, dst, 6, &width, &height));
+}
+
 static void test_book_toc_limits_are_zero_based(void) {
     gint max_depth = book_toc_max_depth_for_test();
 
@@ -320,6 +461,12 @@ void register_book_tests(void) {
     g_test_add_func("/book/null_helpers_are_safe", test_book_null_helpers_are_safe);
     g_test_add_func("/book/fallback/page_image_free/frees_pixels",
                     test_book_fallback_page_image_free_frees_pixels);
+    g_test_add_func("/book/display_lists/reused_across_sizes",
+                    test_book_render_page_reuses_display_list_across_sizes);
+    g_test_add_func("/book/display_lists/cover_visible_pages",
+                    test_book_display_lists_cover_visible_pages);
+    g_test_add_func("/book/thumbnail_cache/round_trip",
+                    test_book_thumbnail_cache_round_trip);
     g_test_add_func("/book/toc/limits_are_zero_based",
                     test_book_toc_limits_are_zero_based);
     g_test_add_func("/book/page_image_free/resets_and_is_idempotent",
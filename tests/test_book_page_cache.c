@@ -0,0 +1,341 @@
+#include <glib.h>
+#include <string.h>
+
+#include "book_page_cache.h"
+
+/*
+ * These tests never queue prefetch work, so the worker never dereferences the
+ * document and an opaque placeholder is enough.
+ */
+static gint g_book_page_cache_test_doc_storage;
+
+static BookPageCache *create_test_cache(void) {
+    BookPageCache *cache = book_page_cache_create((BookDocument *)&g_book_page_cache_test_doc_storage);
+    g_assert_nonnull(cache);
+    return cache;
+}
+
+static RendererConfig make_test_config(gint width, gint height) {
+    RendererConfig config = {0};
+    config.max_width = width;
+    config.max_height = height;
+    config.preserve_aspect_ratio = TRUE;
+    config.work_factor = 9;
+    config.gamma = 1.0;
+    return config;
+}
+
+static void test_book_page_cache_create_rejects_null_document(void) {
+    g_assert_null(book_page_cache_create(NULL));
+    book_page_cache_destroy(NULL);
+}
+
+static void test_book_page_cache_rendered_round_trip_returns_copy(void) {
+    BookPageCache *cache = create_test_cache();
+    RendererConfig config = make_test_config(40, 20);
+
+    GString *rendered = g_string_new("page-3");
+    book_page_cache_store_rendered(cache, 3, 40, 20, &config, rendered, 30, 18, TRUE);
+    g_string_free(rendered, TRUE);
+
+    gint width = 0;
+    gint height = 0;
+    gboolean graphics_mode = FALSE;
+    GString *first = book_page_cache_get_rendered(cache, 3, 40, 20, &config,
+                                                  &width, &height, &graphics_mode);
+    g_assert_nonnull(first);
+    g_assert_cmpstr(first->str, ==, "page-3");
+    g_assert_cmpint(width, ==, 30);
+    g_assert_cmpint(height, ==, 18);
+    g_assert_true(graphics_mode);
+
+    g_string_assign(first, "caller-mutation");
+    GString *second = book_page_cache_get_rendered(cache, 3, 40, 20, &config, NULL, NULL, NULL);
+    g_assert_nonnull(second);
+    g_assert_cmpstr(second->str, ==, "page-3");
+
+    g_string_free(first, TRUE);
+    g_string_free(second, TRUE);
+    book_page_cache_destroy(cache);
+}
+
+static void test_book_page_cache_rendered_requires_matching_size_and_config(void) {
+    BookPageCache *cache = create_test_cache();
+    RendererConfig config = make_test_config(40, 20);
+
+    GString *rendered = g_string_new("page-1");
+    book_page_cache_store_rendered(cache, 1, 40, 20, &config, rendered, 40, 20, FALSE);
+    g_string_free(rendered, TRUE);
+
+    g_assert_null(book_page_cache_get_rendered(cache, 2, 40, 20, &config, NULL, NULL, NULL));
+    g_assert_null(book_page_cache_get_rendered(cache, 1, 41, 20, &config, NULL, NULL, NULL));
+
+    RendererConfig text_config = config;
+    text_config.force_text = TRUE;
+    g_assert_null(book_page_cache_get_rendered(cache, 1, 40, 20, &text_config, NULL, NULL, NULL));
+
+    book_page_cache_destroy(cache);
+}
+
+static void test_book_page_cache_evicts_least_recently_used_page(void) {
+    BookPageCache *cache = create_test_cache();
+    RendererConfig config = make_test_config(10, 5);
+
+    for (gint page = 0; page <= BOOK_PAGE_CACHE_MAX_ENTRIES; page++) {
+        GString *rendered = g_string_new("page");
+        book_page_cache_store_rendered(cache, page, 10, 5, &config, rendered, 10, 5, FALSE);
+        g_string_free(rendered, TRUE);
+        if (page == 0) {
+            continue;
+        }
+        // Keep page 1 hot so page 0 is the eviction victim.
+        GString *hot = book_page_cache_get_rendered(cache, 1, 10, 5, &config, NULL, NULL, NULL);
+        g_assert_nonnull(hot);
+        g_string_free(hot, TRUE);
+    }
+
+    g_assert_null(book_page_cache_get_rendered(cache, 0, 10, 5, &config, NULL, NULL, NULL));
+    GString *kept = book_page_cache_get_rendered(cache, 1, 10, 5, &config, NULL, NULL, NULL);
+    g_assert_nonnull(kept);
+    g_string_free(kept, TRUE);
+
+    book_page_cache_destroy(cache);
+}
+
+/*
+ * The worker tests below run a copy of the cache whose page renders are
+ * scripted: they record the order pages were asked for and can be held at a
+ * gate, so the prefetch worker can be observed without MuPDF or chafa.
+ */
+#define SCRIPTED_BOOK_PAGE_COUNT 10
+
+typedef struct {
+    GMutex mutex;
+    GCond cond;
+    gint order[16];
+    gint renders;
+    gint started_page;
+    gboolean gate_closed;
+} ScriptedBook;
+
+static ScriptedBook g_scripted_book;
+static gint g_scripted_renderer_storage;
+
+static void scripted_book_reset(gboolean gate_closed) {
+    g_mutex_lock(&g_scripted_book.mutex);
+    memset(g_scripted_book.order, 0, sizeof(g_scripted_book.order));
+    g_scripted_book.renders = 0;
+    g_scripted_book.started_page = -1;
+    g_scripted_book.gate_closed = gate_closed;
+    g_mutex_unlock(&g_scripted_book.mutex);
+}
+
+static gint scripted_book_get_page_count(const BookDocument *doc) {
+    (void)doc;
+    return SCRIPTED_BOOK_PAGE_COUNT;
+}
+
+static ErrorCode scripted_book_render_page(BookDocument *doc,
+                                           gint page_index,
+                                           gint target_cols,
+                                           gint target_rows,
+                                           BookPageImage *out_image) {
+    (void)doc;
+    (void)target_cols;
+    (void)target_rows;
+    g_mutex_lock(&g_scripted_book.mutex);
+    if (g_scripted_book.renders < (gint)G_N_ELEMENTS(g_scripted_book.order)) {
+        g_scripted_book.order[g_scripted_book.renders] = page_index;
+    }
+    g_scripted_book.renders++;
+    g_scripted_book.started_page = page_index;
+    g_cond_broadcast(&g_scripted_book.cond);
+    while (g_scripted_book.gate_closed) {
+        g_cond_wait(&g_scripted_book.cond, &g_scripted_book.mutex);
+    }
+    g_mutex_unlock(&g_scripted_book.mutex);
+
+    out_image->pixels = g_malloc0(4);
+    out_image->width = 1;
+    out_image->height = 1;
+    out_image->stride = 4;
+    out_image->channels = 4;
+    return ERROR_NONE;
+}
+
+static ImageRenderer *scripted_renderer_create(void) {
+    return (ImageRenderer *)&g_scripted_renderer_storage;
+}
+
+static void scripted_renderer_destroy(ImageRenderer *renderer) {
+    (void)renderer;
+}
+
+static ErrorCode scripted_renderer_initialize(ImageRenderer *renderer, const RendererConfig *config) {
+    (void)renderer;
+    (void)config;
+    return ERROR_NONE;
+}
+
+static GString *scripted_renderer_render_image_data(ImageRenderer *renderer,
+                                                    const guint8 *pixel_data,
+                                                    gint width,
+                                                    gint height,
+                                                    gint rowstride,
+                                                    gint n_channels) {
+    (void)renderer;
+    (void)pixel_data;
+    (void)rowstride;
+    (void)n_channels;
+    return g_string_new(width > 0 && height > 0 ? "page" : "");
+}
+
+static void scripted_renderer_get_rendered_dimensions(ImageRenderer *renderer, gint *width, gint *height) {
+    (void)renderer;
+    *width = 1;
+    *height = 1;
+}
+
+static gboolean scripted_renderer_is_graphics_mode(const ImageRenderer *renderer) {
+    (void)renderer;
+    return FALSE;
+}
+
+#define book_page_cache_create scripted_book_page_cache_create
+#define book_page_cache_destroy scripted_book_page_cache_destroy
+#define book_page_cache_render_page scripted_book_page_cache_render_page
+#define book_page_cache_get_rendered scripted_book_page_cache_get_rendered
+#define book_page_cache_store_rendered scripted_book_page_cache_store_rendered
+#define book_page_cache_prefetch scripted_book_page_cache_prefetch
+#define book_get_page_count scripted_book_get_page_count
+#define book_render_page scripted_book_render_page
+#define renderer_create scripted_renderer_create
+#define renderer_destroy scripted_renderer_destroy
+#define renderer_initialize scripted_renderer_initialize
+#define renderer_render_image_data scripted_renderer_render_image_data
+#define renderer_get_rendered_dimensions scripted_renderer_get_rendered_dimensions
+#define renderer_is_graphics_mode scripted_renderer_is_graphics_mode
+// The header is already included, so the renamed copy needs this prototype.
+void book_page_cache_destroy(BookPageCache *cache);
+#include "../src/book_page_cache.c"
+#undef book_page_cache_create
+#undef book_page_cache_destroy
+#undef book_page_cache_render_page
+#undef book_page_cache_get_rendered
+#undef book_page_cache_store_rendered
+#undef book_page_cache_prefetch
+#undef book_get_page_count
+#undef book_render_page
+#undef renderer_create
+#undef renderer_destroy
+#undef renderer_initialize
+#undef renderer_render_image_data
+#undef renderer_get_rendered_dimensions
+#undef renderer_is_graphics_mode
+
+static void scripted_book_wait(gint renders, gint started_page) {
+    gint64 deadline = g_get_monotonic_time() + 5 * G_TIME_SPAN_SECOND;
+    g_mutex_lock(&g_scripted_book.mutex);
+    while (g_scripted_book.renders < renders ||
+           (started_page >= 0 && g_scripted_book.started_page != started_page)) {
+        if (!g_cond_wait_until(&g_scripted_book.cond, &g_scripted_book.mutex, deadline)) {
+            break;
+        }
+    }
+    g_assert_cmpint(g_scripted_book.renders, >=, renders);
+    g_mutex_unlock(&g_scripted_book.mutex);
+}
+
+static gpointer scripted_book_open_gate_later(gpointer data) {
+    (void)data;
+    g_usleep(20000);
+    g_mutex_lock(&g_scripted_book.mutex);
+    g_scripted_book.gate_closed = FALSE;
+    g_cond_broadcast(&g_scripted_book.cond);
+    g_mutex_unlock(&g_scripted_book.mutex);
+    return NULL;
+}
+
+static void assert_prefetch_order(gint page_index, gint span, gint direction, const gint *expected, gint count) {
+    scripted_book_reset(FALSE);
+    BookPageCache *cache = scripted_book_page_cache_create((BookDocument *)&g_book_page_cache_test_doc_storage);
+    g_assert_nonnull(cache);
+    RendererConfig config = make_test_config(10, 5);
+
+    scripted_book_page_cache_prefetch(cache, page_index, span, direction, 10, 5, &config);
+    scripted_book_wait(count, -1);
+    scripted_book_page_cache_destroy(cache);
+
+    g_assert_cmpint(g_scripted_book.renders, ==, count);
+    for (gint i = 0; i < count; i++) {
+        g_assert_cmpint(g_scripted_book.order[i], ==, expected[i]);
+    }
+}
+
+static void test_book_page_cache_prefetch_follows_reading_order(void) {
+    const gint forward[] = {5, 6, 3};
+    assert_prefetch_order(4, 1, 1, forward, G_N_ELEMENTS(forward));
+    const gint backward[] = {3, 2, 5};
+    assert_prefetch_order(4, 1, -1, backward, G_N_ELEMENTS(backward));
+    const gint spread[] = {6, 7, 3};
+    assert_prefetch_order(4, 2, 1, spread, G_N_ELEMENTS(spread));
+    // Pages past either end are skipped
+    const gint last[] = {9, 7};
+    assert_prefetch_order(8, 1, 1, last, G_N_ELEMENTS(last));
+}
+
+static void test_book_page_cache_render_waits_for_in_flight_prefetch(void) {
+    scripted_book_reset(TRUE);
+    BookPageCache *cache = scripted_book_page_cache_create((BookDocument *)&g_book_page_cache_test_doc_storage);
+    g_assert_nonnull(cache);
+    RendererConfig config = make_test_config(10, 5);
+
+    scripted_book_page_cache_prefetch(cache, 4, 1, 1, 10, 5, &config);
+    scripted_book_wait(1, 5);
+    GThread *opener = g_thread_new("open-gate", scripted_book_open_gate_later, NULL);
+    BookPageImage image = {0};
+    g_assert_cmpint(scripted_book_page_cache_render_page(cache, 5, 10, 5, &image), ==, ERROR_NONE);
+    g_thread_join(opener);
+    g_assert_cmpint(image.width, ==, 1);
+    book_page_image_free(&image);
+
+    // The page being prefetched was waited for rather than rendered again
+    scripted_book_page_cache_destroy(cache);
+    gint page_5_renders = 0;
+    for (gint i = 0; i < g_scripted_book.renders; i++) {
+        page_5_renders += g_scripted_book.order[i] == 5;
+    }
+    g_assert_cmpint(page_5_renders, ==, 1);
+}
+
+static void test_book_page_cache_destroy_cancels_queued_prefetch(void) {
+    scripted_book_reset(TRUE);
+    BookPageCache *cache = scripted_book_page_cache_create((BookDocument *)&g_book_page_cache_test_doc_storage);
+    g_assert_nonnull(cache);
+    RendererConfig config = make_test_config(10, 5);
+
+    scripted_book_page_cache_prefetch(cache, 4, 1, 1, 10, 5, &config);
+    scripted_book_wait(1, 5);
+    GThread *opener = g_thread_new("open-gate", scripted_book_open_gate_later, NULL);
+    // Waits for the page in progress; the two queued behind it never start
+    scripted_book_page_cache_destroy(cache);
+    g_thread_join(opener);
+    g_assert_cmpint(g_scripted_book.renders, ==, 1);
+}
+
+void register_book_page_cache_tests(void) {
+    g_test_add_func("/book_page_cache/create/rejects_null_document",
+                    test_book_page_cache_create_rejects_null_document);
+    g_test_add_func("/book_page_cache/rendered/round_trip_returns_copy",
+                    test_book_page_cache_rendered_round_trip_returns_copy);
+    g_test_add_func("/book_page_cache/rendered/requires_matching_size_and_config",
+                    test_book_page_cache_rendered_requires_matching_size_and_config);
+    g_test_add_func("/book_page_cache/lru/evicts_least_recently_used_page",
+                    test_book_page_cache_evicts_least_recently_used_page);
+    g_test_add_func("/book_page_cache/prefetch/follows_reading_order",
+                    test_book_page_cache_prefetch_follows_reading_order);
+    g_test_add_func("/book_page_cache/prefetch/render_waits_for_in_flight",
+                    test_book_page_cache_render_waits_for_in_flight_prefetch);
+    g_test_add_func("/book_page_cache/prefetch/destroy_cancels_queued",
+                    test_book_page_cache_destroy_cancels_queued_prefetch);
+}
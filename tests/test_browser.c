@@ -65,21 +65,14 @@ static void test_browser_scan_directory_filters_and_sorts(void) {
     g_assert_cmpint(browser_scan_directory(browser, dir), ==, ERROR_NONE);
     g_assert_cmpint(browser_get_total_files(browser), ==, 3);
 
-    GList *files = browser_get_all_files(browser);
+    const MediaIndex *files = browser_get_all_files(browser);
     g_assert_nonnull(files);
-    g_assert_cmpint(g_list_length(files), ==, 3);
+    g_assert_cmpint(media_index_length(files), ==, 3);
 
-    gchar *first = g_path_get_basename(files->data);
-    gchar *second = g_path_get_basename(files->next->data);
-    gchar *third = g_path_get_basename(files->next->next->data);
-
-    g_assert_cmpstr(first, ==, "a.jpg");
-    g_assert_cmpstr(second, ==, "b.png");
-    g_assert_cmpstr(third, ==, "noext");
-
-    g_free(first);
-    g_free(second);
-    g_free(third);
+    g_assert_cmpstr(media_index_get_name(files, 0), ==, "a.jpg");
+    g_assert_cmpstr(media_index_get_name(files, 1), ==, "b.png");
+    g_assert_cmpstr(media_index_get_name(files, 2), ==, "noext");
+    g_assert_cmpint(media_index_find_name(files, "noext"), ==, 2);
 
     g_assert_cmpstr(browser_get_directory(browser), ==, dir);
     g_assert_cmpstr(browser_get_current_file(browser), ==, a_jpg);
@@ -131,6 +124,36 @@ static void test_browser_navigation_and_delete(void) {
     g_free(b_jpg);
 }
 
+static void test_browser_scan_directory_defers_validation(void) {
+    static const guint8 k_png[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    static const guint8 k_invalid[] = {0x00, 0x01, 0x02, 0x03};
+
+    gchar *dir = create_temp_dir();
+    gchar *b_png = write_file_in_dir(dir, "b.png", k_png, sizeof(k_png));
+    gchar *c_png = write_file_in_dir(dir, "c.png", k_invalid, sizeof(k_invalid));
+    gchar *noext = write_file_in_dir(dir, "noext", k_png, sizeof(k_png));
+    gchar *junk = write_file_in_dir(dir, "junk", k_invalid, sizeof(k_invalid));
+
+    FileBrowser *browser = browser_create();
+    g_assert_nonnull(browser);
+    g_assert_false(browser->defer_validation);
+    browser->defer_validation = TRUE;
+    g_assert_cmpint(browser_scan_directory(browser, dir), ==, ERROR_NONE);
+
+    // c.png is listed on its extension alone; extensionless files are still sniffed.
+    g_assert_cmpint(browser_get_total_files(browser), ==, 3);
+    const MediaIndex *files = browser_get_all_files(browser);
+    g_assert_cmpstr(media_index_get(files, 0), ==, b_png);
+    g_assert_cmpstr(media_index_get(files, 1), ==, c_png);
+    g_assert_cmpstr(media_index_get(files, 2), ==, noext);
+
+    browser_destroy(browser);
+    g_free(b_png);
+    g_free(c_png);
+    g_free(noext);
+    g_free(junk);
+}
+
 static void test_browser_reset(void) {
     static const guint8 k_png[] = {0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
 
@@ -155,6 +178,7 @@ static void test_browser_reset(void) {
 
 void register_browser_tests(void) {
     g_test_add_func("/browser/scan/filters_and_sorts", test_browser_scan_directory_filters_and_sorts);
+    g_test_add_func("/browser/scan/defers_validation", test_browser_scan_directory_defers_validation);
     g_test_add_func("/browser/navigation_and_delete", test_browser_navigation_and_delete);
     g_test_add_func("/browser/reset", test_browser_reset);
 }
@@ -1,5 +1,6 @@
 #include <glib.h>
 #include <glib/gstdio.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "common.h"
@@ -26,6 +27,23 @@ void register_kitty_graphics_tests(void);
 void register_app_cli_tests(void);
 void register_app_startup_tests(void);
 void register_book_tests(void);
+void register_book_page_cache_tests(void);
+void register_image_zoom_tests(void);
+void register_path_sort_tests(void);
+void register_media_index_tests(void);
+void register_media_meta_tests(void);
+void register_dir_scan_tests(void);
+void register_dir_loader_tests(void);
+void register_dir_watch_tests(void);
+void register_event_loop_tests(void);
+void register_term_output_tests(void);
+void register_kitty_registry_tests(void);
+void register_kitty_compress_tests(void);
+void register_kitty_animation_tests(void);
+void register_sixel_encoder_tests(void);
+void register_video_dirty_tests(void);
+void register_trace_tests(void);
+void register_perf_hud_tests(void);
 gboolean video_player_debug_should_log_for_test(const gchar *event);
 
 static void test_video_player_debug_filter_covers_logged_events(void) {
@@ -278,6 +296,26 @@ static void test_cleanup_helpers(void) {
     g_assert_null(value);
 }
 
+static void parallel_for_count(guint index, gpointer user_data) {
+    gint *hits = (gint *)user_data;
+    g_atomic_int_inc(&hits[index]);
+}
+
+static void test_parallel_for_visits_every_index_once(void) {
+    gint hits[64] = {0};
+    parallel_for(G_N_ELEMENTS(hits), 4, parallel_for_count, hits);
+    for (guint i = 0; i < G_N_ELEMENTS(hits); i++) {
+        g_assert_cmpint(hits[i], ==, 1);
+    }
+
+    // One thread runs in order on the caller; nothing to do is a no-op
+    memset(hits, 0, sizeof(hits));
+    parallel_for(3, 1, parallel_for_count, hits);
+    parallel_for(0, 4, parallel_for_count, hits);
+    g_assert_cmpint(hits[0] + hits[1] + hits[2], ==, 3);
+    g_assert_cmpint(hits[3], ==, 0);
+}
+
 static void test_error_code_to_string(void) {
     g_assert_cmpstr(error_code_to_string(ERROR_NONE), ==, "No error");
     g_assert_cmpstr(error_code_to_string(ERROR_INVALID_ARGS), ==, "Invalid arguments");
@@ -299,6 +337,7 @@ int main(int argc, char **argv) {
     g_test_add_func("/common/file_helpers", test_file_helpers);
     g_test_add_func("/common/cleanup_helpers", test_cleanup_helpers);
     g_test_add_func("/common/error_code_to_string", test_error_code_to_string);
+    g_test_add_func("/common/parallel_for", test_parallel_for_visits_every_index_once);
     g_test_add_func("/common/video_player_debug_filter_covers_logged_events",
                     test_video_player_debug_filter_covers_logged_events);
     register_browser_tests();
@@ -320,6 +359,23 @@ int main(int argc, char **argv) {
     register_app_cli_tests();
     register_app_startup_tests();
     register_book_tests();
+    register_book_page_cache_tests();
+    register_image_zoom_tests();
+    register_path_sort_tests();
+    register_media_index_tests();
+    register_media_meta_tests();
+    register_dir_scan_tests();
+    register_dir_loader_tests();
+    register_dir_watch_tests();
+    register_event_loop_tests();
+    register_term_output_tests();
+    register_kitty_registry_tests();
+    register_kitty_compress_tests();
+    register_kitty_animation_tests();
+    register_sixel_encoder_tests();
+    register_video_dirty_tests();
+    register_trace_tests();
+    register_perf_hud_tests();
     register_video_player_tests();
     register_app_media_session_tests();
     register_app_single_render_integration_tests();
@@ -0,0 +1,261 @@
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dir_loader.h"
+#include "path_sort.h"
+
+static const gchar k_png_data[] = {(gchar)0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Removes files, symlinks and nested directories below @p path.
+static void remove_tree(const gchar *path) {
+    if (g_remove(path) == 0) {
+        return;
+    }
+    GDir *handle = g_dir_open(path, 0, NULL);
+    if (handle) {
+        const gchar *name = NULL;
+        while ((name = g_dir_read_name(handle)) != NULL) {
+            gchar *child = g_build_filename(path, name, NULL);
+            remove_tree(child);
+            g_free(child);
+        }
+        g_dir_close(handle);
+    }
+    g_rmdir(path);
+}
+
+static void remove_dir_tree(gpointer data) {
+    gchar *dir = data;
+    remove_tree(dir);
+    g_free(dir);
+}
+
+static gchar *create_temp_dir(void) {
+    gchar *template = g_build_filename(g_get_tmp_dir(), "pixelterm-dir-loader-XXXXXX", NULL);
+    gchar *dir = g_mkdtemp(template);
+    g_assert_nonnull(dir);
+    g_test_queue_destroy(remove_dir_tree, dir);
+    return dir;
+}
+
+static void write_file(const gchar *dir, const gchar *name, const gchar *contents, gssize len) {
+    gchar *path = g_build_filename(dir, name, NULL);
+    g_assert_true(g_file_set_contents(path, contents, len, NULL));
+    g_free(path);
+}
+
+// Polls like the main loop does until the scan reports completion.
+static GList *take_all(DirLoader *loader) {
+    GList *all = NULL;
+    gboolean done = FALSE;
+    for (gint attempt = 0; attempt < 5000 && !done; attempt++) {
+        GList *batch = dir_loader_take(loader, &done);
+        if (batch) {
+            all = g_list_concat(all, batch);
+        } else if (!done) {
+            g_usleep(1000);
+        }
+    }
+    g_assert_true(done);
+    return all;
+}
+
+static void test_dir_loader_streams_media_and_skips_focus(void) {
+    gchar *dir = create_temp_dir();
+    write_file(dir, "b.png", k_png_data, sizeof(k_png_data));
+    write_file(dir, "a.jpg", "not really a jpeg", -1);
+    write_file(dir, "shown.png", k_png_data, sizeof(k_png_data));
+    write_file(dir, "noext", k_png_data, sizeof(k_png_data));
+    write_file(dir, "notes.txt", "text", -1);
+    gchar *subdir = g_build_filename(dir, "album.png", NULL);
+    g_assert_cmpint(g_mkdir(subdir, 0700), ==, 0);
+
+    DirLoader *loader = dir_loader_start(dir, "shown.png", FALSE, 0, NULL);
+    g_assert_nonnull(loader);
+    GList *files = take_all(loader);
+
+    // Extension matches are not opened; extensionless files are sniffed.
+    gchar *names[4] = {0};
+    guint count = 0;
+    for (GList *cur = files; cur && count < G_N_ELEMENTS(names); cur = cur->next) {
+        names[count++] = g_path_get_basename(cur->data);
+    }
+    g_assert_cmpuint(g_list_length(files), ==, 3);
+    g_assert_cmpstr(names[0], ==, "a.jpg");
+    g_assert_cmpstr(names[1], ==, "b.png");
+    g_assert_cmpstr(names[2], ==, "noext");
+
+    gboolean done = FALSE;
+    g_assert_null(dir_loader_take(loader, &done));
+    g_assert_true(done);
+
+    for (guint i = 0; i < count; i++) {
+        g_free(names[i]);
+    }
+    g_list_free_full(files, g_free);
+    dir_loader_free(loader);
+    g_rmdir(subdir);
+    g_free(subdir);
+}
+
+static void test_dir_loader_batches_large_directories_in_order(void) {
+    gchar *dir = create_temp_dir();
+    const guint total = DIR_LOADER_FIRST_BATCH * 3 + 7;
+    for (guint i = 0; i < total; i++) {
+        gchar *name = g_strdup_printf("img_%05u.png", i);
+        write_file(dir, name, k_png_data, sizeof(k_png_data));
+        g_free(name);
+    }
+
+    DirLoader *loader = dir_loader_start(dir, NULL, FALSE, 0, NULL);
+    g_assert_nonnull(loader);
+    GList *files = take_all(loader);
+
+    g_assert_cmpuint(g_list_length(files), ==, total);
+    // Batches arrive sorted; merge them the way the app does and check the order.
+    GList *merged = NULL;
+    GList *cur = files;
+    while (cur) {
+        GList *next = cur->next;
+        cur->next = NULL;
+        if (next) {
+            next->prev = NULL;
+        }
+        merged = path_sort_merge(merged, cur, FALSE);
+        cur = next;
+    }
+    guint idx = 0;
+    for (GList *link = merged; link; link = link->next, idx++) {
+        gchar *expected = g_strdup_printf("img_%05u.png", idx);
+        gchar *basename = g_path_get_basename(link->data);
+        g_assert_cmpstr(basename, ==, expected);
+        g_free(basename);
+        g_free(expected);
+    }
+    g_list_free_full(merged, g_free);
+    dir_loader_free(loader);
+}
+
+static void test_dir_loader_free_cancels_running_scan(void) {
+    gchar *dir = create_temp_dir();
+    for (guint i = 0; i < 64; i++) {
+        gchar *name = g_strdup_printf("frame_%02u.png", i);
+        write_file(dir, name, k_png_data, sizeof(k_png_data));
+        g_free(name);
+    }
+
+    DirLoader *loader = dir_loader_start(dir, NULL, TRUE, 0, NULL);
+    g_assert_nonnull(loader);
+    dir_loader_free(loader);
+    dir_loader_free(NULL);
+
+    gboolean done = TRUE;
+    g_assert_null(dir_loader_take(NULL, &done));
+    g_assert_false(done);
+}
+
+static gchar *make_subdir(const gchar *parent, const gchar *name) {
+    gchar *path = g_build_filename(parent, name, NULL);
+    g_assert_cmpint(g_mkdir(path, 0700), ==, 0);
+    return path;
+}
+
+static void test_dir_loader_recurses_to_depth_once_per_directory(void) {
+    gchar *dir = create_temp_dir();
+    write_file(dir, "top.png", k_png_data, sizeof(k_png_data));
+    gchar *a = make_subdir(dir, "a");
+    gchar *deep = make_subdir(a, "deep");
+    gchar *deeper = make_subdir(deep, "deeper");
+    gchar *b = make_subdir(dir, "b");
+    gchar *hidden = make_subdir(dir, ".thumbs");
+    write_file(a, "one.png", k_png_data, sizeof(k_png_data));
+    write_file(deep, "two.png", k_png_data, sizeof(k_png_data));
+    write_file(deeper, "three.png", k_png_data, sizeof(k_png_data));
+    write_file(b, "top.png", k_png_data, sizeof(k_png_data));
+    write_file(hidden, "cached.png", k_png_data, sizeof(k_png_data));
+    // A link back to the root would list everything again without the visited set
+    gchar *loop = g_build_filename(b, "loop", NULL);
+    g_assert_cmpint(symlink(dir, loop), ==, 0);
+
+    DirLoader *loader = dir_loader_start(dir, "top.png", FALSE, 2, NULL);
+    g_assert_nonnull(loader);
+    GList *files = path_sort_list_relative(take_all(loader), strlen(dir), FALSE);
+
+    // skip_name only applies to the top level; order follows the relative path
+    const gchar *expected[] = {"a/deep/two.png", "a/one.png", "b/top.png", NULL};
+    guint count = 0;
+    for (GList *cur = files; cur; cur = cur->next, count++) {
+        g_assert_nonnull(expected[count]);
+        gchar *expected_path = g_build_filename(dir, expected[count], NULL);
+        g_assert_cmpstr(cur->data, ==, expected_path);
+        g_free(expected_path);
+    }
+    g_assert_null(expected[count]);
+
+    g_list_free_full(files, g_free);
+    dir_loader_free(loader);
+    g_free(loop);
+    g_free(hidden);
+    g_free(b);
+    g_free(deeper);
+    g_free(deep);
+    g_free(a);
+}
+
+static void test_dir_loader_answers_sniff_from_media_meta(void) {
+    gchar *dir = create_temp_dir();
+    write_file(dir, "known-not-media", k_png_data, sizeof(k_png_data));
+    write_file(dir, "known-image", "plain text", -1);
+    write_file(dir, "changed", "plain text", -1);
+    write_file(dir, "fresh", "plain text", -1);
+
+    MediaMetaStore *store = media_meta_store_open_file(dir, NULL);
+    const MediaMeta not_media = {MEDIA_KIND_UNKNOWN, 0, 0, FALSE, -1};
+    const MediaMeta image = {MEDIA_KIND_IMAGE, 8, 8, FALSE, -1};
+    gchar *known_not_media = g_build_filename(dir, "known-not-media", NULL);
+    gchar *known_image = g_build_filename(dir, "known-image", NULL);
+    gchar *changed = g_build_filename(dir, "changed", NULL);
+    media_meta_store_put(store, known_not_media, &not_media);
+    media_meta_store_put(store, known_image, &image);
+    media_meta_store_put(store, changed, &not_media);
+    // A different size makes the record stale, so the file is sniffed again
+    write_file(dir, "changed", k_png_data, sizeof(k_png_data));
+
+    DirLoader *loader = dir_loader_start(dir, NULL, FALSE, 0, store);
+    g_assert_nonnull(loader);
+    // The loader works from its own copy
+    media_meta_store_free(store);
+    GList *files = path_sort_list_relative(take_all(loader), strlen(dir), FALSE);
+
+    // Recorded verdicts win over the content, which is not read
+    g_assert_cmpuint(g_list_length(files), ==, 2);
+    g_assert_cmpstr(files->data, ==, changed);
+    g_assert_cmpstr(files->next->data, ==, known_image);
+
+    // Only the file that was actually sniffed and rejected is reported
+    GList *rejected = dir_loader_take_rejected(loader);
+    g_assert_cmpuint(g_list_length(rejected), ==, 1);
+    g_assert_true(g_str_has_suffix(rejected->data, G_DIR_SEPARATOR_S "fresh"));
+    g_assert_null(dir_loader_take_rejected(loader));
+
+    g_list_free_full(rejected, g_free);
+    g_list_free_full(files, g_free);
+    dir_loader_free(loader);
+    g_free(changed);
+    g_free(known_image);
+    g_free(known_not_media);
+}
+
+void register_dir_loader_tests(void) {
+    g_test_add_func("/dir_loader/streams_media_and_skips_focus", test_dir_loader_streams_media_and_skips_focus);
+    g_test_add_func("/dir_loader/batches_large_directories_in_order",
+                    test_dir_loader_batches_large_directories_in_order);
+    g_test_add_func("/dir_loader/free_cancels_running_scan", test_dir_loader_free_cancels_running_scan);
+    g_test_add_func("/dir_loader/recurses_to_depth_once_per_directory",
+                    test_dir_loader_recurses_to_depth_once_per_directory);
+    g_test_add_func("/dir_loader/answers_sniff_from_media_meta", test_dir_loader_answers_sniff_from_media_meta);
+}
@@ -0,0 +1,131 @@
+#define _GNU_SOURCE
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <unistd.h>
+
+#include "dir_scan.h"
+
+typedef struct {
+    gchar *dir;
+} DirScanFixture;
+
+static void dir_scan_fixture_setup(DirScanFixture *fixture, gconstpointer user_data) {
+    (void)user_data;
+    gchar *template = g_build_filename(g_get_tmp_dir(), "pixelterm-dir-scan-XXXXXX", NULL);
+    fixture->dir = g_mkdtemp(template);
+    g_assert_nonnull(fixture->dir);
+}
+
+static void dir_scan_fixture_teardown(DirScanFixture *fixture, gconstpointer user_data) {
+    (void)user_data;
+    GDir *handle = g_dir_open(fixture->dir, 0, NULL);
+    if (handle) {
+        const gchar *name = NULL;
+        while ((name = g_dir_read_name(handle)) != NULL) {
+            gchar *path = g_build_filename(fixture->dir, name, NULL);
+            if (g_remove(path) != 0) {
+                g_rmdir(path);
+            }
+            g_free(path);
+        }
+        g_dir_close(handle);
+    }
+    g_rmdir(fixture->dir);
+    g_free(fixture->dir);
+}
+
+static gchar *write_file(const gchar *dir, const gchar *name, const gchar *contents, gssize len) {
+    gchar *path = g_build_filename(dir, name, NULL);
+    g_assert_true(g_file_set_contents(path, contents, len, NULL));
+    return path;
+}
+
+static const DirScanEntry *find_entry(GArray *entries, const gchar *name) {
+    for (guint i = 0; i < entries->len; i++) {
+        const DirScanEntry *entry = &g_array_index(entries, DirScanEntry, i);
+        if (g_strcmp0(entry->name, name) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void test_dir_scan_read_classifies_entries(DirScanFixture *fixture, gconstpointer user_data) {
+    (void)user_data;
+    g_free(write_file(fixture->dir, "photo.jpg", "x", 1));
+    gchar *subdir = g_build_filename(fixture->dir, "album", NULL);
+    g_assert_cmpint(g_mkdir(subdir, 0700), ==, 0);
+    gchar *file_link = g_build_filename(fixture->dir, "link.jpg", NULL);
+    gchar *dir_link = g_build_filename(fixture->dir, "album-link", NULL);
+    gchar *dangling = g_build_filename(fixture->dir, "dangling", NULL);
+    g_assert_cmpint(symlink("photo.jpg", file_link), ==, 0);
+    g_assert_cmpint(symlink("album", dir_link), ==, 0);
+    g_assert_cmpint(symlink("missing", dangling), ==, 0);
+
+    GArray *entries = NULL;
+    g_assert_cmpint(dir_scan_read(fixture->dir, &entries), ==, ERROR_NONE);
+    g_assert_nonnull(entries);
+    g_assert_cmpuint(entries->len, ==, 4);
+
+    g_assert_cmpint(find_entry(entries, "photo.jpg")->type, ==, DIR_SCAN_ENTRY_REGULAR);
+    g_assert_cmpint(find_entry(entries, "album")->type, ==, DIR_SCAN_ENTRY_DIRECTORY);
+    g_assert_cmpint(find_entry(entries, "link.jpg")->type, ==, DIR_SCAN_ENTRY_REGULAR);
+    g_assert_cmpint(find_entry(entries, "album-link")->type, ==, DIR_SCAN_ENTRY_DIRECTORY);
+    g_assert_null(find_entry(entries, "dangling"));
+    g_assert_null(find_entry(entries, "."));
+    g_assert_null(find_entry(entries, ".."));
+
+    dir_scan_entries_free(entries);
+    g_free(subdir);
+    g_free(file_link);
+    g_free(dir_link);
+    g_free(dangling);
+}
+
+static void test_dir_scan_read_rejects_missing_directory(DirScanFixture *fixture, gconstpointer user_data) {
+    (void)user_data;
+    gchar *missing = g_build_filename(fixture->dir, "missing", NULL);
+    GArray *entries = (GArray *)0x1;
+    g_assert_cmpint(dir_scan_read(missing, &entries), ==, ERROR_FILE_NOT_FOUND);
+    g_assert_null(entries);
+    dir_scan_entries_free(NULL);
+    g_free(missing);
+}
+
+static void test_dir_scan_sniff_media_batch(DirScanFixture *fixture, gconstpointer user_data) {
+    (void)user_data;
+    static const gchar k_png[] = {(gchar)0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A};
+    static const gchar k_mp4[] = {0, 0, 0, 0x18, 'f', 't', 'y', 'p', 'm', 'p', '4', '2'};
+
+    // Enough paths to take the thread pool path, alternating valid and invalid.
+    enum { COUNT = 12 };
+    gchar *paths[COUNT];
+    for (guint i = 0; i < COUNT; i++) {
+        gchar *name = g_strdup_printf("file%02u", i);
+        if (i % 3 == 0) {
+            paths[i] = write_file(fixture->dir, name, k_png, sizeof(k_png));
+        } else if (i % 3 == 1) {
+            paths[i] = write_file(fixture->dir, name, k_mp4, sizeof(k_mp4));
+        } else {
+            paths[i] = write_file(fixture->dir, name, "plain text", -1);
+        }
+        g_free(name);
+    }
+
+    gboolean valid[COUNT];
+    dir_scan_sniff_media((const gchar *const *)paths, COUNT, valid);
+    for (guint i = 0; i < COUNT; i++) {
+        g_assert_cmpint(valid[i], ==, i % 3 != 2);
+        g_free(paths[i]);
+    }
+}
+
+void register_dir_scan_tests(void) {
+    g_test_add("/dir_scan/read/classifies_entries", DirScanFixture, NULL,
+               dir_scan_fixture_setup, test_dir_scan_read_classifies_entries, dir_scan_fixture_teardown);
+    g_test_add("/dir_scan/read/rejects_missing_directory", DirScanFixture, NULL,
+               dir_scan_fixture_setup, test_dir_scan_read_rejects_missing_directory, dir_scan_fixture_teardown);
+    g_test_add("/dir_scan/sniff_media/batch", DirScanFixture, NULL,
+               dir_scan_fixture_setup, test_dir_scan_sniff_media_batch, dir_scan_fixture_teardown);
+}
@@ -0,0 +1,130 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+
+#include "dir_watch.h"
+
+static void remove_dir_tree(gpointer data) {
+    gchar *dir = data;
+    GDir *handle = g_dir_open(dir, 0, NULL);
+    if (handle) {
+        const gchar *name = NULL;
+        while ((name = g_dir_read_name(handle)) != NULL) {
+            gchar *path = g_build_filename(dir, name, NULL);
+            if (g_remove(path) != 0) {
+                g_rmdir(path);
+            }
+            g_free(path);
+        }
+        g_dir_close(handle);
+    }
+    g_rmdir(dir);
+    g_free(dir);
+}
+
+static gchar *create_temp_dir(void) {
+    gchar *template = g_build_filename(g_get_tmp_dir(), "pixelterm-dir-watch-XXXXXX", NULL);
+    gchar *dir = g_mkdtemp(template);
+    g_assert_nonnull(dir);
+    g_test_queue_destroy(remove_dir_tree, dir);
+    return dir;
+}
+
+static gchar *write_file(const gchar *dir, const gchar *name, const gchar *contents) {
+    gchar *path = g_build_filename(dir, name, NULL);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+    return path;
+}
+
+// Collects events until one of @p type for @p name shows up or time runs out.
+static gboolean wait_for_event(DirWatch *watch, DirWatchEventType type, const gchar *name, gboolean *out_is_dir) {
+    for (gint attempt = 0; attempt < 600; attempt++) {
+        GArray *events = dir_watch_take_events(watch);
+        gboolean found = FALSE;
+        for (guint i = 0; events && i < events->len && !found; i++) {
+            const DirWatchEvent *event = &g_array_index(events, DirWatchEvent, i);
+            if (event->type == type && g_strcmp0(event->name, name) == 0) {
+                found = TRUE;
+                if (out_is_dir) {
+                    *out_is_dir = event->is_directory;
+                }
+            }
+        }
+        dir_watch_events_free(events);
+        if (found) {
+            return TRUE;
+        }
+        g_usleep(5000);
+    }
+    return FALSE;
+}
+
+static void test_dir_watch_reports_changes(DirWatchBackend backend) {
+    gchar *dir = create_temp_dir();
+    gchar *existing = write_file(dir, "existing.png", "old");
+
+    DirWatch *watch = dir_watch_new(dir, backend);
+    g_assert_nonnull(watch);
+    g_assert_cmpstr(dir_watch_get_directory(watch), ==, dir);
+    if (backend == DIR_WATCH_BACKEND_POLL) {
+        g_assert_true(dir_watch_is_polling(watch));
+        g_assert_cmpint(dir_watch_get_fd(watch), ==, -1);
+    }
+    dir_watch_set_poll_interval(watch, 0);
+    g_assert_null(dir_watch_take_events(watch));
+
+    gboolean is_dir = TRUE;
+    gchar *added = write_file(dir, "new.png", "frame");
+    g_assert_true(wait_for_event(watch, DIR_WATCH_EVENT_ADDED, "new.png", &is_dir));
+    g_assert_false(is_dir);
+
+    gchar *subdir = g_build_filename(dir, "album", NULL);
+    g_assert_cmpint(g_mkdir(subdir, 0700), ==, 0);
+    g_assert_true(wait_for_event(watch, DIR_WATCH_EVENT_ADDED, "album", &is_dir));
+    g_assert_true(is_dir);
+
+    // Rewrite in place; the size changes so polling sees it with coarse timestamps
+    FILE *file = fopen(existing, "w");
+    g_assert_nonnull(file);
+    g_assert_cmpint(fputs("rewritten", file), >=, 0);
+    g_assert_cmpint(fclose(file), ==, 0);
+    g_assert_true(wait_for_event(watch, DIR_WATCH_EVENT_MODIFIED, "existing.png", NULL));
+
+    gchar *renamed = g_build_filename(dir, "renamed.png", NULL);
+    g_assert_cmpint(g_rename(added, renamed), ==, 0);
+    g_assert_true(wait_for_event(watch, DIR_WATCH_EVENT_ADDED, "renamed.png", NULL));
+
+    g_assert_cmpint(g_remove(renamed), ==, 0);
+    g_assert_true(wait_for_event(watch, DIR_WATCH_EVENT_REMOVED, "renamed.png", NULL));
+
+    dir_watch_free(watch);
+    dir_watch_free(NULL);
+    g_free(existing);
+    g_free(added);
+    g_free(renamed);
+    g_free(subdir);
+}
+
+static void test_dir_watch_auto_reports_changes(void) {
+    test_dir_watch_reports_changes(DIR_WATCH_BACKEND_AUTO);
+}
+
+static void test_dir_watch_poll_reports_changes(void) {
+    test_dir_watch_reports_changes(DIR_WATCH_BACKEND_POLL);
+}
+
+static void test_dir_watch_rejects_missing_directory(void) {
+    gchar *dir = create_temp_dir();
+    gchar *missing = g_build_filename(dir, "missing", NULL);
+    g_assert_null(dir_watch_new(missing, DIR_WATCH_BACKEND_AUTO));
+    g_assert_null(dir_watch_new(NULL, DIR_WATCH_BACKEND_POLL));
+    g_assert_null(dir_watch_take_events(NULL));
+    g_assert_cmpint(dir_watch_get_fd(NULL), ==, -1);
+    g_free(missing);
+}
+
+void register_dir_watch_tests(void) {
+    g_test_add_func("/dir_watch/auto/reports_changes", test_dir_watch_auto_reports_changes);
+    g_test_add_func("/dir_watch/poll/reports_changes", test_dir_watch_poll_reports_changes);
+    g_test_add_func("/dir_watch/rejects_missing_directory", test_dir_watch_rejects_missing_directory);
+}
@@ -0,0 +1,111 @@
+#include <glib.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "event_loop.h"
+
+typedef struct {
+    gint fds[2];
+    EventLoop *loop;
+} EventLoopFixture;
+
+static void event_loop_fixture_open(EventLoopFixture *fixture) {
+    g_assert_cmpint(pipe(fixture->fds), ==, 0);
+    fixture->loop = event_loop_new(fixture->fds[0]);
+    g_assert_nonnull(fixture->loop);
+}
+
+static void event_loop_fixture_close(EventLoopFixture *fixture) {
+    event_loop_free(fixture->loop);
+    close(fixture->fds[0]);
+    close(fixture->fds[1]);
+}
+
+static gboolean mark_fired(gpointer user_data) {
+    gboolean *fired = user_data;
+    *fired = TRUE;
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer wake_after_delay(gpointer user_data) {
+    (void)user_data;
+    g_usleep(20000);
+    event_loop_wake();
+    return NULL;
+}
+
+static void test_event_loop_reports_input(void) {
+    EventLoopFixture fixture;
+    event_loop_fixture_open(&fixture);
+
+    g_assert_cmpint(write(fixture.fds[1], "q", 1), ==, 1);
+    guint ready = event_loop_wait(fixture.loop, 1000);
+    g_assert_true(ready & EVENT_LOOP_READY_INPUT);
+
+    event_loop_fixture_close(&fixture);
+}
+
+static void test_event_loop_reports_signals(void) {
+    EventLoopFixture fixture;
+    event_loop_fixture_open(&fixture);
+
+    event_loop_notify_signal(SIGWINCH);
+    guint ready = event_loop_wait(fixture.loop, 1000);
+    g_assert_cmpuint(ready, ==, EVENT_LOOP_READY_RESIZE);
+
+    event_loop_notify_signal(SIGTERM);
+    event_loop_notify_signal(SIGWINCH);
+    ready = event_loop_wait(fixture.loop, 1000);
+    g_assert_cmpuint(ready, ==, EVENT_LOOP_READY_SIGNAL | EVENT_LOOP_READY_RESIZE);
+
+    event_loop_fixture_close(&fixture);
+    // Without a loop the notification is dropped
+    event_loop_notify_signal(SIGWINCH);
+}
+
+static void test_event_loop_times_out(void) {
+    EventLoopFixture fixture;
+    event_loop_fixture_open(&fixture);
+
+    gint64 start = g_get_monotonic_time();
+    g_assert_cmpuint(event_loop_wait(fixture.loop, 20), ==, EVENT_LOOP_READY_NONE);
+    g_assert_cmpint(g_get_monotonic_time() - start, >=, 15000);
+
+    event_loop_fixture_close(&fixture);
+}
+
+static void test_event_loop_dispatches_context_timers(void) {
+    EventLoopFixture fixture;
+    event_loop_fixture_open(&fixture);
+
+    gboolean fired = FALSE;
+    g_timeout_add(10, mark_fired, &fired);
+    gint64 start = g_get_monotonic_time();
+    while (!fired && g_get_monotonic_time() - start < G_USEC_PER_SEC) {
+        event_loop_wait(fixture.loop, -1);
+    }
+    g_assert_true(fired);
+
+    event_loop_fixture_close(&fixture);
+}
+
+static void test_event_loop_wakes_from_other_threads(void) {
+    EventLoopFixture fixture;
+    event_loop_fixture_open(&fixture);
+
+    gint64 start = g_get_monotonic_time();
+    GThread *thread = g_thread_new("event-loop-wake", wake_after_delay, NULL);
+    g_assert_cmpuint(event_loop_wait(fixture.loop, 5000), ==, EVENT_LOOP_READY_NONE);
+    g_assert_cmpint(g_get_monotonic_time() - start, <, 4 * G_USEC_PER_SEC);
+    g_thread_join(thread);
+
+    event_loop_fixture_close(&fixture);
+}
+
+void register_event_loop_tests(void) {
+    g_test_add_func("/event_loop/reports_input", test_event_loop_reports_input);
+    g_test_add_func("/event_loop/reports_signals", test_event_loop_reports_signals);
+    g_test_add_func("/event_loop/times_out", test_event_loop_times_out);
+    g_test_add_func("/event_loop/dispatches_context_timers", test_event_loop_dispatches_context_timers);
+    g_test_add_func("/event_loop/wakes_from_other_threads", test_event_loop_wakes_from_other_threads);
+}
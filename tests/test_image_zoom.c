@@ -0,0 +1,87 @@
+#include <glib.h>
+
+#include "image_zoom.h"
+
+// Solid-colour image: left half red, right half blue.
+static GdkPixbuf *create_split_pixbuf(gint width, gint height) {
+    GdkPixbuf *pixbuf = gdk_pixbuf_new(GDK_COLORSPACE_RGB, FALSE, 8, width, height);
+    g_assert_nonnull(pixbuf);
+    guint8 *pixels = gdk_pixbuf_get_pixels(pixbuf);
+    gint rowstride = gdk_pixbuf_get_rowstride(pixbuf);
+    for (gint y = 0; y < height; y++) {
+        for (gint x = 0; x < width; x++) {
+            guint8 *px = pixels + y * rowstride + x * 3;
+            gboolean left = x < width / 2;
+            px[0] = left ? 255 : 0;
+            px[1] = 0;
+            px[2] = left ? 0 : 255;
+        }
+    }
+    return pixbuf;
+}
+
+static void test_image_zoom_level_for_scale(void) {
+    g_assert_cmpint(image_zoom_level_for_scale(4.0), ==, 0);
+    g_assert_cmpint(image_zoom_level_for_scale(1.0), ==, 0);
+    g_assert_cmpint(image_zoom_level_for_scale(0.75), ==, 0);
+    g_assert_cmpint(image_zoom_level_for_scale(0.5), ==, 1);
+    g_assert_cmpint(image_zoom_level_for_scale(0.3), ==, 1);
+    g_assert_cmpint(image_zoom_level_for_scale(0.25), ==, 2);
+    g_assert_cmpint(image_zoom_level_for_scale(1e-12), ==, IMAGE_ZOOM_MAX_LEVELS - 1);
+    g_assert_cmpint(image_zoom_level_for_scale(0.0), ==, IMAGE_ZOOM_MAX_LEVELS - 1);
+}
+
+static void test_image_zoom_source_keeps_path_and_size(void) {
+    g_assert_null(image_zoom_source_new_from_pixbuf("/tmp/none.png", NULL));
+
+    GdkPixbuf *pixbuf = create_split_pixbuf(64, 32);
+    ImageZoomSource *source = image_zoom_source_new_from_pixbuf("/tmp/split.png", pixbuf);
+    g_object_unref(pixbuf);
+    g_assert_nonnull(source);
+
+    gint width = 0;
+    gint height = 0;
+    image_zoom_source_get_size(source, &width, &height);
+    g_assert_cmpint(width, ==, 64);
+    g_assert_cmpint(height, ==, 32);
+    g_assert_cmpstr(image_zoom_source_get_path(source), ==, "/tmp/split.png");
+
+    image_zoom_source_free(source);
+    image_zoom_source_free(NULL);
+}
+
+static void test_image_zoom_viewport_samples_requested_region(void) {
+    GdkPixbuf *pixbuf = create_split_pixbuf(64, 32);
+    ImageZoomSource *source = image_zoom_source_new_from_pixbuf("/tmp/split.png", pixbuf);
+    g_object_unref(pixbuf);
+
+    // At 4x the virtual image is 256x128; a viewport on the right edge is all blue.
+    GdkPixbuf *zoomed = image_zoom_source_render_viewport(source, 4.0, 200, 40, 40, 20);
+    g_assert_nonnull(zoomed);
+    g_assert_cmpint(gdk_pixbuf_get_width(zoomed), ==, 40);
+    g_assert_cmpint(gdk_pixbuf_get_height(zoomed), ==, 20);
+    const guint8 *px = gdk_pixbuf_get_pixels(zoomed);
+    g_assert_cmpint(px[0], ==, 0);
+    g_assert_cmpint(px[2], ==, 255);
+    g_object_unref(zoomed);
+
+    // Downscaled viewports come from a mip level and keep the left half red.
+    GdkPixbuf *reduced = image_zoom_source_render_viewport(source, 0.25, 0, 0, 4, 8);
+    g_assert_nonnull(reduced);
+    px = gdk_pixbuf_get_pixels(reduced);
+    g_assert_cmpint(px[0], ==, 255);
+    g_assert_cmpint(px[2], ==, 0);
+    g_object_unref(reduced);
+
+    g_assert_null(image_zoom_source_render_viewport(source, 1.0, 0, 0, 0, 10));
+    g_assert_null(image_zoom_source_render_viewport(NULL, 1.0, 0, 0, 10, 10));
+
+    image_zoom_source_free(source);
+}
+
+void register_image_zoom_tests(void) {
+    g_test_add_func("/image_zoom/level_for_scale", test_image_zoom_level_for_scale);
+    g_test_add_func("/image_zoom/source/keeps_path_and_size", test_image_zoom_source_keeps_path_and_size);
+    g_test_add_func("/image_zoom/viewport/samples_requested_region",
+                    test_image_zoom_viewport_samples_requested_region);
+}
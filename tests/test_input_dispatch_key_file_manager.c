@@ -30,10 +30,10 @@ static gchar *write_book_fixture(const gchar *dir) {
 static PixelTermApp make_file_manager_app(const gchar *selected_path) {
     PixelTermApp app = {0};
     app.mode = APP_MODE_FILE_MANAGER;
-    app.file_manager.entries = g_list_append(NULL, g_strdup(selected_path));
+    app.file_manager.entries = g_ptr_array_new_with_free_func(g_free);
+    g_ptr_array_add(app.file_manager.entries, g_strdup(selected_path));
     app.file_manager.entries_count = 1;
     app.file_manager.selected_entry = 0;
-    app.file_manager.selected_link_index = -1;
     app.file_manager.directory = g_path_get_dirname(selected_path);
     return app;
 }
@@ -42,18 +42,18 @@ static void cleanup_file_manager_app(PixelTermApp *app) {
     if (!app) {
         return;
     }
-    g_list_free_full(app->file_manager.entries, g_free);
+    g_clear_pointer(&app->file_manager.entries, g_ptr_array_unref);
     g_free(app->file_manager.directory);
 }
 
 static PixelTermApp make_file_manager_list_app(void) {
     PixelTermApp app = {0};
     app.mode = APP_MODE_FILE_MANAGER;
-    app.file_manager.entries = g_list_append(app.file_manager.entries, g_strdup("alpha.jpg"));
-    app.file_manager.entries = g_list_append(app.file_manager.entries, g_strdup("bravo.jpg"));
+    app.file_manager.entries = g_ptr_array_new_with_free_func(g_free);
+    g_ptr_array_add(app.file_manager.entries, g_strdup("alpha.jpg"));
+    g_ptr_array_add(app.file_manager.entries, g_strdup("bravo.jpg"));
     app.file_manager.entries_count = 2;
     app.file_manager.selected_entry = 1;
-    app.file_manager.selected_link_index = -1;
     app.file_manager.directory = g_strdup("/");
     return app;
 }
@@ -398,18 +398,18 @@ static void test_input_parses_sgr_mouse_press_with_terminator(void) {
 
 typedef struct {
     PixelTermApp *app;
-} ToggleVideoFpsCall;
+} TogglePerfHudCall;
 
-static void toggle_video_fps_capture(gpointer user_data) {
-    ToggleVideoFpsCall *call = (ToggleVideoFpsCall *)user_data;
+static void toggle_perf_hud_capture(gpointer user_data) {
+    TogglePerfHudCall *call = (TogglePerfHudCall *)user_data;
     g_assert_nonnull(call);
-    input_dispatch_key_modes_toggle_video_fps(call->app);
+    input_dispatch_key_modes_toggle_perf_hud(call->app);
 }
 
 static void test_video_fps_second_toggle_restores_stats_row(void) {
     VideoPlayer player = {0};
     PixelTermApp app = make_single_app(&player);
-    ToggleVideoFpsCall call = {.app = &app};
+    TogglePerfHudCall call = {.app = &app};
 
     app.term_height = 24;
     app.show_fps = TRUE;
@@ -423,10 +423,11 @@ static void test_video_fps_second_toggle_restores_stats_row(void) {
     input_dispatch_test_reset_stubs();
     g_input_dispatch_stub_state.current_is_video = TRUE;
 
-    gchar *output = capture_output(toggle_video_fps_capture, &call);
+    gchar *output = capture_output(toggle_perf_hud_capture, &call);
 
     g_assert_false(app.show_fps);
     g_assert_false(player.show_stats);
+    g_assert_cmpint(g_input_dispatch_stub_state.perf_hud_clear_calls, ==, 1);
     g_assert_nonnull(g_strstr_len(output, -1, "\033[3;1H\033[2K"));
     g_assert_null(g_strstr_len(output, -1, "\033[4;1H\033[2K"));
 
@@ -434,6 +435,27 @@ static void test_video_fps_second_toggle_restores_stats_row(void) {
     g_ptr_array_free(player.last_frame_lines, TRUE);
 }
 
+static void test_perf_hud_toggles_outside_video(void) {
+    PixelTermApp app = make_single_app(NULL);
+    app.mode = APP_MODE_BOOK;
+    app.term_height = 24;
+
+    input_dispatch_test_reset_stubs();
+    input_dispatch_key_modes_toggle_perf_hud(&app);
+    g_assert_true(app.show_fps);
+    g_assert_cmpint(g_input_dispatch_stub_state.perf_hud_render_calls, ==, 1);
+
+    input_dispatch_key_modes_toggle_perf_hud(&app);
+    g_assert_false(app.show_fps);
+    g_assert_cmpint(g_input_dispatch_stub_state.perf_hud_clear_calls, ==, 1);
+
+    // The file manager has no HUD
+    app.mode = APP_MODE_FILE_MANAGER;
+    input_dispatch_key_modes_toggle_perf_hud(&app);
+    g_assert_false(app.show_fps);
+    g_assert_cmpint(g_input_dispatch_stub_state.perf_hud_render_calls, ==, 1);
+}
+
 void register_input_dispatch_key_single_tests(void) {
     g_test_add_func("/input/eof/requests_exit", test_input_eof_requests_exit);
     g_test_add_func("/input/read_error/requests_exit",
@@ -456,6 +478,8 @@ void register_input_dispatch_key_single_tests(void) {
                     test_video_scale_keeps_paused_video_paused);
     g_test_add_func("/input_dispatch_key_single/video/fps_second_toggle_restores_stats_row",
                     test_video_fps_second_toggle_restores_stats_row);
+    g_test_add_func("/input_dispatch_key_single/perf_hud/toggles_outside_video",
+                    test_perf_hud_toggles_outside_video);
     g_test_add_func("/input_dispatch_key_single/navigation/failure_does_not_refresh_or_advance_queue",
                     test_navigation_failure_does_not_refresh_or_advance_queue);
     g_test_add_func("/input/input_maps_fullwidth_question_to_help_key",
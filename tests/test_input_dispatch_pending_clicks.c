@@ -49,9 +49,31 @@ static void test_preview_click_processes_new_pending_after_mode_round_trip(void)
     g_assert_cmpint(g_input_dispatch_stub_state.preview_selection_render_calls, ==, 0);
 }
 
+static void test_pending_clicks_timeout_tracks_earliest_click(void) {
+    PixelTermApp app = {0};
+
+    g_assert_cmpint(input_dispatch_pending_clicks_timeout_ms(&app), ==, -1);
+    g_assert_cmpint(input_dispatch_pending_clicks_timeout_ms(NULL), ==, -1);
+
+    app.input.single_click.pending = TRUE;
+    app.input.single_click.pending_time = g_get_monotonic_time();
+    gint timeout = input_dispatch_pending_clicks_timeout_ms(&app);
+    g_assert_cmpint(timeout, >, 300);
+    g_assert_cmpint(timeout, <=, 401);
+
+    app.input.preview_click.pending = TRUE;
+    app.input.preview_click.pending_time = g_get_monotonic_time() - 300000;
+    g_assert_cmpint(input_dispatch_pending_clicks_timeout_ms(&app), <=, 101);
+
+    app.input.preview_click.pending_time = g_get_monotonic_time() - 500000;
+    g_assert_cmpint(input_dispatch_pending_clicks_timeout_ms(&app), ==, 0);
+}
+
 void register_input_dispatch_pending_clicks_tests(void) {
     g_test_add_func("/input_dispatch_pending_clicks/preview_click/clears_when_mode_changes_without_hooks",
                     test_preview_click_clears_when_mode_changes_without_hooks);
     g_test_add_func("/input_dispatch_pending_clicks/preview_click/processes_new_pending_after_mode_round_trip",
                     test_preview_click_processes_new_pending_after_mode_round_trip);
+    g_test_add_func("/input_dispatch_pending_clicks/timeout_tracks_earliest_click",
+                    test_pending_clicks_timeout_tracks_earliest_click);
 }
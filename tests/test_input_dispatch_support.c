@@ -105,6 +105,17 @@ ErrorCode app_display_help(PixelTermApp *app) {
     return ERROR_NONE;
 }
 
+void app_render_perf_hud(PixelTermApp *app, gboolean force) {
+    (void)app;
+    (void)force;
+    g_input_dispatch_stub_state.perf_hud_render_calls++;
+}
+
+void app_clear_perf_hud(PixelTermApp *app) {
+    (void)app;
+    g_input_dispatch_stub_state.perf_hud_clear_calls++;
+}
+
 ErrorCode app_handle_mouse_click_book_preview(PixelTermApp *app,
                                               gint mouse_x,
                                               gint mouse_y,
@@ -0,0 +1,215 @@
+#include <glib.h>
+#include <string.h>
+
+#include "kitty_animation.h"
+
+#define TEST_WIDTH 4
+#define TEST_HEIGHT 2
+
+static void fill_frame(guint8 *pixels, gint width, gint height, guint8 value) {
+    for (gint i = 0; i < width * height; i++) {
+        pixels[i * 4] = value;
+        pixels[i * 4 + 1] = (guint8)(value + 1);
+        pixels[i * 4 + 2] = (guint8)(value + 2);
+        pixels[i * 4 + 3] = 255;
+    }
+}
+
+// Joins and decodes the payloads of every command in @p out.
+static guint8 *decode_payloads(const GString *out, gsize *out_len) {
+    GString *encoded = g_string_new(NULL);
+    const char *pos = out->str;
+    while ((pos = strstr(pos, "\033_G")) != NULL) {
+        const char *end = strstr(pos, "\033\\");
+        g_assert_nonnull(end);
+        const char *semicolon = memchr(pos, ';', (gsize)(end - pos));
+        if (semicolon) {
+            g_string_append_len(encoded, semicolon + 1, end - semicolon - 1);
+        }
+        pos = end + 2;
+    }
+    guint8 *decoded = g_base64_decode(encoded->str, out_len);
+    g_string_free(encoded, TRUE);
+    return decoded;
+}
+
+static void test_kitty_animation_first_frame_transmits_image(void) {
+    KittyAnimation *animation = kitty_animation_new(TEST_WIDTH, TEST_HEIGHT, 2, 1);
+    g_assert_nonnull(animation);
+    guint32 id = kitty_animation_get_id(animation);
+    g_assert_cmpuint(id, >, 0);
+
+    guint8 frame[TEST_WIDTH * TEST_HEIGHT * 4];
+    fill_frame(frame, TEST_WIDTH, TEST_HEIGHT, 10);
+    GString *out = g_string_new(NULL);
+    g_assert_true(kitty_animation_append_frame(animation, frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 100, out));
+    g_assert_cmpuint(kitty_animation_frame_count(animation), ==, 1);
+
+    gchar *header = g_strdup_printf("\033_Ga=T,i=%u,f=32,s=4,v=2,c=2,r=1,C=1,q=2;", id);
+    gchar *gap = g_strdup_printf("\033\\\033_Ga=a,i=%u,r=1,z=100,q=2\033\\", id);
+    g_assert_true(g_str_has_prefix(out->str, header));
+    g_assert_true(g_str_has_suffix(out->str, gap));
+
+    gsize len = 0;
+    guint8 *decoded = decode_payloads(out, &len);
+    g_assert_cmpmem(decoded, len, frame, sizeof(frame));
+
+    g_free(decoded);
+    g_free(header);
+    g_free(gap);
+    g_string_free(out, TRUE);
+    kitty_animation_free(animation);
+}
+
+static void test_kitty_animation_sends_changed_rectangle(void) {
+    KittyAnimation *animation = kitty_animation_new(TEST_WIDTH, TEST_HEIGHT, 2, 1);
+    guint32 id = kitty_animation_get_id(animation);
+    guint8 frame[TEST_WIDTH * TEST_HEIGHT * 4];
+    fill_frame(frame, TEST_WIDTH, TEST_HEIGHT, 10);
+    GString *out = g_string_new(NULL);
+    g_assert_true(kitty_animation_append_frame(animation, frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 100, out));
+
+    // One pixel at (2, 1) changes
+    guint8 *pixel = frame + (1 * TEST_WIDTH + 2) * 4;
+    pixel[0] = 200;
+    g_string_truncate(out, 0);
+    g_assert_true(kitty_animation_append_frame(animation, frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 50, out));
+    gchar *encoded = g_base64_encode(pixel, 4);
+    gchar *expected = g_strdup_printf("\033_Ga=f,i=%u,f=32,s=1,v=1,x=2,y=1,c=1,X=1,z=50,q=2;%s\033\\", id, encoded);
+    g_assert_cmpstr(out->str, ==, expected);
+    g_free(expected);
+    g_free(encoded);
+
+    // The same frame again lengthens frame 2
+    g_string_truncate(out, 0);
+    g_assert_true(kitty_animation_append_frame(animation, frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 30, out));
+    expected = g_strdup_printf("\033_Ga=a,i=%u,r=2,z=80,q=2\033\\", id);
+    g_assert_cmpstr(out->str, ==, expected);
+    g_free(expected);
+
+    // A frame changing everywhere is sent whole
+    fill_frame(frame, TEST_WIDTH, TEST_HEIGHT, 90);
+    g_string_truncate(out, 0);
+    g_assert_true(kitty_animation_append_frame(animation, frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 40, out));
+    gchar *header = g_strdup_printf("\033_Ga=f,i=%u,f=32,s=4,v=2,z=40,q=2;", id);
+    g_assert_true(g_str_has_prefix(out->str, header));
+    g_free(header);
+    g_assert_cmpuint(kitty_animation_frame_count(animation), ==, 4);
+
+    g_string_free(out, TRUE);
+    kitty_animation_free(animation);
+}
+
+static void test_kitty_animation_scales_and_chunks_frames(void) {
+    const gint source_width = 128;
+    const gint source_height = 96;
+    KittyAnimation *animation = kitty_animation_new(64, 48, 8, 3);
+    g_assert_true(kitty_animation_matches(animation, 64, 48, 8, 3));
+    g_assert_false(kitty_animation_matches(animation, 64, 48, 8, 4));
+
+    guint8 *source = g_malloc((gsize)source_width * source_height * 4);
+    fill_frame(source, source_width, source_height, 60);
+    GString *out = g_string_new(NULL);
+    g_assert_true(kitty_animation_append_frame(animation, source, source_width, source_height, source_width * 4, 100,
+                                               out));
+
+    g_assert_true(g_str_has_prefix(out->str, "\033_Ga=T,"));
+    g_assert_nonnull(strstr(out->str, ",m=1;"));
+    g_assert_nonnull(strstr(out->str, "\033_Gm=0;"));
+
+    gsize len = 0;
+    guint8 *decoded = decode_payloads(out, &len);
+    g_assert_cmpuint(len, ==, 64 * 48 * 4);
+    guint8 *expected = g_malloc(len);
+    fill_frame(expected, 64, 48, 60);
+    g_assert_cmpmem(decoded, len, expected, len);
+
+    g_assert_false(kitty_animation_append_frame(animation, NULL, source_width, source_height, source_width * 4, 100,
+                                                out));
+    g_assert_false(kitty_animation_append_frame(animation, source, source_width, source_height, 3, 100, out));
+
+    g_free(expected);
+    g_free(decoded);
+    g_free(source);
+    g_string_free(out, TRUE);
+    kitty_animation_free(animation);
+}
+
+static void test_kitty_animation_control_commands(void) {
+    g_assert_null(kitty_animation_new(0, 2, 1, 1));
+    KittyAnimation *animation = kitty_animation_new(TEST_WIDTH, TEST_HEIGHT, 2, 1);
+    guint32 id = kitty_animation_get_id(animation);
+    GString *out = g_string_new(NULL);
+
+    kitty_animation_append_place(animation, out);
+    kitty_animation_append_state(animation, KITTY_ANIMATION_LOADING, 0, out);
+    kitty_animation_append_state(animation, KITTY_ANIMATION_RUNNING, 3, out);
+    kitty_animation_append_state(animation, KITTY_ANIMATION_STOPPED, 3, out);
+    kitty_animation_append_delete(animation, out);
+
+    gchar *expected = g_strdup_printf("\033_Ga=p,i=%u,c=2,r=1,C=1,q=2\033\\"
+                                      "\033_Ga=a,i=%u,s=2,v=1,q=2\033\\"
+                                      "\033_Ga=a,i=%u,s=3,v=4,q=2\033\\"
+                                      "\033_Ga=a,i=%u,s=1,q=2\033\\"
+                                      "\033_Ga=d,d=I,i=%u,q=2\033\\",
+                                      id, id, id, id, id);
+    g_assert_cmpstr(out->str, ==, expected);
+
+    KittyAnimation *other = kitty_animation_new(TEST_WIDTH, TEST_HEIGHT, 2, 1);
+    g_assert_cmpuint(kitty_animation_get_id(other), !=, id);
+
+    g_free(expected);
+    g_string_free(out, TRUE);
+    kitty_animation_free(other);
+    kitty_animation_free(animation);
+}
+
+static void test_kitty_animation_find_loop(void) {
+    gint frames = -1;
+    gint loops = -1;
+
+    // A B C A B C: endless three-frame loop
+    const guint64 endless[] = {1, 2, 3, 1, 2, 3};
+    g_assert_false(kitty_animation_find_loop(endless, 4, FALSE, &frames, &loops));
+    g_assert_true(kitty_animation_find_loop(endless, 6, FALSE, &frames, &loops));
+    g_assert_cmpint(frames, ==, 3);
+    g_assert_cmpint(loops, ==, 0);
+
+    // A first frame shown again mid-loop is not a loop
+    const guint64 blink[] = {1, 2, 1, 3, 1, 2, 1, 3};
+    g_assert_false(kitty_animation_find_loop(blink, 5, FALSE, &frames, &loops));
+    g_assert_true(kitty_animation_find_loop(blink, 8, FALSE, &frames, &loops));
+    g_assert_cmpint(frames, ==, 4);
+
+    // Played twice, then stopped
+    g_assert_true(kitty_animation_find_loop(endless, 6, TRUE, &frames, &loops));
+    g_assert_cmpint(frames, ==, 3);
+    g_assert_cmpint(loops, ==, 2);
+
+    // Played once
+    g_assert_true(kitty_animation_find_loop(blink, 5, TRUE, &frames, &loops));
+    g_assert_cmpint(frames, ==, 5);
+    g_assert_cmpint(loops, ==, 1);
+
+    g_assert_false(kitty_animation_find_loop(endless, 0, TRUE, &frames, &loops));
+}
+
+static void test_kitty_animation_hash_frame(void) {
+    guint8 frame[TEST_WIDTH * TEST_HEIGHT * 4];
+    fill_frame(frame, TEST_WIDTH, TEST_HEIGHT, 10);
+    guint64 hash = kitty_animation_hash_frame(frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 4, 100);
+
+    g_assert_cmpuint(hash, ==, kitty_animation_hash_frame(frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 4, 100));
+    g_assert_cmpuint(hash, !=, kitty_animation_hash_frame(frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 4, 90));
+    frame[sizeof(frame) - 2] ^= 1;
+    g_assert_cmpuint(hash, !=, kitty_animation_hash_frame(frame, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4, 4, 100));
+}
+
+void register_kitty_animation_tests(void) {
+    g_test_add_func("/kitty_animation/frame/first_transmits_image", test_kitty_animation_first_frame_transmits_image);
+    g_test_add_func("/kitty_animation/frame/sends_changed_rectangle", test_kitty_animation_sends_changed_rectangle);
+    g_test_add_func("/kitty_animation/frame/scales_and_chunks", test_kitty_animation_scales_and_chunks_frames);
+    g_test_add_func("/kitty_animation/control_commands", test_kitty_animation_control_commands);
+    g_test_add_func("/kitty_animation/find_loop", test_kitty_animation_find_loop);
+    g_test_add_func("/kitty_animation/hash_frame", test_kitty_animation_hash_frame);
+}
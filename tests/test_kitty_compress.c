@@ -0,0 +1,167 @@
+#include <glib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include "kitty_compress.h"
+#include "process_env.h"
+
+#define TEST_WIDTH 128
+#define TEST_HEIGHT 96
+#define TEST_RAW_BYTES (TEST_WIDTH * TEST_HEIGHT * 4)
+
+// Shaped like Chafa's output: cursor setup, a header without data, chunks
+// of at most 4096 base64 bytes, an end chunk and a trailing reset.
+static GString *make_rendered(guint8 **out_pixels) {
+    guint8 *pixels = g_malloc(TEST_RAW_BYTES);
+    for (gint i = 0; i < TEST_RAW_BYTES; i += 4) {
+        pixels[i] = (guint8)((i / 4) % TEST_WIDTH);
+        pixels[i + 1] = 40;
+        pixels[i + 2] = (guint8)((i / 4) / TEST_WIDTH);
+        pixels[i + 3] = 255;
+    }
+    gchar *encoded = g_base64_encode(pixels, TEST_RAW_BYTES);
+    gsize encoded_len = strlen(encoded);
+
+    GString *rendered = g_string_new("\033[?25l");
+    g_string_append_printf(rendered, "\033_Ga=T,f=32,s=%d,v=%d,c=8,r=3,m=1\033\\", TEST_WIDTH, TEST_HEIGHT);
+    for (gsize offset = 0; offset < encoded_len; offset += 4096) {
+        g_string_append(rendered, "\033_Gm=1;");
+        g_string_append_len(rendered, encoded + offset, (gssize)MIN((gsize)4096, encoded_len - offset));
+        g_string_append(rendered, "\033\\");
+    }
+    g_string_append(rendered, "\033_Gm=0;\033\\\033[0m");
+    g_free(encoded);
+    *out_pixels = pixels;
+    return rendered;
+}
+
+// Joins the payloads of a chunked transmit and inflates them.
+static guint8 *inflate_transmit(const GString *packed, gsize expected_len) {
+    GString *encoded = g_string_new(NULL);
+    const char *pos = packed->str;
+    while ((pos = strstr(pos, "\033_G")) != NULL) {
+        const char *end = strstr(pos, "\033\\");
+        const char *semicolon = memchr(pos, ';', (gsize)(end - pos));
+        if (semicolon) {
+            g_string_append_len(encoded, semicolon + 1, end - semicolon - 1);
+        }
+        pos = end + 2;
+    }
+    gsize packed_len = 0;
+    guchar *deflated = g_base64_decode(encoded->str, &packed_len);
+    g_string_free(encoded, TRUE);
+
+    guint8 *raw = g_malloc(expected_len);
+    uLongf raw_len = expected_len;
+    g_assert_cmpint(uncompress(raw, &raw_len, deflated, packed_len), ==, Z_OK);
+    g_assert_cmpuint(raw_len, ==, expected_len);
+    g_free(deflated);
+    return raw;
+}
+
+static void test_kitty_compress_transmit_round_trips(void) {
+    guint8 *pixels = NULL;
+    GString *rendered = make_rendered(&pixels);
+
+    gsize raw_bytes = 0;
+    GString *packed = kitty_compress_transmit(rendered, 6, &raw_bytes);
+    g_assert_nonnull(packed);
+    g_assert_cmpuint(raw_bytes, ==, TEST_RAW_BYTES);
+    g_assert_cmpuint(packed->len, <, rendered->len / 2);
+    g_assert_true(g_str_has_prefix(packed->str, "\033[?25l\033_Ga=T,f=32,s=128,v=96,c=8,r=3,o=z,m=1\033\\\033_Gm="));
+    g_assert_true(g_str_has_suffix(packed->str, "\033\\\033[0m"));
+    g_assert_nonnull(strstr(packed->str, "\033_Gm=0;"));
+
+    guint8 *raw = inflate_transmit(packed, TEST_RAW_BYTES);
+    g_assert_cmpmem(raw, TEST_RAW_BYTES, pixels, TEST_RAW_BYTES);
+
+    g_free(raw);
+    g_string_free(packed, TRUE);
+    g_string_free(rendered, TRUE);
+    g_free(pixels);
+}
+
+static void test_kitty_compress_transmit_ignores_other_output(void) {
+    const char *others[] = {
+        "\033[38;2;1;2;3m\xe2\x96\x80\033[0m",
+        "\033_Ga=T,f=100,s=2,v=1;iVBORw0KGgo=\033\\",
+        "\033_Ga=T,f=32,s=1,v=1,o=z;eJxjYGBgAAAABAAB\033\\",
+        "\033_Ga=T,f=32,s=1,v=1,t=s;L3NobQ==\033\\",
+        "\033_Ga=p,i=4\033\\",
+        "\033Ptmux;\033\033_Ga=T,f=32,s=1,v=1;AAAAAA==\033\033\\\033\\",
+        // Payload shorter than the announced size
+        "\033_Ga=T,f=32,s=4,v=4;AAAAAA==\033\\",
+    };
+
+    for (gsize i = 0; i < G_N_ELEMENTS(others); i++) {
+        GString *rendered = g_string_new(others[i]);
+        g_assert_null(kitty_compress_transmit(rendered, 6, NULL));
+        g_assert_false(kitty_compress_rendered(rendered));
+        g_assert_cmpstr(rendered->str, ==, others[i]);
+        g_string_free(rendered, TRUE);
+    }
+}
+
+static void test_kitty_compress_pick_level_weighs_link_speed(void) {
+    kitty_compress_reset();
+    const gsize frame = 1920 * 1080 * 4;
+
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_NEVER, frame, 1e5, TRUE), ==, 0);
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_ALWAYS, 1024, 1e5, TRUE), ==, 0);
+
+    // Unmeasured link: only ssh sessions compress on their own
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_AUTO, frame, 0.0, FALSE), ==, 0);
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_AUTO, frame, 0.0, TRUE), ==, 1);
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_ALWAYS, frame, 0.0, FALSE), ==, 1);
+
+    // A local terminal reads faster than deflate runs
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_AUTO, frame, 2e9, TRUE), ==, 0);
+    g_assert_cmpint(kitty_compress_pick_level(KITTY_COMPRESSION_ALWAYS, frame, 2e9, FALSE), >=, 1);
+
+    // Slower links afford more effort
+    gint fast = kitty_compress_pick_level(KITTY_COMPRESSION_AUTO, frame, 20e6, FALSE);
+    gint slow = kitty_compress_pick_level(KITTY_COMPRESSION_AUTO, frame, 0.5e6, FALSE);
+    g_assert_cmpint(fast, >=, 1);
+    g_assert_cmpint(slow, >, fast);
+}
+
+static void test_kitty_compress_rendered_follows_mode(void) {
+    kitty_compress_reset();
+    pixelterm_env_unset_for_test("SSH_CONNECTION");
+    pixelterm_env_unset_for_test("SSH_CLIENT");
+    pixelterm_env_unset_for_test("SSH_TTY");
+    guint8 *pixels = NULL;
+    GString *rendered = make_rendered(&pixels);
+    GString *original = g_string_new_len(rendered->str, (gssize)rendered->len);
+
+    // Local session, link not measured yet
+    g_assert_false(kitty_compress_rendered(rendered));
+    g_assert_cmpstr(rendered->str, ==, original->str);
+
+    pixelterm_env_set_for_test("SSH_CONNECTION", "10.0.0.1 50000 10.0.0.2 22");
+    kitty_compress_set_mode(KITTY_COMPRESSION_NEVER);
+    g_assert_false(kitty_compress_rendered(rendered));
+
+    kitty_compress_set_mode(KITTY_COMPRESSION_AUTO);
+    g_assert_true(kitty_compress_rendered(rendered));
+    g_assert_nonnull(strstr(rendered->str, ",o=z,"));
+    // Already compressed output is left alone
+    g_assert_false(kitty_compress_rendered(rendered));
+
+    guint8 *raw = inflate_transmit(rendered, TEST_RAW_BYTES);
+    g_assert_cmpmem(raw, TEST_RAW_BYTES, pixels, TEST_RAW_BYTES);
+
+    g_free(raw);
+    g_string_free(original, TRUE);
+    g_string_free(rendered, TRUE);
+    g_free(pixels);
+    pixelterm_env_reset_for_test();
+    kitty_compress_reset();
+}
+
+void register_kitty_compress_tests(void) {
+    g_test_add_func("/kitty_compress/transmit/round_trips", test_kitty_compress_transmit_round_trips);
+    g_test_add_func("/kitty_compress/transmit/ignores_other_output", test_kitty_compress_transmit_ignores_other_output);
+    g_test_add_func("/kitty_compress/pick_level/weighs_link_speed", test_kitty_compress_pick_level_weighs_link_speed);
+    g_test_add_func("/kitty_compress/rendered/follows_mode", test_kitty_compress_rendered_follows_mode);
+}
@@ -1,7 +1,10 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "kitty_graphics.h"
+#include "kitty_graphics_scale_internal.h"
 #include "process_env.h"
 
 static void test_kitty_graphics_shm_command_contains_expected_controls(void) {
@@ -71,6 +74,227 @@ static void test_kitty_graphics_frame_rejects_large_payload(void) {
                                                     512));
 }
 
+static gchar *ring_frame_path(const KittyGraphicsFrame *frame) {
+    const gchar *encoded = strrchr(frame->command->str, ';');
+    g_assert_nonnull(encoded);
+    gchar *trimmed = g_strndup(encoded + 1, strlen(encoded + 1) - 2);
+    gsize len = 0;
+    guchar *decoded = g_base64_decode(trimmed, &len);
+    g_free(trimmed);
+    gchar *path = g_strndup((const gchar *)decoded, len);
+    g_free(decoded);
+    return path;
+}
+
+static KittyGraphicsFrame *ring_frame_filled(KittyShmRing *ring, guint8 value) {
+    guint8 pixels[2 * 2 * 4];
+    memset(pixels, value, sizeof(pixels));
+    KittyGraphicsFrame *frame = kitty_graphics_frame_new_ring_rgba(ring, pixels, 2, 2, 8, 1, 1);
+    g_assert_nonnull(frame);
+    g_assert_nonnull(frame->slot);
+    g_assert_null(frame->shm_name);
+    return frame;
+}
+
+static void test_kitty_graphics_ring_writes_frames_in_place(void) {
+    gchar *dir = g_dir_make_tmp("pixelterm-ring-XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    KittyShmRing *ring = kitty_shm_ring_new(dir);
+    g_assert_nonnull(ring);
+
+    KittyGraphicsFrame *first = ring_frame_filled(ring, 0x11);
+    g_assert_nonnull(strstr(first->command->str, "t=f"));
+    g_assert_nonnull(strstr(first->command->str, "S=16"));
+    gchar *path = ring_frame_path(first);
+    g_assert_cmpstr(path, ==, kitty_shm_slot_get_path(first->slot));
+    gchar *contents = NULL;
+    gsize len = 0;
+    g_assert_true(g_file_get_contents(path, &contents, &len, NULL));
+    g_assert_cmpuint(len, ==, 16);
+    g_assert_cmpint(contents[0], ==, 0x11);
+    g_free(contents);
+
+    // A frame dropped before it was shown frees its slot at once
+    kitty_graphics_frame_free(first);
+    KittyGraphicsFrame *second = ring_frame_filled(ring, 0x22);
+    gchar *second_path = ring_frame_path(second);
+    g_assert_cmpstr(second_path, ==, path);
+    g_assert_true(g_file_get_contents(path, &contents, &len, NULL));
+    g_assert_cmpint(contents[0], ==, 0x22);
+    g_free(contents);
+
+    // A submitted frame is left for the terminal to read
+    kitty_shm_slot_submitted(second->slot);
+    second->slot = NULL;
+    kitty_graphics_frame_free(second);
+    KittyGraphicsFrame *third = ring_frame_filled(ring, 0x33);
+    gchar *third_path = ring_frame_path(third);
+    g_assert_cmpstr(third_path, !=, path);
+    g_assert_cmpuint(kitty_shm_ring_slot_count(ring), ==, 2);
+
+    // Freeing the ring deletes its files; held slots go when released
+    kitty_shm_ring_free(ring);
+    g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(third_path, G_FILE_TEST_EXISTS));
+    kitty_graphics_frame_free(third);
+    g_assert_false(g_file_test(third_path, G_FILE_TEST_EXISTS));
+
+    g_free(third_path);
+    g_free(second_path);
+    g_free(path);
+    g_rmdir(dir);
+    g_free(dir);
+}
+
+static void test_kitty_graphics_ring_recreates_files_deleted_by_terminal(void) {
+    gchar *dir = g_dir_make_tmp("pixelterm-ring-XXXXXX", NULL);
+    KittyShmRing *ring = kitty_shm_ring_new(dir);
+    g_assert_nonnull(ring);
+
+    KittyGraphicsFrame *first = ring_frame_filled(ring, 0x11);
+    gchar *path = ring_frame_path(first);
+    kitty_shm_slot_submitted(first->slot);
+    first->slot = NULL;
+    kitty_graphics_frame_free(first);
+    // The terminal read the frame and deleted the file
+    g_assert_cmpint(g_unlink(path), ==, 0);
+
+    g_usleep(150 * 1000);
+    KittyGraphicsFrame *second = ring_frame_filled(ring, 0x22);
+    gchar *second_path = ring_frame_path(second);
+    g_assert_cmpstr(second_path, ==, path);
+    gchar *contents = NULL;
+    gsize len = 0;
+    g_assert_true(g_file_get_contents(path, &contents, &len, NULL));
+    g_assert_cmpuint(len, ==, 16);
+    g_assert_cmpint(contents[0], ==, 0x22);
+    g_free(contents);
+    g_assert_cmpuint(kitty_shm_ring_slot_count(ring), ==, 1);
+
+    kitty_graphics_frame_free(second);
+    kitty_shm_ring_free(ring);
+    g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+    g_free(second_path);
+    g_free(path);
+    g_rmdir(dir);
+    g_free(dir);
+}
+
+static void test_kitty_graphics_ring_removes_files_of_exited_processes(void) {
+    gchar *dir = g_dir_make_tmp("pixelterm-ring-XXXXXX", NULL);
+    g_assert_nonnull(dir);
+    // No process has this id; the file was left behind by one that was killed
+    gchar *stale = g_build_filename(dir, "pixelterm-kitty-2147483000-3", NULL);
+    gchar *own_name = g_strdup_printf("pixelterm-kitty-%ld-9", (long)getpid());
+    gchar *own = g_build_filename(dir, own_name, NULL);
+    gchar *other = g_build_filename(dir, "pixelterm-kitty-notes", NULL);
+    g_assert_true(g_file_set_contents(stale, "x", 1, NULL));
+    g_assert_true(g_file_set_contents(own, "x", 1, NULL));
+    g_assert_true(g_file_set_contents(other, "x", 1, NULL));
+
+    KittyShmRing *ring = kitty_shm_ring_new(dir);
+    g_assert_nonnull(ring);
+    g_assert_false(g_file_test(stale, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(own, G_FILE_TEST_EXISTS));
+    g_assert_true(g_file_test(other, G_FILE_TEST_EXISTS));
+    kitty_shm_ring_free(ring);
+
+    g_unlink(own);
+    g_unlink(other);
+    g_rmdir(dir);
+    g_free(other);
+    g_free(own);
+    g_free(own_name);
+    g_free(stale);
+    g_free(dir);
+}
+
+static void test_kitty_graphics_ring_requires_directory(void) {
+    g_assert_null(kitty_shm_ring_new("/nonexistent/pixelterm-ring"));
+    g_assert_null(kitty_graphics_frame_new_ring_rgba(NULL, (const guint8 *)"\0\0\0\0", 1, 1, 4, 1, 1));
+}
+
+static void test_kitty_graphics_scale_averages_covered_pixels(void) {
+    // Black and white columns, with a half-transparent second row
+    guint8 src[2 * 4 * 4];
+    for (gint y = 0; y < 2; y++) {
+        for (gint x = 0; x < 4; x++) {
+            guint8 *px = src + (y * 4 + x) * 4;
+            memset(px, (x % 2) ? 255 : 0, 3);
+            px[3] = y ? 128 : 255;
+        }
+    }
+    guint8 dest[2 * 4];
+    kitty_graphics_scale_rgba_area(dest, 2, 1, src, 4, 2, 4 * 4);
+    for (gint x = 0; x < 2; x++) {
+        g_assert_cmpint(dest[x * 4 + 0], ==, 128);
+        g_assert_cmpint(dest[x * 4 + 1], ==, 128);
+        g_assert_cmpint(dest[x * 4 + 2], ==, 128);
+        g_assert_cmpint(dest[x * 4 + 3], ==, 192);
+    }
+
+    // Three columns into two: the middle one is split evenly
+    const guint8 row[3 * 4] = { 0, 0, 0, 255, 90, 90, 90, 255, 180, 180, 180, 255 };
+    kitty_graphics_scale_rgba_area(dest, 2, 1, row, 3, 1, sizeof(row));
+    g_assert_cmpint(dest[0], ==, 30);
+    g_assert_cmpint(dest[4], ==, 150);
+    g_assert_cmpint(dest[3], ==, 255);
+    g_assert_cmpint(dest[7], ==, 255);
+}
+
+static void test_kitty_graphics_scale_same_size_is_identity(void) {
+    const gint width = 7;
+    const gint height = 3;
+    const gint rowstride = width * 4 + 4;
+    guint8 *src = g_malloc0((gsize)rowstride * height);
+    for (gint i = 0; i < rowstride * height; i++) {
+        src[i] = (guint8)(i * 37 + 11);
+    }
+    guint8 *dest = g_malloc((gsize)width * height * 4);
+    kitty_graphics_scale_rgba_area(dest, width, height, src, width, height, rowstride);
+    for (gint y = 0; y < height; y++) {
+        g_assert_cmpmem(dest + y * width * 4, width * 4, src + y * rowstride, width * 4);
+    }
+    g_free(dest);
+    g_free(src);
+}
+
+static void test_kitty_graphics_scale_variants_match_scalar(void) {
+    const gint sizes[][4] = {
+        { 1920, 1080, 1280, 720 },
+        { 641, 479, 97, 61 },
+        { 33, 17, 32, 16 },
+        { 5, 300, 3, 7 },
+    };
+    const KittyScaleImpl impls[] = { KITTY_SCALE_IMPL_SSE2, KITTY_SCALE_IMPL_AVX2, KITTY_SCALE_IMPL_NEON };
+
+    for (gsize i = 0; i < G_N_ELEMENTS(sizes); i++) {
+        gint src_width = sizes[i][0];
+        gint src_height = sizes[i][1];
+        gint dest_width = sizes[i][2];
+        gint dest_height = sizes[i][3];
+        gint rowstride = src_width * 4 + 8;
+        gsize dest_size = (gsize)dest_width * dest_height * 4;
+        guint8 *src = g_malloc((gsize)rowstride * src_height);
+        for (gsize p = 0; p < (gsize)rowstride * src_height; p++) {
+            src[p] = (guint8)((p * 2654435761u) >> 13);
+        }
+        guint8 *expected = g_malloc(dest_size);
+        guint8 *actual = g_malloc(dest_size);
+        g_assert_true(kitty_graphics_scale_rgba_area_with(KITTY_SCALE_IMPL_SCALAR, expected, dest_width, dest_height,
+                                                          src, src_width, src_height, rowstride));
+        for (gsize k = 0; k < G_N_ELEMENTS(impls); k++) {
+            if (kitty_graphics_scale_rgba_area_with(impls[k], actual, dest_width, dest_height,
+                                                    src, src_width, src_height, rowstride)) {
+                g_assert_cmpmem(actual, dest_size, expected, dest_size);
+            }
+        }
+        g_free(actual);
+        g_free(expected);
+        g_free(src);
+    }
+}
+
 void register_kitty_graphics_tests(void) {
     g_test_add_func("/kitty_graphics/shm_command/controls", test_kitty_graphics_shm_command_contains_expected_controls);
     g_test_add_func("/kitty_graphics/shm_command/rejects_invalid_input", test_kitty_graphics_shm_command_rejects_invalid_input);
@@ -78,4 +302,13 @@ void register_kitty_graphics_tests(void) {
     g_test_add_func("/kitty_graphics/shm_auto/allows_explicit_override", test_kitty_graphics_shm_auto_enabled_allows_explicit_override);
     g_test_add_func("/kitty_graphics/frame/rejects_rowstride_overflow", test_kitty_graphics_frame_rejects_rowstride_overflow);
     g_test_add_func("/kitty_graphics/frame/rejects_large_payload", test_kitty_graphics_frame_rejects_large_payload);
+    g_test_add_func("/kitty_graphics/ring/writes_frames_in_place", test_kitty_graphics_ring_writes_frames_in_place);
+    g_test_add_func("/kitty_graphics/ring/recreates_files_deleted_by_terminal",
+                    test_kitty_graphics_ring_recreates_files_deleted_by_terminal);
+    g_test_add_func("/kitty_graphics/ring/removes_files_of_exited_processes",
+                    test_kitty_graphics_ring_removes_files_of_exited_processes);
+    g_test_add_func("/kitty_graphics/ring/requires_directory", test_kitty_graphics_ring_requires_directory);
+    g_test_add_func("/kitty_graphics/scale/averages_covered_pixels", test_kitty_graphics_scale_averages_covered_pixels);
+    g_test_add_func("/kitty_graphics/scale/same_size_is_identity", test_kitty_graphics_scale_same_size_is_identity);
+    g_test_add_func("/kitty_graphics/scale/variants_match_scalar", test_kitty_graphics_scale_variants_match_scalar);
 }
@@ -0,0 +1,153 @@
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "kitty_registry.h"
+
+// Shaped like chafa's output: a payload-less header, data chunks, an end chunk
+#define TEST_KITTY_IMAGE "\033_Ga=T,f=32,s=4,v=2,c=2,r=1,m=1\033\\" \
+                         "\033_Gm=1;AAAAAAAA\033\\" \
+                         "\033_Gm=0;\033\\"
+#define TEST_KITTY_IMAGE_BYTES (4 * 2 * 4)
+
+static guint32 transmit_image(KittyRegistry *registry, const char *path, GString *out) {
+    GString *rendered = g_string_new(TEST_KITTY_IMAGE);
+    g_assert_true(kitty_registry_transmit(registry, path, 10, 5, 2, 1, rendered, out));
+    g_string_free(rendered, TRUE);
+
+    const char *tagged = strstr(out->str, "\033_Gi=");
+    g_assert_nonnull(tagged);
+    guint id = 0;
+    g_assert_cmpint(sscanf(tagged, "\033_Gi=%u,", &id), ==, 1);
+    return id;
+}
+
+static void test_kitty_registry_places_resident_images(void) {
+    KittyRegistry *registry = kitty_registry_new(KITTY_REGISTRY_DEFAULT_BUDGET);
+    GString *out = g_string_new(NULL);
+
+    g_assert_false(kitty_registry_place(registry, "/a.png", 10, 5, out, NULL, NULL));
+    g_assert_cmpuint(out->len, ==, 0);
+
+    guint32 id = transmit_image(registry, "/a.png", out);
+    gchar *expected = g_strdup_printf("\033_Gi=%u,q=2,a=T,f=32,s=4,v=2,c=2,r=1,m=1\033\\"
+                                      "\033_Gm=1;AAAAAAAA\033\\\033_Gm=0;\033\\", id);
+    g_assert_cmpstr(out->str, ==, expected);
+    g_free(expected);
+    g_assert_cmpuint(kitty_registry_count(registry), ==, 1);
+    g_assert_cmpuint(kitty_registry_resident_bytes(registry), ==, TEST_KITTY_IMAGE_BYTES);
+
+    g_string_truncate(out, 0);
+    gint width = 0;
+    gint height = 0;
+    g_assert_true(kitty_registry_place(registry, "/a.png", 10, 5, out, &width, &height));
+    expected = g_strdup_printf("\033_Ga=p,i=%u,c=2,r=1,q=2\033\\", id);
+    g_assert_cmpstr(out->str, ==, expected);
+    g_free(expected);
+    g_assert_cmpint(width, ==, 2);
+    g_assert_cmpint(height, ==, 1);
+
+    // Another geometry is another image
+    g_string_truncate(out, 0);
+    g_assert_false(kitty_registry_place(registry, "/a.png", 20, 10, out, NULL, NULL));
+
+    g_string_free(out, TRUE);
+    kitty_registry_free(registry);
+}
+
+static void test_kitty_registry_ignores_other_output(void) {
+    KittyRegistry *registry = kitty_registry_new(KITTY_REGISTRY_DEFAULT_BUDGET);
+    GString *out = g_string_new(NULL);
+    const char *others[] = {
+        "\033[38;2;1;2;3m\xe2\x96\x80\033[0m",
+        "\033Pq#0;2;0;0;0~\033\\",
+        "\033_Ga=T,i=7,f=32,s=1,v=1;AAAA\033\\",
+        "\033_Ga=t,f=32,s=1,v=1;AAAA\033\\",
+        "\033_Ga=T,f=32,s=1,v=1,m=1;AAAA\033\\",
+    };
+
+    for (gsize i = 0; i < G_N_ELEMENTS(others); i++) {
+        GString *rendered = g_string_new(others[i]);
+        g_assert_false(kitty_registry_transmit(registry, "/a.png", 10, 5, 1, 1, rendered, out));
+        g_string_free(rendered, TRUE);
+    }
+    g_assert_cmpuint(out->len, ==, 0);
+    g_assert_cmpuint(kitty_registry_count(registry), ==, 0);
+
+    g_string_free(out, TRUE);
+    kitty_registry_free(registry);
+}
+
+static void test_kitty_registry_evicts_least_recently_used(void) {
+    KittyRegistry *registry = kitty_registry_new(2 * TEST_KITTY_IMAGE_BYTES);
+    GString *out = g_string_new(NULL);
+
+    guint32 id_a = transmit_image(registry, "/a.png", out);
+    g_string_truncate(out, 0);
+    guint32 id_b = transmit_image(registry, "/b.png", out);
+    g_string_truncate(out, 0);
+    g_assert_true(kitty_registry_place(registry, "/a.png", 10, 5, out, NULL, NULL));
+    g_string_truncate(out, 0);
+
+    guint32 id_c = transmit_image(registry, "/c.png", out);
+    g_assert_cmpuint(id_c, !=, id_a);
+    g_assert_cmpuint(id_c, !=, id_b);
+    gchar *delete_b = g_strdup_printf("\033_Ga=d,d=I,i=%u,q=2\033\\", id_b);
+    g_assert_true(g_str_has_prefix(out->str, delete_b));
+    g_free(delete_b);
+
+    g_assert_cmpuint(kitty_registry_count(registry), ==, 2);
+    g_assert_cmpuint(kitty_registry_resident_bytes(registry), ==, 2 * TEST_KITTY_IMAGE_BYTES);
+    g_string_truncate(out, 0);
+    g_assert_false(kitty_registry_place(registry, "/b.png", 10, 5, out, NULL, NULL));
+    g_assert_true(kitty_registry_place(registry, "/a.png", 10, 5, out, NULL, NULL));
+
+    // An image larger than the budget is never kept
+    KittyRegistry *small = kitty_registry_new(TEST_KITTY_IMAGE_BYTES - 1);
+    GString *rendered = g_string_new(TEST_KITTY_IMAGE);
+    g_assert_false(kitty_registry_transmit(small, "/a.png", 10, 5, 2, 1, rendered, out));
+    g_string_free(rendered, TRUE);
+    kitty_registry_free(small);
+
+    g_string_free(out, TRUE);
+    kitty_registry_free(registry);
+}
+
+static void test_kitty_registry_forget_and_clear_delete_images(void) {
+    KittyRegistry *registry = kitty_registry_new(KITTY_REGISTRY_DEFAULT_BUDGET);
+    GString *out = g_string_new(NULL);
+
+    guint32 id_a = transmit_image(registry, "/a.png", out);
+    g_string_truncate(out, 0);
+    GString *rendered = g_string_new(TEST_KITTY_IMAGE);
+    g_assert_true(kitty_registry_transmit(registry, "/a.png", 20, 10, 2, 1, rendered, out));
+    g_string_free(rendered, TRUE);
+    g_string_truncate(out, 0);
+    guint32 id_b = transmit_image(registry, "/b.png", out);
+    g_string_truncate(out, 0);
+
+    kitty_registry_forget(registry, "/a.png", out);
+    g_assert_cmpuint(kitty_registry_count(registry), ==, 1);
+    gchar *delete_a = g_strdup_printf("\033_Ga=d,d=I,i=%u,q=2\033\\", id_a);
+    g_assert_nonnull(strstr(out->str, delete_a));
+    g_free(delete_a);
+
+    g_string_truncate(out, 0);
+    kitty_registry_clear(registry, out);
+    gchar *delete_b = g_strdup_printf("\033_Ga=d,d=I,i=%u,q=2\033\\", id_b);
+    g_assert_cmpstr(out->str, ==, delete_b);
+    g_free(delete_b);
+    g_assert_cmpuint(kitty_registry_count(registry), ==, 0);
+    g_assert_cmpuint(kitty_registry_resident_bytes(registry), ==, 0);
+
+    g_string_free(out, TRUE);
+    kitty_registry_free(registry);
+}
+
+void register_kitty_registry_tests(void) {
+    g_test_add_func("/kitty_registry/places_resident_images", test_kitty_registry_places_resident_images);
+    g_test_add_func("/kitty_registry/ignores_other_output", test_kitty_registry_ignores_other_output);
+    g_test_add_func("/kitty_registry/evicts_least_recently_used", test_kitty_registry_evicts_least_recently_used);
+    g_test_add_func("/kitty_registry/forget_and_clear_delete_images",
+                    test_kitty_registry_forget_and_clear_delete_images);
+}
@@ -0,0 +1,125 @@
+#include <glib.h>
+
+#include "media_index.h"
+
+static void assert_index_order(const MediaIndex *index, const gchar *const *expected) {
+    gint i = 0;
+    for (; expected[i]; i++) {
+        g_assert_cmpstr(media_index_get(index, i), ==, expected[i]);
+    }
+    g_assert_cmpint(media_index_length(index), ==, i);
+}
+
+static void test_media_index_insert_and_find(void) {
+    MediaIndex *index = media_index_new(FALSE);
+    g_assert_cmpint(media_index_length(index), ==, 0);
+    g_assert_null(media_index_get(index, 0));
+
+    g_assert_cmpint(media_index_insert(index, "/d/c.png"), ==, 0);
+    g_assert_cmpint(media_index_insert(index, "/d/a.png"), ==, 0);
+    g_assert_cmpint(media_index_insert(index, "/d/b.png"), ==, 1);
+    g_assert_cmpint(media_index_insert(index, "/d/B.png"), ==, 1);
+    // A duplicate name is not added again
+    g_assert_cmpint(media_index_insert(index, "/d/b.png"), ==, 2);
+
+    const gchar *expected[] = {"/d/a.png", "/d/B.png", "/d/b.png", "/d/c.png", NULL};
+    assert_index_order(index, expected);
+    g_assert_cmpstr(media_index_get_name(index, 1), ==, "B.png");
+    g_assert_null(media_index_get(index, -1));
+    g_assert_null(media_index_get_name(index, 4));
+
+    g_assert_cmpint(media_index_find_name(index, "c.png"), ==, 3);
+    g_assert_cmpint(media_index_find_name(index, "missing.png"), ==, -1);
+    g_assert_cmpint(media_index_find_path(index, "/d/b.png"), ==, 2);
+    g_assert_cmpint(media_index_find_path(index, "/other/b.png"), ==, -1);
+
+    media_index_free(index);
+    media_index_free(NULL);
+    g_assert_cmpint(media_index_length(NULL), ==, 0);
+    g_assert_cmpint(media_index_find_name(NULL, "a.png"), ==, -1);
+}
+
+static void test_media_index_merge_and_remove(void) {
+    MediaIndex *index = media_index_new(TRUE);
+    media_index_append(index, "/d/IMG_2.jpg");
+    media_index_append(index, "/d/IMG_10.jpg");
+
+    GList *batch = NULL;
+    batch = g_list_append(batch, g_strdup("/d/IMG_1.jpg"));
+    batch = g_list_append(batch, g_strdup("/d/IMG_3.jpg"));
+    batch = g_list_append(batch, g_strdup("/d/IMG_20.jpg"));
+    g_assert_cmpint(media_index_merge(index, batch), ==, 3);
+    g_assert_cmpint(media_index_merge(index, NULL), ==, 0);
+
+    const gchar *merged[] = {"/d/IMG_1.jpg", "/d/IMG_2.jpg", "/d/IMG_3.jpg", "/d/IMG_10.jpg", "/d/IMG_20.jpg", NULL};
+    assert_index_order(index, merged);
+    g_assert_cmpint(media_index_find_name(index, "IMG_10.jpg"), ==, 3);
+
+    media_index_remove(index, 1);
+    media_index_remove(index, 10);
+    const gchar *removed[] = {"/d/IMG_1.jpg", "/d/IMG_3.jpg", "/d/IMG_10.jpg", "/d/IMG_20.jpg", NULL};
+    assert_index_order(index, removed);
+    g_assert_cmpint(media_index_find_path(index, "/d/IMG_2.jpg"), ==, -1);
+
+    media_index_clear(index);
+    g_assert_cmpint(media_index_length(index), ==, 0);
+    g_assert_cmpint(media_index_insert(index, "/d/IMG_5.jpg"), ==, 0);
+
+    media_index_free(index);
+}
+
+static void test_media_index_remove_reclaims_strings(void) {
+    MediaIndex *index = media_index_new_relative("/photos", FALSE);
+    GList *paths = NULL;
+    for (gint i = 999; i >= 0; i--) {
+        paths = g_list_prepend(paths, g_strdup_printf("/photos/2024/trip/img_%04d.jpg", i));
+    }
+    g_assert_cmpint(media_index_merge(index, paths), ==, 1000);
+
+    // Added and deleted again, as a directory watcher would; the survivors
+    // are copied out of the old strings along the way
+    while (media_index_length(index) > 2) {
+        media_index_remove(index, 1);
+    }
+    const gchar *expected[] = {"/photos/2024/trip/img_0000.jpg", "/photos/2024/trip/img_0999.jpg", NULL};
+    assert_index_order(index, expected);
+    g_assert_cmpstr(media_index_get_name(index, 1), ==, "2024/trip/img_0999.jpg");
+    g_assert_cmpint(media_index_find_path(index, "/photos/2024/trip/img_0999.jpg"), ==, 1);
+    g_assert_cmpint(media_index_insert(index, "/photos/2024/trip/img_0500.jpg"), ==, 1);
+    g_assert_cmpstr(media_index_get_name(index, 1), ==, "2024/trip/img_0500.jpg");
+
+    media_index_free(index);
+}
+
+static void test_media_index_rooted_orders_by_relative_path(void) {
+    MediaIndex *index = media_index_new_relative("/r", FALSE);
+    g_assert_cmpstr(media_index_get_root(index), ==, "/r");
+    g_assert_null(media_index_get_root(NULL));
+
+    g_assert_cmpint(media_index_insert(index, "/r/b.png"), ==, 0);
+    g_assert_cmpint(media_index_insert(index, "/r/a/b.png"), ==, 0);
+    // The same basename in another directory is a separate entry
+    g_assert_cmpint(media_index_insert(index, "/r/c/b.png"), ==, 2);
+
+    GList *batch = NULL;
+    batch = g_list_append(batch, g_strdup("/r/a/a.png"));
+    batch = g_list_append(batch, g_strdup("/r/c/a.png"));
+    g_assert_cmpint(media_index_merge(index, batch), ==, 2);
+
+    const gchar *expected[] = {"/r/a/a.png", "/r/a/b.png", "/r/b.png", "/r/c/a.png", "/r/c/b.png", NULL};
+    assert_index_order(index, expected);
+    g_assert_cmpstr(media_index_get_name(index, 3), ==, "c/a.png");
+    g_assert_cmpint(media_index_find_name(index, "b.png"), ==, 2);
+    g_assert_cmpint(media_index_find_path(index, "/r/c/b.png"), ==, 4);
+    g_assert_cmpint(media_index_find_path(index, "/rc/b.png"), ==, -1);
+
+    media_index_free(index);
+}
+
+void register_media_index_tests(void) {
+    g_test_add_func("/media_index/insert_and_find", test_media_index_insert_and_find);
+    g_test_add_func("/media_index/merge_and_remove", test_media_index_merge_and_remove);
+    g_test_add_func("/media_index/remove_reclaims_strings", test_media_index_remove_reclaims_strings);
+    g_test_add_func("/media_index/rooted_orders_by_relative_path",
+                    test_media_index_rooted_orders_by_relative_path);
+}
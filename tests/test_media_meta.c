@@ -0,0 +1,157 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "media_meta.h"
+#include "process_env.h"
+
+static void remove_tree(const gchar *path) {
+    if (g_remove(path) == 0) {
+        return;
+    }
+    GDir *handle = g_dir_open(path, 0, NULL);
+    if (handle) {
+        const gchar *name = NULL;
+        while ((name = g_dir_read_name(handle)) != NULL) {
+            gchar *child = g_build_filename(path, name, NULL);
+            remove_tree(child);
+            g_free(child);
+        }
+        g_dir_close(handle);
+    }
+    g_rmdir(path);
+}
+
+static void remove_dir_tree(gpointer data) {
+    gchar *dir = data;
+    remove_tree(dir);
+    g_free(dir);
+}
+
+static gchar *create_temp_dir(void) {
+    gchar *template = g_build_filename(g_get_tmp_dir(), "pixelterm-media-meta-XXXXXX", NULL);
+    gchar *dir = g_mkdtemp(template);
+    g_assert_nonnull(dir);
+    g_test_queue_destroy(remove_dir_tree, dir);
+    return dir;
+}
+
+static gchar *write_file(const gchar *dir, const gchar *name, const gchar *contents) {
+    gchar *path = g_build_filename(dir, name, NULL);
+    g_assert_true(g_file_set_contents(path, contents, -1, NULL));
+    return path;
+}
+
+static void test_media_meta_round_trips_through_cache_file(void) {
+    gchar *dir = create_temp_dir();
+    gchar *cache = g_build_filename(dir, "cache", "meta.bin", NULL);
+    gchar *clip = write_file(dir, "clip.mp4", "video");
+    gchar *still = write_file(dir, "still.png", "image");
+
+    MediaMetaStore *store = media_meta_store_open_file(dir, cache);
+    g_assert_nonnull(store);
+    MediaMeta meta = {MEDIA_KIND_UNKNOWN, 0, 0, FALSE, -1};
+    g_assert_false(media_meta_store_lookup(store, clip, &meta));
+
+    MediaMeta clip_meta = {MEDIA_KIND_VIDEO, 1920, 1080, FALSE, 83000};
+    MediaMeta still_meta = {MEDIA_KIND_ANIMATED_IMAGE, 64, 48, TRUE, -1};
+    media_meta_store_put(store, clip, &clip_meta);
+    media_meta_store_put(store, still, &still_meta);
+    g_assert_cmpuint(media_meta_store_size(store), ==, 2);
+    media_meta_store_free(store);
+    g_assert_true(g_file_test(cache, G_FILE_TEST_IS_REGULAR));
+
+    store = media_meta_store_open_file(dir, cache);
+    g_assert_cmpuint(media_meta_store_size(store), ==, 2);
+    g_assert_true(media_meta_store_lookup(store, clip, &meta));
+    g_assert_cmpint(meta.kind, ==, MEDIA_KIND_VIDEO);
+    g_assert_cmpint(meta.width, ==, 1920);
+    g_assert_cmpint(meta.height, ==, 1080);
+    g_assert_cmpint(meta.duration_ms, ==, 83000);
+    g_assert_true(media_meta_store_lookup(store, still, &meta));
+    g_assert_cmpint(meta.kind, ==, MEDIA_KIND_ANIMATED_IMAGE);
+    g_assert_true(meta.animated);
+
+    media_meta_store_forget(store, still);
+    g_assert_false(media_meta_store_lookup(store, still, &meta));
+    media_meta_store_free(store);
+
+    g_free(still);
+    g_free(clip);
+    g_free(cache);
+}
+
+static void test_media_meta_drops_records_of_changed_files(void) {
+    gchar *dir = create_temp_dir();
+    gchar *cache = g_build_filename(dir, "meta.bin", NULL);
+    gchar *path = write_file(dir, "photo.jpg", "first");
+
+    MediaMetaStore *store = media_meta_store_open_file(dir, cache);
+    MediaMeta meta = {MEDIA_KIND_IMAGE, 10, 20, FALSE, -1};
+    media_meta_store_put(store, path, &meta);
+    g_assert_true(media_meta_store_lookup(store, path, &meta));
+
+    // A different size invalidates the record even if the mtime is unchanged
+    g_assert_true(g_file_set_contents(path, "rewritten", -1, NULL));
+    g_assert_false(media_meta_store_lookup(store, path, &meta));
+    g_assert_cmpuint(media_meta_store_size(store), ==, 0);
+
+    g_assert_cmpint(g_remove(path), ==, 0);
+    media_meta_store_put(store, path, &meta);
+    g_assert_cmpuint(media_meta_store_size(store), ==, 0);
+    media_meta_store_free(store);
+
+    g_free(path);
+    g_free(cache);
+}
+
+static void test_media_meta_ignores_corrupt_cache_file(void) {
+    gchar *dir = create_temp_dir();
+    gchar *cache = write_file(dir, "meta.bin", "PTMM\x01");
+    gchar *path = write_file(dir, "a.png", "image");
+
+    MediaMetaStore *store = media_meta_store_open_file(dir, cache);
+    g_assert_nonnull(store);
+    g_assert_cmpuint(media_meta_store_size(store), ==, 0);
+    MediaMeta meta = {MEDIA_KIND_IMAGE, 1, 1, FALSE, -1};
+    media_meta_store_put(store, path, &meta);
+    g_assert_true(media_meta_store_save(store));
+    media_meta_store_free(store);
+
+    store = media_meta_store_open_file(dir, cache);
+    g_assert_cmpuint(media_meta_store_size(store), ==, 1);
+    media_meta_store_free(store);
+
+    g_assert_null(media_meta_store_open(NULL));
+    g_assert_false(media_meta_store_lookup(NULL, path, &meta));
+    media_meta_store_free(NULL);
+
+    g_free(path);
+    g_free(cache);
+}
+
+static void test_media_meta_cache_path_follows_xdg(void) {
+    pixelterm_env_set_for_test("XDG_CACHE_HOME", "/tmp/xdg-cache");
+    gchar *path = media_meta_cache_path("/photos");
+    g_assert_true(g_str_has_prefix(path, "/tmp/xdg-cache/pixelterm/media-meta/"));
+    g_assert_true(g_str_has_suffix(path, ".bin"));
+    gchar *other = media_meta_cache_path("/photos/2024");
+    g_assert_cmpstr(path, !=, other);
+    g_free(other);
+    g_free(path);
+
+    pixelterm_env_set_for_test("XDG_CACHE_HOME", "");
+    pixelterm_env_set_for_test("HOME", "/home/viewer");
+    path = media_meta_cache_path("/photos");
+    g_assert_true(g_str_has_prefix(path, "/home/viewer/.cache/pixelterm/media-meta/"));
+    g_free(path);
+    pixelterm_env_reset_for_test();
+
+    g_assert_null(media_meta_cache_path(NULL));
+}
+
+void register_media_meta_tests(void) {
+    g_test_add_func("/media_meta/round_trips_through_cache_file", test_media_meta_round_trips_through_cache_file);
+    g_test_add_func("/media_meta/drops_records_of_changed_files", test_media_meta_drops_records_of_changed_files);
+    g_test_add_func("/media_meta/ignores_corrupt_cache_file", test_media_meta_ignores_corrupt_cache_file);
+    g_test_add_func("/media_meta/cache_path_follows_xdg", test_media_meta_cache_path_follows_xdg);
+}
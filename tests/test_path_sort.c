@@ -0,0 +1,147 @@
+#include <glib.h>
+
+#include "path_sort.h"
+
+static GList *build_list(const gchar *const *paths) {
+    GList *list = NULL;
+    for (gsize i = 0; paths[i]; i++) {
+        list = g_list_append(list, (gpointer)paths[i]);
+    }
+    return list;
+}
+
+static void assert_list_order(GList *list, const gchar *const *expected) {
+    gsize i = 0;
+    for (GList *link = list; link; link = link->next, i++) {
+        g_assert_nonnull(expected[i]);
+        g_assert_cmpstr(link->data, ==, expected[i]);
+    }
+    g_assert_null(expected[i]);
+}
+
+static void test_path_sort_default_order(void) {
+    const gchar *input[] = {"/x/b.png", "/y/B.png", "/x/a.png", "/z/10.png", "/z/2.png", "/x/A.png", NULL};
+    const gchar *expected[] = {"/x/A.png", "/x/a.png", "/y/B.png", "/x/b.png", "/z/10.png", "/z/2.png", NULL};
+
+    GList *list = build_list(input);
+    list = path_sort_list(list, FALSE);
+    assert_list_order(list, expected);
+    g_list_free(list);
+
+    g_assert_cmpint(path_sort_compare("/a/Zeta", "/b/alpha", FALSE), >, 0);
+    g_assert_cmpint(path_sort_compare("/a/A", "/b/a", FALSE), <, 0);
+    g_assert_cmpint(path_sort_compare("/a/abc", "/b/ab", FALSE), >, 0);
+    g_assert_cmpint(path_sort_compare(NULL, "/b/ab", FALSE), <, 0);
+    g_assert_cmpint(path_sort_compare(NULL, NULL, FALSE), ==, 0);
+}
+
+static void test_path_sort_natural_order(void) {
+    const gchar *input[] = {"IMG_10.jpg", "IMG_2.jpg", "IMG_1.jpg", "IMG_002.jpg", "IMG_100.jpg", "IMG.jpg", NULL};
+    // '.' sorts before '_', so the bare name leads.
+    const gchar *expected[] = {"IMG.jpg", "IMG_1.jpg", "IMG_002.jpg", "IMG_2.jpg", "IMG_10.jpg", "IMG_100.jpg", NULL};
+
+    GList *list = build_list(input);
+    list = path_sort_list(list, TRUE);
+    assert_list_order(list, expected);
+    g_list_free(list);
+
+    g_assert_cmpint(path_sort_compare("IMG_2", "IMG_10", TRUE), <, 0);
+    g_assert_cmpint(path_sort_compare("IMG_2", "IMG_10", FALSE), >, 0);
+    g_assert_cmpint(path_sort_compare("v1.9", "v1.10", TRUE), <, 0);
+    g_assert_cmpint(path_sort_compare("a0", "a", TRUE), >, 0);
+}
+
+static void test_path_sort_list_matches_compare(void) {
+    const gchar *input[] = {"d/x9", "c/X10", "b/x09", "a/_1", "e/x", "f/X", "g/x10b", "h/x10a", NULL};
+
+    for (gint natural = 0; natural <= 1; natural++) {
+        GList *list = build_list(input);
+        list = path_sort_list(list, natural);
+        for (GList *link = list; link && link->next; link = link->next) {
+            g_assert_cmpint(path_sort_compare(link->data, link->next->data, natural), <=, 0);
+        }
+        g_list_free(list);
+    }
+}
+
+static void test_path_sort_reuses_nodes_and_keeps_equal_order(void) {
+    // Same basename in different directories compares equal; input order must survive.
+    const gchar *input[] = {"/3/same", "/1/same", "/2/same", "/0/other", NULL};
+    const gchar *expected[] = {"/0/other", "/3/same", "/1/same", "/2/same", NULL};
+
+    GList *list = build_list(input);
+    GList *head = list;
+    GList *sorted = path_sort_list(list, FALSE);
+    g_assert_true(sorted == head);
+    assert_list_order(sorted, expected);
+    g_list_free(sorted);
+
+    g_assert_null(path_sort_list(NULL, TRUE));
+}
+
+static void test_path_sort_uses_basename(void) {
+    g_assert_cmpint(path_sort_compare("/zzz/a.png", "/aaa/b.png", FALSE), <, 0);
+    g_assert_cmpint(path_sort_compare("/dir/a/", "/dir/b", FALSE), <, 0);
+    g_assert_cmpint(path_sort_compare("/dir/a/", "/other/a", FALSE), ==, 0);
+    g_assert_cmpint(path_sort_compare("", ".", FALSE), ==, 0);
+}
+
+static void test_path_sort_relative_order(void) {
+    const gchar *input[] = {"/r/b.png", "/r/a/10.png", "/r/a.png", "/r/a/2.png", "/r/B/x.png", "/r/ab/c.png", NULL};
+    // A directory's files come before names that only share its prefix.
+    const gchar *expected[] = {"/r/a/2.png", "/r/a/10.png", "/r/ab/c.png", "/r/a.png", "/r/B/x.png", "/r/b.png", NULL};
+
+    GList *list = build_list(input);
+    list = path_sort_list_relative(list, 2, TRUE);
+    assert_list_order(list, expected);
+    g_list_free(list);
+
+    g_assert_cmpint(path_sort_compare_relative("/r/x/same", "/r/y/same", 2, FALSE), <, 0);
+    g_assert_cmpint(path_sort_compare_relative("/r//a", "/r/a", 2, FALSE), ==, 0);
+    g_assert_cmpint(path_sort_compare_relative("a/b", "a.b", 0, FALSE), <, 0);
+
+    const gchar *existing[] = {"/r/a/1", "/r/c", NULL};
+    const gchar *batch[] = {"/r/a/0", "/r/b/9", NULL};
+    const gchar *merged[] = {"/r/a/0", "/r/a/1", "/r/b/9", "/r/c", NULL};
+    list = path_sort_merge_relative(build_list(existing), build_list(batch), 2, FALSE);
+    assert_list_order(list, merged);
+    g_list_free(list);
+}
+
+static void test_path_sort_merge_keeps_links(void) {
+    const gchar *existing[] = {"b1", "b3", "b5", NULL};
+    const gchar *batch[] = {"a", "b2", "b3", "c", NULL};
+    const gchar *expected[] = {"a", "b1", "b2", "b3", "b3", "b5", "c", NULL};
+
+    GList *list = build_list(existing);
+    GList *b3_link = list->next;
+    GList *added = build_list(batch);
+    GList *added_b3 = added->next->next;
+
+    list = path_sort_merge(list, added, FALSE);
+    assert_list_order(list, expected);
+    g_assert_null(list->prev);
+    // The existing b3 keeps its node and sorts ahead of the new equal entry.
+    g_assert_true(g_list_nth(list, 3) == b3_link);
+    g_assert_true(g_list_nth(list, 4) == added_b3);
+    for (GList *link = list; link && link->next; link = link->next) {
+        g_assert_true(link->next->prev == link);
+    }
+    g_list_free(list);
+
+    GList *only = build_list(batch);
+    g_assert_true(path_sort_merge(NULL, only, FALSE) == only);
+    g_assert_true(path_sort_merge(only, NULL, FALSE) == only);
+    g_list_free(only);
+}
+
+void register_path_sort_tests(void) {
+    g_test_add_func("/path_sort/default_order", test_path_sort_default_order);
+    g_test_add_func("/path_sort/natural_order", test_path_sort_natural_order);
+    g_test_add_func("/path_sort/list_matches_compare", test_path_sort_list_matches_compare);
+    g_test_add_func("/path_sort/reuses_nodes_and_keeps_equal_order",
+                    test_path_sort_reuses_nodes_and_keeps_equal_order);
+    g_test_add_func("/path_sort/uses_basename", test_path_sort_uses_basename);
+    g_test_add_func("/path_sort/relative_order", test_path_sort_relative_order);
+    g_test_add_func("/path_sort/merge_keeps_links", test_path_sort_merge_keeps_links);
+}
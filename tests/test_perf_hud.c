@@ -0,0 +1,95 @@
+#include <glib.h>
+#include <string.h>
+
+#include "metrics.h"
+#include "perf_hud.h"
+
+static gpointer metrics_busy_worker(gpointer data) {
+    (void)data;
+    for (gint i = 0; i < 1000; i++) {
+        metrics_add(METRIC_WORKER_BUSY_US, 1);
+    }
+    return NULL;
+}
+
+static void test_metrics_snapshot_sees_every_thread(void) {
+    metrics_reset_for_test();
+    metrics_set(METRIC_FRAME_BYTES, 4096);
+    metrics_set(METRIC_FRAME_BYTES, 2048);
+
+    GThread *threads[4];
+    for (guint i = 0; i < G_N_ELEMENTS(threads); i++) {
+        threads[i] = g_thread_new("metrics-test", metrics_busy_worker, NULL);
+    }
+    for (guint i = 0; i < G_N_ELEMENTS(threads); i++) {
+        g_thread_join(threads[i]);
+    }
+
+    gint64 elapsed = metrics_set_elapsed(METRIC_DECODE_US, g_get_monotonic_time() - 1500);
+    g_assert_cmpint(elapsed, >=, 1500);
+
+    gint64 values[METRIC_COUNT];
+    metrics_snapshot(values);
+    g_assert_cmpint(values[METRIC_FRAME_BYTES], ==, 2048);
+    g_assert_cmpint(values[METRIC_WORKER_BUSY_US], ==, 4000);
+    g_assert_cmpint(values[METRIC_DECODE_US], ==, elapsed);
+    g_assert_cmpint(values[METRIC_RENDER_US], ==, 0);
+
+    metrics_reset_for_test();
+    metrics_snapshot(values);
+    g_assert_cmpint(values[METRIC_WORKER_BUSY_US], ==, 0);
+}
+
+static void test_perf_hud_format_reports_metrics(void) {
+    gint64 values[METRIC_COUNT] = {0};
+    values[METRIC_DECODE_US] = 12345;
+    values[METRIC_RENDER_US] = 4100;
+    values[METRIC_WRITE_US] = 800;
+    values[METRIC_FRAME_BYTES] = 46285;
+    values[METRIC_PRELOAD_QUEUE] = 3;
+    values[METRIC_PRELOAD_HITS] = 7;
+    values[METRIC_PRELOAD_MISSES] = 1;
+    values[METRIC_CACHE_BYTES] = 13002342;
+    PerfHud hud = {0};
+    gchar line[PERF_HUD_LINE_MAX];
+
+    perf_hud_format(&hud, values, line, sizeof(line));
+    g_assert_cmpstr(line, ==,
+                    "decode 12.3ms  chafa 4.1ms  write 0.8ms  45.2K/frame  queue 3"
+                    "  hit 87%  cache 12.4M  workers --");
+
+    // Nothing looked up yet, and small sizes stay in bytes
+    values[METRIC_PRELOAD_HITS] = 0;
+    values[METRIC_PRELOAD_MISSES] = 0;
+    values[METRIC_FRAME_BYTES] = 812;
+    perf_hud_format(&hud, values, line, sizeof(line));
+    g_assert_nonnull(strstr(line, "  812B/frame  "));
+    g_assert_nonnull(strstr(line, "  hit --  "));
+}
+
+static void test_perf_hud_sample_measures_worker_time(void) {
+    gint64 values[METRIC_COUNT] = {0};
+    PerfHud hud = {0};
+    gchar line[PERF_HUD_LINE_MAX];
+
+    values[METRIC_WORKER_BUSY_US] = 5000000;
+    perf_hud_sample(&hud, values, 1000000);
+    g_assert_false(hud.worker_measured);
+
+    // Two workers busy for the whole quarter second read as two cores
+    values[METRIC_WORKER_BUSY_US] += 500000;
+    perf_hud_sample(&hud, values, 1250000);
+    g_assert_true(hud.worker_measured);
+    g_assert_cmpfloat_with_epsilon(hud.worker_percent, 200.0, 0.001);
+    perf_hud_format(&hud, values, line, sizeof(line));
+    g_assert_true(g_str_has_suffix(line, "  workers 200%"));
+
+    perf_hud_sample(&hud, values, 1500000);
+    g_assert_cmpfloat_with_epsilon(hud.worker_percent, 0.0, 0.001);
+}
+
+void register_perf_hud_tests(void) {
+    g_test_add_func("/metrics/snapshot_sees_every_thread", test_metrics_snapshot_sees_every_thread);
+    g_test_add_func("/perf_hud/format_reports_metrics", test_perf_hud_format_reports_metrics);
+    g_test_add_func("/perf_hud/sample_measures_worker_time", test_perf_hud_sample_measures_worker_time);
+}
@@ -236,6 +236,57 @@ static void test_preloader_cache_add_enforces_limit_after_insert(void) {
     preloader_destroy(preloader);
 }
 
+static void test_preloader_cache_bytes_follow_entries(void) {
+    ImagePreloader *preloader = preloader_create();
+    g_assert_nonnull(preloader);
+    preloader->max_cache_size = 2;
+
+    GString *rendered = g_string_new("12345");
+    preloader_cache_add(preloader, "a.png", rendered, 7, 3, FALSE, 10, 5);
+    preloader_cache_add(preloader, "b.png", rendered, 7, 3, FALSE, 10, 5);
+    g_assert_cmpuint(preloader->cache_bytes, ==, 10);
+
+    // Replacing an entry swaps its bytes; evicting one drops them
+    g_string_assign(rendered, "123");
+    preloader_cache_add(preloader, "b.png", rendered, 7, 3, FALSE, 10, 5);
+    g_assert_cmpuint(preloader->cache_bytes, ==, 8);
+    preloader_cache_add(preloader, "c.png", rendered, 7, 3, FALSE, 10, 5);
+    g_assert_cmpuint(preloader->cache_bytes, ==, 6);
+
+    preloader_cache_remove(preloader, "b.png");
+    g_assert_cmpuint(preloader->cache_bytes, ==, 3);
+    preloader_cache_clear(preloader);
+    g_assert_cmpuint(preloader->cache_bytes, ==, 0);
+
+    g_string_free(rendered, TRUE);
+    preloader_destroy(preloader);
+}
+
+static void test_preloader_cancel_pending_clears_queue_and_keeps_cache(void) {
+    ImagePreloader *preloader = preloader_create();
+    g_assert_nonnull(preloader);
+
+    GString *rendered = g_string_new("old-geometry");
+    preloader_cache_add(preloader, "image.png", rendered, 7, 3, FALSE, 10, 5);
+    g_string_free(rendered, TRUE);
+    g_assert_cmpint(preloader_add_task(preloader, "next.png", 1, 10, 5), ==, ERROR_NONE);
+    g_assert_cmpuint(g_queue_get_length(preloader->task_queue), ==, 1);
+    guint generation = preloader->generation;
+
+    preloader_cancel_pending(preloader);
+    g_assert_cmpuint(g_queue_get_length(preloader->task_queue), ==, 0);
+    g_assert_cmpuint(preloader->generation, !=, generation);
+
+    // Renders for a geometry that comes back are still served
+    GString *cached = preloader_get_cached_image(preloader, "image.png", 10, 5);
+    g_assert_nonnull(cached);
+    g_assert_cmpstr(cached->str, ==, "old-geometry");
+    g_string_free(cached, TRUE);
+
+    preloader_cancel_pending(NULL);
+    preloader_destroy(preloader);
+}
+
 void register_preloader_tests(void) {
     g_test_add_func("/preloader/get_cached_image/caller_owned_copy",
                     test_preloader_get_cached_image_returns_caller_owned_copy);
@@ -257,6 +308,10 @@ void register_preloader_tests(void) {
                     test_preloader_stop_clears_pending_tasks);
     g_test_add_func("/preloader/cache_cleanup/public_wrapper_enforces_limit",
                     test_preloader_cache_cleanup_public_wrapper_enforces_limit);
+    g_test_add_func("/preloader/cache_bytes/follow_entries",
+                    test_preloader_cache_bytes_follow_entries);
     g_test_add_func("/preloader/cache_add/enforces_limit_after_insert",
                     test_preloader_cache_add_enforces_limit_after_insert);
+    g_test_add_func("/preloader/cancel_pending/clears_queue_and_keeps_cache",
+                    test_preloader_cancel_pending_clears_queue_and_keeps_cache);
 }
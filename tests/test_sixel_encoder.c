@@ -0,0 +1,176 @@
+#include <glib.h>
+#include <string.h>
+
+#include "common.h"
+#include "sixel_encoder.h"
+
+static guint8 *new_frame(gint width, gint height) {
+    return g_malloc0((gsize)width * height * 4);
+}
+
+static void set_pixel(guint8 *frame, gint width, gint x, gint y, guint8 r, guint8 g, guint8 b) {
+    guint8 *pixel = frame + ((gsize)y * width + x) * 4;
+    pixel[0] = r;
+    pixel[1] = g;
+    pixel[2] = b;
+    pixel[3] = 255;
+}
+
+static void fill_gray_ramp(guint8 *frame, gint width, gint height, gint shift) {
+    for (gint y = 0; y < height; y++) {
+        for (gint x = 0; x < width; x++) {
+            guint8 value = (guint8)CLAMP(x * 255 / (width - 1) + shift, 0, 255);
+            set_pixel(frame, width, x, y, value, value, value);
+        }
+    }
+}
+
+// Returns the color definitions ("#n;2;r;g;b") of an encoded image.
+static gchar *palette_of(const GString *out) {
+    const char *start = strchr(out->str, '#');
+    const char *end = start;
+    while (end && *end == '#') {
+        const char *after_index = end + 1 + strspn(end + 1, "0123456789");
+        if (*after_index != ';') {
+            break;
+        }
+        end = strchr(after_index, '#');
+    }
+    g_assert_nonnull(end);
+    return g_strndup(start, (gsize)(end - start));
+}
+
+static void test_sixel_encoder_single_color(void) {
+    const gint width = 12;
+    const gint height = 6;
+    guint8 *frame = new_frame(width, height);
+    for (gint y = 0; y < height; y++) {
+        for (gint x = 0; x < width; x++) {
+            set_pixel(frame, width, x, y, 128, 64, 32);
+        }
+    }
+    SixelPaletteCache *cache = sixel_palette_cache_new();
+    GString *out = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_nonnull(out);
+    g_assert_cmpstr(out->str, ==, "\033P0;1;0q\"1;1;12;6#0;2;50;25;13#0!12~\033\\");
+
+    g_string_free(out, TRUE);
+    sixel_palette_cache_free(cache);
+    g_free(frame);
+}
+
+static void test_sixel_encoder_two_colors_two_bands(void) {
+    const gint width = 8;
+    const gint height = 12;
+    guint8 *frame = new_frame(width, height);
+    for (gint y = 0; y < height; y++) {
+        for (gint x = 0; x < width; x++) {
+            guint8 value = x < width / 2 ? 0 : 255;
+            set_pixel(frame, width, x, y, value, value, value);
+        }
+    }
+    SixelPaletteCache *cache = sixel_palette_cache_new();
+    GString *out = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_nonnull(out);
+    g_assert_cmpstr(out->str, ==,
+                    "\033P0;1;0q\"1;1;8;12#0;2;0;0;0#1;2;100;100;100"
+                    "#0!4~$#1!4?!4~-"
+                    "#0!4~$#1!4?!4~\033\\");
+
+    g_string_free(out, TRUE);
+    sixel_palette_cache_free(cache);
+    g_free(frame);
+}
+
+static void test_sixel_encoder_reuses_palette_until_scene_changes(void) {
+    const gint width = 64;
+    const gint height = 48;
+    guint8 *frame = new_frame(width, height);
+    SixelPaletteCache *cache = sixel_palette_cache_new();
+    g_assert_cmpuint(sixel_palette_cache_get_builds(cache), ==, 0);
+
+    fill_gray_ramp(frame, width, height, 0);
+    GString *first = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_cmpuint(sixel_palette_cache_get_builds(cache), ==, 1);
+
+    // A slightly brighter frame of the same scene keeps the palette
+    fill_gray_ramp(frame, width, height, 3);
+    GString *second = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_cmpuint(sixel_palette_cache_get_builds(cache), ==, 1);
+    gchar *first_palette = palette_of(first);
+    gchar *second_palette = palette_of(second);
+    g_assert_cmpuint(strlen(first_palette), >, 0);
+    g_assert_cmpstr(first_palette, ==, second_palette);
+    g_free(first_palette);
+    g_free(second_palette);
+
+    // Saturated colors the gray palette cannot show start a new scene
+    for (gint y = 0; y < height; y++) {
+        for (gint x = 0; x < width; x++) {
+            set_pixel(frame, width, x, y, (guint8)(x * 4), 0, (guint8)(255 - y * 5));
+        }
+    }
+    GString *third = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_cmpuint(sixel_palette_cache_get_builds(cache), ==, 2);
+
+    sixel_palette_cache_reset(cache);
+    GString *fourth = sixel_encode_rgba(cache, frame, width, height, width * 4, width, height);
+    g_assert_cmpuint(sixel_palette_cache_get_builds(cache), ==, 3);
+    g_assert_cmpstr(third->str, ==, fourth->str);
+
+    g_string_free(first, TRUE);
+    g_string_free(second, TRUE);
+    g_string_free(third, TRUE);
+    g_string_free(fourth, TRUE);
+    sixel_palette_cache_free(cache);
+    g_free(frame);
+}
+
+static void test_sixel_encoder_scales_and_validates(void) {
+    const gint width = 16;
+    const gint height = 12;
+    guint8 *frame = new_frame(width, height);
+    fill_gray_ramp(frame, width, height, 0);
+    SixelPaletteCache *cache = sixel_palette_cache_new();
+
+    GString *out = sixel_encode_rgba(cache, frame, width, height, width * 4, 8, 6);
+    g_assert_nonnull(out);
+    g_assert_true(g_str_has_prefix(out->str, "\033P0;1;0q\"1;1;8;6#"));
+    g_assert_true(g_str_has_suffix(out->str, "\033\\"));
+    g_assert_null(strchr(out->str, '-'));
+
+    g_assert_null(sixel_encode_rgba(NULL, frame, width, height, width * 4, 8, 6));
+    g_assert_null(sixel_encode_rgba(cache, NULL, width, height, width * 4, 8, 6));
+    g_assert_null(sixel_encode_rgba(cache, frame, width, height, width * 3, 8, 6));
+    g_assert_null(sixel_encode_rgba(cache, frame, width, height, width * 4, 0, 6));
+
+    g_string_free(out, TRUE);
+    sixel_palette_cache_free(cache);
+    g_free(frame);
+}
+
+static void test_sixel_encoder_image_size(void) {
+    gint cell_width = 0;
+    gint cell_height = 0;
+    get_terminal_cell_geometry(&cell_width, &cell_height);
+
+    gint width = 0;
+    gint height = 0;
+    g_assert_true(sixel_get_image_size(3, 2, &width, &height));
+    g_assert_cmpint(width, ==, 3 * cell_width);
+    g_assert_cmpint(height % 6, ==, 0);
+    g_assert_cmpint(height, <=, 2 * cell_height);
+    g_assert_cmpint(height, >, 2 * cell_height - 6);
+
+    g_assert_false(sixel_get_image_size(0, 2, &width, &height));
+    g_assert_false(sixel_get_image_size(3, -1, &width, &height));
+}
+
+void register_sixel_encoder_tests(void) {
+    g_test_add_func("/sixel_encoder/encode/single_color", test_sixel_encoder_single_color);
+    g_test_add_func("/sixel_encoder/encode/two_colors_two_bands", test_sixel_encoder_two_colors_two_bands);
+    g_test_add_func("/sixel_encoder/palette/reused_until_scene_changes",
+                    test_sixel_encoder_reuses_palette_until_scene_changes);
+    g_test_add_func("/sixel_encoder/encode/scales_and_validates", test_sixel_encoder_scales_and_validates);
+    g_test_add_func("/sixel_encoder/image_size", test_sixel_encoder_image_size);
+}
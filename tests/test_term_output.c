@@ -0,0 +1,123 @@
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "term_output.h"
+
+static gchar *read_available(gint fd) {
+    GString *data = g_string_new(NULL);
+    gchar buffer[4096];
+    ssize_t n = 0;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        g_string_append_len(data, buffer, n);
+    }
+    g_assert_true(n == 0 || errno == EAGAIN || errno == EWOULDBLOCK);
+    return g_string_free(data, FALSE);
+}
+
+static void open_capture_pipe(gint fds[2]) {
+    g_assert_cmpint(pipe(fds), ==, 0);
+    g_assert_cmpint(fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK), ==, 0);
+}
+
+static void test_term_output_writes_frame_once(void) {
+    gint fds[2];
+    open_capture_pipe(fds);
+    g_assert_true(term_output_install(fds[1]));
+
+    term_output_begin_frame();
+    printf("\033[H");
+    fflush(stdout);
+    term_output_begin_frame();
+    for (gint row = 1; row <= 20; row++) {
+        printf("\033[%d;1Hrow %d", row, row);
+        fflush(stdout);
+    }
+    g_assert_true(term_output_end_frame());
+    fwrite("tail", 1, 4, stdout);
+    fflush(stdout);
+
+    // Nothing reaches the descriptor until the outermost frame ends
+    gchar *pending = read_available(fds[0]);
+    g_assert_cmpstr(pending, ==, "");
+    g_free(pending);
+
+    g_assert_true(term_output_end_frame());
+    gchar *frame = read_available(fds[0]);
+    g_assert_true(g_str_has_prefix(frame, "\033[H\033[1;1Hrow 1"));
+    g_assert_true(g_str_has_suffix(frame, "row 20tail"));
+
+    TermOutputStats stats;
+    term_output_get_stats(&stats);
+    g_assert_cmpuint(stats.frames, ==, 1);
+    g_assert_cmpuint(stats.last_frame_bytes, ==, strlen(frame));
+    g_assert_cmpuint(stats.last_frame_syscalls, ==, 1);
+    g_assert_cmpuint(stats.syscalls, ==, 1);
+    g_free(frame);
+
+    term_output_uninstall();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void test_term_output_passes_through_outside_frames(void) {
+    gint fds[2];
+    open_capture_pipe(fds);
+    g_assert_true(term_output_install(fds[1]));
+    g_assert_false(term_output_install(fds[1]));
+
+    printf("plain");
+    fflush(stdout);
+    gchar *plain = read_available(fds[0]);
+    g_assert_cmpstr(plain, ==, "plain");
+    g_free(plain);
+
+    // Empty frames and unmatched ends write nothing
+    term_output_begin_frame();
+    g_assert_true(term_output_end_frame());
+    g_assert_true(term_output_end_frame());
+
+    TermOutputStats stats;
+    term_output_get_stats(&stats);
+    g_assert_cmpuint(stats.frames, ==, 0);
+    g_assert_cmpuint(stats.bytes, ==, 5);
+    g_assert_cmpuint(stats.syscalls, ==, 1);
+
+    term_output_uninstall();
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void test_term_output_flush_closes_open_frames(void) {
+    gint fds[2];
+    open_capture_pipe(fds);
+    g_assert_true(term_output_install(fds[1]));
+
+    term_output_begin_frame();
+    term_output_begin_frame();
+    printf("left open");
+    term_output_flush();
+    gchar *frame = read_available(fds[0]);
+    g_assert_cmpstr(frame, ==, "left open");
+    g_free(frame);
+
+    // Uninstalling writes what is still held
+    term_output_begin_frame();
+    printf("at exit");
+    term_output_uninstall();
+    frame = read_available(fds[0]);
+    g_assert_cmpstr(frame, ==, "at exit");
+    g_free(frame);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void register_term_output_tests(void) {
+    g_test_add_func("/term_output/writes_frame_once", test_term_output_writes_frame_once);
+    g_test_add_func("/term_output/passes_through_outside_frames", test_term_output_passes_through_outside_frames);
+    g_test_add_func("/term_output/flush_closes_open_frames", test_term_output_flush_closes_open_frames);
+}
@@ -0,0 +1,174 @@
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "process_env.h"
+#include "trace.h"
+
+static gchar *trace_temp_path(void) {
+    gchar *path = g_strdup_printf("%s/pixelterm-trace-XXXXXX", g_get_tmp_dir());
+    gint fd = g_mkstemp(path);
+    g_assert_cmpint(fd, >=, 0);
+    close(fd);
+    return path;
+}
+
+static gchar *trace_read_and_remove(const gchar *path) {
+    gchar *contents = NULL;
+    g_assert_true(g_file_get_contents(path, &contents, NULL, NULL));
+    g_remove(path);
+    return contents;
+}
+
+static guint count_occurrences(const gchar *haystack, const gchar *needle) {
+    guint count = 0;
+    for (const gchar *p = strstr(haystack, needle); p; p = strstr(p + 1, needle)) {
+        count++;
+    }
+    return count;
+}
+
+static void record_span(const char *category, const char *name) {
+    TraceSpan span = trace_span_begin(category, name);
+    trace_span_end(&span);
+}
+
+static gpointer trace_worker(gpointer data) {
+    (void)data;
+    trace_set_thread_name("worker");
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_RENDER, "image");
+    trace_span_end_arg(&span, "bytes", 42);
+    return NULL;
+}
+
+static gpointer trace_named_worker(gpointer data) {
+    const gchar *name = data;
+    trace_set_thread_name(name);
+    record_span(TRACE_CATEGORY_PRELOAD, name);
+    return NULL;
+}
+
+// The tid on the first line of @p json that contains @p needle, or -1.
+static gint trace_tid_of_line(const gchar *json, const gchar *needle) {
+    const gchar *match = strstr(json, needle);
+    if (!match) {
+        return -1;
+    }
+    const gchar *line = match;
+    while (line > json && line[-1] != '\n') {
+        line--;
+    }
+    const gchar *tid = strstr(line, "\"tid\":");
+    gint value = -1;
+    if (!tid || sscanf(tid, "\"tid\":%d", &value) != 1) {
+        return -1;
+    }
+    return value;
+}
+
+static void test_trace_disabled_records_nothing(void) {
+    trace_reset_for_test();
+    pixelterm_env_unset_for_test(TRACE_ENV);
+    trace_init(NULL);
+
+    g_assert_false(trace_enabled());
+    TraceSpan span = trace_span_begin(TRACE_CATEGORY_DECODE, "image");
+    g_assert_cmpint(span.start_us, ==, 0);
+    trace_span_end(&span);
+    g_assert_true(trace_finish());
+
+    pixelterm_env_set_for_test(TRACE_ENV, "0");
+    trace_init(NULL);
+    g_assert_false(trace_enabled());
+    pixelterm_env_reset_for_test();
+}
+
+static void test_trace_writes_spans_per_thread(void) {
+    trace_reset_for_test();
+    gchar *path = trace_temp_path();
+    trace_init(path);
+    g_assert_true(trace_enabled());
+
+    record_span(TRACE_CATEGORY_PRESENT, "frame");
+    GThread *thread = g_thread_new("trace-test", trace_worker, NULL);
+    g_thread_join(thread);
+
+    g_assert_true(trace_finish());
+    g_assert_false(trace_enabled());
+    gchar *json = trace_read_and_remove(path);
+
+    g_assert_true(g_str_has_prefix(json, "{\"traceEvents\":[\n"));
+    g_assert_nonnull(strstr(json, "\"args\":{\"name\":\"main\"}"));
+    g_assert_nonnull(strstr(json, "\"args\":{\"name\":\"worker\"}"));
+    g_assert_nonnull(strstr(json, "{\"name\":\"frame\",\"cat\":\"present\",\"ph\":\"X\""));
+    g_assert_nonnull(strstr(json, "{\"name\":\"image\",\"cat\":\"render\",\"ph\":\"X\""));
+    g_assert_nonnull(strstr(json, "\"args\":{\"bytes\":42}"));
+    g_assert_nonnull(strstr(json, "\"dropped_spans\":0"));
+    g_assert_cmpuint(count_occurrences(json, "\"ph\":\"X\""), ==, 2);
+    // The two spans sit on different tracks
+    g_assert_cmpuint(count_occurrences(json, "\"name\":\"thread_name\""), ==, 2);
+    g_free(json);
+
+    // Finishing twice writes nothing more
+    g_assert_true(trace_finish());
+    g_assert_false(g_file_test(path, G_FILE_TEST_EXISTS));
+    g_free(path);
+}
+
+static void test_trace_reused_ring_keeps_attribution(void) {
+    trace_reset_for_test();
+    gchar *path = trace_temp_path();
+    trace_init(path);
+
+    // The second thread may take over the first one's ring after it exits
+    GThread *thread = g_thread_new("trace-first", trace_named_worker, (gpointer)"first");
+    g_thread_join(thread);
+    thread = g_thread_new("trace-second", trace_named_worker, (gpointer)"second");
+    g_thread_join(thread);
+
+    g_assert_true(trace_finish());
+    gchar *json = trace_read_and_remove(path);
+    gint first_track = trace_tid_of_line(json, "\"args\":{\"name\":\"first\"}");
+    gint second_track = trace_tid_of_line(json, "\"args\":{\"name\":\"second\"}");
+    g_assert_cmpint(first_track, >, 0);
+    g_assert_cmpint(second_track, >, 0);
+    g_assert_cmpint(first_track, !=, second_track);
+    g_assert_cmpint(trace_tid_of_line(json, "{\"name\":\"first\",\"cat\""), ==, first_track);
+    g_assert_cmpint(trace_tid_of_line(json, "{\"name\":\"second\",\"cat\""), ==, second_track);
+    g_assert_nonnull(strstr(json, "\"dropped_spans\":0"));
+    g_free(json);
+    g_free(path);
+}
+
+static void test_trace_ring_keeps_latest_spans(void) {
+    trace_reset_for_test();
+    gchar *path = trace_temp_path();
+    pixelterm_env_set_for_test(TRACE_ENV, path);
+    trace_init(NULL);
+    pixelterm_env_reset_for_test();
+    g_assert_true(trace_enabled());
+
+    for (gint i = 0; i < 5; i++) {
+        record_span(TRACE_CATEGORY_SCAN, "old");
+    }
+    for (gint i = 0; i < TRACE_RING_CAPACITY; i++) {
+        record_span(TRACE_CATEGORY_SCAN, "new");
+    }
+
+    g_assert_true(trace_finish());
+    gchar *json = trace_read_and_remove(path);
+    g_assert_null(strstr(json, "\"name\":\"old\""));
+    g_assert_cmpuint(count_occurrences(json, "\"name\":\"new\""), ==, TRACE_RING_CAPACITY);
+    g_assert_nonnull(strstr(json, "\"dropped_spans\":5"));
+    g_free(json);
+    g_free(path);
+}
+
+void register_trace_tests(void) {
+    g_test_add_func("/trace/disabled_records_nothing", test_trace_disabled_records_nothing);
+    g_test_add_func("/trace/writes_spans_per_thread", test_trace_writes_spans_per_thread);
+    g_test_add_func("/trace/ring_keeps_latest_spans", test_trace_ring_keeps_latest_spans);
+    g_test_add_func("/trace/reused_ring_keeps_attribution", test_trace_reused_ring_keeps_attribution);
+}
@@ -0,0 +1,195 @@
+#include <glib.h>
+#include <string.h>
+
+#include "video_dirty.h"
+
+// 8x4 cells of 2x2 pixels
+#define TEST_COLUMNS 8
+#define TEST_ROWS 4
+#define TEST_WIDTH (TEST_COLUMNS * 2)
+#define TEST_HEIGHT (TEST_ROWS * 2)
+
+static VideoDirtyFrame *new_gray_frame(guint8 value) {
+    guint8 pixels[TEST_WIDTH * TEST_HEIGHT * 4];
+    memset(pixels, value, sizeof(pixels));
+    return video_dirty_frame_new(pixels, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4,
+                                 TEST_WIDTH, TEST_HEIGHT, TEST_COLUMNS, TEST_ROWS, 2);
+}
+
+// Changes one pixel inside the given cell.
+static void touch_cell(VideoDirtyFrame *frame, gint column, gint row) {
+    guint8 *pixel = frame->pixels + ((gsize)(row * 2 + 1) * frame->width + (gsize)(column * 2)) * 4;
+    pixel[1] ^= 0xff;
+}
+
+static void assert_rect(const GArray *rects, guint index, gint column, gint row, gint columns, gint rows) {
+    g_assert_cmpuint(index, <, rects->len);
+    const VideoDirtyRect *rect = &g_array_index(rects, VideoDirtyRect, index);
+    g_assert_cmpint(rect->column, ==, column);
+    g_assert_cmpint(rect->row, ==, row);
+    g_assert_cmpint(rect->columns, ==, columns);
+    g_assert_cmpint(rect->rows, ==, rows);
+}
+
+static void test_video_dirty_identical_frames_have_no_rects(void) {
+    VideoDirtyFrame *previous = new_gray_frame(40);
+    VideoDirtyFrame *current = new_gray_frame(40);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    gdouble changed = 1.0;
+
+    g_assert_true(video_dirty_find_rects(previous, current, rects, &changed));
+    g_assert_cmpuint(rects->len, ==, 0);
+    g_assert_cmpfloat(changed, ==, 0.0);
+
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(previous);
+    video_dirty_frame_free(current);
+}
+
+static void test_video_dirty_single_cell(void) {
+    VideoDirtyFrame *previous = new_gray_frame(40);
+    VideoDirtyFrame *current = new_gray_frame(40);
+    touch_cell(current, 5, 2);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    gdouble changed = 0.0;
+
+    g_assert_true(video_dirty_find_rects(previous, current, rects, &changed));
+    g_assert_cmpuint(rects->len, ==, 1);
+    assert_rect(rects, 0, 5, 2, 1, 1);
+    g_assert_cmpfloat_with_epsilon(changed, 1.0 / (TEST_COLUMNS * TEST_ROWS), 1e-9);
+
+    gint x = 0;
+    gint y = 0;
+    gint width = 0;
+    gint height = 0;
+    video_dirty_get_pixel_rect(current, &g_array_index(rects, VideoDirtyRect, 0), &x, &y, &width, &height);
+    g_assert_cmpint(x, ==, 10);
+    g_assert_cmpint(y, ==, 4);
+    g_assert_cmpint(width, ==, 2);
+    g_assert_cmpint(height, ==, 2);
+
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(previous);
+    video_dirty_frame_free(current);
+}
+
+static void test_video_dirty_joins_gaps_and_rows(void) {
+    VideoDirtyFrame *previous = new_gray_frame(40);
+    VideoDirtyFrame *current = new_gray_frame(40);
+    // Row 0: cells 0 and 3 share a rectangle across a two-cell gap, cell 7
+    // is too far away
+    touch_cell(current, 0, 0);
+    touch_cell(current, 3, 0);
+    touch_cell(current, 7, 0);
+    // Row 1 repeats the first run, so that rectangle grows downwards
+    touch_cell(current, 0, 1);
+    touch_cell(current, 3, 1);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    gdouble changed = 0.0;
+
+    g_assert_true(video_dirty_find_rects(previous, current, rects, &changed));
+    g_assert_cmpuint(rects->len, ==, 2);
+    assert_rect(rects, 0, 0, 0, 4, 2);
+    assert_rect(rects, 1, 7, 0, 1, 1);
+    g_assert_cmpfloat_with_epsilon(changed, 9.0 / (TEST_COLUMNS * TEST_ROWS), 1e-9);
+
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(previous);
+    video_dirty_frame_free(current);
+}
+
+static void test_video_dirty_rejects_other_sizes(void) {
+    guint8 pixels[TEST_WIDTH * TEST_HEIGHT * 4] = {0};
+    VideoDirtyFrame *previous = new_gray_frame(40);
+    VideoDirtyFrame *smaller = video_dirty_frame_new(pixels, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4,
+                                                     TEST_WIDTH / 2, TEST_HEIGHT, TEST_COLUMNS / 2,
+                                                     TEST_ROWS, 2);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+
+    g_assert_nonnull(smaller);
+    g_assert_false(video_dirty_find_rects(previous, smaller, rects, NULL));
+    g_assert_false(video_dirty_find_rects(NULL, smaller, rects, NULL));
+    g_assert_null(video_dirty_frame_new(pixels, TEST_WIDTH, TEST_HEIGHT, TEST_WIDTH * 4,
+                                        0, TEST_HEIGHT, TEST_COLUMNS, TEST_ROWS, 2));
+
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(previous);
+    video_dirty_frame_free(smaller);
+}
+
+static void test_video_dirty_tags_kitty_transmit(void) {
+    GString *rendered = g_string_new("\033_Ga=T,f=32,s=16,v=8,m=1;AAAA\033\\\033_Gm=0;AAAA\033\\");
+    gint width = 0;
+    gint height = 0;
+
+    g_assert_true(video_dirty_tag_kitty(rendered, 33554433u, &width, &height));
+    g_assert_cmpstr(rendered->str, ==,
+                    "\033_Gi=33554433,q=2,a=T,f=32,s=16,v=8,m=1;AAAA\033\\\033_Gm=0;AAAA\033\\");
+    g_assert_cmpint(width, ==, 16);
+    g_assert_cmpint(height, ==, 8);
+
+    // Already tagged
+    g_assert_false(video_dirty_tag_kitty(rendered, 33554434u, NULL, NULL));
+    g_string_free(rendered, TRUE);
+
+    rendered = g_string_new("\033_Ga=T,f=32,s=16,v=8,q=1;AAAA\033\\");
+    g_assert_true(video_dirty_tag_kitty(rendered, 7u, NULL, NULL));
+    g_assert_cmpstr(rendered->str, ==, "\033_Gi=7,a=T,f=32,s=16,v=8,q=1;AAAA\033\\");
+    g_string_free(rendered, TRUE);
+
+    rendered = g_string_new("\033_Ga=T,f=100;AAAA\033\\");
+    g_assert_false(video_dirty_tag_kitty(rendered, 7u, NULL, NULL));
+    g_string_free(rendered, TRUE);
+}
+
+static void test_video_dirty_kitty_update_edits_shown_image(void) {
+    VideoDirtyFrame *frame = new_gray_frame(0);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    VideoDirtyRect rect = {1, 2, 1, 1};
+    g_array_append_val(rects, rect);
+    VideoDirtyTarget target = {CHAFA_PIXEL_MODE_KITTY, 42u, NULL, 3, 5};
+    GString *out = g_string_new(NULL);
+
+    video_dirty_append_updates(out, &target, frame, rects);
+    // Four zeroed RGBA pixels
+    g_assert_cmpstr(out->str, ==,
+                    "\033_Ga=f,i=42,r=1,x=2,y=4,s=2,v=2,f=32,X=1,q=2;AAAAAAAAAAAAAAAAAAAAAA==\033\\");
+
+    g_string_free(out, TRUE);
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(frame);
+}
+
+static void test_video_dirty_sixel_update_moves_cursor(void) {
+    VideoDirtyFrame *frame = new_gray_frame(128);
+    GArray *rects = g_array_new(FALSE, FALSE, sizeof(VideoDirtyRect));
+    VideoDirtyRect first = {0, 0, 1, 1};
+    VideoDirtyRect second = {6, 3, 2, 1};
+    g_array_append_val(rects, first);
+    g_array_append_val(rects, second);
+    SixelPaletteCache *palettes = sixel_palette_cache_new();
+    VideoDirtyTarget target = {CHAFA_PIXEL_MODE_SIXELS, 0u, palettes, 3, 5};
+    GString *out = g_string_new(NULL);
+
+    video_dirty_append_updates(out, &target, frame, rects);
+    g_assert_true(g_str_has_prefix(out->str, "\033[3;5H\033P0;1;0q\"1;1;2;2#"));
+    const char *second_update = strstr(out->str, "\033\\\033[6;11H\033P0;1;0q\"1;1;4;2#");
+    g_assert_nonnull(second_update);
+    g_assert_true(g_str_has_suffix(out->str, "\033\\"));
+    g_assert_cmpuint(sixel_palette_cache_get_builds(palettes), ==, 1);
+
+    g_string_free(out, TRUE);
+    sixel_palette_cache_free(palettes);
+    g_array_free(rects, TRUE);
+    video_dirty_frame_free(frame);
+}
+
+void register_video_dirty_tests(void) {
+    g_test_add_func("/video_dirty/find_rects/identical", test_video_dirty_identical_frames_have_no_rects);
+    g_test_add_func("/video_dirty/find_rects/single_cell", test_video_dirty_single_cell);
+    g_test_add_func("/video_dirty/find_rects/joins_gaps_and_rows", test_video_dirty_joins_gaps_and_rows);
+    g_test_add_func("/video_dirty/find_rects/rejects_other_sizes", test_video_dirty_rejects_other_sizes);
+    g_test_add_func("/video_dirty/kitty/tag_transmit", test_video_dirty_tags_kitty_transmit);
+    g_test_add_func("/video_dirty/kitty/update_edits_shown_image", test_video_dirty_kitty_update_edits_shown_image);
+    g_test_add_func("/video_dirty/sixel/update_moves_cursor", test_video_dirty_sixel_update_moves_cursor);
+}